@@ -932,7 +932,7 @@ void indigo_alpaca_ccd_update_property(indigo_alpaca_device *alpaca_device, indi
 		if (property->state == INDIGO_OK_STATE) {
 			for (int i = 0; i < property->count; i++) {
 				indigo_item *item = property->items + i;
-				alpaca_device->ccd.readoutmodes_labels[i] = item->label;
+				alpaca_device->ccd.readoutmodes_labels[i] = (char *)item->label;
 				alpaca_device->ccd.readoutmodes_names[i] = item->name;
 				if (item->sw.value)
 					alpaca_device->ccd.readoutmode = i;
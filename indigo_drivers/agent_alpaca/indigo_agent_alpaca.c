@@ -78,10 +78,8 @@ static void save_config(indigo_device *device) {
 		pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
 		pthread_mutex_lock(&private_data->mutex);
 		indigo_save_property(device, NULL, AGENT_DEVICES_PROPERTY);
-		if (DEVICE_CONTEXT->property_save_file_handle) {
+		if (indigo_flush_properties(device) == INDIGO_OK) {
 			CONFIG_PROPERTY->state = INDIGO_OK_STATE;
-			close(DEVICE_CONTEXT->property_save_file_handle);
-			DEVICE_CONTEXT->property_save_file_handle = 0;
 		} else {
 			CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
 		}
@@ -393,8 +391,10 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		if (AGENT_DISCOVERY_PROPERTY == NULL)
 			return INDIGO_FAILED;
 		for (int i = 0; i <INDIGO_MAX_ITEMS; i++) {
+			char label[INDIGO_NAME_SIZE];
 			sprintf(AGENT_DEVICES_PROPERTY->items[i].name, "%d", i);
-			sprintf(AGENT_DEVICES_PROPERTY->items[i].label, "Device #%d", i);
+			sprintf(label, "Device #%d", i);
+			indigo_set_item_label(AGENT_DEVICES_PROPERTY->items + i, label);
 		}
 		AGENT_DEVICES_PROPERTY->count = 0;
 		// --------------------------------------------------------------------------------
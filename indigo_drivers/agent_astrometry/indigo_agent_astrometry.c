@@ -23,7 +23,7 @@
  \file indigo_agent_astrometry.c
  */
 
-#define DRIVER_VERSION 0x0009
+#define DRIVER_VERSION 0x000A
 #define DRIVER_NAME	"indigo_agent_astrometry"
 
 #include <stdio.h>
@@ -37,6 +37,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
@@ -177,6 +178,23 @@ static char base_dir[512];
 #define AGENT_ASTROMETRY_INDEX_4201_ITEM    	(AGENT_ASTROMETRY_INDEX_42XX_PROPERTY->items+18)
 #define AGENT_ASTROMETRY_INDEX_4200_ITEM    	(AGENT_ASTROMETRY_INDEX_42XX_PROPERTY->items+19)
 
+typedef struct {
+	char path[INDIGO_VALUE_SIZE];
+	void *addr;
+	size_t size;
+} astrometry_index_map;
+
+typedef enum {
+	ASTROMETRY_JOB_SOLVE,
+	ASTROMETRY_JOB_MAP_INDEXES,
+	ASTROMETRY_JOB_EXIT
+} astrometry_job_type;
+
+typedef struct {
+	astrometry_job_type type;
+	indigo_platesolver_task *task;
+} astrometry_job;
+
 typedef struct {
 	platesolver_private_data platesolver;
 	indigo_property *index_41xx_property;
@@ -184,6 +202,15 @@ typedef struct {
 	int frame_width;
 	int frame_height;
 	pid_t pid;
+	int job_pipe[2];
+	pthread_t worker;
+	pthread_mutex_t job_mutex;
+	bool solve_pending;
+	astrometry_index_map *index_maps;
+	int index_map_count;
+	double last_scale;
+	int last_frame_width;
+	int last_frame_height;
 } astrometry_private_data;
 
 // --------------------------------------------------------------------------------
@@ -233,7 +260,7 @@ static bool execute_command(indigo_device *device, char *command, ...) {
 			*nl = 0;
 		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "< %s", line);
 		double d1, d2;
-		char s[16];
+		char s[16], units[16] = "";
 		if (strstr(line, "message:")) {
 			indigo_send_message(device, line + 9);
 		} else if (sscanf(line, "simplexy: nx=%d, ny=%d", &ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width, &ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height) == 2) {
@@ -243,7 +270,14 @@ static bool execute_command(indigo_device *device, char *command, ...) {
 			AGENT_PLATESOLVER_WCS_RA_ITEM->number.value = d1 / 15;
 			AGENT_PLATESOLVER_WCS_DEC_ITEM->number.value = d2;
 			INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->failed = false;
-		} else if (sscanf(line, "Field size: %lg x %lg", &d1, &d2) == 2) {
+		} else if (sscanf(line, "Field size: %lg x %lg %15s", &d1, &d2, units) >= 2) {
+			if (!strncmp(units, "arcmin", 6)) {
+				d1 /= 60;
+				d2 /= 60;
+			} else if (!strncmp(units, "arcsec", 6)) {
+				d1 /= 3600;
+				d2 /= 3600;
+			}
 			AGENT_PLATESOLVER_WCS_WIDTH_ITEM->number.value = d1;
 			AGENT_PLATESOLVER_WCS_HEIGHT_ITEM->number.value = d2;
 			AGENT_PLATESOLVER_WCS_SCALE_ITEM->number.value = (d1 / ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width + d2 / ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height) / 2;
@@ -291,6 +325,168 @@ static void jpeg_decompress_error_callback(j_common_ptr cinfo) {
 
 #define astrometry_save_config indigo_platesolver_save_config
 
+#define MAX_SOURCE_COUNT	500
+
+static char *temporary_files[] = { "", ".xy", ".axy", ".wcs", ".corr", ".match", ".rdls", ".solved", "-indx.xyls", NULL };
+
+typedef struct {
+	float x, y, flux;
+} astrometry_source;
+
+// convert RAW or decoded JPEG image to 16 bit luminance, averaging bin x bin blocks
+
+static uint16_t *make_luminance(void *image, int byte_per_pixel, int components, int width, int height, int bin, int *out_width, int *out_height) {
+	int w = width / bin, h = height / bin;
+	uint16_t *luminance = indigo_safe_malloc(w * h * sizeof(uint16_t));
+	int divider = bin * bin * components;
+	for (int y = 0; y < h; y++) {
+		uint16_t *out = luminance + y * w;
+		for (int x = 0; x < w; x++) {
+			uint32_t sum = 0;
+			for (int j = 0; j < bin; j++) {
+				int offset = ((y * bin + j) * width + x * bin) * components;
+				if (byte_per_pixel == 2) {
+					uint16_t *in = (uint16_t *)image + offset;
+					for (int i = 0; i < bin * components; i++)
+						sum += in[i];
+				} else {
+					uint8_t *in = (uint8_t *)image + offset;
+					for (int i = 0; i < bin * components; i++)
+						sum += in[i];
+				}
+			}
+			out[x] = sum / divider;
+		}
+	}
+	*out_width = w;
+	*out_height = h;
+	return luminance;
+}
+
+static int source_comparator(const void *a, const void *b) {
+	float fa = ((astrometry_source *)a)->flux, fb = ((astrometry_source *)b)->flux;
+	return fa < fb ? 1 : fa > fb ? -1 : 0;
+}
+
+// single pass source extraction - local maxima above median + 5 sigma with flux weighted centroid in 5x5 window
+
+static int extract_sources(uint16_t *data, int width, int height, astrometry_source *sources, int max) {
+	int size = width * height;
+	if (width < 5 || height < 5)
+		return 0;
+	uint32_t *histogram = indigo_safe_malloc(65536 * sizeof(uint32_t));
+	memset(histogram, 0, 65536 * sizeof(uint32_t));
+	for (int i = 0; i < size; i++)
+		histogram[data[i]]++;
+	int median = 0;
+	for (uint32_t count = 0; median < 65536 && (count += histogram[median]) < size / 2; median++)
+		;
+	memset(histogram, 0, 65536 * sizeof(uint32_t));
+	for (int i = 0; i < size; i++)
+		histogram[abs(data[i] - median)]++;
+	int mad = 0;
+	for (uint32_t count = 0; mad < 65536 && (count += histogram[mad]) < size / 2; mad++)
+		;
+	free(histogram);
+	double sigma = mad > 0 ? 1.4826 * mad : 1;
+	int threshold = median + 5 * sigma;
+	int confirm = median + 2 * sigma;
+	int count = 0, weakest = 0;
+	for (int y = 2; y < height - 2; y++) {
+		for (int x = 2; x < width - 2; x++) {
+			uint16_t *p = data + y * width + x;
+			int value = *p;
+			if (value <= threshold)
+				continue;
+			// local maximum, ties are resolved in favour of the first pixel in scan order
+			if (value <= p[-width - 1] || value <= p[-width] || value <= p[-width + 1] || value <= p[-1] || value < p[1] || value < p[width - 1] || value < p[width] || value < p[width + 1])
+				continue;
+			// hot pixel and single row/column defect rejection
+			if ((p[-1] > confirm) + (p[1] > confirm) + (p[-width] > confirm) + (p[width] > confirm) < 2)
+				continue;
+			double flux = 0, sx = 0, sy = 0;
+			for (int j = -2; j <= 2; j++) {
+				for (int i = -2; i <= 2; i++) {
+					int v = p[j * width + i] - median;
+					if (v > 0) {
+						flux += v;
+						sx += v * i;
+						sy += v * j;
+					}
+				}
+			}
+			astrometry_source source = { x + sx / flux, y + sy / flux, flux };
+			if (count < max) {
+				sources[count] = source;
+				if (source.flux < sources[weakest].flux)
+					weakest = count;
+				count++;
+			} else if (source.flux > sources[weakest].flux) {
+				sources[weakest] = source;
+				for (int k = 0; k < count; k++) {
+					if (sources[k].flux < sources[weakest].flux)
+						weakest = k;
+				}
+			}
+		}
+	}
+	qsort(sources, count, sizeof(astrometry_source), source_comparator);
+	return count;
+}
+
+// write source list as FITS binary table (X, Y, FLUX) in the format produced by image2xy
+
+static bool write_xyls(const char *path, astrometry_source *sources, int count, int bin, int width, int height) {
+	int data_size = count * 3 * sizeof(float);
+	if (data_size % FITS_HEADER_SIZE)
+		data_size = (data_size / FITS_HEADER_SIZE + 1) * FITS_HEADER_SIZE;
+	int size = 2 * FITS_HEADER_SIZE + data_size;
+	char *buffer = indigo_safe_malloc(size), *p = buffer;
+	memset(buffer, ' ', 2 * FITS_HEADER_SIZE);
+	memset(buffer + 2 * FITS_HEADER_SIZE, 0, data_size);
+	int t = sprintf(p, "SIMPLE  = %20c", 'T'); p[t] = ' ';
+	t = sprintf(p += 80, "BITPIX  = %20d", 8); p[t] = ' ';
+	t = sprintf(p += 80, "NAXIS   = %20d", 0); p[t] = ' ';
+	t = sprintf(p += 80, "EXTEND  = %20c", 'T'); p[t] = ' ';
+	t = sprintf(p += 80, "END"); p[t] = ' ';
+	p = buffer + FITS_HEADER_SIZE;
+	t = sprintf(p, "XTENSION= 'BINTABLE'"); p[t] = ' ';
+	t = sprintf(p += 80, "BITPIX  = %20d", 8); p[t] = ' ';
+	t = sprintf(p += 80, "NAXIS   = %20d", 2); p[t] = ' ';
+	t = sprintf(p += 80, "NAXIS1  = %20d", (int)(3 * sizeof(float))); p[t] = ' ';
+	t = sprintf(p += 80, "NAXIS2  = %20d", count); p[t] = ' ';
+	t = sprintf(p += 80, "PCOUNT  = %20d", 0); p[t] = ' ';
+	t = sprintf(p += 80, "GCOUNT  = %20d", 1); p[t] = ' ';
+	t = sprintf(p += 80, "TFIELDS = %20d", 3); p[t] = ' ';
+	t = sprintf(p += 80, "TTYPE1  = 'X       '"); p[t] = ' ';
+	t = sprintf(p += 80, "TFORM1  = 'E       '"); p[t] = ' ';
+	t = sprintf(p += 80, "TTYPE2  = 'Y       '"); p[t] = ' ';
+	t = sprintf(p += 80, "TFORM2  = 'E       '"); p[t] = ' ';
+	t = sprintf(p += 80, "TTYPE3  = 'FLUX    '"); p[t] = ' ';
+	t = sprintf(p += 80, "TFORM3  = 'E       '"); p[t] = ' ';
+	t = sprintf(p += 80, "IMAGEW  = %20d", width); p[t] = ' ';
+	t = sprintf(p += 80, "IMAGEH  = %20d", height); p[t] = ' ';
+	t = sprintf(p += 80, "END"); p[t] = ' ';
+	uint32_t *out = (uint32_t *)(buffer + 2 * FITS_HEADER_SIZE);
+	for (int i = 0; i < count; i++) {
+		// FITS pixel coordinates are 1-based, binned pixel centre maps back to the middle of its block
+		float values[3] = { sources[i].x * bin + (bin - 1) / 2.0 + 1, sources[i].y * bin + (bin - 1) / 2.0 + 1, sources[i].flux };
+		for (int j = 0; j < 3; j++) {
+			uint32_t value;
+			memcpy(&value, values + j, sizeof(value));
+			*out++ = htonl(value);
+		}
+	}
+	bool result = false;
+	int handle = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (handle >= 0) {
+		result = indigo_write(handle, buffer, size);
+		close(handle);
+	}
+	free(buffer);
+	return result;
+}
+
 static void *astrometry_solve(indigo_platesolver_task *task) {
 	indigo_device *device = task->device;
 	void *image = task->image;
@@ -302,18 +498,30 @@ static void *astrometry_solve(indigo_platesolver_task *task) {
 		char base[512];
 		sprintf(base, "%s/%s_%lX", base_dir, "image", time(0));
 #pragma clang diagnostic pop
-		// convert any input image to FITS file
-		int handle = open(base, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-		if (handle < 0) {
-			AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, "Can't create temporary image file");
-			goto cleanup;
-		}
 		if (!strncmp("SIMPLE", (const char *)image, 6)) {
-			// FITS - copy only
+			// FITS - copy only and let image2xy extract sources
+			int handle = open(base, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+			if (handle < 0) {
+				AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
+				indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, "Can't create temporary image file");
+				goto cleanup;
+			}
 			indigo_write(handle, (const char *)image, image_size);
+			close(handle);
 			ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width = ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height = 0;
+			char hints[512] = "";
+			int hints_index = 0;
+			hints_index += sprintf(hints + hints_index, " -v");
+			if (AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value > 1) {
+				hints_index += sprintf(hints + hints_index, " -d %d", (int)AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value);
+			}
+			if (!execute_command(device, "image2xy -O%s -o \"%s.xy\" \"%s\"", hints, base, base)) {
+				AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
+				indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, "Execution of image2xy failed");
+				goto cleanup;
+			}
 		} else {
+			// RAW or JPEG - extract sources in-process and pass source list to solve-field
 			int byte_per_pixel = 0, components = 0;
 			if (!strncmp("RAW1", (const char *)(image), 4)) {
 				// 8 bit RAW
@@ -384,69 +592,27 @@ static void *astrometry_solve(indigo_platesolver_task *task) {
 			if (image == NULL) {
 				AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
 				indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, "Unsupported image format");
-				close(handle);
 				goto cleanup;
 			}
-			int pixel_count = ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width * ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height;
-			image_size = pixel_count * byte_per_pixel + FITS_HEADER_SIZE;
-			if (image_size % FITS_HEADER_SIZE) {
-				image_size = (image_size / FITS_HEADER_SIZE + 1) * FITS_HEADER_SIZE;
-			}
-			char *buffer = indigo_safe_malloc(image_size), *p = buffer;
-			memset(buffer, ' ', image_size);
-			int t = sprintf(p, "SIMPLE  = %20c", 'T'); p[t] = ' ';
-			t = sprintf(p += 80, "BITPIX  = %20d", byte_per_pixel * 8); p[t] = ' ';
-			t = sprintf(p += 80, "NAXIS   = %20d", 2); p[t] = ' ';
-			t = sprintf(p += 80, "NAXIS1  = %20d", ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width); p[t] = ' ';
-			t = sprintf(p += 80, "NAXIS2  = %20d", ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height); p[t] = ' ';
-			t = sprintf(p += 80, "EXTEND  = %20c", 'T'); p[t] = ' ';
-			if (byte_per_pixel == 2) {
-				t = sprintf(p += 80, "BZERO   = %20d", 32768); p[t] = ' ';
-				t = sprintf(p += 80, "BSCALE  = %20d", 1); p[t] = ' ';
-			}
-			t = sprintf(p += 80, "END"); p[t] = ' ';
-			p = buffer + FITS_HEADER_SIZE;
-			if (components == 1) {
-				// mono
-				if (byte_per_pixel == 2) {
-					// 16 bit RAW - swap endian
-					uint16_t *in = image;
-					uint16_t *out = (uint16_t *)p;
-					for (int i = 0; i < pixel_count; i++) {
-						int value = *in++ - 32768;
-						*out++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-					}
-				} else {
-					// 8 bit RAW
-					memcpy(p, image, pixel_count);
-				}
-			} else {
-				// RGB
-				if (byte_per_pixel == 2) {
-					// 16 bit RGB - average and swap endian
-					uint16_t *in = image;
-					uint16_t *out = (uint16_t *)p;
-					for (int i = 0; i < pixel_count; i++) {
-						int value = (in[0] + in[1] + in[2]) / 3 - 32768;
-						in += 3;
-						*out++ = (value & 0xff) << 8 | (value & 0xff00) >> 8;
-					}
-				} else {
-					// 8 bit RGB - average
-					char *in = image;
-					char *out = p;
-					for (int i = 0; i < pixel_count; i++) {
-						int value = (in[0] + in[1] + in[2]) / 3;
-						in += 3;
-						*out++ = value;
-					}
-				}
-			}
-			indigo_write(handle, buffer, image_size);
-			free(buffer);
+			int bin = AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value > 1 ? (int)AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value : 1;
+			int width, height;
+			uint16_t *luminance = make_luminance(image, byte_per_pixel, components, ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width, ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height, bin, &width, &height);
 			indigo_safe_free(intermediate_image);
+			intermediate_image = NULL;
+			astrometry_source *sources = indigo_safe_malloc(MAX_SOURCE_COUNT * sizeof(astrometry_source));
+			int count = extract_sources(luminance, width, height, sources, MAX_SOURCE_COUNT);
+			free(luminance);
+			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "%d sources extracted from %dx%d frame (downsample %d)", count, ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width, ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height, bin);
+			char path[INDIGO_VALUE_SIZE];
+			snprintf(path, sizeof(path), "%s.xy", base);
+			bool written = write_xyls(path, sources, count, bin, ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width, ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height);
+			free(sources);
+			if (!written) {
+				AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
+				indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, "Can't create source list file");
+				goto cleanup;
+			}
 		}
-		close(handle);
 		// execute astrometry.net plate solver
 		AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_BUSY_STATE;
 		AGENT_PLATESOLVER_WCS_RA_ITEM->number.value = 0;
@@ -460,7 +626,7 @@ static void *astrometry_solve(indigo_platesolver_task *task) {
 		indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, NULL);
 		char path[INDIGO_VALUE_SIZE];
 		snprintf(path, sizeof((path)), "%s/astrometry.cfg", base_dir);
-		handle = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		int handle = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
 		if (handle < 0) {
 			AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
 			indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, "Can't create astrometry.cfg");
@@ -473,7 +639,7 @@ static void *astrometry_solve(indigo_platesolver_task *task) {
 			indigo_item *item = AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + k;
 			if (item->sw.value) {
 				for (int l = 0; index_files[l]; l++) {
-					if (!strncmp(item->name, index_files[l], 10)) {
+					if (!strncmp(item->name, index_files[l], 4)) {
 						snprintf(config, sizeof(config), "index index-%s\n", index_files[l]);
 						indigo_write(handle, config, strlen(config));
 					}
@@ -484,19 +650,14 @@ static void *astrometry_solve(indigo_platesolver_task *task) {
 		char hints[512] = "";
 		char message[256] = "";
 		int hints_index = 0;
-		if (ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width == 0 || ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height == 0) {
-			hints_index += sprintf(hints + hints_index, " -v");
-		}
-		if (AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value > 1) {
-			hints_index += sprintf(hints + hints_index, " -d %d", (int)AGENT_PLATESOLVER_HINTS_DOWNSAMPLE_ITEM->number.value);
-		}
-		if (!execute_command(device, "image2xy -O%s -o \"%s.xy\" \"%s\"", hints, base, base)) {
-			AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, "Execution of image2xy failed");
-			goto cleanup;
+		if (ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width > 0 && ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height > 0) {
+			hints_index += sprintf(hints + hints_index, " --width %d --height %d", ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width, ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height);
+			// repeated solves with the same camera - limit scale search to +/- 10% of the last solution
+			if (ASTROMETRY_DEVICE_PRIVATE_DATA->last_scale > 0 && ASTROMETRY_DEVICE_PRIVATE_DATA->last_frame_width == ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width && ASTROMETRY_DEVICE_PRIVATE_DATA->last_frame_height == ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height) {
+				double scale = ASTROMETRY_DEVICE_PRIVATE_DATA->last_scale * 3600;
+				hints_index += sprintf(hints + hints_index, " --scale-units arcsecperpix --scale-low %g --scale-high %g", scale * 0.9, scale * 1.1);
+			}
 		}
-		*hints = 0;
-		hints_index = 0;
 		if (AGENT_PLATESOLVER_HINTS_RADIUS_ITEM->number.value > 0) {
 			hints_index += sprintf(hints + hints_index, " --ra %g --dec %g --radius %g", AGENT_PLATESOLVER_HINTS_RA_ITEM->number.value * 15, AGENT_PLATESOLVER_HINTS_DEC_ITEM->number.value, AGENT_PLATESOLVER_HINTS_RADIUS_ITEM->number.value);
 		}
@@ -517,6 +678,11 @@ static void *astrometry_solve(indigo_platesolver_task *task) {
 		if (INDIGO_PLATESOLVER_DEVICE_PRIVATE_DATA->failed) {
 			//strcpy(message, "No solution found");
 			AGENT_PLATESOLVER_WCS_PROPERTY->state = INDIGO_ALERT_STATE;
+			ASTROMETRY_DEVICE_PRIVATE_DATA->last_scale = 0;
+		} else if (ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width > 0 && ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height > 0) {
+			ASTROMETRY_DEVICE_PRIVATE_DATA->last_scale = AGENT_PLATESOLVER_WCS_SCALE_ITEM->number.value;
+			ASTROMETRY_DEVICE_PRIVATE_DATA->last_frame_width = ASTROMETRY_DEVICE_PRIVATE_DATA->frame_width;
+			ASTROMETRY_DEVICE_PRIVATE_DATA->last_frame_height = ASTROMETRY_DEVICE_PRIVATE_DATA->frame_height;
 		}
 		if (AGENT_PLATESOLVER_WCS_PROPERTY->state == INDIGO_BUSY_STATE) {
 			indigo_platesolver_sync(device);
@@ -550,7 +716,11 @@ static void *astrometry_solve(indigo_platesolver_task *task) {
 			indigo_update_property(device, AGENT_PLATESOLVER_WCS_PROPERTY, message);
 		}
 	cleanup:
-		execute_command(device, "rm -rf \"%s\" \"%s.xy\" \"%s.axy\" \"%s.wcs\" \"%s.corr\" \"%s.match\" \"%s.rdls\" \"%s.solved\" \"%s-indx.xyls\"", base, base, base, base, base, base, base, base, base);
+		for (int i = 0; temporary_files[i]; i++) {
+			char path[INDIGO_VALUE_SIZE];
+			snprintf(path, sizeof(path), "%s%s", base, temporary_files[i]);
+			unlink(path);
+		}
 		pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
 	} else {
 		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Solver is busy");
@@ -560,6 +730,141 @@ static void *astrometry_solve(indigo_platesolver_task *task) {
 	return NULL;
 }
 
+// -------------------------------------------------------------------------------- solver worker
+
+// keep selected index files mapped and paged in, so solve-field doesn't read them from disk on every run
+
+static void map_indexes(indigo_device *device) {
+	/* snapshot selected files under config_mutex, mapping and paging in runs without it */
+	pthread_mutex_lock(&DEVICE_CONTEXT->config_mutex);
+	int count = 0;
+	for (int k = 0; k < AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count; k++) {
+		indigo_item *item = AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + k;
+		if (item->sw.value) {
+			for (int l = 0; index_files[l]; l++) {
+				if (!strncmp(item->name, index_files[l], 4))
+					count++;
+			}
+		}
+	}
+	astrometry_index_map *maps = count > 0 ? indigo_safe_malloc(count * sizeof(astrometry_index_map)) : NULL;
+	count = 0;
+	for (int k = 0; k < AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count; k++) {
+		indigo_item *item = AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + k;
+		if (item->sw.value) {
+			for (int l = 0; index_files[l]; l++) {
+				if (!strncmp(item->name, index_files[l], 4))
+					snprintf(maps[count++].path, sizeof(maps->path), "%s/index-%s.fits", base_dir, index_files[l]);
+			}
+		}
+	}
+	pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
+	int mapped = 0;
+	for (int k = 0; k < count; k++) {
+		astrometry_index_map *map = maps + mapped;
+		if (map != maps + k)
+			*map = maps[k];
+		map->addr = NULL;
+		for (int i = 0; i < ASTROMETRY_DEVICE_PRIVATE_DATA->index_map_count; i++) {
+			astrometry_index_map *old = ASTROMETRY_DEVICE_PRIVATE_DATA->index_maps + i;
+			if (old->addr && !strcmp(old->path, map->path)) {
+				*map = *old;
+				old->addr = NULL;
+				break;
+			}
+		}
+		if (map->addr == NULL) {
+			int handle = open(map->path, O_RDONLY);
+			if (handle < 0)
+				continue;
+			struct stat st;
+			if (fstat(handle, &st) == 0 && st.st_size > 0) {
+				map->size = st.st_size;
+				map->addr = mmap(NULL, map->size, PROT_READ, MAP_SHARED, handle, 0);
+				if (map->addr == MAP_FAILED) {
+					INDIGO_DRIVER_ERROR(DRIVER_NAME, "Can't map %s (%s)", map->path, strerror(errno));
+					map->addr = NULL;
+				} else {
+					madvise(map->addr, map->size, MADV_WILLNEED);
+					long page_size = sysconf(_SC_PAGESIZE);
+					volatile unsigned char sum = 0;
+					for (size_t offset = 0; offset < map->size; offset += page_size)
+						sum += ((unsigned char *)map->addr)[offset];
+					INDIGO_DRIVER_DEBUG(DRIVER_NAME, "%s mapped (%ld kB)", map->path, (long)(map->size / 1024));
+				}
+			}
+			close(handle);
+		}
+		if (map->addr)
+			mapped++;
+	}
+	for (int i = 0; i < ASTROMETRY_DEVICE_PRIVATE_DATA->index_map_count; i++) {
+		astrometry_index_map *old = ASTROMETRY_DEVICE_PRIVATE_DATA->index_maps + i;
+		if (old->addr) {
+			munmap(old->addr, old->size);
+			INDIGO_DRIVER_DEBUG(DRIVER_NAME, "%s unmapped", old->path);
+		}
+	}
+	indigo_safe_free(ASTROMETRY_DEVICE_PRIVATE_DATA->index_maps);
+	ASTROMETRY_DEVICE_PRIVATE_DATA->index_maps = maps;
+	ASTROMETRY_DEVICE_PRIVATE_DATA->index_map_count = mapped;
+}
+
+static void unmap_indexes(indigo_device *device) {
+	for (int i = 0; i < ASTROMETRY_DEVICE_PRIVATE_DATA->index_map_count; i++) {
+		astrometry_index_map *map = ASTROMETRY_DEVICE_PRIVATE_DATA->index_maps + i;
+		munmap(map->addr, map->size);
+	}
+	indigo_safe_free(ASTROMETRY_DEVICE_PRIVATE_DATA->index_maps);
+	ASTROMETRY_DEVICE_PRIVATE_DATA->index_maps = NULL;
+	ASTROMETRY_DEVICE_PRIVATE_DATA->index_map_count = 0;
+}
+
+static bool post_job(indigo_device *device, astrometry_job_type type, indigo_platesolver_task *task) {
+	astrometry_job job = { type, task };
+	return write(ASTROMETRY_DEVICE_PRIVATE_DATA->job_pipe[1], &job, sizeof(job)) == sizeof(job);
+}
+
+static void *astrometry_worker(indigo_device *device) {
+	astrometry_job job;
+	while (read(ASTROMETRY_DEVICE_PRIVATE_DATA->job_pipe[0], &job, sizeof(job)) == sizeof(job)) {
+		switch (job.type) {
+			case ASTROMETRY_JOB_SOLVE:
+				astrometry_solve(job.task);
+				pthread_mutex_lock(&ASTROMETRY_DEVICE_PRIVATE_DATA->job_mutex);
+				ASTROMETRY_DEVICE_PRIVATE_DATA->solve_pending = false;
+				pthread_mutex_unlock(&ASTROMETRY_DEVICE_PRIVATE_DATA->job_mutex);
+				break;
+			case ASTROMETRY_JOB_MAP_INDEXES:
+				map_indexes(device);
+				break;
+			case ASTROMETRY_JOB_EXIT:
+				unmap_indexes(device);
+				return NULL;
+		}
+	}
+	return NULL;
+}
+
+static void *astrometry_queue_solve(indigo_platesolver_task *task) {
+	indigo_device *device = task->device;
+	pthread_mutex_lock(&ASTROMETRY_DEVICE_PRIVATE_DATA->job_mutex);
+	bool busy = ASTROMETRY_DEVICE_PRIVATE_DATA->solve_pending;
+	ASTROMETRY_DEVICE_PRIVATE_DATA->solve_pending = true;
+	pthread_mutex_unlock(&ASTROMETRY_DEVICE_PRIVATE_DATA->job_mutex);
+	if (busy || !post_job(device, ASTROMETRY_JOB_SOLVE, task)) {
+		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Solver is busy");
+		if (!busy) {
+			pthread_mutex_lock(&ASTROMETRY_DEVICE_PRIVATE_DATA->job_mutex);
+			ASTROMETRY_DEVICE_PRIVATE_DATA->solve_pending = false;
+			pthread_mutex_unlock(&ASTROMETRY_DEVICE_PRIVATE_DATA->job_mutex);
+		}
+		free(task->image);
+		free(task);
+	}
+	return NULL;
+}
+
 static void sync_installed_indexes(indigo_device *device, char *dir, indigo_property *property) {
 	static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 	char path[INDIGO_VALUE_SIZE];
@@ -606,9 +911,12 @@ static void sync_installed_indexes(indigo_device *device, char *dir, indigo_prop
 		if (remove) {
 			for (int j = 0; j < AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count; j++) {
 				if (!strcmp(item->name, AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items[j].name)) {
-					indigo_item tmp[AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count - j];
-					memcpy(tmp, AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + (j + 1), (AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count - j) * sizeof(indigo_item));
-					memcpy(AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + j, tmp, (AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count - j) * sizeof(indigo_item));
+					indigo_release_item_strings(AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + j, 1);
+					indigo_item tmp[AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count - j - 1];
+					memcpy(tmp, AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + (j + 1), (AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count - j - 1) * sizeof(indigo_item));
+					memcpy(AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + j, tmp, (AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count - j - 1) * sizeof(indigo_item));
+					/* last slot is a duplicate now, it doesn't own its label */
+					memset(AGENT_PLATESOLVER_USE_INDEX_PROPERTY->items + AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count - 1, 0, sizeof(indigo_item));
 					AGENT_PLATESOLVER_USE_INDEX_PROPERTY->count--;
 					break;
 				}
@@ -620,6 +928,7 @@ static void sync_installed_indexes(indigo_device *device, char *dir, indigo_prop
 	AGENT_PLATESOLVER_USE_INDEX_PROPERTY->state = INDIGO_OK_STATE;
 	indigo_define_property(device, AGENT_PLATESOLVER_USE_INDEX_PROPERTY, NULL);
 	astrometry_save_config(device);
+	post_job(device, ASTROMETRY_JOB_MAP_INDEXES, NULL);
 	pthread_mutex_unlock(&mutex);
 }
 
@@ -703,8 +1012,14 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		}
 		// --------------------------------------------------------------------------------
 		ASTROMETRY_DEVICE_PRIVATE_DATA->platesolver.save_config = astrometry_save_config;
-		ASTROMETRY_DEVICE_PRIVATE_DATA->platesolver.solve = astrometry_solve;
+		ASTROMETRY_DEVICE_PRIVATE_DATA->platesolver.solve = astrometry_queue_solve;
+		pthread_mutex_init(&ASTROMETRY_DEVICE_PRIVATE_DATA->job_mutex, NULL);
+		if (pipe(ASTROMETRY_DEVICE_PRIVATE_DATA->job_pipe) || pthread_create(&ASTROMETRY_DEVICE_PRIVATE_DATA->worker, NULL, (void *(*)(void *))astrometry_worker, device)) {
+			INDIGO_DRIVER_ERROR(DRIVER_NAME, "Can't start solver worker (%s)", strerror(errno));
+			return INDIGO_FAILED;
+		}
 		indigo_load_properties(device, false);
+		post_job(device, ASTROMETRY_JOB_MAP_INDEXES, NULL);
 		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
 		return agent_enumerate_properties(device, NULL, NULL);
 	}
@@ -750,12 +1065,22 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 			/* NB: To kill the whole process group with PID you should send kill signal to -PID (-1 * PID) */
 			kill(-ASTROMETRY_DEVICE_PRIVATE_DATA->pid, SIGTERM);
 		}
+	} else if (indigo_property_match(AGENT_PLATESOLVER_USE_INDEX_PROPERTY, property)) {
+	// -------------------------------------------------------------------------------- AGENT_PLATESOLVER_USE_INDEX
+		indigo_result result = indigo_platesolver_change_property(device, client, property);
+		post_job(device, ASTROMETRY_JOB_MAP_INDEXES, NULL);
+		return result;
 	}
 	return indigo_platesolver_change_property(device, client, property);
 }
 
 static indigo_result agent_device_detach(indigo_device *device) {
 	assert(device != NULL);
+	post_job(device, ASTROMETRY_JOB_EXIT, NULL);
+	pthread_join(ASTROMETRY_DEVICE_PRIVATE_DATA->worker, NULL);
+	close(ASTROMETRY_DEVICE_PRIVATE_DATA->job_pipe[0]);
+	close(ASTROMETRY_DEVICE_PRIVATE_DATA->job_pipe[1]);
+	pthread_mutex_destroy(&ASTROMETRY_DEVICE_PRIVATE_DATA->job_mutex);
 	indigo_release_property(AGENT_ASTROMETRY_INDEX_41XX_PROPERTY);
 	indigo_release_property(AGENT_ASTROMETRY_INDEX_42XX_PROPERTY);
 	return indigo_platesolver_device_detach(device);
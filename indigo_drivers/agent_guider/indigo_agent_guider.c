@@ -27,9 +27,12 @@
 #define DRIVER_NAME	"indigo_agent_guider"
 
 #include <stdlib.h>
+#include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <math.h>
+#include <sys/time.h>
 #include <assert.h>
 #include <pthread.h>
 
@@ -57,11 +60,20 @@
 #define AGENT_GUIDER_DEC_MODE_SOUTH_ITEM    	(AGENT_GUIDER_DEC_MODE_PROPERTY->items+2)
 #define AGENT_GUIDER_DEC_MODE_NONE_ITEM    		(AGENT_GUIDER_DEC_MODE_PROPERTY->items+3)
 
+#define AGENT_GUIDER_DEFECT_MAP_PROPERTY			(DEVICE_PRIVATE_DATA->agent_guider_defect_map_property)
+#define AGENT_GUIDER_DEFECT_MAP_ENABLED_ITEM	(AGENT_GUIDER_DEFECT_MAP_PROPERTY->items+0)
+#define AGENT_GUIDER_DEFECT_MAP_DISABLED_ITEM	(AGENT_GUIDER_DEFECT_MAP_PROPERTY->items+1)
+
+#define AGENT_GUIDER_PIPELINE_PROPERTY				(DEVICE_PRIVATE_DATA->agent_guider_pipeline_property)
+#define AGENT_GUIDER_PIPELINE_ENABLED_ITEM		(AGENT_GUIDER_PIPELINE_PROPERTY->items+0)
+#define AGENT_GUIDER_PIPELINE_DISABLED_ITEM		(AGENT_GUIDER_PIPELINE_PROPERTY->items+1)
+
 #define AGENT_START_PROCESS_PROPERTY					(DEVICE_PRIVATE_DATA->agent_start_process_property)
 #define AGENT_GUIDER_START_PREVIEW_ITEM  			(AGENT_START_PROCESS_PROPERTY->items+0)
 #define AGENT_GUIDER_START_CALIBRATION_ITEM 	(AGENT_START_PROCESS_PROPERTY->items+1)
 #define AGENT_GUIDER_START_CALIBRATION_AND_GUIDING_ITEM 	(AGENT_START_PROCESS_PROPERTY->items+2)
 #define AGENT_GUIDER_START_GUIDING_ITEM 			(AGENT_START_PROCESS_PROPERTY->items+3)
+#define AGENT_GUIDER_START_DEFECT_MAP_ITEM 		(AGENT_START_PROCESS_PROPERTY->items+4)
 
 #define AGENT_ABORT_PROCESS_PROPERTY					(DEVICE_PRIVATE_DATA->agent_abort_process_property)
 #define AGENT_ABORT_PROCESS_ITEM      				(AGENT_ABORT_PROCESS_PROPERTY->items+0)
@@ -128,6 +140,8 @@
 typedef struct {
 	indigo_property *agent_guider_detection_mode_property;
 	indigo_property *agent_guider_dec_mode_property;
+	indigo_property *agent_guider_defect_map_property;
+	indigo_property *agent_guider_pipeline_property;
 	indigo_property *agent_start_process_property;
 	indigo_property *agent_abort_process_property;
 	indigo_property *agent_settings_property;
@@ -145,6 +159,17 @@ typedef struct {
 	double rmse_ra_threshold, rmse_dec_threshold;
 	unsigned long rmse_count;
 	void *last_image;
+	long last_image_size;
+	bool last_image_shared;
+	int image_download_pending;
+	pthread_cond_t image_download_done;
+	unsigned long image_download_sequence, image_download_applied;
+	indigo_defect_map defect_map;
+	char defect_map_ccd[INDIGO_NAME_SIZE];
+	int defect_map_bin_x, defect_map_bin_y;
+	bool pipelined, exposure_running;
+	double exposure_start_time;
+	void *pipelined_image;
 	enum { IGNORE = -2, PREVIEW, GUIDING, INIT, CLEAR_DEC, CLEAR_RA, MOVE_NORTH, MOVE_SOUTH, MOVE_WEST, MOVE_EAST, FAILED, DONE } phase;
 	double stack_x[MAX_STACK], stack_y[MAX_STACK];
 	int stack_size;
@@ -160,12 +185,12 @@ static void save_config(indigo_device *device) {
 		indigo_save_property(device, NULL, AGENT_GUIDER_SETTINGS_PROPERTY);
 		indigo_save_property(device, NULL, AGENT_GUIDER_DETECTION_MODE_PROPERTY);
 		indigo_save_property(device, NULL, AGENT_GUIDER_DEC_MODE_PROPERTY);
+		indigo_save_property(device, NULL, AGENT_GUIDER_DEFECT_MAP_PROPERTY);
+		indigo_save_property(device, NULL, AGENT_GUIDER_PIPELINE_PROPERTY);
 		char *selection_property_items[] = { AGENT_GUIDER_SELECTION_RADIUS_ITEM_NAME, AGENT_GUIDER_SELECTION_SUBFRAME_ITEM_NAME, AGENT_GUIDER_SELECTION_EDGE_CLIPPING_ITEM_NAME, AGENT_GUIDER_SELECTION_STAR_COUNT_ITEM_NAME };
 		indigo_save_property_items(device, NULL, AGENT_GUIDER_SELECTION_PROPERTY, 4, (const char **)selection_property_items);
-		if (DEVICE_CONTEXT->property_save_file_handle) {
+		if (indigo_flush_properties(device) == INDIGO_OK) {
 			CONFIG_PROPERTY->state = INDIGO_OK_STATE;
-			close(DEVICE_CONTEXT->property_save_file_handle);
-			DEVICE_CONTEXT->property_save_file_handle = 0;
 		} else {
 			CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
 		}
@@ -175,6 +200,176 @@ static void save_config(indigo_device *device) {
 	}
 }
 
+static void get_ccd_frame_origin(indigo_device *device, int *left, int *top, int *bin_x, int *bin_y) {
+	indigo_property *agent_ccd_frame_property, *agent_ccd_bin_property;
+	*left = *top = 0;
+	*bin_x = *bin_y = 1;
+	if (indigo_filter_cached_property(device, INDIGO_FILTER_CCD_INDEX, CCD_BIN_PROPERTY_NAME, NULL, &agent_ccd_bin_property)) {
+		for (int i = 0; i < agent_ccd_bin_property->count; i++) {
+			indigo_item *item = agent_ccd_bin_property->items + i;
+			if (!strcmp(item->name, CCD_BIN_HORIZONTAL_ITEM_NAME))
+				*bin_x = item->number.value;
+			else if (!strcmp(item->name, CCD_BIN_VERTICAL_ITEM_NAME))
+				*bin_y = item->number.value;
+		}
+	}
+	if (indigo_filter_cached_property(device, INDIGO_FILTER_CCD_INDEX, CCD_FRAME_PROPERTY_NAME, NULL, &agent_ccd_frame_property)) {
+		for (int i = 0; i < agent_ccd_frame_property->count; i++) {
+			indigo_item *item = agent_ccd_frame_property->items + i;
+			if (!strcmp(item->name, CCD_FRAME_LEFT_ITEM_NAME))
+				*left = item->number.value / (*bin_x > 0 ? *bin_x : 1);
+			else if (!strcmp(item->name, CCD_FRAME_TOP_ITEM_NAME))
+				*top = item->number.value / (*bin_y > 0 ? *bin_y : 1);
+		}
+	}
+}
+
+static void load_defect_map(indigo_device *device) {
+	char *ccd_name = FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX];
+	if (!strcmp(DEVICE_PRIVATE_DATA->defect_map_ccd, ccd_name))
+		return;
+	indigo_delete_defect_map(&DEVICE_PRIVATE_DATA->defect_map);
+	indigo_copy_name(DEVICE_PRIVATE_DATA->defect_map_ccd, ccd_name);
+	int handle = indigo_open_config_file(ccd_name, 0, O_RDONLY, ".defects");
+	if (handle < 0)
+		return;
+	FILE *file = fdopen(handle, "r");
+	if (file == NULL) {
+		close(handle);
+		return;
+	}
+	indigo_defect_map *map = &DEVICE_PRIVATE_DATA->defect_map;
+	int count = 0;
+	if (fscanf(file, "%d %d %d %d %d", &DEVICE_PRIVATE_DATA->defect_map_bin_x, &DEVICE_PRIVATE_DATA->defect_map_bin_y, &map->width, &map->height, &count) == 5 && count > 0) {
+		map->defects = indigo_safe_malloc(count * sizeof(indigo_defect));
+		for (int i = 0; i < count; i++) {
+			indigo_defect *defect = map->defects + map->count;
+			if (fscanf(file, "%d %d %d", &defect->x, &defect->y, &defect->count) != 3 || defect->count < 0 || defect->count > INDIGO_DEFECT_NEIGHBOURS)
+				break;
+			bool valid = true;
+			for (int j = 0; j < defect->count && valid; j++) {
+				int dx, dy;
+				valid = fscanf(file, "%d %d", &dx, &dy) == 2;
+				defect->dx[j] = dx;
+				defect->dy[j] = dy;
+			}
+			if (!valid)
+				break;
+			map->count++;
+		}
+		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "%d defects loaded for '%s'", map->count, ccd_name);
+	}
+	fclose(file);
+}
+
+static bool save_defect_map(indigo_device *device) {
+	char *ccd_name = FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX];
+	int handle = indigo_open_config_file(ccd_name, 0, O_WRONLY | O_CREAT | O_TRUNC, ".defects");
+	if (handle < 0)
+		return false;
+	FILE *file = fdopen(handle, "w");
+	if (file == NULL) {
+		close(handle);
+		return false;
+	}
+	indigo_defect_map *map = &DEVICE_PRIVATE_DATA->defect_map;
+	fprintf(file, "%d %d %d %d %d\n", DEVICE_PRIVATE_DATA->defect_map_bin_x, DEVICE_PRIVATE_DATA->defect_map_bin_y, map->width, map->height, map->count);
+	for (int i = 0; i < map->count; i++) {
+		indigo_defect *defect = map->defects + i;
+		fprintf(file, "%d %d %d", defect->x, defect->y, defect->count);
+		for (int j = 0; j < defect->count; j++)
+			fprintf(file, " %d %d", defect->dx[j], defect->dy[j]);
+		fputc('\n', file);
+	}
+	return fclose(file) == 0;
+}
+
+/* returns frame to process, *applied is set if hot pixels were repaired and per pixel filtering is not needed */
+static indigo_raw_header *apply_defect_map(indigo_device *device, indigo_raw_header *header, bool *applied) {
+	*applied = false;
+	if (!AGENT_GUIDER_DEFECT_MAP_ENABLED_ITEM->sw.value)
+		return header;
+	load_defect_map(device);
+	if (DEVICE_PRIVATE_DATA->defect_map.count == 0)
+		return header;
+	int left, top, bin_x, bin_y;
+	get_ccd_frame_origin(device, &left, &top, &bin_x, &bin_y);
+	if (bin_x != DEVICE_PRIVATE_DATA->defect_map_bin_x || bin_y != DEVICE_PRIVATE_DATA->defect_map_bin_y)
+		return header;
+	if (DEVICE_PRIVATE_DATA->last_image_shared) {
+		/* frame is shared with the bus BLOB cache, correct a private copy */
+		void *image = indigo_alloc_blob_content(DEVICE_PRIVATE_DATA->last_image_size);
+		memcpy(image, header, DEVICE_PRIVATE_DATA->last_image_size);
+		indigo_release_blob_content(DEVICE_PRIVATE_DATA->last_image);
+		DEVICE_PRIVATE_DATA->last_image = header = image;
+		DEVICE_PRIVATE_DATA->last_image_shared = false;
+	}
+	*applied = indigo_apply_defect_map(header->signature, (void*)header + sizeof(indigo_raw_header), left, top, header->width, header->height, &DEVICE_PRIVATE_DATA->defect_map) == INDIGO_OK;
+	return header;
+}
+
+typedef struct {
+	indigo_device *device;
+	unsigned long sequence;
+} image_download;
+
+static void image_downloaded(indigo_item *item, bool success, void *data) {
+	image_download *download = data;
+	indigo_device *device = download->device;
+	pthread_mutex_lock(&DEVICE_PRIVATE_DATA->mutex);
+	/* downloads may complete out of order, never replace newer frame */
+	if (download->sequence > DEVICE_PRIVATE_DATA->image_download_applied) {
+		DEVICE_PRIVATE_DATA->image_download_applied = download->sequence;
+		indigo_release_blob_content(DEVICE_PRIVATE_DATA->last_image);
+		DEVICE_PRIVATE_DATA->last_image = NULL;
+		if (success && item->blob.value) {
+			DEVICE_PRIVATE_DATA->last_image = indigo_alloc_blob_content(DEVICE_PRIVATE_DATA->last_image_size = item->blob.size);
+			memcpy(DEVICE_PRIVATE_DATA->last_image, item->blob.value, item->blob.size);
+			DEVICE_PRIVATE_DATA->last_image_shared = false;
+		} else {
+			INDIGO_DRIVER_ERROR(DRIVER_NAME, "Image download failed");
+		}
+	}
+	if (--DEVICE_PRIVATE_DATA->image_download_pending == 0)
+		pthread_cond_broadcast(&DEVICE_PRIVATE_DATA->image_download_done);
+	pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
+	free(download);
+}
+
+static void wait_for_image_download(indigo_device *device) {
+	pthread_mutex_lock(&DEVICE_PRIVATE_DATA->mutex);
+	while (DEVICE_PRIVATE_DATA->image_download_pending > 0)
+		pthread_cond_wait(&DEVICE_PRIVATE_DATA->image_download_done, &DEVICE_PRIVATE_DATA->mutex);
+	pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
+}
+
+static double get_time() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1000000.0;
+}
+
+static indigo_property_state start_exposure(indigo_device *device, indigo_property *agent_exposure_property) {
+	indigo_property_state state = INDIGO_ALERT_STATE;
+	indigo_change_number_property_1(FILTER_DEVICE_CONTEXT->client, FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX], CCD_EXPOSURE_PROPERTY_NAME, CCD_EXPOSURE_ITEM_NAME, AGENT_GUIDER_SETTINGS_EXPOSURE_ITEM->number.value);
+	DEVICE_PRIVATE_DATA->exposure_start_time = get_time();
+	for (int i = 0; i < BUSY_TIMEOUT * 1000 && !FILTER_DEVICE_CONTEXT->property_removed && (state = agent_exposure_property->state) != INDIGO_BUSY_STATE && AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE; i++)
+		indigo_usleep(1000);
+	if (AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE && (FILTER_DEVICE_CONTEXT->property_removed || state != INDIGO_BUSY_STATE))
+		INDIGO_DRIVER_ERROR(DRIVER_NAME, "CCD_EXPOSURE didn't become busy in %d second(s)", BUSY_TIMEOUT);
+	return state;
+}
+
+static void stop_pipeline(indigo_device *device) {
+	if (DEVICE_PRIVATE_DATA->exposure_running) {
+		indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX], CCD_ABORT_EXPOSURE_PROPERTY_NAME, CCD_ABORT_EXPOSURE_ITEM_NAME, true);
+		DEVICE_PRIVATE_DATA->exposure_running = false;
+	}
+	indigo_release_blob_content(DEVICE_PRIVATE_DATA->pipelined_image);
+	DEVICE_PRIVATE_DATA->pipelined_image = NULL;
+	DEVICE_PRIVATE_DATA->pipelined = false;
+}
+
 static indigo_property_state capture_raw_frame(indigo_device *device) {
 	char *ccd_name = FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX];
 	indigo_property_state state = INDIGO_ALERT_STATE;
@@ -187,20 +382,22 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 		INDIGO_DRIVER_ERROR(DRIVER_NAME, "CCD_IMAGE_FORMAT not found");
 		return INDIGO_ALERT_STATE;
 	}
-	indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, ccd_name, CCD_IMAGE_FORMAT_PROPERTY_NAME, CCD_IMAGE_FORMAT_RAW_ITEM_NAME, true);
+	if (!DEVICE_PRIVATE_DATA->exposure_running)
+		indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, ccd_name, CCD_IMAGE_FORMAT_PROPERTY_NAME, CCD_IMAGE_FORMAT_RAW_ITEM_NAME, true);
 	FILTER_DEVICE_CONTEXT->property_removed = false;
+	/* previous pipelined frame is processed, its exposure may be already running */
+	indigo_release_blob_content(DEVICE_PRIVATE_DATA->pipelined_image);
+	DEVICE_PRIVATE_DATA->pipelined_image = NULL;
 	for (int exposure_attempt = 0; exposure_attempt < 3; exposure_attempt++) {
 		if (FILTER_DEVICE_CONTEXT->property_removed)
 			return INDIGO_ALERT_STATE;
 		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
 			return INDIGO_ALERT_STATE;
-		indigo_change_number_property_1(FILTER_DEVICE_CONTEXT->client, ccd_name, CCD_EXPOSURE_PROPERTY_NAME, CCD_EXPOSURE_ITEM_NAME, AGENT_GUIDER_SETTINGS_EXPOSURE_ITEM->number.value);
-		for (int i = 0; i < BUSY_TIMEOUT * 1000 && !FILTER_DEVICE_CONTEXT->property_removed && (state = agent_exposure_property->state) != INDIGO_BUSY_STATE && AGENT_ABORT_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE; i++)
-			indigo_usleep(1000);
-		if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
-			return INDIGO_ALERT_STATE;
-		if (FILTER_DEVICE_CONTEXT->property_removed || state != INDIGO_BUSY_STATE) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "CCD_EXPOSURE didn't become busy in %d second(s)", BUSY_TIMEOUT);
+		if (DEVICE_PRIVATE_DATA->exposure_running) {
+			DEVICE_PRIVATE_DATA->exposure_running = false;
+		} else if ((state = start_exposure(device, agent_exposure_property)) != INDIGO_BUSY_STATE) {
+			if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE)
+				return INDIGO_ALERT_STATE;
 			indigo_usleep(ONE_SECOND_DELAY);
 			continue;
 		}
@@ -225,6 +422,7 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 			INDIGO_DRIVER_ERROR(DRIVER_NAME, "Exposure failed");
 			return INDIGO_ALERT_STATE;
 		}
+		wait_for_image_download(device);
 		if (AGENT_GUIDER_STATS_PHASE_ITEM->number.value == IGNORE)
 			return agent_exposure_property->state;
 		indigo_raw_header *header = (indigo_raw_header *)(DEVICE_PRIVATE_DATA->last_image);
@@ -232,6 +430,17 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 			indigo_send_message(device, "No RAW image received");
 			return INDIGO_ALERT_STATE;
 		}
+		bool defects_repaired;
+		header = apply_defect_map(device, header, &defects_repaired);
+		if (DEVICE_PRIVATE_DATA->pipelined && AGENT_GUIDER_STATS_PHASE_ITEM->number.value == GUIDING) {
+			/* keep this frame and integrate the next one while it is processed and the correction is applied */
+			pthread_mutex_lock(&DEVICE_PRIVATE_DATA->mutex);
+			indigo_release_blob_content(DEVICE_PRIVATE_DATA->pipelined_image);
+			DEVICE_PRIVATE_DATA->pipelined_image = DEVICE_PRIVATE_DATA->last_image;
+			DEVICE_PRIVATE_DATA->last_image = NULL;
+			pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
+			DEVICE_PRIVATE_DATA->exposure_running = start_exposure(device, agent_exposure_property) == INDIGO_BUSY_STATE;
+		}
 		bool missing_selection = false;
 		if (AGENT_GUIDER_DETECTION_SELECTION_ITEM->sw.value) {
 			for (int i = 0; i < AGENT_GUIDER_SELECTION_STAR_COUNT_ITEM->number.value; i++) {
@@ -305,12 +514,13 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 			DEVICE_PRIVATE_DATA->stack_size = 0;
 			DEVICE_PRIVATE_DATA->drift_x = DEVICE_PRIVATE_DATA->drift_y = 0;
 			if (AGENT_GUIDER_DETECTION_DONUTS_ITEM->sw.value) {
-				result = indigo_donuts_frame_digest(
+				result = indigo_donuts_frame_digest_with_filter(
 					header->signature,
 					(void*)header + sizeof(indigo_raw_header),
 					header->width, header->height,
 					(int)AGENT_GUIDER_SELECTION_EDGE_CLIPPING_ITEM->number.value,
-					DEVICE_PRIVATE_DATA->reference
+					DEVICE_PRIVATE_DATA->reference,
+					!defects_repaired
 				);
 				AGENT_GUIDER_STATS_SNR_ITEM->number.value = DEVICE_PRIVATE_DATA->reference->snr;
 				if (AGENT_GUIDER_STATS_PHASE_ITEM->number.value >= GUIDING && DEVICE_PRIVATE_DATA->reference->snr < 9) {
@@ -336,7 +546,7 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 				DEVICE_PRIVATE_DATA->reference->centroid_x = 0;
 				DEVICE_PRIVATE_DATA->reference->centroid_y = 0;
 				for (int i = 0; i < count && result == INDIGO_OK; i++) {
-					result = indigo_selection_frame_digest_iterative(
+					result = indigo_selection_frame_digest_iterative_with_filter(
 						header->signature,
 						(void*)header + sizeof(indigo_raw_header),
 						&(AGENT_GUIDER_SELECTION_X_ITEM + 2 * i)->number.value,
@@ -345,7 +555,8 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 						header->width,
 						header->height,
 						DEVICE_PRIVATE_DATA->reference + i + 1,
-						DIGEST_CONVERGE_ITERATIONS
+						DIGEST_CONVERGE_ITERATIONS,
+						!defects_repaired
 					);
 					DEVICE_PRIVATE_DATA->reference->centroid_x += DEVICE_PRIVATE_DATA->reference[i + 1].centroid_x;
 					DEVICE_PRIVATE_DATA->reference->centroid_y += DEVICE_PRIVATE_DATA->reference[i + 1].centroid_y;
@@ -391,13 +602,14 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 			indigo_frame_digest digest = { 0 };
 			indigo_result result;
 			if (AGENT_GUIDER_DETECTION_DONUTS_ITEM->sw.value) {
-				result = indigo_donuts_frame_digest(
+				result = indigo_donuts_frame_digest_with_filter(
 					header->signature,
 					(void*)header + sizeof(indigo_raw_header),
 					header->width,
 					header->height,
 					(int)AGENT_GUIDER_SELECTION_EDGE_CLIPPING_ITEM->number.value,
-					&digest
+					&digest,
+					!defects_repaired
 				);
 				AGENT_GUIDER_STATS_SNR_ITEM->number.value = digest.snr;
 				if (AGENT_GUIDER_STATS_PHASE_ITEM->number.value >= GUIDING && digest.snr < 9) {
@@ -422,7 +634,7 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 				digest.centroid_x = 0;
 				digest.centroid_y = 0;
 				for (int i = 0; i < count && result == INDIGO_OK; i++) {
-					result = indigo_selection_frame_digest_iterative(
+					result = indigo_selection_frame_digest_iterative_with_filter(
 						header->signature,
 						(void*)header + sizeof(indigo_raw_header),
 						&(AGENT_GUIDER_SELECTION_X_ITEM + 2 * i)->number.value,
@@ -431,7 +643,8 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 						header->width,
 						header->height,
 						&digests[i],
-						DIGEST_CONVERGE_ITERATIONS
+						DIGEST_CONVERGE_ITERATIONS,
+						!defects_repaired
 					);
 				}
 
@@ -602,6 +815,7 @@ static void select_subframe(indigo_device *device) {
 				frame_height += GRID;
 			int size = sizeof(indigo_property) + device_ccd_frame_property->count * sizeof(indigo_item);
 			DEVICE_PRIVATE_DATA->saved_frame = indigo_safe_malloc_copy(size, agent_ccd_frame_property);
+			indigo_retain_item_strings(DEVICE_PRIVATE_DATA->saved_frame->items, DEVICE_PRIVATE_DATA->saved_frame->count);
 			strcpy(DEVICE_PRIVATE_DATA->saved_frame->device, device_ccd_frame_property->device);
 			char *names[] = { CCD_FRAME_LEFT_ITEM_NAME, CCD_FRAME_TOP_ITEM_NAME, CCD_FRAME_WIDTH_ITEM_NAME, CCD_FRAME_HEIGHT_ITEM_NAME };
 			double values[] = { frame_left * bin_x, frame_top * bin_y,  frame_width * bin_x, frame_height * bin_y };
@@ -697,7 +911,8 @@ static void preview_process(indigo_device *device) {
 	AGENT_GUIDER_START_PREVIEW_ITEM->sw.value =
 	AGENT_GUIDER_START_CALIBRATION_ITEM->sw.value =
 	AGENT_GUIDER_START_CALIBRATION_AND_GUIDING_ITEM->sw.value =
-	AGENT_GUIDER_START_GUIDING_ITEM->sw.value = false;
+	AGENT_GUIDER_START_GUIDING_ITEM->sw.value =
+	AGENT_GUIDER_START_DEFECT_MAP_ITEM->sw.value = false;
 	AGENT_START_PROCESS_PROPERTY->state = AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE ? INDIGO_OK_STATE : INDIGO_ALERT_STATE;
 	indigo_update_property(device, AGENT_START_PROCESS_PROPERTY, NULL);
 	if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
@@ -707,6 +922,52 @@ static void preview_process(indigo_device *device) {
 	FILTER_DEVICE_CONTEXT->running_process = false;
 }
 
+static void defect_map_process(indigo_device *device) {
+	FILTER_DEVICE_CONTEXT->running_process = true;
+	char *ccd_name = FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX];
+	indigo_property_state state = INDIGO_ALERT_STATE;
+	int left, top, bin_x, bin_y;
+	get_ccd_frame_origin(device, &left, &top, &bin_x, &bin_y);
+	indigo_send_message(device, "Capturing dark frame for defect map, make sure the guide camera is covered");
+	indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, ccd_name, CCD_FRAME_TYPE_PROPERTY_NAME, CCD_FRAME_TYPE_DARK_ITEM_NAME, true);
+	AGENT_GUIDER_STATS_PHASE_ITEM->number.value = IGNORE;
+	if (capture_raw_frame(device) == INDIGO_OK_STATE) {
+		indigo_raw_header *header = (indigo_raw_header *)(DEVICE_PRIVATE_DATA->last_image);
+		indigo_defect_map *map = &DEVICE_PRIVATE_DATA->defect_map;
+		if (header && indigo_make_defect_map(header->signature, (void*)header + sizeof(indigo_raw_header), header->width, header->height, map) == INDIGO_OK) {
+			/* defect map coordinates are relative to the full (binned) frame */
+			for (int i = 0; i < map->count; i++) {
+				map->defects[i].x += left;
+				map->defects[i].y += top;
+			}
+			map->width += left;
+			map->height += top;
+			indigo_copy_name(DEVICE_PRIVATE_DATA->defect_map_ccd, ccd_name);
+			DEVICE_PRIVATE_DATA->defect_map_bin_x = bin_x;
+			DEVICE_PRIVATE_DATA->defect_map_bin_y = bin_y;
+			if (save_defect_map(device)) {
+				indigo_send_message(device, "Defect map with %d defects created", map->count);
+				state = INDIGO_OK_STATE;
+			} else {
+				indigo_send_message(device, "Failed to save defect map");
+			}
+		} else {
+			indigo_send_message(device, "No RAW image received");
+		}
+	}
+	indigo_change_switch_property_1(FILTER_DEVICE_CONTEXT->client, ccd_name, CCD_FRAME_TYPE_PROPERTY_NAME, CCD_FRAME_TYPE_LIGHT_ITEM_NAME, true);
+	AGENT_GUIDER_STATS_PHASE_ITEM->number.value = state == INDIGO_OK_STATE ? DONE : FAILED;
+	indigo_update_property(device, AGENT_GUIDER_STATS_PROPERTY, NULL);
+	AGENT_GUIDER_START_DEFECT_MAP_ITEM->sw.value = false;
+	AGENT_START_PROCESS_PROPERTY->state = state;
+	indigo_update_property(device, AGENT_START_PROCESS_PROPERTY, NULL);
+	if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
+		AGENT_ABORT_PROCESS_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, AGENT_ABORT_PROCESS_PROPERTY, NULL);
+	}
+	FILTER_DEVICE_CONTEXT->running_process = false;
+}
+
 static void change_step(indigo_device *device, double q) {
 	if (q > 1) {
 		indigo_send_message(device, "Drift is too slow");
@@ -1000,7 +1261,8 @@ static void _calibrate_process(indigo_device *device, bool will_guide) {
 	AGENT_GUIDER_START_PREVIEW_ITEM->sw.value =
 	AGENT_GUIDER_START_CALIBRATION_ITEM->sw.value =
 	AGENT_GUIDER_START_CALIBRATION_AND_GUIDING_ITEM->sw.value =
-	AGENT_GUIDER_START_GUIDING_ITEM->sw.value = false;
+	AGENT_GUIDER_START_GUIDING_ITEM->sw.value =
+	AGENT_GUIDER_START_DEFECT_MAP_ITEM->sw.value = false;
 	indigo_update_property(device, AGENT_START_PROCESS_PROPERTY, NULL);
 	if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
 		AGENT_ABORT_PROCESS_PROPERTY->state = INDIGO_OK_STATE;
@@ -1064,6 +1326,9 @@ static void guide_process(indigo_device *device) {
 	AGENT_GUIDER_SETTINGS_DITH_Y_ITEM->number.target = 0;
 	indigo_update_property(device, AGENT_GUIDER_SETTINGS_PROPERTY, NULL);
 	DEVICE_PRIVATE_DATA->rmse_ra_sum = DEVICE_PRIVATE_DATA->rmse_dec_sum = DEVICE_PRIVATE_DATA->rmse_count = 0;
+	DEVICE_PRIVATE_DATA->pipelined = AGENT_GUIDER_PIPELINE_ENABLED_ITEM->sw.value;
+	/* part of the last correction the running exposure didn't see yet (pipelined mode only) */
+	double pending_ra = 0, pending_dec = 0;
 	while (AGENT_START_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
 		if (capture_raw_frame(device) != INDIGO_OK_STATE) {
 			AGENT_START_PROCESS_PROPERTY->state = AGENT_START_PROCESS_PROPERTY->state == INDIGO_OK_STATE ? INDIGO_OK_STATE : INDIGO_ALERT_STATE;
@@ -1080,6 +1345,11 @@ static void guide_process(indigo_device *device) {
 			double drift_dec = DEVICE_PRIVATE_DATA->drift_x * sin_angle - DEVICE_PRIVATE_DATA->drift_y * cos_angle;
 			double avg_drift_ra = DEVICE_PRIVATE_DATA->avg_drift_x * cos_angle + DEVICE_PRIVATE_DATA->avg_drift_y * sin_angle;
 			double avg_drift_dec = DEVICE_PRIVATE_DATA->avg_drift_x * sin_angle - DEVICE_PRIVATE_DATA->avg_drift_y * cos_angle;
+			/* correction has opposite sign to drift, measured drift lacks the part of the last pulse applied after the exposure ended */
+			drift_ra += pending_ra;
+			drift_dec += pending_dec;
+			avg_drift_ra += pending_ra;
+			avg_drift_dec += pending_dec;
 			AGENT_GUIDER_STATS_DRIFT_RA_ITEM->number.value = round(1000 * drift_ra) / 1000;
 			AGENT_GUIDER_STATS_DRIFT_DEC_ITEM->number.value = round(1000 * drift_dec) / 1000;
 			double correction_ra = 0, correction_dec = 0;
@@ -1127,6 +1397,16 @@ static void guide_process(indigo_device *device) {
 				AGENT_START_PROCESS_PROPERTY->state = AGENT_START_PROCESS_PROPERTY->state == INDIGO_OK_STATE ? INDIGO_OK_STATE : INDIGO_ALERT_STATE;
 				break;
 			}
+			if (DEVICE_PRIVATE_DATA->exposure_running) {
+				/* exposure integrating during the pulse sees only the part of the correction applied before it ended */
+				double exposure = AGENT_GUIDER_SETTINGS_EXPOSURE_ITEM->number.value;
+				double seen = exposure > 0 ? (DEVICE_PRIVATE_DATA->exposure_start_time + exposure - get_time()) / exposure : 0;
+				seen = fmax(0, fmin(1, seen));
+				pending_ra = (1 - seen) * correction_ra * AGENT_GUIDER_SETTINGS_SPEED_RA_ITEM->number.value;
+				pending_dec = (1 - seen) * correction_dec * AGENT_GUIDER_SETTINGS_SPEED_DEC_ITEM->number.value;
+			} else {
+				pending_ra = pending_dec = 0;
+			}
 			if (AGENT_GUIDER_STATS_DITHERING_ITEM->number.value == 0) {
 				DEVICE_PRIVATE_DATA->rmse_ra_sum += drift_ra * drift_ra;
 				DEVICE_PRIVATE_DATA->rmse_dec_sum += drift_dec * drift_dec;
@@ -1165,7 +1445,7 @@ static void guide_process(indigo_device *device) {
 				}
 			}
 		}
-		double reported_delay_time = AGENT_GUIDER_SETTINGS_DELAY_ITEM->number.target;
+		double reported_delay_time = DEVICE_PRIVATE_DATA->pipelined ? 0 : AGENT_GUIDER_SETTINGS_DELAY_ITEM->number.target;
 		if (reported_delay_time > 0) {
 			AGENT_GUIDER_STATS_DELAY_ITEM->number.value = reported_delay_time;
 			indigo_update_property(device, AGENT_GUIDER_STATS_PROPERTY, NULL);
@@ -1189,13 +1469,15 @@ static void guide_process(indigo_device *device) {
 		}
 		indigo_update_property(device, AGENT_GUIDER_STATS_PROPERTY, NULL);
 	}
+	stop_pipeline(device);
 	AGENT_GUIDER_STATS_PHASE_ITEM->number.value = AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE ? DONE : FAILED;
 	AGENT_GUIDER_STATS_DITHERING_ITEM->number.value = 0;
 	indigo_update_property(device, AGENT_GUIDER_STATS_PROPERTY, NULL);
 	AGENT_GUIDER_START_PREVIEW_ITEM->sw.value =
 	AGENT_GUIDER_START_CALIBRATION_ITEM->sw.value =
 	AGENT_GUIDER_START_CALIBRATION_AND_GUIDING_ITEM->sw.value =
-	AGENT_GUIDER_START_GUIDING_ITEM->sw.value = false;
+	AGENT_GUIDER_START_GUIDING_ITEM->sw.value =
+	AGENT_GUIDER_START_DEFECT_MAP_ITEM->sw.value = false;
 	AGENT_START_PROCESS_PROPERTY->state = AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE ? INDIGO_OK_STATE : INDIGO_ALERT_STATE;
 	indigo_update_property(device, AGENT_START_PROCESS_PROPERTY, NULL);
 	if (AGENT_ABORT_PROCESS_PROPERTY->state == INDIGO_BUSY_STATE) {
@@ -1267,13 +1549,24 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		indigo_init_switch_item(AGENT_GUIDER_DEC_MODE_NORTH_ITEM, AGENT_GUIDER_DEC_MODE_NORTH_ITEM_NAME, "North only", false);
 		indigo_init_switch_item(AGENT_GUIDER_DEC_MODE_SOUTH_ITEM, AGENT_GUIDER_DEC_MODE_SOUTH_ITEM_NAME, "South only", false);
 		indigo_init_switch_item(AGENT_GUIDER_DEC_MODE_NONE_ITEM, AGENT_GUIDER_DEC_MODE_NONE_ITEM_NAME, "None", false);
-		AGENT_START_PROCESS_PROPERTY = indigo_init_switch_property(NULL, device->name, AGENT_START_PROCESS_PROPERTY_NAME, "Agent", "Start process", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, 4);
+		AGENT_GUIDER_DEFECT_MAP_PROPERTY = indigo_init_switch_property(NULL, device->name, AGENT_GUIDER_DEFECT_MAP_PROPERTY_NAME, "Agent", "Hot pixel defect map", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 2);
+		if (AGENT_GUIDER_DEFECT_MAP_PROPERTY == NULL)
+			return INDIGO_FAILED;
+		indigo_init_switch_item(AGENT_GUIDER_DEFECT_MAP_ENABLED_ITEM, AGENT_GUIDER_DEFECT_MAP_ENABLED_ITEM_NAME, "Enabled", true);
+		indigo_init_switch_item(AGENT_GUIDER_DEFECT_MAP_DISABLED_ITEM, AGENT_GUIDER_DEFECT_MAP_DISABLED_ITEM_NAME, "Disabled", false);
+		AGENT_GUIDER_PIPELINE_PROPERTY = indigo_init_switch_property(NULL, device->name, AGENT_GUIDER_PIPELINE_PROPERTY_NAME, "Agent", "Pipelined guiding", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 2);
+		if (AGENT_GUIDER_PIPELINE_PROPERTY == NULL)
+			return INDIGO_FAILED;
+		indigo_init_switch_item(AGENT_GUIDER_PIPELINE_ENABLED_ITEM, AGENT_GUIDER_PIPELINE_ENABLED_ITEM_NAME, "Enabled", false);
+		indigo_init_switch_item(AGENT_GUIDER_PIPELINE_DISABLED_ITEM, AGENT_GUIDER_PIPELINE_DISABLED_ITEM_NAME, "Disabled", true);
+		AGENT_START_PROCESS_PROPERTY = indigo_init_switch_property(NULL, device->name, AGENT_START_PROCESS_PROPERTY_NAME, "Agent", "Start process", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, 5);
 		if (AGENT_START_PROCESS_PROPERTY == NULL)
 			return INDIGO_FAILED;
 		indigo_init_switch_item(AGENT_GUIDER_START_PREVIEW_ITEM, AGENT_GUIDER_START_PREVIEW_ITEM_NAME, "Start preview", false);
 		indigo_init_switch_item(AGENT_GUIDER_START_CALIBRATION_ITEM, AGENT_GUIDER_START_CALIBRATION_ITEM_NAME, "Start calibration", false);
 		indigo_init_switch_item(AGENT_GUIDER_START_CALIBRATION_AND_GUIDING_ITEM, AGENT_GUIDER_START_CALIBRATION_AND_GUIDING_ITEM_NAME, "Start calibration and guiding", false);
 		indigo_init_switch_item(AGENT_GUIDER_START_GUIDING_ITEM, AGENT_GUIDER_START_GUIDING_ITEM_NAME, "Start guiding", false);
+		indigo_init_switch_item(AGENT_GUIDER_START_DEFECT_MAP_ITEM, AGENT_GUIDER_START_DEFECT_MAP_ITEM_NAME, "Build defect map", false);
 		AGENT_ABORT_PROCESS_PROPERTY = indigo_init_switch_property(NULL, device->name, AGENT_ABORT_PROCESS_PROPERTY_NAME, "Agent", "Abort", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, 1);
 		if (AGENT_ABORT_PROCESS_PROPERTY == NULL)
 			return INDIGO_FAILED;
@@ -1351,6 +1644,7 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		// --------------------------------------------------------------------------------
 		CONNECTION_PROPERTY->hidden = true;
 		pthread_mutex_init(&DEVICE_PRIVATE_DATA->mutex, NULL);
+		pthread_cond_init(&DEVICE_PRIVATE_DATA->image_download_done, NULL);
 		indigo_load_properties(device, false);
 		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
 		return agent_enumerate_properties(device, NULL, NULL);
@@ -1373,6 +1667,10 @@ static indigo_result agent_enumerate_properties(indigo_device *device, indigo_cl
 		indigo_define_property(device, AGENT_GUIDER_STATS_PROPERTY, NULL);
 	if (indigo_property_match(AGENT_GUIDER_DEC_MODE_PROPERTY, property))
 		indigo_define_property(device, AGENT_GUIDER_DEC_MODE_PROPERTY, NULL);
+	if (indigo_property_match(AGENT_GUIDER_DEFECT_MAP_PROPERTY, property))
+		indigo_define_property(device, AGENT_GUIDER_DEFECT_MAP_PROPERTY, NULL);
+	if (indigo_property_match(AGENT_GUIDER_PIPELINE_PROPERTY, property))
+		indigo_define_property(device, AGENT_GUIDER_PIPELINE_PROPERTY, NULL);
 	if (indigo_property_match(AGENT_START_PROCESS_PROPERTY, property))
 		indigo_define_property(device, AGENT_START_PROCESS_PROPERTY, NULL);
 	if (indigo_property_match(AGENT_ABORT_PROCESS_PROPERTY, property))
@@ -1427,6 +1725,18 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		AGENT_GUIDER_DEC_MODE_PROPERTY->state = INDIGO_OK_STATE;
 		save_config(device);
 		indigo_update_property(device, AGENT_GUIDER_DEC_MODE_PROPERTY, NULL);
+	} else if (indigo_property_match(AGENT_GUIDER_DEFECT_MAP_PROPERTY, property)) {
+// -------------------------------------------------------------------------------- AGENT_GUIDER_DEFECT_MAP
+		indigo_property_copy_values(AGENT_GUIDER_DEFECT_MAP_PROPERTY, property, false);
+		AGENT_GUIDER_DEFECT_MAP_PROPERTY->state = INDIGO_OK_STATE;
+		save_config(device);
+		indigo_update_property(device, AGENT_GUIDER_DEFECT_MAP_PROPERTY, NULL);
+	} else if (indigo_property_match(AGENT_GUIDER_PIPELINE_PROPERTY, property)) {
+// -------------------------------------------------------------------------------- AGENT_GUIDER_PIPELINE
+		indigo_property_copy_values(AGENT_GUIDER_PIPELINE_PROPERTY, property, false);
+		AGENT_GUIDER_PIPELINE_PROPERTY->state = INDIGO_OK_STATE;
+		save_config(device);
+		indigo_update_property(device, AGENT_GUIDER_PIPELINE_PROPERTY, NULL);
 	} else if (indigo_property_match(AGENT_GUIDER_SETTINGS_PROPERTY, property)) {
 // -------------------------------------------------------------------------------- AGENT_GUIDER_SETTINGS
 		double dith_x = AGENT_GUIDER_SETTINGS_DITH_X_ITEM->number.value;
@@ -1511,6 +1821,10 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 					AGENT_START_PROCESS_PROPERTY->state = INDIGO_BUSY_STATE;
 					indigo_set_timer(device, 0, preview_process, NULL);
 					indigo_update_property(device, AGENT_START_PROCESS_PROPERTY, NULL);
+				} else if (AGENT_GUIDER_START_DEFECT_MAP_ITEM->sw.value) {
+					AGENT_START_PROCESS_PROPERTY->state = INDIGO_BUSY_STATE;
+					indigo_set_timer(device, 0, defect_map_process, NULL);
+					indigo_update_property(device, AGENT_START_PROCESS_PROPERTY, NULL);
 				} else if (!FILTER_GUIDER_LIST_PROPERTY->items->sw.value) {
 					if (AGENT_GUIDER_START_CALIBRATION_ITEM->sw.value) {
 						AGENT_START_PROCESS_PROPERTY->state = INDIGO_BUSY_STATE;
@@ -1527,7 +1841,8 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 					AGENT_GUIDER_START_PREVIEW_ITEM->sw.value =
 					AGENT_GUIDER_START_CALIBRATION_ITEM->sw.value =
 					AGENT_GUIDER_START_CALIBRATION_AND_GUIDING_ITEM->sw.value =
-					AGENT_GUIDER_START_GUIDING_ITEM->sw.value = false;
+					AGENT_GUIDER_START_GUIDING_ITEM->sw.value =
+					AGENT_GUIDER_START_DEFECT_MAP_ITEM->sw.value = false;
 					AGENT_START_PROCESS_PROPERTY->state = INDIGO_ALERT_STATE;
 					indigo_update_property(device, AGENT_START_PROCESS_PROPERTY, "No guider is selected");
 				}
@@ -1535,7 +1850,8 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 				AGENT_GUIDER_START_PREVIEW_ITEM->sw.value =
 				AGENT_GUIDER_START_CALIBRATION_ITEM->sw.value =
 				AGENT_GUIDER_START_CALIBRATION_AND_GUIDING_ITEM->sw.value =
-				AGENT_GUIDER_START_GUIDING_ITEM->sw.value = false;
+				AGENT_GUIDER_START_GUIDING_ITEM->sw.value =
+				AGENT_GUIDER_START_DEFECT_MAP_ITEM->sw.value = false;
 				AGENT_START_PROCESS_PROPERTY->state = INDIGO_ALERT_STATE;
 				indigo_update_property(device, AGENT_START_PROCESS_PROPERTY, "No CCD is selected");
 			}
@@ -1556,6 +1872,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 
 static indigo_result agent_device_detach(indigo_device *device) {
 	assert(device != NULL);
+	wait_for_image_download(device);
 	save_config(device);
 	indigo_release_property(AGENT_GUIDER_DETECTION_MODE_PROPERTY);
 	indigo_release_property(AGENT_START_PROCESS_PROPERTY);
@@ -1565,10 +1882,15 @@ static indigo_result agent_device_detach(indigo_device *device) {
 	indigo_release_property(AGENT_GUIDER_SELECTION_PROPERTY);
 	indigo_release_property(AGENT_GUIDER_STATS_PROPERTY);
 	indigo_release_property(AGENT_GUIDER_DEC_MODE_PROPERTY);
+	indigo_release_property(AGENT_GUIDER_DEFECT_MAP_PROPERTY);
+	indigo_release_property(AGENT_GUIDER_PIPELINE_PROPERTY);
 	for (int i = 0; i <= MAX_MULTISTAR_COUNT; i++)
 		indigo_delete_frame_digest(DEVICE_PRIVATE_DATA->reference + i);
+	indigo_delete_defect_map(&DEVICE_PRIVATE_DATA->defect_map);
+	pthread_cond_destroy(&DEVICE_PRIVATE_DATA->image_download_done);
 	pthread_mutex_destroy(&DEVICE_PRIVATE_DATA->mutex);
-	indigo_safe_free(DEVICE_PRIVATE_DATA->last_image);
+	indigo_release_blob_content(DEVICE_PRIVATE_DATA->last_image);
+	DEVICE_PRIVATE_DATA->last_image = NULL;
 	return indigo_filter_device_detach(device);
 }
 
@@ -1577,14 +1899,33 @@ static indigo_result agent_device_detach(indigo_device *device) {
 static indigo_result agent_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
 	if (*FILTER_CLIENT_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX] && !strcmp(property->device, FILTER_CLIENT_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX])) {
 		if (property->state == INDIGO_OK_STATE && !strcmp(property->name, CCD_IMAGE_PROPERTY_NAME)) {
-			if (strchr(property->device, '@'))
-				indigo_populate_http_blob_item(property->items);
+			if (strchr(property->device, '@') && *property->items->blob.url) {
+				/* don't block remote server parser thread, download in background */
+				image_download *download = indigo_safe_malloc(sizeof(image_download));
+				download->device = FILTER_CLIENT_CONTEXT->device;
+				pthread_mutex_lock(&CLIENT_PRIVATE_DATA->mutex);
+				download->sequence = ++CLIENT_PRIVATE_DATA->image_download_sequence;
+				CLIENT_PRIVATE_DATA->image_download_pending++;
+				pthread_mutex_unlock(&CLIENT_PRIVATE_DATA->mutex);
+				if (!indigo_populate_http_blob_item_async(property->items, image_downloaded, download)) {
+					pthread_mutex_lock(&CLIENT_PRIVATE_DATA->mutex);
+					if (--CLIENT_PRIVATE_DATA->image_download_pending == 0)
+						pthread_cond_broadcast(&CLIENT_PRIVATE_DATA->image_download_done);
+					pthread_mutex_unlock(&CLIENT_PRIVATE_DATA->mutex);
+					free(download);
+				}
+				return indigo_filter_update_property(client, device, property, message);
+			}
+			indigo_release_blob_content(CLIENT_PRIVATE_DATA->last_image);
+			CLIENT_PRIVATE_DATA->last_image = NULL;
 			if (property->items->blob.value) {
-				CLIENT_PRIVATE_DATA->last_image = indigo_safe_realloc(CLIENT_PRIVATE_DATA->last_image, property->items->blob.size);
-				memcpy(CLIENT_PRIVATE_DATA->last_image, property->items->blob.value, property->items->blob.size);
-			} else if (CLIENT_PRIVATE_DATA->last_image) {
-				free(CLIENT_PRIVATE_DATA->last_image);
-				CLIENT_PRIVATE_DATA->last_image = NULL;
+				/* local CCD - share frame cached by the bus, otherwise copy it */
+				CLIENT_PRIVATE_DATA->last_image = indigo_retain_blob_content(property->items, &CLIENT_PRIVATE_DATA->last_image_size);
+				CLIENT_PRIVATE_DATA->last_image_shared = CLIENT_PRIVATE_DATA->last_image != NULL;
+				if (CLIENT_PRIVATE_DATA->last_image == NULL) {
+					CLIENT_PRIVATE_DATA->last_image = indigo_alloc_blob_content(CLIENT_PRIVATE_DATA->last_image_size = property->items->blob.size);
+					memcpy(CLIENT_PRIVATE_DATA->last_image, property->items->blob.value, property->items->blob.size);
+				}
 			}
 		}
 	}
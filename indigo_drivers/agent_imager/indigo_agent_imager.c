@@ -23,7 +23,7 @@
  \file indigo_agent_imager.c
  */
 
-#define DRIVER_VERSION 0x001B
+#define DRIVER_VERSION 0x001C
 #define DRIVER_NAME	"indigo_agent_imager"
 
 #include <stdio.h>
@@ -36,7 +36,9 @@
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <setjmp.h>
 #include <sys/stat.h>
+#include <jpeglib.h>
 
 #include <indigo/indigo_driver_xml.h>
 #include <indigo/indigo_filter.h>
@@ -108,6 +110,7 @@
 #define AGENT_IMAGER_STATS_HFD_ITEM      			(AGENT_IMAGER_STATS_PROPERTY->items+9)
 #define AGENT_IMAGER_STATS_PEAK_ITEM      		(AGENT_IMAGER_STATS_PROPERTY->items+10)
 #define AGENT_IMAGER_STATS_DITHERING_ITEM     (AGENT_IMAGER_STATS_PROPERTY->items+11)
+#define AGENT_IMAGER_STATS_STACKED_ITEM     	(AGENT_IMAGER_STATS_PROPERTY->items+12)
 
 #define MAX_STAR_COUNT												50
 #define AGENT_IMAGER_STARS_PROPERTY						(DEVICE_PRIVATE_DATA->agent_stars_property)
@@ -122,6 +125,22 @@
 #define AGENT_IMAGER_SEQUENCE_PROPERTY				(DEVICE_PRIVATE_DATA->agent_sequence)
 #define AGENT_IMAGER_SEQUENCE_ITEM						(AGENT_IMAGER_SEQUENCE_PROPERTY->items+0)
 
+#define AGENT_IMAGER_STACK_PROPERTY						(DEVICE_PRIVATE_DATA->agent_stack_property)
+#define AGENT_IMAGER_STACK_DISABLED_ITEM			(AGENT_IMAGER_STACK_PROPERTY->items+0)
+#define AGENT_IMAGER_STACK_TRANSLATION_ITEM		(AGENT_IMAGER_STACK_PROPERTY->items+1)
+#define AGENT_IMAGER_STACK_ROTATION_ITEM			(AGENT_IMAGER_STACK_PROPERTY->items+2)
+
+#define AGENT_IMAGER_STACK_SETTINGS_PROPERTY	(DEVICE_PRIVATE_DATA->agent_stack_settings_property)
+#define AGENT_IMAGER_STACK_SETTINGS_SIGMA_ITEM	(AGENT_IMAGER_STACK_SETTINGS_PROPERTY->items+0)
+#define AGENT_IMAGER_STACK_SETTINGS_REFRESH_ITEM	(AGENT_IMAGER_STACK_SETTINGS_PROPERTY->items+1)
+
+#define AGENT_IMAGER_STACK_IMAGE_PROPERTY			(DEVICE_PRIVATE_DATA->agent_stack_image_property)
+#define AGENT_IMAGER_STACK_IMAGE_ITEM					(AGENT_IMAGER_STACK_IMAGE_PROPERTY->items+0)
+
+#define STACK_STAR_COUNT											50
+#define STACK_VOTE_STARS											12
+#define STACK_MATCH_TOLERANCE									2.0
+
 #define SEQUENCE_SIZE			16
 
 #define BUSY_TIMEOUT 5
@@ -145,6 +164,9 @@ typedef struct {
 	indigo_property *agent_stats_property;
 	indigo_property *agent_sequence;
 	indigo_property *agent_sequence_state;
+	indigo_property *agent_stack_property;
+	indigo_property *agent_stack_settings_property;
+	indigo_property *agent_stack_image_property;
 	indigo_property *saved_frame;
 	double saved_frame_left, saved_frame_top;
 	char current_folder[INDIGO_VALUE_SIZE];
@@ -155,12 +177,23 @@ typedef struct {
 	double drift_x, drift_y;
 	int bin_x, bin_y;
 	void *last_image;
+	long last_image_size;
+	bool last_image_shared;
+	int image_download_pending;
+	pthread_cond_t image_download_done;
+	unsigned long image_download_sequence, image_download_applied;
 	int stack_size;
 	pthread_mutex_t mutex;
 	double focus_exposure;
 	bool dithering_started, dithering_finished;
 	bool allow_subframing;
 	bool find_stars;
+	float *stack_mean, *stack_m2, *stack_count;
+	int stack_width, stack_height, stack_channels;
+	indigo_star_detection stack_stars[STACK_STAR_COUNT];
+	int stack_star_count;
+	void *stack_preview;
+	bool stack_format_warning;
 } agent_private_data;
 
 // -------------------------------------------------------------------------------- INDIGO agent common code
@@ -175,12 +208,12 @@ static void save_config(indigo_device *device) {
 		indigo_save_property(device, NULL, AGENT_IMAGER_FOCUS_PROPERTY);
 		indigo_save_property(device, NULL, AGENT_IMAGER_DITHERING_PROPERTY);
 		indigo_save_property(device, NULL, AGENT_IMAGER_SEQUENCE_PROPERTY);
+		indigo_save_property(device, NULL, AGENT_IMAGER_STACK_PROPERTY);
+		indigo_save_property(device, NULL, AGENT_IMAGER_STACK_SETTINGS_PROPERTY);
 		char *selection_property_items[] = { AGENT_IMAGER_SELECTION_RADIUS_ITEM_NAME, AGENT_IMAGER_SELECTION_SUBFRAME_ITEM_NAME };
 		indigo_save_property_items(device, NULL, AGENT_IMAGER_SELECTION_PROPERTY, 2, (const char **)selection_property_items);
-		if (DEVICE_CONTEXT->property_save_file_handle) {
+		if (indigo_flush_properties(device) == INDIGO_OK) {
 			CONFIG_PROPERTY->state = INDIGO_OK_STATE;
-			close(DEVICE_CONTEXT->property_save_file_handle);
-			DEVICE_CONTEXT->property_save_file_handle = 0;
 		} else {
 			CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
 		}
@@ -266,6 +299,7 @@ static void select_subframe(indigo_device *device) {
 				frame_height += GRID;
 			int size = sizeof(indigo_property) + device_ccd_frame_property->count * sizeof(indigo_item);
 			DEVICE_PRIVATE_DATA->saved_frame = indigo_safe_malloc_copy(size, agent_ccd_frame_property);
+			indigo_retain_item_strings(DEVICE_PRIVATE_DATA->saved_frame->items, DEVICE_PRIVATE_DATA->saved_frame->count);
 			strcpy(DEVICE_PRIVATE_DATA->saved_frame->device, device_ccd_frame_property->device);
 			char *names[] = { CCD_FRAME_LEFT_ITEM_NAME, CCD_FRAME_TOP_ITEM_NAME, CCD_FRAME_WIDTH_ITEM_NAME, CCD_FRAME_HEIGHT_ITEM_NAME };
 			double values[] = { frame_left * DEVICE_PRIVATE_DATA->bin_x, frame_top * DEVICE_PRIVATE_DATA->bin_y,  frame_width * DEVICE_PRIVATE_DATA->bin_x, frame_height * DEVICE_PRIVATE_DATA->bin_y };
@@ -294,6 +328,41 @@ static void restore_subframe(indigo_device *device) {
 	}
 }
 
+typedef struct {
+	indigo_device *device;
+	unsigned long sequence;
+} image_download;
+
+static void image_downloaded(indigo_item *item, bool success, void *data) {
+	image_download *download = data;
+	indigo_device *device = download->device;
+	pthread_mutex_lock(&DEVICE_PRIVATE_DATA->mutex);
+	/* downloads may complete out of order, never replace newer frame */
+	if (download->sequence > DEVICE_PRIVATE_DATA->image_download_applied) {
+		DEVICE_PRIVATE_DATA->image_download_applied = download->sequence;
+		indigo_release_blob_content(DEVICE_PRIVATE_DATA->last_image);
+		DEVICE_PRIVATE_DATA->last_image = NULL;
+		if (success && item->blob.value) {
+			DEVICE_PRIVATE_DATA->last_image = indigo_alloc_blob_content(DEVICE_PRIVATE_DATA->last_image_size = item->blob.size);
+			memcpy(DEVICE_PRIVATE_DATA->last_image, item->blob.value, item->blob.size);
+			DEVICE_PRIVATE_DATA->last_image_shared = false;
+		} else {
+			INDIGO_DRIVER_ERROR(DRIVER_NAME, "Image download failed");
+		}
+	}
+	if (--DEVICE_PRIVATE_DATA->image_download_pending == 0)
+		pthread_cond_broadcast(&DEVICE_PRIVATE_DATA->image_download_done);
+	pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
+	free(download);
+}
+
+static void wait_for_image_download(indigo_device *device) {
+	pthread_mutex_lock(&DEVICE_PRIVATE_DATA->mutex);
+	while (DEVICE_PRIVATE_DATA->image_download_pending > 0)
+		pthread_cond_wait(&DEVICE_PRIVATE_DATA->image_download_done, &DEVICE_PRIVATE_DATA->mutex);
+	pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
+}
+
 static indigo_property_state capture_raw_frame(indigo_device *device) {
 	char *ccd_name = FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX];
 	indigo_property_state state = INDIGO_ALERT_STATE;
@@ -366,6 +435,7 @@ static indigo_property_state capture_raw_frame(indigo_device *device) {
 		INDIGO_DRIVER_ERROR(DRIVER_NAME, "Exposure failed");
 		return INDIGO_ALERT_STATE;
 	}
+	wait_for_image_download(device);
 	if ((AGENT_IMAGER_SELECTION_X_ITEM->number.value > 0 && AGENT_IMAGER_SELECTION_Y_ITEM->number.value > 0) || DEVICE_PRIVATE_DATA->allow_subframing || DEVICE_PRIVATE_DATA->find_stars) {
 		indigo_raw_header *header = (indigo_raw_header *)(DEVICE_PRIVATE_DATA->last_image);
 		if (header == NULL || (header->signature != INDIGO_RAW_MONO8 && header->signature != INDIGO_RAW_MONO16 && header->signature != INDIGO_RAW_RGB24 && header->signature != INDIGO_RAW_RGB48)) {
@@ -457,6 +527,465 @@ static void preview_process(indigo_device *device) {
 	FILTER_DEVICE_CONTEXT->running_process = false;
 }
 
+// -------------------------------------------------------------------------------- Live stacking
+
+struct indigo_jpeg_compress_struct {
+	struct jpeg_compress_struct pub;
+	jmp_buf jpeg_error;
+};
+
+static void jpeg_compress_error_callback(j_common_ptr cinfo) {
+	longjmp(((struct indigo_jpeg_compress_struct *)cinfo)->jpeg_error, 1);
+}
+
+static void stack_reset(indigo_device *device) {
+	indigo_safe_free(DEVICE_PRIVATE_DATA->stack_mean);
+	indigo_safe_free(DEVICE_PRIVATE_DATA->stack_m2);
+	indigo_safe_free(DEVICE_PRIVATE_DATA->stack_count);
+	DEVICE_PRIVATE_DATA->stack_mean = DEVICE_PRIVATE_DATA->stack_m2 = DEVICE_PRIVATE_DATA->stack_count = NULL;
+	DEVICE_PRIVATE_DATA->stack_width = DEVICE_PRIVATE_DATA->stack_height = DEVICE_PRIVATE_DATA->stack_channels = 0;
+	DEVICE_PRIVATE_DATA->stack_star_count = 0;
+	DEVICE_PRIVATE_DATA->stack_format_warning = false;
+	AGENT_IMAGER_STATS_STACKED_ITEM->number.value = 0;
+}
+
+/* decode RAW or 8/16-bit FITS frame to planar float channels and 16-bit luminance used for star detection (bayered FITS is debayered, RAW header doesn't carry CFA pattern) */
+static bool stack_decode_frame(void *image, long size, int *width, int *height, int *channels, float **planes, uint16_t **luminance) {
+	indigo_raw_header *header = image;
+	int bitpix = 0, naxis = 0, naxis3 = 1;
+	long offset = 0;
+	double bzero = 0, bscale = 1;
+	bool interleaved = false, bayer = false;
+	indigo_cfa_pattern pattern = INDIGO_CFA_NONE;
+	if (size > sizeof(indigo_raw_header) && (header->signature == INDIGO_RAW_MONO8 || header->signature == INDIGO_RAW_MONO16 || header->signature == INDIGO_RAW_RGB24 || header->signature == INDIGO_RAW_RGB48)) {
+		*width = header->width;
+		*height = header->height;
+		bitpix = (header->signature == INDIGO_RAW_MONO8 || header->signature == INDIGO_RAW_RGB24) ? 8 : -16;
+		naxis3 = (header->signature == INDIGO_RAW_RGB24 || header->signature == INDIGO_RAW_RGB48) ? 3 : 1;
+		offset = sizeof(indigo_raw_header);
+		interleaved = true;
+	} else if (size > FITS_HEADER_SIZE && !strncmp(image, "SIMPLE  =", 9)) {
+		char *card = image;
+		*width = *height = 0;
+		for (long i = 0; i < size / 80; i++, card += 80) {
+			if (!strncmp(card, "END     ", 8)) {
+				offset = ((i * 80) / FITS_HEADER_SIZE + 1) * FITS_HEADER_SIZE;
+				break;
+			}
+			if (card[8] != '=')
+				continue;
+			if (!strncmp(card, "BITPIX  ", 8))
+				bitpix = atoi(card + 10);
+			else if (!strncmp(card, "NAXIS   ", 8))
+				naxis = atoi(card + 10);
+			else if (!strncmp(card, "NAXIS1  ", 8))
+				*width = atoi(card + 10);
+			else if (!strncmp(card, "NAXIS2  ", 8))
+				*height = atoi(card + 10);
+			else if (!strncmp(card, "NAXIS3  ", 8))
+				naxis3 = atoi(card + 10);
+			else if (!strncmp(card, "BZERO   ", 8))
+				bzero = indigo_atod(card + 10);
+			else if (!strncmp(card, "BSCALE  ", 8))
+				bscale = indigo_atod(card + 10);
+			else if (!strncmp(card, "BAYERPAT", 8)) {
+				pattern = indigo_cfa_pattern_from_string(card + 10);
+				bayer = true;
+			}
+		}
+		if (offset == 0 || (bitpix != 8 && bitpix != 16) || (naxis == 2 && naxis3 != 1) || (naxis == 3 && naxis3 != 3) || naxis < 2 || naxis > 3)
+			return false;
+	} else {
+		return false;
+	}
+	long count = (long)*width * *height;
+	if (count <= 0 || offset + count * naxis3 * (abs(bitpix) / 8) > size)
+		return false;
+	if (bayer && naxis3 == 1 && pattern == INDIGO_CFA_NONE)
+		return false;
+	float *data = indigo_safe_malloc(count * naxis3 * sizeof(float));
+	uint8_t *data8 = image + offset;
+	uint16_t *data16 = image + offset;
+	for (int c = 0; c < naxis3; c++) {
+		float *plane = data + c * count;
+		if (interleaved) {
+			if (bitpix == 8) {
+				for (long i = 0; i < count; i++)
+					plane[i] = data8[i * naxis3 + c];
+			} else {
+				for (long i = 0; i < count; i++)
+					plane[i] = data16[i * naxis3 + c];
+			}
+		} else {
+			if (bitpix == 8) {
+				uint8_t *raw = data8 + c * count;
+				for (long i = 0; i < count; i++)
+					plane[i] = raw[i] * bscale + bzero;
+			} else {
+				uint8_t *raw = data8 + c * count * 2;
+				for (long i = 0; i < count; i++, raw += 2)
+					plane[i] = (int16_t)(raw[0] << 8 | raw[1]) * bscale + bzero;
+			}
+		}
+	}
+	if (bayer && naxis3 == 1) {
+		/* interpolate colours before alignment, shifted or rotated mosaic would mix them */
+		uint16_t *mosaic = indigo_safe_malloc(count * sizeof(uint16_t));
+		for (long i = 0; i < count; i++)
+			mosaic[i] = data[i] < 0 ? 0 : data[i] > 65535 ? 65535 : data[i];
+		uint16_t *rgb = indigo_safe_malloc(count * 3 * sizeof(uint16_t));
+		indigo_result result = indigo_debayer(INDIGO_RAW_MONO16, mosaic, *width, *height, pattern, INDIGO_DEBAYER_BILINEAR, rgb, NULL, NULL);
+		free(mosaic);
+		free(data);
+		if (result != INDIGO_OK) {
+			free(rgb);
+			return false;
+		}
+		naxis3 = 3;
+		data = indigo_safe_malloc(count * naxis3 * sizeof(float));
+		for (int c = 0; c < naxis3; c++) {
+			float *plane = data + c * count;
+			for (long i = 0; i < count; i++)
+				plane[i] = rgb[i * 3 + c];
+		}
+		free(rgb);
+	}
+	*planes = data;
+	*channels = naxis3;
+	uint16_t *lum = *luminance = indigo_safe_malloc(count * sizeof(uint16_t));
+	float scale = (bitpix == 8 ? 256.0f : 1.0f) / naxis3;
+	for (long i = 0; i < count; i++) {
+		float value = 0;
+		for (int c = 0; c < naxis3; c++)
+			value += data[c * count + i];
+		value *= scale;
+		lum[i] = value < 0 ? 0 : value > 65535 ? 65535 : value;
+	}
+	return true;
+}
+
+typedef struct {
+	double cos_a, sin_a, dx, dy; /* frame -> stack coordinates */
+} stack_transform;
+
+static int stack_match(stack_transform *t, indigo_star_detection *ref, int ref_count, indigo_star_detection *stars, int count, int *pairs) {
+	int matched = 0;
+	for (int j = 0; j < count; j++) {
+		double x = t->cos_a * stars[j].x - t->sin_a * stars[j].y + t->dx;
+		double y = t->sin_a * stars[j].x + t->cos_a * stars[j].y + t->dy;
+		double best = STACK_MATCH_TOLERANCE * STACK_MATCH_TOLERANCE;
+		pairs[j] = -1;
+		for (int i = 0; i < ref_count; i++) {
+			double d = (ref[i].x - x) * (ref[i].x - x) + (ref[i].y - y) * (ref[i].y - y);
+			if (d < best) {
+				best = d;
+				pairs[j] = i;
+			}
+		}
+		if (pairs[j] >= 0)
+			matched++;
+	}
+	return matched;
+}
+
+/* vote for the transformation with most matching stars and refine it by least squares fit */
+static bool stack_register(indigo_star_detection *ref, int ref_count, indigo_star_detection *stars, int count, bool rotation, stack_transform *result) {
+	int pairs[STACK_STAR_COUNT], best_pairs[STACK_STAR_COUNT];
+	int best = 0;
+	int candidates_ref = ref_count < STACK_VOTE_STARS ? ref_count : STACK_VOTE_STARS;
+	int candidates = count < STACK_VOTE_STARS ? count : STACK_VOTE_STARS;
+	stack_transform t;
+	if (rotation) {
+		for (int a = 0; a < candidates_ref; a++) {
+			for (int b = a + 1; b < candidates_ref; b++) {
+				double ref_dx = ref[b].x - ref[a].x, ref_dy = ref[b].y - ref[a].y;
+				double ref_distance = sqrt(ref_dx * ref_dx + ref_dy * ref_dy);
+				for (int c = 0; c < candidates; c++) {
+					for (int d = 0; d < candidates; d++) {
+						if (c == d)
+							continue;
+						double dx = stars[d].x - stars[c].x, dy = stars[d].y - stars[c].y;
+						if (fabs(sqrt(dx * dx + dy * dy) - ref_distance) > STACK_MATCH_TOLERANCE)
+							continue;
+						double angle = atan2(ref_dy, ref_dx) - atan2(dy, dx);
+						t.cos_a = cos(angle);
+						t.sin_a = sin(angle);
+						t.dx = ref[a].x - (t.cos_a * stars[c].x - t.sin_a * stars[c].y);
+						t.dy = ref[a].y - (t.sin_a * stars[c].x + t.cos_a * stars[c].y);
+						int matched = stack_match(&t, ref, ref_count, stars, count, pairs);
+						if (matched > best) {
+							best = matched;
+							memcpy(best_pairs, pairs, count * sizeof(int));
+						}
+					}
+				}
+			}
+		}
+	} else {
+		t.cos_a = 1;
+		t.sin_a = 0;
+		for (int i = 0; i < candidates_ref; i++) {
+			for (int j = 0; j < candidates; j++) {
+				t.dx = ref[i].x - stars[j].x;
+				t.dy = ref[i].y - stars[j].y;
+				int matched = stack_match(&t, ref, ref_count, stars, count, pairs);
+				if (matched > best) {
+					best = matched;
+					memcpy(best_pairs, pairs, count * sizeof(int));
+				}
+			}
+		}
+	}
+	if (best < (ref_count < 3 || count < 3 ? 1 : 3))
+		return false;
+	double ref_x = 0, ref_y = 0, x = 0, y = 0;
+	for (int j = 0; j < count; j++) {
+		if (best_pairs[j] >= 0) {
+			ref_x += ref[best_pairs[j]].x;
+			ref_y += ref[best_pairs[j]].y;
+			x += stars[j].x;
+			y += stars[j].y;
+		}
+	}
+	ref_x /= best;
+	ref_y /= best;
+	x /= best;
+	y /= best;
+	result->cos_a = 1;
+	result->sin_a = 0;
+	if (rotation) {
+		double sxx = 0, sxy = 0;
+		for (int j = 0; j < count; j++) {
+			if (best_pairs[j] >= 0) {
+				double px = stars[j].x - x, py = stars[j].y - y;
+				double qx = ref[best_pairs[j]].x - ref_x, qy = ref[best_pairs[j]].y - ref_y;
+				sxx += px * qx + py * qy;
+				sxy += px * qy - py * qx;
+			}
+		}
+		double angle = atan2(sxy, sxx);
+		result->cos_a = cos(angle);
+		result->sin_a = sin(angle);
+	}
+	result->dx = ref_x - (result->cos_a * x - result->sin_a * y);
+	result->dy = ref_y - (result->sin_a * x + result->cos_a * y);
+	return true;
+}
+
+/* running mean with optional sigma clipping against the current per-pixel statistics, kept branch free (bitwise combined
+   conditions used as 0/1 weights, divisors without selects) so gcc -O3 vectorises it */
+static void stack_accumulate_row(float *restrict mean, float *restrict m2, float *restrict count, const float *restrict value, const float *restrict valid, int n, float kappa2) {
+	const int unclipped = kappa2 == 0;
+	for (int i = 0; i < n; i++) {
+		float c = count[i];
+		float d = value[i] - mean[i];
+		float variance = m2[i] / (c + (c < 1));
+		float accept = (float)((valid[i] != 0) & ((c < 3) | unclipped | (d * d <= kappa2 * variance)));
+		float new_count = c + accept;
+		float delta = accept * d / (new_count + (new_count < 1));
+		mean[i] += delta;
+		m2[i] += accept * d * (d - delta);
+		count[i] = new_count;
+	}
+}
+
+static void stack_accumulate(indigo_device *device, float *planes, int width, int height, stack_transform *t) {
+	int stack_width = DEVICE_PRIVATE_DATA->stack_width;
+	int stack_height = DEVICE_PRIVATE_DATA->stack_height;
+	long count = (long)width * height;
+	long stack_count = (long)stack_width * stack_height;
+	float kappa2 = AGENT_IMAGER_STACK_SETTINGS_SIGMA_ITEM->number.value * AGENT_IMAGER_STACK_SETTINGS_SIGMA_ITEM->number.value;
+	float *value = indigo_safe_malloc(stack_width * sizeof(float));
+	float *valid = indigo_safe_malloc(stack_width * sizeof(float));
+	for (int c = 0; c < DEVICE_PRIVATE_DATA->stack_channels; c++) {
+		float *plane = planes + c * count;
+		for (int y = 0; y < stack_height; y++) {
+			/* stack -> frame coordinates */
+			double sx = t->cos_a * (0 - t->dx) + t->sin_a * (y - t->dy);
+			double sy = -t->sin_a * (0 - t->dx) + t->cos_a * (y - t->dy);
+			for (int x = 0; x < stack_width; x++, sx += t->cos_a, sy -= t->sin_a) {
+				int x0 = (int)floor(sx), y0 = (int)floor(sy);
+				if (x0 < 0 || y0 < 0 || x0 >= width - 1 || y0 >= height - 1) {
+					value[x] = valid[x] = 0;
+					continue;
+				}
+				float fx = sx - x0, fy = sy - y0;
+				float *p = plane + (long)y0 * width + x0;
+				value[x] = (p[0] * (1 - fx) + p[1] * fx) * (1 - fy) + (p[width] * (1 - fx) + p[width + 1] * fx) * fy;
+				valid[x] = 1;
+			}
+			long offset = c * stack_count + (long)y * stack_width;
+			stack_accumulate_row(DEVICE_PRIVATE_DATA->stack_mean + offset, DEVICE_PRIVATE_DATA->stack_m2 + offset, DEVICE_PRIVATE_DATA->stack_count + offset, value, valid, stack_width, kappa2);
+		}
+	}
+	free(value);
+	free(valid);
+}
+
+static float stack_select(float *data, int count, int k) {
+	int left = 0, right = count - 1;
+	while (left < right) {
+		float pivot = data[k];
+		int i = left, j = right;
+		do {
+			while (data[i] < pivot)
+				i++;
+			while (pivot < data[j])
+				j--;
+			if (i <= j) {
+				float tmp = data[i];
+				data[i] = data[j];
+				data[j] = tmp;
+				i++;
+				j--;
+			}
+		} while (i <= j);
+		if (j < k)
+			left = i;
+		if (k < i)
+			right = j;
+	}
+	return data[k];
+}
+
+static float stack_mtf(float m, float x) {
+	if (x <= 0)
+		return 0;
+	if (x >= 1)
+		return 1;
+	return (m - 1) * x / ((2 * m - 1) * x - m);
+}
+
+/* auto-stretched JPEG preview of the stack (shadows clipped at median - 2.8 MAD, background moved to 25%) */
+static void stack_publish_preview(indigo_device *device) {
+	int width = DEVICE_PRIVATE_DATA->stack_width;
+	int height = DEVICE_PRIVATE_DATA->stack_height;
+	int channels = DEVICE_PRIVATE_DATA->stack_channels;
+	long count = (long)width * height;
+	float *mean = DEVICE_PRIVATE_DATA->stack_mean;
+	int samples = count < 100000 ? (int)count : 100000;
+	long step = count / samples;
+	float *sample = indigo_safe_malloc(samples * sizeof(float));
+	float lo[3], hi[3], m[3];
+	for (int c = 0; c < channels; c++) {
+		float *plane = mean + c * count;
+		float max = plane[0];
+		for (int i = 0; i < samples; i++) {
+			sample[i] = plane[i * step];
+			if (sample[i] > max)
+				max = sample[i];
+		}
+		int half = samples / 2;
+		float median = stack_select(sample, samples, half);
+		for (int i = 0; i < samples; i++)
+			sample[i] = fabsf(sample[i] - median);
+		float mad = 1.4826f * stack_select(sample, samples, half);
+		lo[c] = median - 2.8f * mad;
+		hi[c] = max > lo[c] ? max : lo[c] + 1;
+		float background = (median - lo[c]) / (hi[c] - lo[c]);
+		m[c] = stack_mtf(0.25f, background);
+	}
+	free(sample);
+	unsigned char *rgb = indigo_safe_malloc(count * channels);
+	for (int c = 0; c < channels; c++) {
+		float *plane = mean + c * count;
+		float scale = 1 / (hi[c] - lo[c]);
+		for (long i = 0; i < count; i++)
+			rgb[i * channels + c] = (unsigned char)(255 * stack_mtf(m[c], (plane[i] - lo[c]) * scale) + 0.5f);
+	}
+	unsigned char *volatile mem = NULL;
+	unsigned long mem_size = 0;
+	struct indigo_jpeg_compress_struct cinfo;
+	struct jpeg_error_mgr jerr;
+	cinfo.pub.err = jpeg_std_error(&jerr);
+	jerr.error_exit = jpeg_compress_error_callback;
+	if (setjmp(cinfo.jpeg_error)) {
+		jpeg_destroy_compress(&cinfo.pub);
+		free(rgb);
+		/* jpeg_mem_dest() buffer is allocated by libjpeg and not released by jpeg_destroy_compress() */
+		indigo_safe_free(mem);
+		INDIGO_DRIVER_ERROR(DRIVER_NAME, "JPEG compression failed");
+		return;
+	}
+	jpeg_create_compress(&cinfo.pub);
+	jpeg_mem_dest(&cinfo.pub, (unsigned char **)&mem, &mem_size);
+	cinfo.pub.image_width = width;
+	cinfo.pub.image_height = height;
+	cinfo.pub.input_components = channels;
+	cinfo.pub.in_color_space = channels == 3 ? JCS_RGB : JCS_GRAYSCALE;
+	jpeg_set_defaults(&cinfo.pub);
+	jpeg_set_quality(&cinfo.pub, 90, true);
+	jpeg_start_compress(&cinfo.pub, TRUE);
+	while (cinfo.pub.next_scanline < cinfo.pub.image_height) {
+		JSAMPROW row_pointer[1] = { (JSAMPROW)(rgb + (long)cinfo.pub.next_scanline * width * channels) };
+		jpeg_write_scanlines(&cinfo.pub, row_pointer, 1);
+	}
+	jpeg_finish_compress(&cinfo.pub);
+	jpeg_destroy_compress(&cinfo.pub);
+	free(rgb);
+	pthread_mutex_lock(&DEVICE_PRIVATE_DATA->mutex);
+	indigo_safe_free(DEVICE_PRIVATE_DATA->stack_preview);
+	AGENT_IMAGER_STACK_IMAGE_ITEM->blob.value = DEVICE_PRIVATE_DATA->stack_preview = mem;
+	AGENT_IMAGER_STACK_IMAGE_ITEM->blob.size = mem_size;
+	strcpy(AGENT_IMAGER_STACK_IMAGE_ITEM->blob.format, ".jpeg");
+	*AGENT_IMAGER_STACK_IMAGE_ITEM->blob.url = 0;
+	AGENT_IMAGER_STACK_IMAGE_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, AGENT_IMAGER_STACK_IMAGE_PROPERTY, NULL);
+	pthread_mutex_unlock(&DEVICE_PRIVATE_DATA->mutex);
+}
+
+static void stack_frame(indigo_device *device) {
+	wait_for_image_download(device);
+	void *image = DEVICE_PRIVATE_DATA->last_image;
+	int width, height, channels;
+	float *planes = NULL;
+	uint16_t *luminance = NULL;
+	if (image == NULL || !stack_decode_frame(image, DEVICE_PRIVATE_DATA->last_image_size, &width, &height, &channels, &planes, &luminance)) {
+		if (!DEVICE_PRIVATE_DATA->stack_format_warning) {
+			indigo_send_message(device, "Live stacking requires RAW or 8/16-bit FITS image format");
+			DEVICE_PRIVATE_DATA->stack_format_warning = true;
+		}
+		return;
+	}
+	indigo_star_detection stars[STACK_STAR_COUNT];
+	int star_count = 0;
+	indigo_find_stars_precise(INDIGO_RAW_MONO16, luminance, (uint16_t)AGENT_IMAGER_SELECTION_RADIUS_ITEM->number.value, width, height, STACK_STAR_COUNT, stars, &star_count);
+	free(luminance);
+	if (DEVICE_PRIVATE_DATA->stack_mean != NULL && (width != DEVICE_PRIVATE_DATA->stack_width || height != DEVICE_PRIVATE_DATA->stack_height || channels != DEVICE_PRIVATE_DATA->stack_channels || DEVICE_PRIVATE_DATA->stack_star_count == 0)) {
+		indigo_send_message(device, "Frame format changed, live stack restarted");
+		stack_reset(device);
+	}
+	stack_transform t = { 1, 0, 0, 0 };
+	if (DEVICE_PRIVATE_DATA->stack_mean == NULL) {
+		if (star_count == 0) {
+			indigo_send_message(device, "No stars detected, frame not stacked");
+			free(planes);
+			return;
+		}
+		long size = (long)width * height * channels;
+		DEVICE_PRIVATE_DATA->stack_mean = indigo_safe_malloc(size * sizeof(float));
+		DEVICE_PRIVATE_DATA->stack_m2 = indigo_safe_malloc(size * sizeof(float));
+		DEVICE_PRIVATE_DATA->stack_count = indigo_safe_malloc(size * sizeof(float));
+		DEVICE_PRIVATE_DATA->stack_width = width;
+		DEVICE_PRIVATE_DATA->stack_height = height;
+		DEVICE_PRIVATE_DATA->stack_channels = channels;
+		memcpy(DEVICE_PRIVATE_DATA->stack_stars, stars, star_count * sizeof(indigo_star_detection));
+		DEVICE_PRIVATE_DATA->stack_star_count = star_count;
+	} else if (!stack_register(DEVICE_PRIVATE_DATA->stack_stars, DEVICE_PRIVATE_DATA->stack_star_count, stars, star_count, AGENT_IMAGER_STACK_ROTATION_ITEM->sw.value, &t)) {
+		indigo_send_message(device, "Frame can't be registered, not stacked");
+		free(planes);
+		return;
+	}
+	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Stacking frame, shift %.2f, %.2f, rotation %.3f°", t.dx, t.dy, atan2(t.sin_a, t.cos_a) * 180 / M_PI);
+	stack_accumulate(device, planes, width, height, &t);
+	free(planes);
+	int stacked = ++AGENT_IMAGER_STATS_STACKED_ITEM->number.value;
+	indigo_update_property(device, AGENT_IMAGER_STATS_PROPERTY, NULL);
+	int refresh = AGENT_IMAGER_STACK_SETTINGS_REFRESH_ITEM->number.value;
+	if (refresh <= 1 || stacked == 1 || stacked % refresh == 0)
+		stack_publish_preview(device);
+}
+
 static bool exposure_batch(indigo_device *device) {
 	char *ccd_name = FILTER_DEVICE_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX];
 	indigo_property_state state = INDIGO_ALERT_STATE;
@@ -483,6 +1012,7 @@ static bool exposure_batch(indigo_device *device) {
 	set_headers(device);
 	FILTER_DEVICE_CONTEXT->property_removed = false;
 	AGENT_IMAGER_STATS_BATCH_ITEM->number.value++;
+	stack_reset(device);
 	for (int remaining_exposures = AGENT_IMAGER_BATCH_COUNT_ITEM->number.target; remaining_exposures != 0; remaining_exposures--) {
 		AGENT_IMAGER_STATS_FRAME_ITEM->number.value++;
 		indigo_update_property(device, AGENT_IMAGER_STATS_PROPERTY, NULL);
@@ -545,6 +1075,8 @@ static bool exposure_batch(indigo_device *device) {
 			return false;
 		}
 		if (light_frame) {
+			if (!AGENT_IMAGER_STACK_DISABLED_ITEM->sw.value)
+				stack_frame(device);
 			if (remaining_exposures != 0) {
 				if (AGENT_IMAGER_DITHERING_AGGRESSIVITY_ITEM->number.target != 0) {
 					for (int item_index = 0; item_index < FILTER_DEVICE_CONTEXT->filter_related_agent_list_property->count; item_index++) {
@@ -1258,7 +1790,7 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		indigo_init_number_item(AGENT_IMAGER_SELECTION_RADIUS_ITEM, AGENT_IMAGER_SELECTION_RADIUS_ITEM_NAME, "Radius (px)", 1, 50, 1, 8);
 		indigo_init_number_item(AGENT_IMAGER_SELECTION_SUBFRAME_ITEM, AGENT_IMAGER_SELECTION_SUBFRAME_ITEM_NAME, "Subframe", 0, 10, 1, 0);
 		// -------------------------------------------------------------------------------- Focusing stats
-		AGENT_IMAGER_STATS_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_IMAGER_STATS_PROPERTY_NAME, "Agent", "Statistics", INDIGO_OK_STATE, INDIGO_RO_PERM, 12);
+		AGENT_IMAGER_STATS_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_IMAGER_STATS_PROPERTY_NAME, "Agent", "Statistics", INDIGO_OK_STATE, INDIGO_RO_PERM, 13);
 		if (AGENT_IMAGER_STATS_PROPERTY == NULL)
 			return INDIGO_FAILED;
 		indigo_init_number_item(AGENT_IMAGER_STATS_EXPOSURE_ITEM, AGENT_IMAGER_STATS_EXPOSURE_ITEM_NAME, "Elapsed exposure", 0, 3600, 0, 0);
@@ -1273,6 +1805,23 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		indigo_init_number_item(AGENT_IMAGER_STATS_HFD_ITEM, AGENT_IMAGER_STATS_HFD_ITEM_NAME, "HFD", 0, 0xFFFF, 0, 0);
 		indigo_init_number_item(AGENT_IMAGER_STATS_PEAK_ITEM, AGENT_IMAGER_STATS_PEAK_ITEM_NAME, "Peak", 0, 0xFFFF, 0, 0);
 		indigo_init_number_item(AGENT_IMAGER_STATS_DITHERING_ITEM, AGENT_IMAGER_STATS_DITHERING_ITEM_NAME, "Dithering RMSE", 0, 0xFFFF, 0, 0);
+		indigo_init_number_item(AGENT_IMAGER_STATS_STACKED_ITEM, AGENT_IMAGER_STATS_STACKED_ITEM_NAME, "Stacked frames", 0, 0xFFFFFFFF, 0, 0);
+		// -------------------------------------------------------------------------------- Live stacking
+		AGENT_IMAGER_STACK_PROPERTY = indigo_init_switch_property(NULL, device->name, AGENT_IMAGER_STACK_PROPERTY_NAME, "Agent", "Live stacking", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 3);
+		if (AGENT_IMAGER_STACK_PROPERTY == NULL)
+			return INDIGO_FAILED;
+		indigo_init_switch_item(AGENT_IMAGER_STACK_DISABLED_ITEM, AGENT_IMAGER_STACK_DISABLED_ITEM_NAME, "Disabled", true);
+		indigo_init_switch_item(AGENT_IMAGER_STACK_TRANSLATION_ITEM, AGENT_IMAGER_STACK_TRANSLATION_ITEM_NAME, "Translation only", false);
+		indigo_init_switch_item(AGENT_IMAGER_STACK_ROTATION_ITEM, AGENT_IMAGER_STACK_ROTATION_ITEM_NAME, "Translation and rotation", false);
+		AGENT_IMAGER_STACK_SETTINGS_PROPERTY = indigo_init_number_property(NULL, device->name, AGENT_IMAGER_STACK_SETTINGS_PROPERTY_NAME, "Agent", "Live stacking settings", INDIGO_OK_STATE, INDIGO_RW_PERM, 2);
+		if (AGENT_IMAGER_STACK_SETTINGS_PROPERTY == NULL)
+			return INDIGO_FAILED;
+		indigo_init_number_item(AGENT_IMAGER_STACK_SETTINGS_SIGMA_ITEM, AGENT_IMAGER_STACK_SETTINGS_SIGMA_ITEM_NAME, "Rejection threshold (sigma)", 0, 10, 0.5, 3);
+		indigo_init_number_item(AGENT_IMAGER_STACK_SETTINGS_REFRESH_ITEM, AGENT_IMAGER_STACK_SETTINGS_REFRESH_ITEM_NAME, "Preview refresh (frames)", 1, 100, 1, 1);
+		AGENT_IMAGER_STACK_IMAGE_PROPERTY = indigo_init_blob_property(NULL, device->name, AGENT_IMAGER_STACK_IMAGE_PROPERTY_NAME, "Agent", "Live stack preview", INDIGO_OK_STATE, 1);
+		if (AGENT_IMAGER_STACK_IMAGE_PROPERTY == NULL)
+			return INDIGO_FAILED;
+		indigo_init_blob_item(AGENT_IMAGER_STACK_IMAGE_ITEM, AGENT_IMAGER_STACK_IMAGE_ITEM_NAME, "Image");
 		// -------------------------------------------------------------------------------- Sequencer
 		AGENT_IMAGER_SEQUENCE_PROPERTY = indigo_init_text_property(NULL, device->name, AGENT_IMAGER_SEQUENCE_PROPERTY_NAME, "Agent", "Sequence", INDIGO_OK_STATE, INDIGO_RW_PERM, 1 + SEQUENCE_SIZE);
 		if (AGENT_IMAGER_SEQUENCE_PROPERTY == NULL)
@@ -1287,6 +1836,7 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		// --------------------------------------------------------------------------------
 		CONNECTION_PROPERTY->hidden = true;
 		pthread_mutex_init(&DEVICE_PRIVATE_DATA->mutex, NULL);
+		pthread_cond_init(&DEVICE_PRIVATE_DATA->image_download_done, NULL);
 		indigo_load_properties(device, false);
 		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
 		return agent_enumerate_properties(device, NULL, NULL);
@@ -1325,6 +1875,12 @@ static indigo_result agent_enumerate_properties(indigo_device *device, indigo_cl
 		indigo_define_property(device, AGENT_IMAGER_STATS_PROPERTY, NULL);
 	if (indigo_property_match(AGENT_IMAGER_SEQUENCE_PROPERTY, property))
 		indigo_define_property(device, AGENT_IMAGER_SEQUENCE_PROPERTY, NULL);
+	if (indigo_property_match(AGENT_IMAGER_STACK_PROPERTY, property))
+		indigo_define_property(device, AGENT_IMAGER_STACK_PROPERTY, NULL);
+	if (indigo_property_match(AGENT_IMAGER_STACK_SETTINGS_PROPERTY, property))
+		indigo_define_property(device, AGENT_IMAGER_STACK_SETTINGS_PROPERTY, NULL);
+	if (indigo_property_match(AGENT_IMAGER_STACK_IMAGE_PROPERTY, property))
+		indigo_define_property(device, AGENT_IMAGER_STACK_IMAGE_PROPERTY, NULL);
 	return indigo_filter_enumerate_properties(device, client, property);
 }
 
@@ -1359,6 +1915,20 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 		save_config(device);
 		indigo_update_property(device, AGENT_IMAGER_DITHERING_PROPERTY, NULL);
 		return INDIGO_OK;
+	} else if (indigo_property_match(AGENT_IMAGER_STACK_PROPERTY, property)) {
+		// -------------------------------------------------------------------------------- AGENT_IMAGER_STACK
+		indigo_property_copy_values(AGENT_IMAGER_STACK_PROPERTY, property, false);
+		AGENT_IMAGER_STACK_PROPERTY->state = INDIGO_OK_STATE;
+		save_config(device);
+		indigo_update_property(device, AGENT_IMAGER_STACK_PROPERTY, NULL);
+		return INDIGO_OK;
+	} else if (indigo_property_match(AGENT_IMAGER_STACK_SETTINGS_PROPERTY, property)) {
+		// -------------------------------------------------------------------------------- AGENT_IMAGER_STACK_SETTINGS
+		indigo_property_copy_values(AGENT_IMAGER_STACK_SETTINGS_PROPERTY, property, false);
+		AGENT_IMAGER_STACK_SETTINGS_PROPERTY->state = INDIGO_OK_STATE;
+		save_config(device);
+		indigo_update_property(device, AGENT_IMAGER_STACK_SETTINGS_PROPERTY, NULL);
+		return INDIGO_OK;
 	} else if (indigo_property_match(AGENT_IMAGER_STARS_PROPERTY, property)) {
 	// -------------------------------------------------------------------------------- AGENT_IMAGER_STARS
 		if (AGENT_START_PROCESS_PROPERTY->state != INDIGO_BUSY_STATE && AGENT_IMAGER_STARS_PROPERTY->state != INDIGO_BUSY_STATE) {
@@ -1599,6 +2169,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 
 static indigo_result agent_device_detach(indigo_device *device) {
 	assert(device != NULL);
+	wait_for_image_download(device);
 	save_config(device);
 	indigo_release_property(AGENT_IMAGER_BATCH_PROPERTY);
 	indigo_release_property(AGENT_IMAGER_FOCUS_PROPERTY);
@@ -1615,9 +2186,18 @@ static indigo_result agent_device_detach(indigo_device *device) {
 	indigo_release_property(AGENT_ABORT_PROCESS_PROPERTY);
 	indigo_release_property(AGENT_IMAGER_SEQUENCE_PROPERTY);
 	indigo_release_property(AGENT_WHEEL_FILTER_PROPERTY);
+	indigo_release_property(AGENT_IMAGER_STACK_PROPERTY);
+	indigo_release_property(AGENT_IMAGER_STACK_SETTINGS_PROPERTY);
+	indigo_release_property(AGENT_IMAGER_STACK_IMAGE_PROPERTY);
+	pthread_cond_destroy(&DEVICE_PRIVATE_DATA->image_download_done);
 	pthread_mutex_destroy(&DEVICE_PRIVATE_DATA->mutex);
 	indigo_safe_free(DEVICE_PRIVATE_DATA->image_buffer);
-	indigo_safe_free(DEVICE_PRIVATE_DATA->last_image);
+	indigo_safe_free(DEVICE_PRIVATE_DATA->stack_mean);
+	indigo_safe_free(DEVICE_PRIVATE_DATA->stack_m2);
+	indigo_safe_free(DEVICE_PRIVATE_DATA->stack_count);
+	indigo_safe_free(DEVICE_PRIVATE_DATA->stack_preview);
+	indigo_release_blob_content(DEVICE_PRIVATE_DATA->last_image);
+	DEVICE_PRIVATE_DATA->last_image = NULL;
 	return indigo_filter_device_detach(device);
 }
 
@@ -1678,7 +2258,7 @@ static indigo_result agent_define_property(indigo_client *client, indigo_device
 			indigo_property *agent_wheel_filter_property = CLIENT_PRIVATE_DATA->agent_wheel_filter_property;
 			agent_wheel_filter_property->count = property->count;
 			for (int i = 0; i < property->count; i++)
-				strcpy(agent_wheel_filter_property->items[i].label, property->items[i].text.value);
+				indigo_set_item_label(agent_wheel_filter_property->items + i, property->items[i].text.value);
 			agent_wheel_filter_property->hidden = false;
 			indigo_define_property(FILTER_CLIENT_CONTEXT->device, agent_wheel_filter_property, NULL);
 		} else if (!strcmp(property->name, WHEEL_SLOT_PROPERTY_NAME)) {
@@ -1708,14 +2288,33 @@ static indigo_result agent_define_property(indigo_client *client, indigo_device
 static indigo_result agent_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
 	if (*FILTER_CLIENT_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX] && !strcmp(property->device, FILTER_CLIENT_CONTEXT->device_name[INDIGO_FILTER_CCD_INDEX])) {
 		if (property->state == INDIGO_OK_STATE && !strcmp(property->name, CCD_IMAGE_PROPERTY_NAME)) {
-			if (strchr(property->device, '@'))
-				indigo_populate_http_blob_item(property->items);
+			if (strchr(property->device, '@') && *property->items->blob.url) {
+				/* don't block remote server parser thread, download in background */
+				image_download *download = indigo_safe_malloc(sizeof(image_download));
+				download->device = FILTER_CLIENT_CONTEXT->device;
+				pthread_mutex_lock(&CLIENT_PRIVATE_DATA->mutex);
+				download->sequence = ++CLIENT_PRIVATE_DATA->image_download_sequence;
+				CLIENT_PRIVATE_DATA->image_download_pending++;
+				pthread_mutex_unlock(&CLIENT_PRIVATE_DATA->mutex);
+				if (!indigo_populate_http_blob_item_async(property->items, image_downloaded, download)) {
+					pthread_mutex_lock(&CLIENT_PRIVATE_DATA->mutex);
+					if (--CLIENT_PRIVATE_DATA->image_download_pending == 0)
+						pthread_cond_broadcast(&CLIENT_PRIVATE_DATA->image_download_done);
+					pthread_mutex_unlock(&CLIENT_PRIVATE_DATA->mutex);
+					free(download);
+				}
+				return indigo_filter_update_property(client, device, property, message);
+			}
+			indigo_release_blob_content(CLIENT_PRIVATE_DATA->last_image);
+			CLIENT_PRIVATE_DATA->last_image = NULL;
 			if (property->items->blob.value) {
-				CLIENT_PRIVATE_DATA->last_image = indigo_safe_realloc(CLIENT_PRIVATE_DATA->last_image, property->items->blob.size);
-				memcpy(CLIENT_PRIVATE_DATA->last_image, property->items->blob.value, property->items->blob.size);
-			} else if (CLIENT_PRIVATE_DATA->last_image) {
-				free(CLIENT_PRIVATE_DATA->last_image);
-				CLIENT_PRIVATE_DATA->last_image = NULL;
+				/* local CCD - share frame cached by the bus, otherwise copy it */
+				CLIENT_PRIVATE_DATA->last_image = indigo_retain_blob_content(property->items, &CLIENT_PRIVATE_DATA->last_image_size);
+				CLIENT_PRIVATE_DATA->last_image_shared = CLIENT_PRIVATE_DATA->last_image != NULL;
+				if (CLIENT_PRIVATE_DATA->last_image == NULL) {
+					CLIENT_PRIVATE_DATA->last_image = indigo_alloc_blob_content(CLIENT_PRIVATE_DATA->last_image_size = property->items->blob.size);
+					memcpy(CLIENT_PRIVATE_DATA->last_image, property->items->blob.value, property->items->blob.size);
+				}
 			}
 		} else if (property->state == INDIGO_OK_STATE && !strcmp(property->name, CCD_IMAGE_FILE_PROPERTY_NAME)) {
 			pthread_mutex_lock(&CLIENT_PRIVATE_DATA->mutex);
@@ -1754,7 +2353,7 @@ static indigo_result agent_update_property(indigo_client *client, indigo_device
 			indigo_property *agent_wheel_filter_property = CLIENT_PRIVATE_DATA->agent_wheel_filter_property;
 			agent_wheel_filter_property->count = property->count;
 			for (int i = 0; i < property->count; i++)
-				strcpy(agent_wheel_filter_property->items[i].label, property->items[i].text.value);
+				indigo_set_item_label(agent_wheel_filter_property->items + i, property->items[i].text.value);
 			agent_wheel_filter_property->hidden = false;
 			indigo_delete_property(FILTER_CLIENT_CONTEXT->device, agent_wheel_filter_property, NULL);
 			indigo_define_property(FILTER_CLIENT_CONTEXT->device, agent_wheel_filter_property, NULL);
@@ -23,7 +23,7 @@
  \file indigo_agent_scripting.c
  */
 
-#define DRIVER_VERSION 0x0003
+#define DRIVER_VERSION 0x0005
 #define DRIVER_NAME	"indigo_agent_scripting"
 
 #include <stdlib.h>
@@ -45,6 +45,7 @@
 #define MAX_USER_SCRIPT_COUNT											128
 #define MAX_CACHED_SCRIPT_COUNT										126
 #define MAX_TIMER_COUNT														32
+#define MAX_SUBSCRIPTION_COUNT										64
 
 #define AGENT_SCRIPTING_ADD_SCRIPT_PROPERTY				(PRIVATE_DATA->agent_add_script_property)
 #define AGENT_SCRIPTING_ADD_SCRIPT_NAME_ITEM			(AGENT_SCRIPTING_ADD_SCRIPT_PROPERTY->items+0)
@@ -66,6 +67,29 @@ static char boot_js[] = {
 	0
 };
 
+static void *boot_bytecode = NULL;
+static duk_size_t boot_bytecode_size = 0;
+
+typedef enum {
+	DEFINE_EVENT,
+	UPDATE_EVENT,
+	DELETE_EVENT,
+	MESSAGE_EVENT
+} script_event_type;
+
+typedef struct script_event {
+	script_event_type type;
+	char device[INDIGO_NAME_SIZE];
+	indigo_property *property;
+	char *message;
+	struct script_event *next;
+} script_event;
+
+typedef struct {
+	char device[INDIGO_NAME_SIZE];
+	char property[INDIGO_NAME_SIZE];
+} script_subscription;
+
 typedef struct {
 	indigo_property *agent_add_script_property;
 	indigo_property *agent_execute_script_property;
@@ -77,6 +101,14 @@ typedef struct {
 	indigo_timer *timers[MAX_TIMER_COUNT];
 	duk_context *ctx;
 	pthread_mutex_t mutex;
+	script_subscription subscriptions[MAX_SUBSCRIPTION_COUNT];
+	int subscription_count;
+	pthread_mutex_t subscription_mutex;
+	script_event *event_head, *event_tail;
+	pthread_mutex_t event_mutex;
+	pthread_cond_t event_cond;
+	pthread_t event_thread;
+	bool event_thread_running;
 } agent_private_data;
 
 static agent_private_data *private_data = NULL;
@@ -98,10 +130,8 @@ static void save_config(indigo_device *device) {
 		}
 		indigo_save_property(device, NULL, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY);
 		indigo_save_property(device, NULL, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY);
-		if (DEVICE_CONTEXT->property_save_file_handle) {
+		if (indigo_flush_properties(device) == INDIGO_OK) {
 			CONFIG_PROPERTY->state = INDIGO_OK_STATE;
-			close(DEVICE_CONTEXT->property_save_file_handle);
-			DEVICE_CONTEXT->property_save_file_handle = 0;
 		} else {
 			CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
 		}
@@ -356,7 +386,7 @@ static duk_ret_t define_text_property(duk_context *ctx) {
 				indigo_copy_value(item->text.value, duk_to_string(ctx, -1));
 				duk_get_prop_string(ctx, 5, key);
 				duk_get_prop_string(ctx, -1, "label");
-				indigo_copy_value(item->label, duk_to_string(ctx, -1));
+				indigo_set_item_label(item, duk_to_string(ctx, -1));
 				duk_pop(ctx); // label
 				duk_pop(ctx); // item defs
 				duk_pop_2(ctx); // item
@@ -392,7 +422,7 @@ static duk_ret_t define_number_property(duk_context *ctx) {
 				item->number.value = duk_to_number(ctx, -1);;
 				duk_get_prop_string(ctx, 5, key);
 				duk_get_prop_string(ctx, -1, "label");
-				indigo_copy_value(item->label, duk_to_string(ctx, -1));
+				indigo_set_item_label(item, duk_to_string(ctx, -1));
 				duk_pop(ctx); // label
 				duk_get_prop_string(ctx, -1, "format");
 				indigo_copy_value(item->number.format, duk_to_string(ctx, -1));
@@ -441,7 +471,7 @@ static duk_ret_t define_switch_property(duk_context *ctx) {
 				item->number.value = duk_to_boolean(ctx, -1);;
 				duk_get_prop_string(ctx, 5, key);
 				duk_get_prop_string(ctx, -1, "label");
-				indigo_copy_value(item->label, duk_to_string(ctx, -1));
+				indigo_set_item_label(item, duk_to_string(ctx, -1));
 				duk_pop(ctx); // label
 				duk_pop(ctx); // item defs
 				duk_pop_2(ctx); // item
@@ -476,7 +506,7 @@ static duk_ret_t define_light_property(duk_context *ctx) {
 				item->light.value = require_state(ctx, -1);;
 				duk_get_prop_string(ctx, 5, key);
 				duk_get_prop_string(ctx, -1, "label");
-				indigo_copy_value(item->label, duk_to_string(ctx, -1));
+				indigo_set_item_label(item, duk_to_string(ctx, -1));
 				duk_pop(ctx); // label
 				duk_pop(ctx); // item defs
 				duk_pop_2(ctx); // item
@@ -673,20 +703,265 @@ static duk_ret_t cancel_timer(duk_context *ctx) {
 	return DUK_RET_ERROR;
 }
 
+// function indigo_subscribe(device_name, property_name)
+
+static duk_ret_t subscribe(duk_context *ctx) {
+	const char *device = duk_is_null_or_undefined(ctx, 0) ? "" : duk_require_string(ctx, 0);
+	const char *property = duk_is_null_or_undefined(ctx, 1) ? "" : duk_require_string(ctx, 1);
+	pthread_mutex_lock(&PRIVATE_DATA->subscription_mutex);
+	for (int i = 0; i < PRIVATE_DATA->subscription_count; i++) {
+		script_subscription *subscription = PRIVATE_DATA->subscriptions + i;
+		if (!strcmp(subscription->device, device) && !strcmp(subscription->property, property)) {
+			pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+			return 0;
+		}
+	}
+	if (PRIVATE_DATA->subscription_count == MAX_SUBSCRIPTION_COUNT) {
+		pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+		return DUK_RET_RANGE_ERROR;
+	}
+	script_subscription *subscription = PRIVATE_DATA->subscriptions + PRIVATE_DATA->subscription_count++;
+	indigo_copy_name(subscription->device, device);
+	indigo_copy_name(subscription->property, property);
+	pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+	/* properties filtered out so far are not cached by boot.js yet */
+	indigo_property property_template = { 0 };
+	if (!strchr(device, '*'))
+		indigo_copy_name(property_template.device, device);
+	if (!strchr(property, '*'))
+		indigo_copy_name(property_template.name, property);
+	indigo_enumerate_properties(agent_client, &property_template);
+	return 0;
+}
+
+// function indigo_unsubscribe(device_name, property_name)
+
+static duk_ret_t unsubscribe(duk_context *ctx) {
+	const char *device = duk_is_null_or_undefined(ctx, 0) ? "" : duk_require_string(ctx, 0);
+	const char *property = duk_is_null_or_undefined(ctx, 1) ? "" : duk_require_string(ctx, 1);
+	pthread_mutex_lock(&PRIVATE_DATA->subscription_mutex);
+	for (int i = 0; i < PRIVATE_DATA->subscription_count; i++) {
+		script_subscription *subscription = PRIVATE_DATA->subscriptions + i;
+		if (!strcmp(subscription->device, device) && !strcmp(subscription->property, property)) {
+			memmove(subscription, subscription + 1, (--PRIVATE_DATA->subscription_count - i) * sizeof(script_subscription));
+			break;
+		}
+	}
+	pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+	return 0;
+}
+
 static bool execute_script(indigo_property *property) {
 	bool result = true;
 	char *script = indigo_get_text_item_value(property->count == 1 ? property->items : property->items + 1);
 	if (script && *script) {
 		pthread_mutex_lock(&PRIVATE_DATA->mutex);
-		if (duk_peval_string(PRIVATE_DATA->ctx, script)) {
+		/* compiled script is cached in the heap stash until the script is changed or deleted */
+		duk_push_heap_stash(PRIVATE_DATA->ctx);
+		if (!duk_get_prop_string(PRIVATE_DATA->ctx, -1, property->name)) {
+			duk_pop(PRIVATE_DATA->ctx);
+			duk_push_string(PRIVATE_DATA->ctx, script);
+			duk_push_string(PRIVATE_DATA->ctx, property->label);
+			if (duk_pcompile(PRIVATE_DATA->ctx, 0) == 0) {
+				duk_dup_top(PRIVATE_DATA->ctx);
+				duk_put_prop_string(PRIVATE_DATA->ctx, -3, property->name);
+			} else {
+				indigo_send_message(agent_device, "Failed to compile script '%s' (%s)", property->label, duk_safe_to_string(PRIVATE_DATA->ctx, -1));
+				result = false;
+			}
+		}
+		if (result && duk_pcall(PRIVATE_DATA->ctx, 0)) {
 			indigo_send_message(agent_device, "Failed to execute script '%s' (%s)", property->label, duk_safe_to_string(PRIVATE_DATA->ctx, -1));
 			result = false;
 		}
+		duk_pop_2(PRIVATE_DATA->ctx);
 		pthread_mutex_unlock(&PRIVATE_DATA->mutex);
 	}
 	return result;
 }
 
+static void invalidate_script(indigo_property *property) {
+	pthread_mutex_lock(&PRIVATE_DATA->mutex);
+	duk_push_heap_stash(PRIVATE_DATA->ctx);
+	duk_del_prop_string(PRIVATE_DATA->ctx, -1, property->name);
+	duk_pop(PRIVATE_DATA->ctx);
+	pthread_mutex_unlock(&PRIVATE_DATA->mutex);
+}
+
+static bool execute_boot_script() {
+	/* boot.js is compiled once per process, agent reloads load its bytecode */
+	if (boot_bytecode) {
+		void *buffer = duk_push_fixed_buffer(PRIVATE_DATA->ctx, boot_bytecode_size);
+		memcpy(buffer, boot_bytecode, boot_bytecode_size);
+		duk_load_function(PRIVATE_DATA->ctx);
+	} else {
+		duk_push_string(PRIVATE_DATA->ctx, boot_js);
+		duk_push_string(PRIVATE_DATA->ctx, "boot.js");
+		if (duk_pcompile(PRIVATE_DATA->ctx, 0)) {
+			INDIGO_DRIVER_ERROR(DRIVER_NAME, "%s", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
+			duk_pop(PRIVATE_DATA->ctx);
+			return false;
+		}
+		duk_dup_top(PRIVATE_DATA->ctx);
+		duk_dump_function(PRIVATE_DATA->ctx);
+		void *buffer = duk_get_buffer(PRIVATE_DATA->ctx, -1, &boot_bytecode_size);
+		boot_bytecode = indigo_safe_malloc_copy(boot_bytecode_size, buffer);
+		duk_pop(PRIVATE_DATA->ctx);
+	}
+	bool result = true;
+	if (duk_pcall(PRIVATE_DATA->ctx, 0)) {
+		INDIGO_DRIVER_ERROR(DRIVER_NAME, "%s", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
+		result = false;
+	}
+	duk_pop(PRIVATE_DATA->ctx);
+	return result;
+}
+
+// -------------------------------------------------------------------------------- Event queue
+
+static bool match_pattern(const char *pattern, const char *name) {
+	if (*pattern == 0)
+		return true;
+	const char *wildcard = strchr(pattern, '*');
+	if (wildcard)
+		return strncmp(pattern, name, wildcard - pattern) == 0;
+	return strcmp(pattern, name) == 0;
+}
+
+static bool is_subscribed(const char *device, const char *property) {
+	bool result = false;
+	pthread_mutex_lock(&PRIVATE_DATA->subscription_mutex);
+	if (PRIVATE_DATA->subscription_count == 0) {
+		result = true;
+	} else {
+		for (int i = 0; i < PRIVATE_DATA->subscription_count; i++) {
+			script_subscription *subscription = PRIVATE_DATA->subscriptions + i;
+			if (match_pattern(subscription->device, device) && (property == NULL || *property == 0 || match_pattern(subscription->property, property))) {
+				result = true;
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&PRIVATE_DATA->subscription_mutex);
+	return result;
+}
+
+static void free_event(script_event *event) {
+	indigo_safe_free(event->property);
+	indigo_safe_free(event->message);
+	free(event);
+}
+
+static void queue_event(script_event_type type, const char *device, indigo_property *property, const char *message) {
+	if (!PRIVATE_DATA->event_thread_running || !is_subscribed(device, property ? property->name : NULL))
+		return;
+	script_event *event = indigo_safe_malloc(sizeof(script_event));
+	event->type = type;
+	indigo_copy_name(event->device, device);
+	if (property) {
+		/* only short text values and BLOB URLs are passed to the scripts, don't keep pointers owned by the sender */
+		int size = sizeof(indigo_property) + property->count * sizeof(indigo_item);
+		event->property = indigo_safe_malloc_copy(size, property);
+		for (int i = 0; i < property->count; i++) {
+			indigo_item *item = event->property->items + i;
+			if (property->type == INDIGO_TEXT_VECTOR) {
+				item->text.long_value = NULL;
+			} else if (property->type == INDIGO_BLOB_VECTOR) {
+				item->blob.value = NULL;
+			}
+		}
+	}
+	if (message)
+		event->message = strdup(message);
+	pthread_mutex_lock(&PRIVATE_DATA->event_mutex);
+	if (!PRIVATE_DATA->event_thread_running) {
+		pthread_mutex_unlock(&PRIVATE_DATA->event_mutex);
+		free_event(event);
+		return;
+	}
+	if (PRIVATE_DATA->event_tail)
+		PRIVATE_DATA->event_tail->next = event;
+	else
+		PRIVATE_DATA->event_head = event;
+	PRIVATE_DATA->event_tail = event;
+	pthread_cond_signal(&PRIVATE_DATA->event_cond);
+	pthread_mutex_unlock(&PRIVATE_DATA->event_mutex);
+}
+
+static void dispatch_event(script_event *event) {
+	indigo_property *property = event->property;
+	duk_push_global_object(PRIVATE_DATA->ctx);
+	switch (event->type) {
+		case DEFINE_EVENT:
+			if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_define_property")) {
+				duk_push_string(PRIVATE_DATA->ctx, property->device);
+				duk_push_string(PRIVATE_DATA->ctx, property->name);
+				push_items(property, false);
+				push_state(property->state);
+				duk_push_string(PRIVATE_DATA->ctx, property->perm == INDIGO_RW_PERM ? "RW" : property->perm == INDIGO_RO_PERM ? "RO" : "WO");
+				duk_push_string(PRIVATE_DATA->ctx, event->message);
+				if (duk_pcall(PRIVATE_DATA->ctx, 6)) {
+					INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_define_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
+				}
+			}
+			break;
+		case UPDATE_EVENT:
+			if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_update_property")) {
+				duk_push_string(PRIVATE_DATA->ctx, property->device);
+				duk_push_string(PRIVATE_DATA->ctx, property->name);
+				push_items(property, false);
+				push_state(property->state);
+				duk_push_string(PRIVATE_DATA->ctx, event->message);
+				if (duk_pcall(PRIVATE_DATA->ctx, 5)) {
+					INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_update_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
+				}
+			}
+			break;
+		case DELETE_EVENT:
+			if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_delete_property")) {
+				duk_push_string(PRIVATE_DATA->ctx, property->device);
+				duk_push_string(PRIVATE_DATA->ctx, property->name);
+				duk_push_string(PRIVATE_DATA->ctx, event->message);
+				if (duk_pcall(PRIVATE_DATA->ctx, 3)) {
+					INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_delete_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
+				}
+			}
+			break;
+		case MESSAGE_EVENT:
+			if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "agent_on_send_message")) {
+				duk_push_string(PRIVATE_DATA->ctx, event->device);
+				duk_push_string(PRIVATE_DATA->ctx, event->message);
+				if (duk_pcall(PRIVATE_DATA->ctx, 2)) {
+					INDIGO_DRIVER_ERROR(DRIVER_NAME, "agent_on_send_message() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
+				}
+			}
+			break;
+	}
+	duk_pop_2(PRIVATE_DATA->ctx);
+}
+
+static void *event_thread(void *data) {
+	pthread_mutex_lock(&PRIVATE_DATA->event_mutex);
+	while (PRIVATE_DATA->event_thread_running) {
+		script_event *event = PRIVATE_DATA->event_head;
+		if (event == NULL) {
+			pthread_cond_wait(&PRIVATE_DATA->event_cond, &PRIVATE_DATA->event_mutex);
+			continue;
+		}
+		PRIVATE_DATA->event_head = event->next;
+		if (PRIVATE_DATA->event_head == NULL)
+			PRIVATE_DATA->event_tail = NULL;
+		pthread_mutex_unlock(&PRIVATE_DATA->event_mutex);
+		pthread_mutex_lock(&PRIVATE_DATA->mutex);
+		dispatch_event(event);
+		pthread_mutex_unlock(&PRIVATE_DATA->mutex);
+		free_event(event);
+		pthread_mutex_lock(&PRIVATE_DATA->event_mutex);
+	}
+	pthread_mutex_unlock(&PRIVATE_DATA->event_mutex);
+	return NULL;
+}
+
 // -------------------------------------------------------------------------------- INDIGO agent device implementation
 
 static indigo_result agent_enumerate_properties(indigo_device *device, indigo_client *client, indigo_property *property);
@@ -767,9 +1042,11 @@ static indigo_result agent_device_attach(indigo_device *device) {
 			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_set_timer");
 			duk_push_c_function(PRIVATE_DATA->ctx, cancel_timer, 1);
 			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_cancel_timer");
-			if (duk_peval_string(PRIVATE_DATA->ctx, boot_js)) {
-				INDIGO_DRIVER_ERROR(DRIVER_NAME, "%s", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-			} else {
+			duk_push_c_function(PRIVATE_DATA->ctx, subscribe, 2);
+			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_subscribe");
+			duk_push_c_function(PRIVATE_DATA->ctx, unsubscribe, 2);
+			duk_put_global_string(PRIVATE_DATA->ctx, "indigo_unsubscribe");
+			if (execute_boot_script()) {
 				INDIGO_DRIVER_DEBUG(DRIVER_NAME, "boot.js executed");
 			}
 		}
@@ -777,6 +1054,11 @@ static indigo_result agent_device_attach(indigo_device *device) {
 		pthread_mutexattr_init(&Attr);
 		pthread_mutexattr_settype(&Attr, PTHREAD_MUTEX_RECURSIVE);
 		pthread_mutex_init(&PRIVATE_DATA->mutex, &Attr);
+		pthread_mutex_init(&PRIVATE_DATA->subscription_mutex, NULL);
+		pthread_mutex_init(&PRIVATE_DATA->event_mutex, NULL);
+		pthread_cond_init(&PRIVATE_DATA->event_cond, NULL);
+		PRIVATE_DATA->event_head = PRIVATE_DATA->event_tail = NULL;
+		PRIVATE_DATA->event_thread_running = PRIVATE_DATA->ctx && pthread_create(&PRIVATE_DATA->event_thread, NULL, event_thread, NULL) == 0;
 		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
 		return agent_enumerate_properties(device, NULL, NULL);
 	}
@@ -935,6 +1217,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 				int j = atoi(item->name + AGENT_SCRIPTING_SCRIPT_PROPERTY_NAME_LENGTH);
 				indigo_property *script_property = AGENT_SCRIPTING_SCRIPT_PROPERTY(j);
 				if (script_property) {
+					invalidate_script(script_property);
 					indigo_delete_property(device, script_property, NULL);
 					indigo_release_property(script_property);
 					AGENT_SCRIPTING_SCRIPT_PROPERTY(j) = NULL;
@@ -943,16 +1226,25 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 					indigo_delete_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 					indigo_delete_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
 					int count = AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->count;
+					indigo_release_item_strings(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + i, 1);
+					indigo_release_item_strings(AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->items + i, 1);
+					indigo_release_item_strings(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + i + 1, 1);
+					indigo_release_item_strings(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + i + 1, 1);
 					if (i + 1 < count) {
 						indigo_item tmp[count - i - 1];
 						memcpy(tmp, AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + i + 1, sizeof(indigo_item) * (count - i - 1));
 						memcpy(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + i, tmp, sizeof(indigo_item) * (count - i - 1));
 						memcpy(tmp, AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->items + i + 1, sizeof(indigo_item) * (count - i - 1));
 						memcpy(AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->items + i, tmp, sizeof(indigo_item) * (count - i - 1));
-						memcpy(tmp, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + i + 2, sizeof(indigo_item) * (count - i - 2));
-						memcpy(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + (i + 1), tmp, sizeof(indigo_item) * (count - i - 2));
-						memcpy(tmp, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + i + 2, sizeof(indigo_item) * (count - i - 2));
-						memcpy(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + (i + 1), tmp, sizeof(indigo_item) * (count - i - 2));
+						memcpy(tmp, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + i + 2, sizeof(indigo_item) * (count - i - 1));
+						memcpy(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + (i + 1), tmp, sizeof(indigo_item) * (count - i - 1));
+						memcpy(tmp, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + i + 2, sizeof(indigo_item) * (count - i - 1));
+						memcpy(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + (i + 1), tmp, sizeof(indigo_item) * (count - i - 1));
+						/* last slots are duplicates now, they don't own their labels */
+						memset(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->items + count - 1, 0, sizeof(indigo_item));
+						memset(AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->items + count - 1, 0, sizeof(indigo_item));
+						memset(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + count, 0, sizeof(indigo_item));
+						memset(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + count, 0, sizeof(indigo_item));
 					}
 					AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY->count--;
 					AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->count--;
@@ -988,6 +1280,7 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 			indigo_property *script_property = AGENT_SCRIPTING_SCRIPT_PROPERTY(i);
 			if (script_property && indigo_property_match(script_property, property)) {
 				indigo_property_copy_values(script_property, property, false);
+				invalidate_script(script_property);
 				script_property->state = INDIGO_OK_STATE;
 				if (strcmp(script_property->label, script_property->items[0].text.value)) {
 					indigo_delete_property(device, script_property, NULL);
@@ -999,10 +1292,10 @@ static indigo_result agent_change_property(indigo_device *device, indigo_client
 							indigo_delete_property(device, AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY, NULL);
 							indigo_delete_property(device, AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, NULL);
 							indigo_delete_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
-							strcpy(item->label, script_property->label);
-							strcpy(AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->items[j].label, script_property->label);
-							strcpy(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items[j + 1].label, script_property->label);
-							strcpy(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items[j + 1].label, script_property->label);
+							indigo_set_item_label(item, script_property->label);
+							indigo_set_item_label(AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY->items + j, script_property->label);
+							indigo_set_item_label(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY->items + j + 1, script_property->label);
+							indigo_set_item_label(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->items + j + 1, script_property->label);
 							indigo_property_sort_items(AGENT_SCRIPTING_EXECUTE_SCRIPT_PROPERTY, 0);
 							indigo_property_sort_items(AGENT_SCRIPTING_DELETE_SCRIPT_PROPERTY, 0);
 							indigo_property_sort_items(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY, 1);
@@ -1061,13 +1354,29 @@ static indigo_result agent_device_detach(indigo_device *device) {
 		}
 		AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY->state = INDIGO_OK_STATE;
 		indigo_update_property(device, AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY, NULL);
-		duk_destroy_heap(PRIVATE_DATA->ctx);
 	}
+	if (PRIVATE_DATA->event_thread_running) {
+		pthread_mutex_lock(&PRIVATE_DATA->event_mutex);
+		PRIVATE_DATA->event_thread_running = false;
+		pthread_cond_signal(&PRIVATE_DATA->event_cond);
+		pthread_mutex_unlock(&PRIVATE_DATA->event_mutex);
+		pthread_join(PRIVATE_DATA->event_thread, NULL);
+	}
+	while (PRIVATE_DATA->event_head) {
+		script_event *event = PRIVATE_DATA->event_head;
+		PRIVATE_DATA->event_head = event->next;
+		free_event(event);
+	}
+	if (PRIVATE_DATA->ctx)
+		duk_destroy_heap(PRIVATE_DATA->ctx);
 	for (int i = 0; i < MAX_TIMER_COUNT; i++) {
 		if (PRIVATE_DATA->timers[i])
 			indigo_cancel_timer_sync(agent_device, PRIVATE_DATA->timers + i);
 	}
 	pthread_mutex_destroy(&PRIVATE_DATA->mutex);
+	pthread_mutex_destroy(&PRIVATE_DATA->subscription_mutex);
+	pthread_mutex_destroy(&PRIVATE_DATA->event_mutex);
+	pthread_cond_destroy(&PRIVATE_DATA->event_cond);
 	indigo_release_property(AGENT_SCRIPTING_ON_LOAD_SCRIPT_PROPERTY);
 	indigo_release_property(AGENT_SCRIPTING_ON_UNLOAD_SCRIPT_PROPERTY);
 	indigo_release_property(AGENT_SCRIPTING_ADD_SCRIPT_PROPERTY);
@@ -1098,62 +1407,22 @@ static indigo_result agent_client_attach(indigo_client *client) {
 }
 
 static indigo_result agent_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
-	duk_push_global_object(PRIVATE_DATA->ctx);
-	if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_define_property")) {
-		duk_push_string(PRIVATE_DATA->ctx, property->device);
-		duk_push_string(PRIVATE_DATA->ctx, property->name);
-		push_items(property, false);
-		push_state(property->state);
-		duk_push_string(PRIVATE_DATA->ctx, property->perm == INDIGO_RW_PERM ? "RW" : property->perm == INDIGO_RO_PERM ? "RO" : "WO");
-		duk_push_string(PRIVATE_DATA->ctx, message);
-		if (duk_pcall(PRIVATE_DATA->ctx, 6)) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_define_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-		}
-	}
-	duk_pop_2(PRIVATE_DATA->ctx);
+	queue_event(DEFINE_EVENT, property->device, property, message);
 	return INDIGO_OK;
 }
 
 static indigo_result agent_update_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
-	duk_push_global_object(PRIVATE_DATA->ctx);
-	if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_update_property")) {
-		duk_push_string(PRIVATE_DATA->ctx, property->device);
-		duk_push_string(PRIVATE_DATA->ctx, property->name);
-		push_items(property, false);
-		push_state(property->state);
-		duk_push_string(PRIVATE_DATA->ctx, message);
-		if (duk_pcall(PRIVATE_DATA->ctx, 5)) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_update_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-		}
-	}
-	duk_pop_2(PRIVATE_DATA->ctx);
+	queue_event(UPDATE_EVENT, property->device, property, message);
 	return INDIGO_OK;
 }
 
 static indigo_result agent_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
-	duk_push_global_object(PRIVATE_DATA->ctx);
-	if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "indigo_on_delete_property")) {
-		duk_push_string(PRIVATE_DATA->ctx, property->device);
-		duk_push_string(PRIVATE_DATA->ctx, property->name);
-		duk_push_string(PRIVATE_DATA->ctx, message);
-		if (duk_pcall(PRIVATE_DATA->ctx, 3)) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "indigo_on_delete_property() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-		}
-	}
-	duk_pop_2(PRIVATE_DATA->ctx);
+	queue_event(DELETE_EVENT, property->device, property, message);
 	return INDIGO_OK;
 }
 
 static indigo_result agent_send_message(indigo_client *client, indigo_device *device, const char *message) {
-	duk_push_global_object(PRIVATE_DATA->ctx);
-	if (duk_get_prop_string(PRIVATE_DATA->ctx, -1, "agent_on_send_message")) {
-		duk_push_string(PRIVATE_DATA->ctx, device->name);
-		duk_push_string(PRIVATE_DATA->ctx, message);
-		if (duk_pcall(PRIVATE_DATA->ctx, 2)) {
-			INDIGO_DRIVER_ERROR(DRIVER_NAME, "agent_on_send_message() call failed (%s)", duk_safe_to_string(PRIVATE_DATA->ctx, -1));
-		}
-	}
-	duk_pop_2(PRIVATE_DATA->ctx);
+	queue_event(MESSAGE_EVENT, device->name, NULL, message);
 	return INDIGO_OK;
 }
 
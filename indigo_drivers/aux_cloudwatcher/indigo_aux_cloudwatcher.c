@@ -1775,7 +1775,7 @@ static indigo_result aux_change_property(indigo_device *device, indigo_client *c
 		if (DEVICE_CONNECTED) {
 			indigo_delete_property(device, AUX_GPIO_OUTLET_PROPERTY, NULL);
 		}
-		snprintf(AUX_GPIO_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_OUTLET_NAME_1_ITEM->text.value);
+		indigo_set_item_label(AUX_GPIO_OUTLET_1_ITEM, AUX_OUTLET_NAME_1_ITEM->text.value);
 		if (DEVICE_CONNECTED) {
 			indigo_define_property(device, AUX_GPIO_OUTLET_PROPERTY, NULL);
 		}
@@ -538,6 +538,7 @@ static void aux_connection_handler(indigo_device *device) {
 }
 
 static void aux_outlet_names_handler(indigo_device *device) {
+	char label[INDIGO_NAME_SIZE];
 	pthread_mutex_lock(&PRIVATE_DATA->mutex);
 	if (IS_CONNECTED) {
 		indigo_delete_property(device, AUX_HEATER_OUTLET_PROPERTY, NULL);
@@ -545,8 +546,10 @@ static void aux_outlet_names_handler(indigo_device *device) {
 			indigo_delete_property(device, AUX_POWER_OUTLET_STATE_PROPERTY, NULL);
 		}
 	}
-	snprintf(AUX_HEATER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+	snprintf(label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_1_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_2_ITEM, label);
 	AUX_OUTLET_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 	if (IS_CONNECTED) {
 		indigo_define_property(device, AUX_HEATER_OUTLET_PROPERTY, NULL);
@@ -1007,6 +1007,7 @@ static void aux_connection_handler(indigo_device *device) {
 }
 
 static void aux_outlet_names_handler(indigo_device *device) {
+	char label[INDIGO_NAME_SIZE];
 	pthread_mutex_lock(&PRIVATE_DATA->mutex);
 	if (IS_CONNECTED) {
 		indigo_delete_property(device, AUX_POWER_OUTLET_PROPERTY, NULL);
@@ -1018,39 +1019,56 @@ static void aux_outlet_names_handler(indigo_device *device) {
 		indigo_delete_property(device, AUX_USB_PORT_PROPERTY, NULL);
 		indigo_delete_property(device, AUX_USB_PORT_STATE_PROPERTY, NULL);
 	}
-	snprintf(AUX_POWER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_1_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_2_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_3_ITEM->label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_STATE_1_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_STATE_2_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_STATE_3_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_STATE_4_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_STATE_1_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_STATE_2_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_STATE_3_ITEM->label, INDIGO_NAME_SIZE, "%s state", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_CURRENT_1_ITEM->label, INDIGO_NAME_SIZE, "%s current [A] ", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_CURRENT_2_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_CURRENT_3_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
-	snprintf(AUX_POWER_OUTLET_CURRENT_4_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_CURRENT_1_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_CURRENT_2_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
-	snprintf(AUX_HEATER_OUTLET_CURRENT_3_ITEM->label, INDIGO_NAME_SIZE, "%s current [A]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
-	snprintf(AUX_USB_PORT_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_1_ITEM->text.value);
-	snprintf(AUX_USB_PORT_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_2_ITEM->text.value);
-	snprintf(AUX_USB_PORT_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_3_ITEM->text.value);
-	snprintf(AUX_USB_PORT_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_4_ITEM->text.value);
-	snprintf(AUX_USB_PORT_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_5_ITEM->text.value);
-	snprintf(AUX_USB_PORT_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_6_ITEM->text.value);
-	snprintf(AUX_USB_PORT_STATE_1_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_1_ITEM->text.value);
-	snprintf(AUX_USB_PORT_STATE_2_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_2_ITEM->text.value);
-	snprintf(AUX_USB_PORT_STATE_3_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_3_ITEM->text.value);
-	snprintf(AUX_USB_PORT_STATE_4_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_4_ITEM->text.value);
-	snprintf(AUX_USB_PORT_STATE_5_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_5_ITEM->text.value);
-	snprintf(AUX_USB_PORT_STATE_6_ITEM->label, INDIGO_NAME_SIZE, "%s", AUX_USB_PORT_NAME_6_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_1_ITEM, AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_2_ITEM, AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_3_ITEM, AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_4_ITEM, AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
+	snprintf(label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_1_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_2_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s [%%]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_3_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_STATE_1_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_STATE_2_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_STATE_3_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s state", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_STATE_4_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s state", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_STATE_1_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s state", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_STATE_2_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s state", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_STATE_3_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s current [A] ", AUX_POWER_OUTLET_NAME_1_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_CURRENT_1_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s current [A]", AUX_POWER_OUTLET_NAME_2_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_CURRENT_2_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s current [A]", AUX_POWER_OUTLET_NAME_3_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_CURRENT_3_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s current [A]", AUX_POWER_OUTLET_NAME_4_ITEM->text.value);
+	indigo_set_item_label(AUX_POWER_OUTLET_CURRENT_4_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s current [A]", AUX_HEATER_OUTLET_NAME_1_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_CURRENT_1_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s current [A]", AUX_HEATER_OUTLET_NAME_2_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_CURRENT_2_ITEM, label);
+	snprintf(label, INDIGO_NAME_SIZE, "%s current [A]", AUX_HEATER_OUTLET_NAME_3_ITEM->text.value);
+	indigo_set_item_label(AUX_HEATER_OUTLET_CURRENT_3_ITEM, label);
+	indigo_set_item_label(AUX_USB_PORT_1_ITEM, AUX_USB_PORT_NAME_1_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_2_ITEM, AUX_USB_PORT_NAME_2_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_3_ITEM, AUX_USB_PORT_NAME_3_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_4_ITEM, AUX_USB_PORT_NAME_4_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_5_ITEM, AUX_USB_PORT_NAME_5_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_6_ITEM, AUX_USB_PORT_NAME_6_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_STATE_1_ITEM, AUX_USB_PORT_NAME_1_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_STATE_2_ITEM, AUX_USB_PORT_NAME_2_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_STATE_3_ITEM, AUX_USB_PORT_NAME_3_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_STATE_4_ITEM, AUX_USB_PORT_NAME_4_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_STATE_5_ITEM, AUX_USB_PORT_NAME_5_ITEM->text.value);
+	indigo_set_item_label(AUX_USB_PORT_STATE_6_ITEM, AUX_USB_PORT_NAME_6_ITEM->text.value);
 	AUX_OUTLET_NAMES_PROPERTY->state = INDIGO_OK_STATE;
 	if (IS_CONNECTED) {
 		indigo_define_property(device, AUX_POWER_OUTLET_PROPERTY, NULL);
@@ -1695,7 +1695,7 @@ static indigo_result eth_attach(indigo_device *device) {
 		DEVICE_PORT_PROPERTY->hidden = false;
 		indigo_copy_value(DEVICE_PORT_ITEM->text.value, "192.168.0.100");
 		indigo_copy_value(DEVICE_PORT_PROPERTY->label, "Remote camera");
-		indigo_copy_value(DEVICE_PORT_ITEM->label, "IP address / hostname");
+		indigo_set_item_label(DEVICE_PORT_ITEM, "IP address / hostname");
 		// -------------------------------------------------------------------------------- DEVICE_PORTS
 		DEVICE_PORTS_PROPERTY->hidden = true;
 		// --------------------------------------------------------------------------------
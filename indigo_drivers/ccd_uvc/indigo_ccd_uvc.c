@@ -23,7 +23,7 @@
  \file indigo_ccd_uvc.c
  */
 
-#define DRIVER_VERSION 0x0009
+#define DRIVER_VERSION 0x000A
 #define DRIVER_NAME "indigo_ccd_uvc"
 
 #include <stdlib.h>
@@ -159,7 +159,7 @@ static indigo_result ccd_attach(indigo_device *device) {
 	assert(PRIVATE_DATA != NULL);
 	if (indigo_ccd_attach(device, DRIVER_NAME, DRIVER_VERSION) == INDIGO_OK) {
 		// -------------------------------------------------------------------------------- CCD_BIN
-		CCD_BIN_PROPERTY->hidden = true;
+		indigo_ccd_enable_software_binning(device, 4, false);
 		// -------------------------------------------------------------------------------- CCD_FRAME
 		CCD_FRAME_PROPERTY->perm = INDIGO_RO_PERM;
 		CCD_FRAME_BITS_PER_PIXEL_ITEM->number.min = 0;
@@ -273,8 +273,8 @@ static indigo_result dome_attach(indigo_device *device) {
 		DOME_SLAVING_PARAMETERS_PROPERTY->hidden = true;
 		DOME_SHUTTER_PROPERTY->rule = INDIGO_AT_MOST_ONE_RULE;
 		indigo_copy_value(DOME_SHUTTER_PROPERTY->label, "Roof state");
-		indigo_copy_value(DOME_SHUTTER_OPENED_ITEM->label, "Roof opened");
-		indigo_copy_value(DOME_SHUTTER_CLOSED_ITEM->label, "Roof closed");
+		indigo_set_item_label(DOME_SHUTTER_OPENED_ITEM, "Roof opened");
+		indigo_set_item_label(DOME_SHUTTER_CLOSED_ITEM, "Roof closed");
 		// -------------------------------------------------------------------------------- DEVICE_PORT, DEVICE_PORTS
 		DEVICE_PORT_PROPERTY->hidden = false;
 		DEVICE_PORTS_PROPERTY->hidden = false;
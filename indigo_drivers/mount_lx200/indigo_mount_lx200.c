@@ -23,7 +23,7 @@
  \file indigo_mount_lx200.c
  */
 
-#define DRIVER_VERSION 0x000E
+#define DRIVER_VERSION 0x0010
 #define DRIVER_NAME	"indigo_mount_lx200"
 
 #include <stdlib.h>
@@ -122,65 +122,43 @@ static bool meade_open(indigo_device *device) {
 	}
 }
 
-static bool meade_command(indigo_device *device, char *command, char *response, int max, int sleep) {
+static int meade_transaction(indigo_device *device, indigo_transaction_item *items, int count) {
 	pthread_mutex_lock(&PRIVATE_DATA->port_mutex);
-	char c;
-	struct timeval tv;
-	// flush
-	while (true) {
-		fd_set readout;
-		FD_ZERO(&readout);
-		FD_SET(PRIVATE_DATA->handle, &readout);
-		tv.tv_sec = 0;
-		tv.tv_usec = 100000;
-		long result = select(PRIVATE_DATA->handle+1, &readout, NULL, NULL, &tv);
-		if (result == 0)
-			break;
-		if (result < 0) {
-			pthread_mutex_unlock(&PRIVATE_DATA->port_mutex);
-			return false;
-		}
-		result = read(PRIVATE_DATA->handle, &c, 1);
-		if (result < 1) {
-			pthread_mutex_unlock(&PRIVATE_DATA->port_mutex);
-			return false;
+	indigo_flush_input(PRIVATE_DATA->handle, 100000);
+	int result = indigo_transaction(PRIVATE_DATA->handle, items, count, '#', 3100000, 100000);
+	pthread_mutex_unlock(&PRIVATE_DATA->port_mutex);
+	for (int i = 0; i < count; i++) {
+		if (items[i].response != NULL) {
+			for (char *c = items[i].response; *c; c++) {
+				if (*c < 0)
+					*c = ':';
+			}
 		}
+		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Command %s -> %s", items[i].command, items[i].response != NULL ? items[i].response : "NULL");
 	}
-	// write command
-	indigo_write(PRIVATE_DATA->handle, command, strlen(command));
-	if (sleep > 0)
+	return result;
+}
+
+static bool meade_command(indigo_device *device, char *command, char *response, int max, int sleep) {
+	if (sleep > 0) {
+		pthread_mutex_lock(&PRIVATE_DATA->port_mutex);
+		indigo_flush_input(PRIVATE_DATA->handle, 100000);
+		indigo_write(PRIVATE_DATA->handle, command, strlen(command));
 		indigo_usleep(sleep);
-	// read response
-	if (response != NULL) {
-		int index = 0;
-		int timeout = 3;
-		while (index < max) {
-			fd_set readout;
-			FD_ZERO(&readout);
-			FD_SET(PRIVATE_DATA->handle, &readout);
-			tv.tv_sec = timeout;
-			tv.tv_usec = 100000;
-			timeout = 0;
-			long result = select(PRIVATE_DATA->handle+1, &readout, NULL, NULL, &tv);
-			if (result <= 0)
-				break;
-			result = read(PRIVATE_DATA->handle, &c, 1);
-			if (result < 1) {
-				INDIGO_DRIVER_ERROR(DRIVER_NAME, "Failed to read from %s -> %s (%d)", DEVICE_PORT_ITEM->text.value, strerror(errno), errno);
-				pthread_mutex_unlock(&PRIVATE_DATA->port_mutex);
-				return false;
+		indigo_transaction_item item = { NULL, response, max };
+		int result = response != NULL ? indigo_transaction(PRIVATE_DATA->handle, &item, 1, '#', 3100000, 100000) : 0;
+		pthread_mutex_unlock(&PRIVATE_DATA->port_mutex);
+		if (response != NULL) {
+			for (char *c = response; *c; c++) {
+				if (*c < 0)
+					*c = ':';
 			}
-			if (c < 0)
-				c = ':';
-			if (c == '#')
-				break;
-			response[index++] = c;
 		}
-		response[index] = 0;
+		INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Command %s -> %s", command, response != NULL ? response : "NULL");
+		return result >= 0;
 	}
-	pthread_mutex_unlock(&PRIVATE_DATA->port_mutex);
-	INDIGO_DRIVER_DEBUG(DRIVER_NAME, "Command %s -> %s", command, response != NULL ? response : "NULL");
-	return true;
+	indigo_transaction_item item = { command, response, max };
+	return meade_transaction(device, &item, 1) >= 0;
 }
 
 static bool meade_command_progress(indigo_device *device, char *command, char *response, int max, int sleep) {
@@ -292,33 +270,42 @@ static void meade_close(indigo_device *device) {
 }
 
 static void meade_get_coords(indigo_device *device) {
-	char response[128];
-	if (meade_command(device, ":GR#", response, sizeof(response), 0)) {
-		if (strlen(response) < 8) {
-			if (MOUNT_TYPE_MEADE_ITEM->sw.value) {
-				meade_command(device, ":P#", response, sizeof(response), 0);
-				meade_command(device, ":GR#", response, sizeof(response), 0);
-			} else if (MOUNT_TYPE_10MICRONS_ITEM->sw.value) {
-				meade_command(device, ":U1#", NULL, 0, 0);
-				meade_command(device, ":GR#", response, sizeof(response), 0);
-			} else if (MOUNT_TYPE_GEMINI_ITEM->sw.value || MOUNT_TYPE_AP_ITEM->sw.value || MOUNT_TYPE_ON_STEP_ITEM->sw.value) {
-				meade_command(device, ":U#", NULL, 0, 0);
-				meade_command(device, ":GR#", response, sizeof(response), 0);
-			}
+	char response[128], ra[128], dec[128], distance[128];
+	// RA, Dec and slew status are queried in one round trip
+	bool distance_bars = MOUNT_TYPE_MEADE_ITEM->sw.value || MOUNT_TYPE_10MICRONS_ITEM->sw.value || MOUNT_TYPE_ON_STEP_ITEM->sw.value;
+	indigo_transaction_item items[] = {
+		{ ":GR#", ra, sizeof(ra) - 1 },
+		{ ":GD#", dec, sizeof(dec) - 1 },
+		{ ":D#", distance, sizeof(distance) - 1 }
+	};
+	int count = distance_bars ? 3 : 2;
+	int completed = meade_transaction(device, items, count);
+	if (completed > 0 && strlen(ra) < 8) {
+		bool high_precision = true;
+		if (MOUNT_TYPE_MEADE_ITEM->sw.value) {
+			meade_command(device, ":P#", response, sizeof(response) - 1, 0);
+		} else if (MOUNT_TYPE_10MICRONS_ITEM->sw.value) {
+			meade_command(device, ":U1#", NULL, 0, 0);
+		} else if (MOUNT_TYPE_GEMINI_ITEM->sw.value || MOUNT_TYPE_AP_ITEM->sw.value || MOUNT_TYPE_ON_STEP_ITEM->sw.value) {
+			meade_command(device, ":U#", NULL, 0, 0);
+		} else {
+			high_precision = false;
 		}
-		MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value = indigo_stod(response);
-	}
-	if (meade_command(device, ":GD#", response, sizeof(response), 0)) {
-		MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value = indigo_stod(response);
+		if (high_precision)
+			completed = meade_transaction(device, items, count);
 	}
-	if (MOUNT_TYPE_MEADE_ITEM->sw.value || MOUNT_TYPE_10MICRONS_ITEM->sw.value || MOUNT_TYPE_ON_STEP_ITEM->sw.value) {
-		if (meade_command(device, ":D#", response, sizeof(response), 0))
-			MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = *response ? INDIGO_BUSY_STATE : INDIGO_OK_STATE;
+	if (completed > 0)
+		MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value = indigo_stod(ra);
+	if (completed > 1)
+		MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value = indigo_stod(dec);
+	if (distance_bars) {
+		if (completed >= 0)
+			MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = completed > 2 && *distance ? INDIGO_BUSY_STATE : INDIGO_OK_STATE;
 	} else if (MOUNT_TYPE_GEMINI_ITEM->sw.value) {
-		if (meade_command(device, ":Gv#", response, sizeof(response), 0))
+		if (meade_command(device, ":Gv#", response, sizeof(response) - 1, 0))
 			MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = (*response == 'S' || *response == 'C') ? INDIGO_BUSY_STATE : INDIGO_OK_STATE;
 	} else if (MOUNT_TYPE_AVALON_ITEM->sw.value) {
-		if (meade_command(device, ":X34#", response, sizeof(response), 0))
+		if (meade_command(device, ":X34#", response, sizeof(response) - 1, 0))
 			MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = (response[1] == '5' || response[2] == '5') ? INDIGO_BUSY_STATE : INDIGO_OK_STATE;
 	} else {
 		if (PRIVATE_DATA->motioned) {
@@ -348,11 +335,11 @@ static void meade_get_utc(indigo_device *device) {
 		memset(&tm, 0, sizeof(tm));
 		MOUNT_UTC_TIME_PROPERTY->state = INDIGO_ALERT_STATE;
 		char separator[2];
-		if (meade_command(device, ":GC#", response, sizeof(response), 0) && sscanf(response, "%d%c%d%c%d", &tm.tm_mon, separator, &tm.tm_mday, separator, &tm.tm_year) == 5) {
-			if (meade_command(device, ":GL#", response, sizeof(response), 0) && sscanf(response, "%d%c%d%c%d", &tm.tm_hour, separator, &tm.tm_min, separator, &tm.tm_sec) == 5) {
+		if (meade_command(device, ":GC#", response, sizeof(response) - 1, 0) && sscanf(response, "%d%c%d%c%d", &tm.tm_mon, separator, &tm.tm_mday, separator, &tm.tm_year) == 5) {
+			if (meade_command(device, ":GL#", response, sizeof(response) - 1, 0) && sscanf(response, "%d%c%d%c%d", &tm.tm_hour, separator, &tm.tm_min, separator, &tm.tm_sec) == 5) {
 				tm.tm_year += 100; // TODO: To be fixed in year 2100 :)
 				tm.tm_mon -= 1;
-				if (meade_command(device, ":GG#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":GG#", response, sizeof(response) - 1, 0)) {
 					if (MOUNT_TYPE_AP_ITEM->sw.value && response[0] == ':') {
 						if (response[1] == 'A') {
 							switch (response[2]) {
@@ -400,7 +387,7 @@ static void meade_get_utc(indigo_device *device) {
 					tm.tm_gmtoff = -atoi(response) * 3600;
 					sprintf(MOUNT_UTC_OFFSET_ITEM->text.value, "%d", -atoi(response));
 					if (PRIVATE_DATA->use_dst_commands) {
-						if (meade_command(device, ":GH#", response, sizeof(response), 0)) {
+						if (meade_command(device, ":GH#", response, sizeof(response) - 1, 0)) {
 							tm.tm_isdst = atoi(response);
 						}
 					} else {
@@ -417,10 +404,10 @@ static void meade_get_utc(indigo_device *device) {
 
 static void meade_get_observatory(indigo_device *device) {
 	char response[128];
-	if (meade_command(device, ":Gt#", response, sizeof(response), 0)) {
+	if (meade_command(device, ":Gt#", response, sizeof(response) - 1, 0)) {
 		MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.target = MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.value = indigo_stod(response);
 	}
-	if (meade_command(device, ":Gg#", response, sizeof(response), 0)) {
+	if (meade_command(device, ":Gg#", response, sizeof(response) - 1, 0)) {
 		double longitude = indigo_stod(response);
 		if (longitude < 0)
 			longitude += 360;
@@ -436,7 +423,12 @@ static void position_timer_callback(indigo_device *device) {
 		indigo_update_coordinates(device, NULL);
 		meade_get_utc(device);
 		indigo_update_property(device, MOUNT_UTC_TIME_PROPERTY, NULL);
-		indigo_reschedule_timer(device, MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state == INDIGO_BUSY_STATE ? 0.5 : 1, &PRIVATE_DATA->position_timer);
+		indigo_poll_state state = INDIGO_POLL_IDLE;
+		if (MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state == INDIGO_BUSY_STATE)
+			state = INDIGO_POLL_BUSY;
+		else if (MOUNT_TRACKING_ON_ITEM->sw.value && !MOUNT_PARK_PARKED_ITEM->sw.value)
+			state = INDIGO_POLL_ACTIVE;
+		indigo_reschedule_timer(device, indigo_poll_interval(device, state), &PRIVATE_DATA->position_timer);
 	}
 }
 
@@ -510,7 +502,7 @@ static void mount_connect_callback(indigo_device *device) {
 		}
 		if (result) {
 			if (MOUNT_TYPE_DETECT_ITEM->sw.value) {
-				if (meade_command(device, ":GVP#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":GVP#", response, sizeof(response) - 1, 0)) {
 					INDIGO_DRIVER_LOG(DRIVER_NAME, "Product:  %s", response);
 					strncpy(PRIVATE_DATA->product, response, 64);
 				}
@@ -540,7 +532,7 @@ static void mount_connect_callback(indigo_device *device) {
 				MOUNT_GUIDE_RATE_PROPERTY->hidden = true;
 				PRIVATE_DATA->parked = false;
 				strcpy(MOUNT_INFO_VENDOR_ITEM->text.value, "Meade");
-				if (meade_command(device, ":GVF#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":GVF#", response, sizeof(response) - 1, 0)) {
 					INDIGO_DRIVER_LOG(DRIVER_NAME, "Version:  %s", response);
 					char *sep = strchr(response, '|');
 					if (sep != NULL)
@@ -549,11 +541,11 @@ static void mount_connect_callback(indigo_device *device) {
 				} else {
 					indigo_copy_value(MOUNT_INFO_MODEL_ITEM->text.value, PRIVATE_DATA->product);
 				}
-				if (meade_command(device, ":GVN#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":GVN#", response, sizeof(response) - 1, 0)) {
 					INDIGO_DRIVER_LOG(DRIVER_NAME, "Firmware: %s", response);
 					indigo_copy_value(MOUNT_INFO_FIRMWARE_ITEM->text.value, response);
 				}
-				if (meade_command(device, ":GW#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":GW#", response, sizeof(response) - 1, 0)) {
 					INDIGO_DRIVER_LOG(DRIVER_NAME, "Status:   %s", response);
 					ALIGNMENT_MODE_PROPERTY->hidden = false;
 					if (*response == 'P' || *response == 'G') {
@@ -571,7 +563,7 @@ static void mount_connect_callback(indigo_device *device) {
 				meade_get_observatory(device);
 				meade_get_coords(device);
 				meade_get_utc(device);
-				if (meade_command(device, ":GH#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":GH#", response, sizeof(response) - 1, 0)) {
 					PRIVATE_DATA->use_dst_commands = *response != 0;
 				}
 			} else if (MOUNT_TYPE_EQMAC_ITEM->sw.value) {
@@ -602,7 +594,7 @@ static void mount_connect_callback(indigo_device *device) {
 				PRIVATE_DATA->parked = false;
 				indigo_set_switch(MOUNT_TRACKING_PROPERTY, MOUNT_TRACKING_OFF_ITEM, true);
 				indigo_set_switch(MOUNT_PARK_PROPERTY, MOUNT_PARK_UNPARKED_ITEM, true);
-				if (meade_command(device, ":Gstat#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":Gstat#", response, sizeof(response) - 1, 0)) {
 					if (*response == '0') {
 						indigo_set_switch(MOUNT_TRACKING_PROPERTY, MOUNT_TRACKING_ON_ITEM, true);
 					} else if (*response == '5') {
@@ -650,7 +642,7 @@ static void mount_connect_callback(indigo_device *device) {
 				PRIVATE_DATA->parked = false;
 				indigo_set_switch(MOUNT_TRACKING_PROPERTY, MOUNT_TRACKING_OFF_ITEM, true);
 				indigo_set_switch(MOUNT_PARK_PROPERTY, MOUNT_PARK_UNPARKED_ITEM, true);
-				if (meade_command(device, ":X34#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":X34#", response, sizeof(response) - 1, 0)) {
 					if (response[1] == '1') {
 						indigo_set_switch(MOUNT_TRACKING_PROPERTY, MOUNT_TRACKING_ON_ITEM, true);
 					} else {
@@ -658,7 +650,7 @@ static void mount_connect_callback(indigo_device *device) {
 						PRIVATE_DATA->parked = true;
 					}
 				}
-				if (meade_command(device, ":X22#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":X22#", response, sizeof(response) - 1, 0)) {
 					int ra, dec;
 					if (sscanf(response, "%db%d#", &ra, &dec) == 2) {
 						MOUNT_GUIDE_RATE_RA_ITEM->number.value = MOUNT_GUIDE_RATE_RA_ITEM->number.target = ra;
@@ -699,11 +691,11 @@ static void mount_connect_callback(indigo_device *device) {
 				MOUNT_PARK_PARKED_ITEM->sw.value = false;
 				PRIVATE_DATA->parked = false;
 				strcpy(MOUNT_INFO_VENDOR_ITEM->text.value, "On-Step");
-				if (meade_command(device, ":GVN#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":GVN#", response, sizeof(response) - 1, 0)) {
 					INDIGO_DRIVER_LOG(DRIVER_NAME, "Firmware: %s", response);
 					indigo_copy_value(MOUNT_INFO_FIRMWARE_ITEM->text.value, response);
 				}
-				if (meade_command(device, ":GW#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":GW#", response, sizeof(response) - 1, 0)) {
 					INDIGO_DRIVER_LOG(DRIVER_NAME, "Status:   %s", response);
 					ALIGNMENT_MODE_PROPERTY->hidden = false;
 					if (*response == 'P' || *response == 'G') {
@@ -718,7 +710,7 @@ static void mount_connect_callback(indigo_device *device) {
 					}
 					indigo_define_property(device, ALIGNMENT_MODE_PROPERTY, NULL);
 				}
-				if (meade_command(device, ":$QZ?", response, sizeof(response), 0))
+				if (meade_command(device, ":$QZ?", response, sizeof(response) - 1, 0))
 					indigo_set_switch(MOUNT_PEC_PROPERTY, response[0] == 'P' ? MOUNT_PEC_ENABLED_ITEM : MOUNT_PEC_DISABLED_ITEM, true);
 				meade_get_observatory(device);
 				meade_get_coords(device);
@@ -909,7 +901,7 @@ static indigo_result mount_change_property(indigo_device *device, indigo_client
 						INDIGO_DRIVER_ERROR(DRIVER_NAME, "%s failed", command);
 						MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_ALERT_STATE;
 					} else {
-						if (!meade_command(device, ":CM#", response, sizeof(response), 100000) || *response == 0) {
+						if (!meade_command(device, ":CM#", response, sizeof(response) - 1, 100000) || *response == 0) {
 							INDIGO_DRIVER_ERROR(DRIVER_NAME, ":CM# failed");
 							MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_ALERT_STATE;
 						}
@@ -1077,7 +1069,7 @@ static indigo_result mount_change_property(indigo_device *device, indigo_client
 			// :SCMM/DD/YY# returns two delimiters response:
 			// "1Updating Planetary Data#                                #"
 			// readout progress part
-			if (!meade_command_progress(device, command, response, sizeof(response), 0) || *response != '1') {
+			if (!meade_command_progress(device, command, response, sizeof(response) - 1, 0) || *response != '1') {
 				MOUNT_SET_HOST_TIME_PROPERTY->state = INDIGO_ALERT_STATE;
 			} else {
 				if (PRIVATE_DATA->use_dst_commands) {
@@ -1117,7 +1109,7 @@ static indigo_result mount_change_property(indigo_device *device, indigo_client
 			// :SCMM/DD/YY# returns two delimiters response:
 			// "1Updating Planetary Data#                                #"
 			// readout progress part
-			if (!meade_command_progress(device, command, response, sizeof(response), 0) || *response != '1') {
+			if (!meade_command_progress(device, command, response, sizeof(response) - 1, 0) || *response != '1') {
 				MOUNT_UTC_TIME_PROPERTY->state = INDIGO_ALERT_STATE;
 			} else {
 				if (PRIVATE_DATA->use_dst_commands) {
@@ -1266,7 +1258,7 @@ static indigo_result mount_change_property(indigo_device *device, indigo_client
 		MOUNT_HOME_PROPERTY->state = INDIGO_ALERT_STATE;
 		if (MOUNT_HOME_ITEM->sw.value) {
 			if (MOUNT_TYPE_AVALON_ITEM->sw.value) {
-				if (meade_command(device, ":X361#", response, sizeof(response), 0) && strcmp(response, "pA") == 0) {
+				if (meade_command(device, ":X361#", response, sizeof(response) - 1, 0) && strcmp(response, "pA") == 0) {
 					MOUNT_HOME_PROPERTY->state = INDIGO_OK_STATE;
 				}
 			}
@@ -1416,7 +1408,7 @@ static void focuser_timer_callback(indigo_device *device) {
 		char response[16];
 		if (MOUNT_TYPE_MEADE_ITEM->sw.value || MOUNT_TYPE_AP_ITEM->sw.value) {
 			meade_command(device, ":FQ#", NULL, 0, 0);
-			if (meade_command(device, ":FP#", response, sizeof(response), 0)) {
+			if (meade_command(device, ":FP#", response, sizeof(response) - 1, 0)) {
 				FOCUSER_POSITION_ITEM->number.value = atoi(response);
 				FOCUSER_POSITION_PROPERTY->state = INDIGO_OK_STATE;
 			} else {
@@ -1426,12 +1418,12 @@ static void focuser_timer_callback(indigo_device *device) {
 			FOCUSER_STEPS_PROPERTY->state = INDIGO_OK_STATE;
 			indigo_update_property(device, FOCUSER_STEPS_PROPERTY, NULL);
 		} else if (MOUNT_TYPE_ON_STEP_ITEM->sw.value) {
-			if (!meade_command(device, ":FG#", response, sizeof(response), 0)) {
+			if (!meade_command(device, ":FG#", response, sizeof(response) - 1, 0)) {
 				FOCUSER_POSITION_PROPERTY->state = INDIGO_ALERT_STATE;
 				FOCUSER_STEPS_PROPERTY->state = INDIGO_ALERT_STATE;
 			} else {
 				FOCUSER_POSITION_ITEM->number.value = atoi(response);
-				if (!meade_command(device, ":FT#", response, sizeof(response), 0)) {
+				if (!meade_command(device, ":FT#", response, sizeof(response) - 1, 0)) {
 					FOCUSER_POSITION_PROPERTY->state = INDIGO_ALERT_STATE;
 					FOCUSER_STEPS_PROPERTY->state = INDIGO_ALERT_STATE;
 				} else if (response[0] == 'M') {
@@ -1476,7 +1468,7 @@ static void focuser_connect_callback(indigo_device *device) {
 				FOCUSER_SPEED_ITEM->number.max = 2;
 				FOCUSER_SPEED_PROPERTY->state = INDIGO_OK_STATE;
 				meade_command(device, FOCUSER_SPEED_ITEM->number.value == 1 ? ":FS#" : ":FF#", NULL, 0, 0);
-				if (meade_command(device, ":FP#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":FP#", response, sizeof(response) - 1, 0)) {
 					FOCUSER_POSITION_ITEM->number.value = atoi(response);
 					FOCUSER_POSITION_PROPERTY->state = INDIGO_OK_STATE;
 				} else {
@@ -1488,17 +1480,17 @@ static void focuser_connect_callback(indigo_device *device) {
 				FOCUSER_SPEED_PROPERTY->state = INDIGO_OK_STATE;
 				sprintf(command, "F%d", (int)FOCUSER_SPEED_ITEM->number.value);
 				meade_command(device, command, NULL, 0, 0);
-				if (meade_command(device, ":FG#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":FG#", response, sizeof(response) - 1, 0)) {
 					FOCUSER_POSITION_ITEM->number.value = atoi(response);
 					FOCUSER_POSITION_PROPERTY->state = INDIGO_OK_STATE;
 					FOCUSER_POSITION_PROPERTY->perm = INDIGO_RW_PERM;
 				} else {
 					FOCUSER_POSITION_PROPERTY->state = INDIGO_ALERT_STATE;
 				}
-				if (meade_command(device, ":FI#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":FI#", response, sizeof(response) - 1, 0)) {
 					FOCUSER_POSITION_ITEM->number.min = atoi(response);
 				}
-				if (meade_command(device, ":FM#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":FM#", response, sizeof(response) - 1, 0)) {
 					FOCUSER_POSITION_ITEM->number.max = atoi(response);
 				}
 			}
@@ -1590,7 +1582,7 @@ static indigo_result focuser_change_property(indigo_device *device, indigo_clien
 			FOCUSER_ABORT_MOTION_ITEM->sw.value = false;
 			if (MOUNT_TYPE_MEADE_ITEM->sw.value || MOUNT_TYPE_AP_ITEM->sw.value) {
 				meade_command(device, ":FQ#", NULL, 0, 0);
-				if (meade_command(device, ":FP#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":FP#", response, sizeof(response) - 1, 0)) {
 					FOCUSER_POSITION_ITEM->number.value = atoi(response);
 					FOCUSER_POSITION_PROPERTY->state = INDIGO_OK_STATE;
 				} else {
@@ -1598,7 +1590,7 @@ static indigo_result focuser_change_property(indigo_device *device, indigo_clien
 				}
 			} else if (MOUNT_TYPE_ON_STEP_ITEM->sw.value) {
 				meade_command(device, ":FQ#", NULL, 0, 0);
-				if (meade_command(device, ":FG#", response, sizeof(response), 0)) {
+				if (meade_command(device, ":FG#", response, sizeof(response) - 1, 0)) {
 					FOCUSER_POSITION_ITEM->number.value = atoi(response);
 					FOCUSER_POSITION_PROPERTY->state = INDIGO_OK_STATE;
 				} else {
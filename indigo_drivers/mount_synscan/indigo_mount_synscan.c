@@ -406,7 +406,7 @@ static indigo_result guider_attach(indigo_device *device) {
 		GUIDER_RATE_PROPERTY->hidden = false;
 		GUIDER_RATE_PROPERTY->count = 2;
 		strncpy(GUIDER_RATE_PROPERTY->label,"Pulse-Guide Rate", INDIGO_VALUE_SIZE);
-		indigo_copy_value(GUIDER_RATE_ITEM->label, "RA Guiding rate (% of sidereal)");
+		indigo_set_item_label(GUIDER_RATE_ITEM, "RA Guiding rate (% of sidereal)");
 
 		INDIGO_DEVICE_ATTACH_LOG(DRIVER_NAME, device->name);
 
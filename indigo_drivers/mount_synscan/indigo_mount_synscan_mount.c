@@ -162,7 +162,12 @@ static void position_timer_callback(indigo_device *device) {
 				indigo_update_property(device, MOUNT_LST_TIME_PROPERTY, NULL);
 			}
 		}
-		indigo_reschedule_timer(device, 0.5, &PRIVATE_DATA->position_timer);
+		indigo_poll_state state = INDIGO_POLL_IDLE;
+		if (MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state == INDIGO_BUSY_STATE || MOUNT_AUTOHOME_PROPERTY->state == INDIGO_BUSY_STATE)
+			state = INDIGO_POLL_BUSY;
+		else if (MOUNT_TRACKING_ON_ITEM->sw.value && !MOUNT_PARK_PARKED_ITEM->sw.value)
+			state = INDIGO_POLL_ACTIVE;
+		indigo_reschedule_timer(device, indigo_poll_interval(device, state), &PRIVATE_DATA->position_timer);
 	}
 	PRIVATE_DATA->timer_count--;
 }
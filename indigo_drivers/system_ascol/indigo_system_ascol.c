@@ -2560,7 +2560,7 @@ static indigo_result dome_attach(indigo_device *device) {
 		DOME_PARK_PROPERTY->hidden = true;
 
 		// ------------------------------------------------------------------------- DOME_STEPS
-		indigo_copy_value(DOME_STEPS_ITEM->label, "Relaive move (0 to 180°)");
+		indigo_set_item_label(DOME_STEPS_ITEM, "Relaive move (0 to 180°)");
 		DOME_STEPS_ITEM->number.min = 0;
 		DOME_STEPS_ITEM->number.max = 179.99;
 
@@ -2897,11 +2897,11 @@ static indigo_result focuser_attach(indigo_device *device) {
 		// -------------------------------------------------------------------------------- FOCUSER_BACKLASH
 		FOCUSER_BACKLASH_PROPERTY->hidden = true;
 		// -------------------------------------------------------------------------------- FOCUSER_STEPS
-		strncpy(FOCUSER_STEPS_ITEM->label,"Distance (mm)", INDIGO_VALUE_SIZE);
+		indigo_set_item_label(FOCUSER_STEPS_ITEM, "Distance (mm)");
 		FOCUSER_STEPS_ITEM->number.min = 0;
 		FOCUSER_STEPS_ITEM->number.max = 100;
 		// -------------------------------------------------------------------------------- FOCUSER_POSITION
-		strncpy(FOCUSER_POSITION_ITEM->label,"Absolute position (mm)", INDIGO_VALUE_SIZE);
+		indigo_set_item_label(FOCUSER_POSITION_ITEM, "Absolute position (mm)");
 		FOCUSER_POSITION_ITEM->number.min = 0;
 		FOCUSER_POSITION_ITEM->number.max = 100;
 		// -------------------------------------------------------------------------------- FOCUSER STATE
@@ -91,7 +91,7 @@ static indigo_result wheel_attach(indigo_device *device) {
 		INFO_PROPERTY->count = 6;
 		char *sdk_version = EFWGetSDKVersion();
 		indigo_copy_value(INFO_DEVICE_FW_REVISION_ITEM->text.value, sdk_version);
-		indigo_copy_value(INFO_DEVICE_FW_REVISION_ITEM->label, "SDK version");
+		indigo_set_item_label(INFO_DEVICE_FW_REVISION_ITEM, "SDK version");
 
 		pthread_mutex_init(&PRIVATE_DATA->usb_mutex, NULL);
 		return indigo_wheel_enumerate_properties(device, NULL, NULL);
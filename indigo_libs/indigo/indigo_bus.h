@@ -211,8 +211,8 @@ typedef enum {
  */
 typedef struct {/* there is no .name =  because of g++ C99 bug affecting string initialier */
 	char name[INDIGO_NAME_SIZE];        ///< property wide unique item name
-	char label[INDIGO_VALUE_SIZE];      ///< item description in human readable form
-	char hints[INDIGO_VALUE_SIZE];			///< item GUI hints
+	const char *label;                  ///< item description in human readable form (interned, use indigo_set_item_label() to change)
+	const char *hints;                  ///< item GUI hints (interned, use indigo_set_item_hints() to change)
 	union {
 		/** Text property item specific fields.
 		 */
@@ -357,19 +357,35 @@ typedef struct {
 	int output;													///< output handle
 	bool web_socket;										///< connection over WebSocket (RFC6455)
 	char url_prefix[INDIGO_NAME_SIZE];	///< server url prefix (for BLOB download)
+	void *property_cache;								///< remote property cache kept between connections (XML client adapter only)
+	bool delta_updates;									///< client accepts set messages with changed items only (device adapters only)
+	void *sent_values;									///< values last sent to client (device adapters with delta_updates only)
+	bool shared_blobs;									///< input is Unix domain socket, BLOBs may be attached as file descriptors (XML client adapter only)
 } indigo_adapter_context;
 
+/** Remember values of all property items sent to the client (call when property is defined).
+ */
+extern void indigo_track_sent_values(indigo_adapter_context *context, indigo_property *property);
+
+/** Mark items changed since the last update sent to the client and remember new values, returns number of marked items (all items are marked if client doesn't accept delta updates).
+ */
+extern int indigo_select_changed_items(indigo_adapter_context *context, indigo_property *property, bool *changed);
+
+/** Forget values sent to the client for deleted property, all properties of device (if property name is empty) or all properties (if property is NULL).
+ */
+extern void indigo_forget_sent_values(indigo_adapter_context *context, indigo_property *property);
+
 /** BLOB entry type.
  */
 typedef struct {
 	indigo_item *item;     							///< BLOB item
-	void *content;            					///< BLOB content
+	void *content;            					///< BLOB content (reference counted, see indigo_retain_blob_content())
 	long size;              						///< BLOB size
 	char format[INDIGO_NAME_SIZE];  		///< BLOB format, known file type suffix like ".fits" or ".jpeg"
 	pthread_mutex_t mutext;							///< BLOB mutex
 } indigo_blob_entry;
 
-/** Last diagnostic messages.
+/** Last diagnostic messages (on Linux and macOS the last message formatted by the calling thread).
  */
 extern char *indigo_last_message;
 
@@ -381,7 +397,7 @@ extern char indigo_log_name[];
  */
 extern void (*indigo_log_message_handler)(const char *message);
 
-/** Print diagnostic messages.
+/** Print diagnostic messages (on Linux and macOS message is queued to per-thread ring buffer and printed by background thread).
  */
 extern void indigo_log_message(const char *format, va_list args);
 
@@ -392,6 +408,7 @@ extern void indigo_trace(const char *format, ...);
  */
 extern void indigo_debug(const char *format, ...);
 /** Print diagnostic messages on error level, wrap calls to INDIGO_ERROR() macro.
+ Message is printed synchronously after all queued messages, so it is not lost if the process crashes.
  */
 extern void indigo_error(const char *format, ...);
 /** Print diagnostic messages on log level, wrap calls to INDIGO_LOG() macro.
@@ -435,6 +452,10 @@ extern indigo_result indigo_attach_client(indigo_client *client);
  */
 extern indigo_result indigo_detach_client(indigo_client *client);
 
+/** Check if client is attached to bus.
+ */
+extern bool indigo_is_client_attached(indigo_client *client);
+
 /** Broadcast property definition.
  */
 extern indigo_result indigo_define_property(indigo_device *device, indigo_property *property, const char *format, ...);
@@ -495,6 +516,17 @@ extern void indigo_release_property(indigo_property *property);
 /** Validate address of item of registered BLOB property.
  */
 extern indigo_blob_entry *indigo_validate_blob(indigo_item *item);
+/** Allocate reference counted buffer usable as content of BLOB entry, release it by indigo_release_blob_content().
+ */
+extern void *indigo_alloc_blob_content(long size);
+/** Get reference to cached content of BLOB item without copying it (NULL if item is not cached), release it by indigo_release_blob_content().
+ */
+extern void *indigo_retain_blob_content(indigo_item *item, long *size);
+/** Release reference to BLOB content.
+ */
+extern void indigo_release_blob_content(void *content);
+
+// item initializers release label and hints held by the item before, so items must come from indigo_init_*_property() or indigo_resize_property()
 
 /** Initialize text item.
  */
@@ -522,6 +554,11 @@ extern void indigo_init_blob_item(indigo_item *item, const char *name, const cha
  */
 extern bool indigo_populate_http_blob_item(indigo_item *blob_item);
 
+/** populate copy of BLOB item in background thread and call callback when done.
+ Callback is called in download thread, content of item is released after callback returns unless blob.value is set to NULL by callback.
+ */
+extern bool indigo_populate_http_blob_item_async(indigo_item *blob_item, void callback(indigo_item *item, bool success, void *data), void *data);
+
 /** Test, if property matches other property.
  */
 extern bool indigo_property_match(indigo_property *property, indigo_property *other);
@@ -672,6 +709,35 @@ extern char *indigo_get_text_item_value(indigo_item *item);
  */
 extern void indigo_set_text_item_value(indigo_item *item, const char *value);
 
+/** Get shared immutable copy of string (used for item labels and hints), the same pointer is returned for the same content.
+ Each call takes a reference, the copy is freed when the last reference is released by indigo_release_string().
+ */
+extern const char *indigo_intern_string(const char *string);
+
+/** Release reference taken by indigo_intern_string().
+ */
+extern void indigo_release_string(const char *string);
+
+/** Get already interned copy of string without taking a reference, NULL if string is empty or not interned.
+ */
+extern const char *indigo_find_interned_string(const char *string);
+
+/** Take references to labels and hints of items copied with memcpy(), if the copy is released by indigo_release_property() or its items are reinitialized.
+ */
+extern void indigo_retain_item_strings(indigo_item *items, int count);
+
+/** Release labels and hints of items and reset them to empty strings.
+ */
+extern void indigo_release_item_strings(indigo_item *items, int count);
+
+/** Set item label.
+ */
+extern void indigo_set_item_label(indigo_item *item, const char *label);
+
+/** Set item GUI hints.
+ */
+extern void indigo_set_item_hints(indigo_item *item, const char *hints);
+
 #define indigo_fix_locale(s) { char *fc = strchr(s, ','); if (fc) *fc = '.'; }
 
 #define indigo_copy_name(target, source) { memset(target, 0, INDIGO_NAME_SIZE); strncpy(target, source, INDIGO_NAME_SIZE - 1); }
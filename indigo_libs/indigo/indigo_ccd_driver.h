@@ -432,6 +432,94 @@ extern "C" {
  */
 #define CCD_RBI_FLUSH_DISABLED_ITEM     (CCD_RBI_FLUSH_ENABLE_PROPERTY->items + 1)
 
+/** CCD_CALIBRATION property pointer, property is mandatory, property change request is fully handled by indigo_ccd_change_property().
+ */
+#define CCD_CALIBRATION_PROPERTY        (CCD_CONTEXT->ccd_calibration_property)
+
+/** CCD_CALIBRATION.BIAS property item pointer.
+ */
+#define CCD_CALIBRATION_BIAS_ITEM       (CCD_CALIBRATION_PROPERTY->items + 0)
+
+/** CCD_CALIBRATION.DARK property item pointer.
+ */
+#define CCD_CALIBRATION_DARK_ITEM       (CCD_CALIBRATION_PROPERTY->items + 1)
+
+/** CCD_CALIBRATION.FLAT property item pointer.
+ */
+#define CCD_CALIBRATION_FLAT_ITEM       (CCD_CALIBRATION_PROPERTY->items + 2)
+
+/** CCD_CALIBRATION_LIBRARY property pointer, property is mandatory, property change request is fully handled by indigo_ccd_change_property().
+ */
+#define CCD_CALIBRATION_LIBRARY_PROPERTY	(CCD_CONTEXT->ccd_calibration_library_property)
+
+/** CCD_CALIBRATION_LIBRARY.DIR property item pointer.
+ */
+#define CCD_CALIBRATION_LIBRARY_DIR_ITEM	(CCD_CALIBRATION_LIBRARY_PROPERTY->items + 0)
+
+/** CCD_BIN_MODE property pointer, property is optional (visible only with software binning), property change request is fully handled by indigo_ccd_change_property().
+ */
+#define CCD_BIN_MODE_PROPERTY						(CCD_CONTEXT->ccd_bin_mode_property)
+
+/** CCD_BIN_MODE.SUM property item pointer.
+ */
+#define CCD_BIN_MODE_SUM_ITEM						(CCD_BIN_MODE_PROPERTY->items + 0)
+
+/** CCD_BIN_MODE.AVERAGE property item pointer.
+ */
+#define CCD_BIN_MODE_AVERAGE_ITEM				(CCD_BIN_MODE_PROPERTY->items + 1)
+
+/** CCD_JPEG_DEBAYER property pointer, property is mandatory, read-write property, property change request is fully handled by indigo_ccd_change_property().
+ */
+#define CCD_JPEG_DEBAYER_PROPERTY				(CCD_CONTEXT->ccd_jpeg_debayer_property)
+
+/** CCD_JPEG_DEBAYER.NONE property item pointer.
+ */
+#define CCD_JPEG_DEBAYER_NONE_ITEM			(CCD_JPEG_DEBAYER_PROPERTY->items + 0)
+
+/** CCD_JPEG_DEBAYER.SUPERPIXEL property item pointer.
+ */
+#define CCD_JPEG_DEBAYER_SUPERPIXEL_ITEM	(CCD_JPEG_DEBAYER_PROPERTY->items + 1)
+
+/** CCD_JPEG_DEBAYER.BILINEAR property item pointer.
+ */
+#define CCD_JPEG_DEBAYER_BILINEAR_ITEM		(CCD_JPEG_DEBAYER_PROPERTY->items + 2)
+
+/** Number of downsampled preview tiers.
+ */
+#define CCD_PREVIEW_TIER_COUNT					3
+
+/** CCD_PREVIEW_TIERS property pointer, property is mandatory, read-write property, property change request is fully handled by indigo_ccd_change_property().
+ */
+#define CCD_PREVIEW_TIERS_PROPERTY				(CCD_CONTEXT->ccd_preview_tiers_property)
+
+/** CCD_PREVIEW_TIERS.HALF property item pointer.
+ */
+#define CCD_PREVIEW_TIERS_HALF_ITEM				(CCD_PREVIEW_TIERS_PROPERTY->items + 0)
+
+/** CCD_PREVIEW_TIERS.QUARTER property item pointer.
+ */
+#define CCD_PREVIEW_TIERS_QUARTER_ITEM		(CCD_PREVIEW_TIERS_PROPERTY->items + 1)
+
+/** CCD_PREVIEW_TIERS.THUMBNAIL property item pointer.
+ */
+#define CCD_PREVIEW_TIERS_THUMBNAIL_ITEM	(CCD_PREVIEW_TIERS_PROPERTY->items + 2)
+
+/** CCD_PREVIEW_THUMBNAIL property pointer, property is mandatory, read-write property, property change request is fully handled by indigo_ccd_change_property().
+ */
+#define CCD_PREVIEW_THUMBNAIL_PROPERTY		(CCD_CONTEXT->ccd_preview_thumbnail_property)
+
+/** CCD_PREVIEW_THUMBNAIL.SIZE property item pointer.
+ */
+#define CCD_PREVIEW_THUMBNAIL_SIZE_ITEM		(CCD_PREVIEW_THUMBNAIL_PROPERTY->items + 0)
+
+/** CCD_PREVIEW_HALF_IMAGE, CCD_PREVIEW_QUARTER_IMAGE and CCD_PREVIEW_THUMBNAIL_IMAGE property pointers (index matches CCD_PREVIEW_TIERS item), read-only properties, defined if the tier is enabled.
+ */
+#define CCD_PREVIEW_TIER_IMAGE_PROPERTY(i)	(CCD_CONTEXT->ccd_preview_tier_image_property[i])
+
+/** CCD_PREVIEW_HALF_IMAGE.IMAGE, CCD_PREVIEW_QUARTER_IMAGE.IMAGE and CCD_PREVIEW_THUMBNAIL_IMAGE.IMAGE property item pointers.
+ */
+#define CCD_PREVIEW_TIER_IMAGE_ITEM(i)		(CCD_PREVIEW_TIER_IMAGE_PROPERTY(i)->items + 0)
+
 
 /** CCD device context structure.
  */
@@ -472,6 +560,18 @@ typedef struct {
 	indigo_property *ccd_jpeg_settings;						///< CCD_JPEG_SETTINGS property pointer
 	indigo_property *ccd_rbi_flush_enable_property; ///< CCD_RBI_FLUSH_ENABLE property pointer
 	indigo_property *ccd_rbi_flush_property;			///< CCD_RBI_FLUSH property pointer
+	indigo_property *ccd_calibration_property;		///< CCD_CALIBRATION property pointer
+	indigo_property *ccd_calibration_library_property;	///< CCD_CALIBRATION_LIBRARY property pointer
+	indigo_property *ccd_bin_mode_property;				///< CCD_BIN_MODE property pointer
+	indigo_property *ccd_jpeg_debayer_property;		///< CCD_JPEG_DEBAYER property pointer
+	indigo_property *ccd_preview_tiers_property;	///< CCD_PREVIEW_TIERS property pointer
+	indigo_property *ccd_preview_thumbnail_property;	///< CCD_PREVIEW_THUMBNAIL property pointer
+	indigo_property *ccd_preview_tier_image_property[CCD_PREVIEW_TIER_COUNT];	///< CCD_PREVIEW_HALF_IMAGE, CCD_PREVIEW_QUARTER_IMAGE and CCD_PREVIEW_THUMBNAIL_IMAGE property pointers
+	void *preview_tier_image[CCD_PREVIEW_TIER_COUNT];							///< downsampled preview image buffers
+	unsigned long preview_tier_image_size[CCD_PREVIEW_TIER_COUNT];	///< downsampled preview image buffer sizes
+	void *calibration;														///< master frame library and calibration maps
+	bool software_binning;												///< CCD_BIN is applied by indigo_process_image() to unbinned frames
+	bool software_subframe;												///< CCD_FRAME is applied by indigo_process_image() to full frames
 } indigo_ccd_context;
 
 /** Suspend countdown.
@@ -487,6 +587,11 @@ extern void indigo_ccd_resume_countdown(indigo_device *device);
  */
 extern void indigo_use_shortest_exposure_if_bias(indigo_device *device);
 
+/** Enable software binning (up to max_bin) and optionally software subframe in indigo_process_image().
+    Driver should call it after indigo_ccd_attach() and then deliver unbinned (and full) frames to indigo_process_image().
+ */
+extern void indigo_ccd_enable_software_binning(indigo_device *device, int max_bin, bool subframe);
+
 /** Attach callback function.
  */
 extern indigo_result indigo_ccd_attach(indigo_device *device, const char* driver_name, unsigned version);
@@ -114,8 +114,13 @@ typedef struct {
 	int socket;                             ///< stream socket
 	indigo_device *protocol_adapter;        ///< server protocol adapter
 	char last_error[256];										///< last error reported within client thread
+	void *property_cache;                   ///< remote property cache kept between connections (if indigo_resync_remote_servers is set)
 } indigo_server_entry;
 
+/** Keep properties of remote servers cached over reconnect and propagate only real changes after resync.
+ */
+extern bool indigo_resync_remote_servers;
+
 
 /** Array of all available servers.
  */
@@ -208,11 +208,16 @@ typedef struct {
  */
 typedef indigo_result (*driver_entry_point)(indigo_driver_action, indigo_driver_info*);
 
+/** Max number of subscribed clients tracked per device.
+ */
+#define INDIGO_MAX_SUBSCRIBERS	8
+
 /** Device context structure.
  */
 typedef struct {
-	int property_save_file_handle;            ///< handle for property save
+	int property_save_file_handle;            ///< handle for property save (unused, properties are saved to config_store)
 	pthread_mutex_t config_mutex;							///< mutex for configuration load/save synchronisation
+	void *config_store;												///< in-memory configuration store written to config file after quiet period
 	indigo_timer *timers;											///< active timer list
 	indigo_property *connection_property;     ///< CONNECTION property pointer
 	indigo_property *info_property;           ///< INFO property pointer
@@ -223,8 +228,18 @@ typedef struct {
 	indigo_property *device_baudrate_property;///< DEVICE_BAUDRATE property pointer
 	indigo_property *device_ports_property;		///< DEVICE_PORTS property pointer
 	indigo_property *device_auth_property;		///< SECURITY property pointer
+	indigo_client *subscribers[INDIGO_MAX_SUBSCRIBERS]; ///< clients enumerating device properties
+	void *change_handlers;										///< property change handlers bound with indigo_bind_change_handler()
 } indigo_device_context;
 
+/** Device state for poll interval selection.
+ */
+typedef enum {
+	INDIGO_POLL_BUSY = 0,											///< device is moving (slewing, focusing, rotating etc.)
+	INDIGO_POLL_ACTIVE = 1,										///< device is active (tracking etc.)
+	INDIGO_POLL_IDLE = 2											///< device is idle (parked, stopped etc.)
+} indigo_poll_state;
+
 /** log macros
 */
 
@@ -294,6 +309,18 @@ extern indigo_result indigo_device_change_property(indigo_device *device, indigo
  */
 extern indigo_result indigo_device_detach(indigo_device *device);
 
+/** Property change request handler prototype.
+ */
+typedef indigo_result (*indigo_change_handler)(indigo_device *device, indigo_client *client, indigo_property *property);
+
+/** Bind change request handler for property pointer stored at given location (e.g. &CONNECTION_PROPERTY) to a layer identified by its change property callback (e.g. indigo_device_change_property), call it from attach callback.
+ */
+extern void indigo_bind_change_handler(indigo_device *device, indigo_change_handler layer, indigo_property **property, bool writable_only, indigo_change_handler handler);
+
+/** Call the handler bound by the layer for the requested property, if any, and store its result. Returns true if request was handled, otherwise layer should continue with its own matching.
+ */
+extern bool indigo_dispatch_change_property(indigo_device *device, indigo_change_handler layer, indigo_client *client, indigo_property *property, indigo_result *result);
+
 /** Open config file.
  */
 
@@ -304,6 +331,9 @@ extern int indigo_open_config_file(char *device_name, int profile, int mode, con
 extern indigo_result indigo_load_properties(indigo_device *device, bool default_properties);
 
 /** Save single property.
+ With NULL file_handle the property is stored in memory and written to config file after a short quiet period.
+ Stored properties are merged by name into the existing config file, properties not saved anymore are kept until
+ the config file is removed (CONFIG_REMOVE), unlike writing with explicit file_handle which truncates the file.
  */
 extern indigo_result indigo_save_property(indigo_device*device, int *file_handle, indigo_property *property);
 
@@ -311,6 +341,14 @@ extern indigo_result indigo_save_property(indigo_device*device, int *file_handle
  */
 extern indigo_result indigo_save_property_items(indigo_device*device, int *file_handle, indigo_property *property, const int count, const char **items);
 
+/** Write pending property changes to config file immediately.
+ */
+extern indigo_result indigo_flush_properties(indigo_device *device);
+
+/** Flush and release in-memory configuration store.
+ */
+extern void indigo_release_config_store(indigo_device *device);
+
 /** Remove properties.
  */
 extern indigo_result indigo_remove_properties(indigo_device *device);
@@ -341,10 +379,18 @@ void indigo_timetoisolocal(time_t tstamp, char *isotime, int isotime_len);
  */
 time_t indigo_isolocaltotime(char *isotime);
 
-/** Enumerate serial ports.
+/** Enumerate serial ports from process-wide registry (on Linux kept up to date by /dev monitor, DEVICE_PORTS property of attached devices is refreshed on change).
  */
 void indigo_enumerate_serial_ports(indigo_device *device, indigo_property *property);
 
+/** Check if any remote client or agent is subscribed to device properties.
+ */
+extern bool indigo_device_is_subscribed(indigo_device *device);
+
+/** Poll interval (in seconds) for device state, shorter while device is busy and longer if nobody is subscribed to device properties.
+ */
+extern double indigo_poll_interval(indigo_device *device, indigo_poll_state state);
+
 /** Check for double connect/disconnect request.
  */
 extern bool indigo_ignore_connection_change(indigo_device *device, indigo_property *request);
@@ -92,6 +92,25 @@ extern int indigo_read_line(int handle, char *buffer, int length);
  */
 extern bool indigo_write(int handle, const char *buffer, long length);
 
+/** Transaction item, response is framed by terminator or by length, whichever comes first.
+ */
+typedef struct {
+	const char *command;										///< command to send or NULL if only response is read
+	char *response;													///< response buffer (at least length + 1 bytes) or NULL if command has no response
+	int length;															///< maximal response length (excluding terminator)
+	int result;															///< response length or -1 if response was not received
+} indigo_transaction_item;
+
+/** Discard pending input, wait up to timeout (in us) for late data.
+ */
+extern void indigo_flush_input(int handle, long timeout);
+
+/** Execute transaction - write all commands in a single write and read responses with buffered reads.
+    first_timeout (in us) applies to the first byte of each response, gap_timeout (in us) between subsequent bytes,
+    unterminated response is accepted if gap_timeout expires, terminator following response framed by length is consumed. Returns number of completed items or -1 on I/O error.
+ */
+extern int indigo_transaction(int handle, indigo_transaction_item *items, int count, char terminator, long first_timeout, long gap_timeout);
+
 /** Write formatted.
  */
 
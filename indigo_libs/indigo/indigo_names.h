@@ -622,6 +622,105 @@
  */
 #define CCD_RBI_FLUSH_DISABLED_ITEM_NAME     "DISABLED"
 
+//----------------------------------------------------------------------
+/** CCD_CALIBRATION property name.
+ */
+#define CCD_CALIBRATION_PROPERTY_NAME					"CCD_CALIBRATION"
+
+/** CCD_CALIBRATION.BIAS property item name.
+ */
+#define CCD_CALIBRATION_BIAS_ITEM_NAME				"BIAS"
+
+/** CCD_CALIBRATION.DARK property item name.
+ */
+#define CCD_CALIBRATION_DARK_ITEM_NAME				"DARK"
+
+/** CCD_CALIBRATION.FLAT property item name.
+ */
+#define CCD_CALIBRATION_FLAT_ITEM_NAME				"FLAT"
+
+//----------------------------------------------------------------------
+/** CCD_CALIBRATION_LIBRARY property name.
+ */
+#define CCD_CALIBRATION_LIBRARY_PROPERTY_NAME	"CCD_CALIBRATION_LIBRARY"
+
+/** CCD_CALIBRATION_LIBRARY.DIR property item name.
+ */
+#define CCD_CALIBRATION_LIBRARY_DIR_ITEM_NAME	"DIR"
+
+//----------------------------------------------------------------------
+/** CCD_BIN_MODE property name.
+ */
+#define CCD_BIN_MODE_PROPERTY_NAME						"CCD_BIN_MODE"
+
+/** CCD_BIN_MODE.SUM property item name.
+ */
+#define CCD_BIN_MODE_SUM_ITEM_NAME						"SUM"
+
+/** CCD_BIN_MODE.AVERAGE property item name.
+ */
+#define CCD_BIN_MODE_AVERAGE_ITEM_NAME				"AVERAGE"
+
+//----------------------------------------------------------------------
+/** CCD_JPEG_DEBAYER property name.
+ */
+#define CCD_JPEG_DEBAYER_PROPERTY_NAME				"CCD_JPEG_DEBAYER"
+
+/** CCD_JPEG_DEBAYER.NONE property item name.
+ */
+#define CCD_JPEG_DEBAYER_NONE_ITEM_NAME				"NONE"
+
+/** CCD_JPEG_DEBAYER.SUPERPIXEL property item name.
+ */
+#define CCD_JPEG_DEBAYER_SUPERPIXEL_ITEM_NAME	"SUPERPIXEL"
+
+/** CCD_JPEG_DEBAYER.BILINEAR property item name.
+ */
+#define CCD_JPEG_DEBAYER_BILINEAR_ITEM_NAME		"BILINEAR"
+
+//----------------------------------------------------------------------
+/** CCD_PREVIEW_TIERS property name.
+ */
+#define CCD_PREVIEW_TIERS_PROPERTY_NAME				"CCD_PREVIEW_TIERS"
+
+/** CCD_PREVIEW_TIERS.HALF property item name.
+ */
+#define CCD_PREVIEW_TIERS_HALF_ITEM_NAME			"HALF"
+
+/** CCD_PREVIEW_TIERS.QUARTER property item name.
+ */
+#define CCD_PREVIEW_TIERS_QUARTER_ITEM_NAME		"QUARTER"
+
+/** CCD_PREVIEW_TIERS.THUMBNAIL property item name.
+ */
+#define CCD_PREVIEW_TIERS_THUMBNAIL_ITEM_NAME	"THUMBNAIL"
+
+//----------------------------------------------------------------------
+/** CCD_PREVIEW_THUMBNAIL property name.
+ */
+#define CCD_PREVIEW_THUMBNAIL_PROPERTY_NAME		"CCD_PREVIEW_THUMBNAIL"
+
+/** CCD_PREVIEW_THUMBNAIL.SIZE property item name.
+ */
+#define CCD_PREVIEW_THUMBNAIL_SIZE_ITEM_NAME	"SIZE"
+
+//----------------------------------------------------------------------
+/** CCD_PREVIEW_HALF_IMAGE property name.
+ */
+#define CCD_PREVIEW_HALF_IMAGE_PROPERTY_NAME			"CCD_PREVIEW_HALF_IMAGE"
+
+/** CCD_PREVIEW_QUARTER_IMAGE property name.
+ */
+#define CCD_PREVIEW_QUARTER_IMAGE_PROPERTY_NAME		"CCD_PREVIEW_QUARTER_IMAGE"
+
+/** CCD_PREVIEW_THUMBNAIL_IMAGE property name.
+ */
+#define CCD_PREVIEW_THUMBNAIL_IMAGE_PROPERTY_NAME	"CCD_PREVIEW_THUMBNAIL_IMAGE"
+
+/** CCD_PREVIEW_HALF_IMAGE.IMAGE, CCD_PREVIEW_QUARTER_IMAGE.IMAGE and CCD_PREVIEW_THUMBNAIL_IMAGE.IMAGE property item name.
+ */
+#define CCD_PREVIEW_TIER_IMAGE_ITEM_NAME			"IMAGE"
+
 //----------------------------------------------------------------------
 /** DSLR_PROGRAM property name.
  */
@@ -2346,6 +2445,7 @@
 #define AGENT_GUIDER_START_CALIBRATION_ITEM_NAME 			"CALIBRATION"
 #define AGENT_GUIDER_START_CALIBRATION_AND_GUIDING_ITEM_NAME 	"CALIBRATION_AND_GUIDING"
 #define AGENT_GUIDER_START_GUIDING_ITEM_NAME 					"GUIDING"
+#define AGENT_GUIDER_START_DEFECT_MAP_ITEM_NAME 			"DEFECT_MAP"
 
 #define AGENT_PAUSE_PROCESS_PROPERTY_NAME							"AGENT_PAUSE_PROCESS"
 #define AGENT_PAUSE_PROCESS_ITEM_NAME      						"PAUSE"
@@ -2382,6 +2482,14 @@
 #define AGENT_GUIDER_DEC_MODE_SOUTH_ITEM_NAME    			"SOUTH"
 #define AGENT_GUIDER_DEC_MODE_NONE_ITEM_NAME    			"NONE"
 
+#define AGENT_GUIDER_DEFECT_MAP_PROPERTY_NAME					"AGENT_GUIDER_DEFECT_MAP"
+#define AGENT_GUIDER_DEFECT_MAP_ENABLED_ITEM_NAME			"ENABLED"
+#define AGENT_GUIDER_DEFECT_MAP_DISABLED_ITEM_NAME		"DISABLED"
+
+#define AGENT_GUIDER_PIPELINE_PROPERTY_NAME						"AGENT_GUIDER_PIPELINE"
+#define AGENT_GUIDER_PIPELINE_ENABLED_ITEM_NAME				"ENABLED"
+#define AGENT_GUIDER_PIPELINE_DISABLED_ITEM_NAME			"DISABLED"
+
 #define AGENT_GUIDER_SETTINGS_PROPERTY_NAME						"AGENT_GUIDER_SETTINGS"
 #define AGENT_GUIDER_SETTINGS_EXPOSURE_ITEM_NAME   		"EXPOSURE"
 #define AGENT_GUIDER_SETTINGS_DELAY_ITEM_NAME   			"DELAY"
@@ -2474,6 +2582,19 @@
 #define AGENT_IMAGER_STATS_HFD_ITEM_NAME							"HFD"
 #define AGENT_IMAGER_STATS_PEAK_ITEM_NAME							"PEAK"
 #define AGENT_IMAGER_STATS_DITHERING_ITEM_NAME				"DITHERING"
+#define AGENT_IMAGER_STATS_STACKED_ITEM_NAME					"STACKED"
+
+#define AGENT_IMAGER_STACK_PROPERTY_NAME							"AGENT_IMAGER_STACK"
+#define AGENT_IMAGER_STACK_DISABLED_ITEM_NAME					"DISABLED"
+#define AGENT_IMAGER_STACK_TRANSLATION_ITEM_NAME			"TRANSLATION"
+#define AGENT_IMAGER_STACK_ROTATION_ITEM_NAME					"ROTATION"
+
+#define AGENT_IMAGER_STACK_SETTINGS_PROPERTY_NAME			"AGENT_IMAGER_STACK_SETTINGS"
+#define AGENT_IMAGER_STACK_SETTINGS_SIGMA_ITEM_NAME		"SIGMA"
+#define AGENT_IMAGER_STACK_SETTINGS_REFRESH_ITEM_NAME	"REFRESH"
+
+#define AGENT_IMAGER_STACK_IMAGE_PROPERTY_NAME				"AGENT_IMAGER_STACK_IMAGE"
+#define AGENT_IMAGER_STACK_IMAGE_ITEM_NAME						"IMAGE"
 
 #define AGENT_ALIGNMENT_POINT_PROPERY_NAME						"AGENT_ALIGNMENT_POINT_%d"
 #define AGENT_ALIGNMENT_POINT_RA_ITEM_NAME   					"RA"
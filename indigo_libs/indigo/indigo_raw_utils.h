@@ -61,6 +61,37 @@ typedef struct {
 	double snr;
 } indigo_frame_digest;
 
+#define INDIGO_DEFECT_NEIGHBOURS 8
+
+typedef struct {
+	int x;                                      /* Defect X */
+	int y;                                      /* Defect Y */
+	int count;                                  /* Number of good neighbours */
+	signed char dx[INDIGO_DEFECT_NEIGHBOURS];   /* Good neighbour X offsets */
+	signed char dy[INDIGO_DEFECT_NEIGHBOURS];   /* Good neighbour Y offsets */
+} indigo_defect;
+
+typedef enum {
+	INDIGO_CFA_NONE = 0,
+	INDIGO_CFA_RGGB,
+	INDIGO_CFA_GRBG,
+	INDIGO_CFA_GBRG,
+	INDIGO_CFA_BGGR
+} indigo_cfa_pattern;
+
+typedef enum {
+	INDIGO_DEBAYER_SUPERPIXEL = 0,	/* RGB, half resolution, one output pixel per 2x2 cell */
+	INDIGO_DEBAYER_BILINEAR,				/* RGB, full resolution, bilinear interpolation */
+	INDIGO_DEBAYER_LUMINANCE				/* mono, full resolution, CFA independent low pass (pattern is not needed) */
+} indigo_debayer_mode;
+
+typedef struct {
+	int width;                /* Frame width the map was built for */
+	int height;               /* Frame height the map was built for */
+	int count;                /* Number of defects */
+	indigo_defect *defects;   /* Defect list sorted by Y and X */
+} indigo_defect_map;
+
 
 extern double indigo_stddev(double set[], const int count);
 extern double indigo_rmse(double set[], const int count);
@@ -71,13 +102,23 @@ extern indigo_result indigo_selection_psf(indigo_raw_type raw_type, const void *
 
 extern indigo_result indigo_selection_frame_digest(indigo_raw_type raw_type, const void *data, double *x, double *y, const int radius, const int width, const int height, indigo_frame_digest *digest);
 extern indigo_result indigo_selection_frame_digest_iterative(indigo_raw_type raw_type, const void *data, double *x, double *y, const int radius, const int width, const int height, indigo_frame_digest *digest, int converge_iterations);
+extern indigo_result indigo_selection_frame_digest_with_filter(indigo_raw_type raw_type, const void *data, double *x, double *y, const int radius, const int width, const int height, indigo_frame_digest *digest, const bool hot_pixel_filter);
+extern indigo_result indigo_selection_frame_digest_iterative_with_filter(indigo_raw_type raw_type, const void *data, double *x, double *y, const int radius, const int width, const int height, indigo_frame_digest *digest, int converge_iterations, const bool hot_pixel_filter);
 extern indigo_result indigo_reduce_multistar_digest(const indigo_frame_digest *avg_ref, const indigo_frame_digest ref[], const indigo_frame_digest new_digest[], const int count, indigo_frame_digest *digest);
 extern indigo_result indigo_centroid_frame_digest(indigo_raw_type raw_type, const void *data, const int width, const int height, indigo_frame_digest *digest);
 extern indigo_result indigo_donuts_frame_digest(indigo_raw_type raw_type, const void *data, const int width, const int height, const int border, indigo_frame_digest *digest);
+extern indigo_result indigo_donuts_frame_digest_with_filter(indigo_raw_type raw_type, const void *data, const int width, const int height, const int border, indigo_frame_digest *digest, const bool hot_pixel_filter);
 extern indigo_result indigo_calculate_drift(const indigo_frame_digest *ref, const indigo_frame_digest *new_digest, double *drift_x, double *drift_y);
 extern double indigo_guider_reponse(double p_gain, double i_gain, double guide_cycle_time, double drift, double avg_drift);
 extern indigo_result indigo_delete_frame_digest(indigo_frame_digest *fdigest);
 
+extern indigo_result indigo_make_defect_map(indigo_raw_type raw_type, const void *data, const int width, const int height, indigo_defect_map *map);
+extern indigo_result indigo_apply_defect_map(indigo_raw_type raw_type, void *data, const int left, const int top, const int width, const int height, const indigo_defect_map *map);
+extern indigo_result indigo_delete_defect_map(indigo_defect_map *map);
+
+extern indigo_cfa_pattern indigo_cfa_pattern_from_string(const char *pattern);
+extern indigo_result indigo_debayer(indigo_raw_type raw_type, const void *data, const int width, const int height, const indigo_cfa_pattern pattern, const indigo_debayer_mode mode, void *out, int *out_width, int *out_height);
+
 extern indigo_result indigo_raw_to_fists(char *image, char **fits, int *size);
 
 #ifdef __cplusplus
@@ -38,10 +38,25 @@ extern "C" {
 
 extern bool indigo_use_blob_urls;
 
+/** Remote property cache kept by client side adapter between connections to resync remote devices after reconnect.
+ */
+typedef struct {
+	int count;                          ///< allocated slots
+	indigo_property **properties;       ///< cached properties (NULL if slot is empty)
+} indigo_property_cache;
+
+/** Delete all properties kept in remote property cache and release them.
+ */
+extern void indigo_flush_property_cache(indigo_property_cache *cache);
+
 /** XML wire protocol parser.
  */
 extern void indigo_xml_parse(indigo_device *device, indigo_client *client);
 
+/** XML wire protocol parser reading from memory buffer instead of client input handle.
+ */
+extern void indigo_xml_parse_buffer(indigo_client *client, const char *buffer, long length);
+
 /** Escape XML string.
  */
 extern const char *indigo_xml_escape(const char *string);
@@ -30,6 +30,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <time.h>
 #include <math.h>
@@ -56,6 +57,7 @@
 #define MAX_DEVICES 256
 #define MAX_CLIENTS 256
 #define MAX_BLOBS	32
+#define DEVICE_BUCKETS	64
 
 #define BUFFER_SIZE	1024
 
@@ -63,6 +65,15 @@ static indigo_device *devices[MAX_DEVICES];
 static indigo_client *clients[MAX_CLIENTS];
 static indigo_blob_entry *blobs[MAX_BLOBS];
 
+/* Routing index of attached devices: local devices are hashed by name (slot + 1 in bucket heads and chains, 0 terminates),
+ * remote device adapters ('@' prefixed names) may forward any request and are kept in a separate list.
+ */
+static char device_index_names[MAX_DEVICES][INDIGO_NAME_SIZE];
+static int device_index_next[MAX_DEVICES];
+static int device_index_buckets[DEVICE_BUCKETS];
+static int device_forwarders[MAX_DEVICES];
+static int device_forwarder_count = 0;
+
 static pthread_mutex_t bus_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
 #define client_mutex bus_mutex
 #define device_mutex bus_mutex
@@ -70,6 +81,35 @@ static pthread_mutex_t bus_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER;
 bool indigo_use_strict_locking = true;
 
 static pthread_mutex_t blob_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t blob_content_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// cached BLOB content is reference counted, so in-process clients can hold it without copying
+
+typedef struct {
+	int reference_count;
+	long size;
+	long long data[];
+} blob_content;
+
+#define BLOB_CONTENT(content) ((blob_content *)((char *)(content) - offsetof(blob_content, data)))
+
+static void *blob_content_resize(void *content, long size) {
+	if (content != NULL) {
+		pthread_mutex_lock(&blob_content_mutex);
+		bool shared = BLOB_CONTENT(content)->reference_count > 1;
+		if (shared)
+			BLOB_CONTENT(content)->reference_count--;
+		pthread_mutex_unlock(&blob_content_mutex);
+		if (shared)
+			content = NULL;
+		else if (BLOB_CONTENT(content)->size == size)
+			return content;
+	}
+	blob_content *header = indigo_safe_realloc(content ? BLOB_CONTENT(content) : NULL, sizeof(blob_content) + size);
+	header->reference_count = 1;
+	header->size = size;
+	return header->data;
+}
 
 static bool is_started = false;
 
@@ -121,14 +161,12 @@ const char **indigo_main_argv = NULL;
 int indigo_main_argc = 0;
 
 #define LOG_MESSAGE_SIZE	(128 * 1024)
+#define LOG_RING_SIZE			(256 * 1024)	/* power of 2, holds at least one message of LOG_MESSAGE_SIZE */
+#define LOG_FLUSH_INTERVAL	100000			/* us */
 
 char *indigo_last_message = NULL;
 char indigo_log_name[255] = { 0 };
 
-static void free_log_buffers() {
-	indigo_safe_free(indigo_last_message);
-}
-
 #if defined(INDIGO_WINDOWS)
 
 // https://stackoverflow.com/questions/10905892/equivalent-of-gettimeday-for-windows
@@ -162,29 +200,23 @@ int clock_gettime(clockid_t clk_id, struct timespec *ts) {
 }
 #endif
 
-void indigo_log_message(const char *format, va_list args) {
-	static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
-	pthread_mutex_lock(&log_mutex);
-	if (indigo_last_message == NULL) {
-		indigo_last_message = indigo_safe_malloc(LOG_MESSAGE_SIZE);
-		atexit(free_log_buffers);
-	}
-	vsnprintf(indigo_last_message, LOG_MESSAGE_SIZE, format, args);
-	char *line = indigo_last_message;
+static void log_output(struct timeval *now, char *message) {
+	char *line = message;
 	if (indigo_log_message_handler != NULL) {
-		indigo_log_message_handler(indigo_last_message);
+		indigo_log_message_handler(message);
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
-  } else if (indigo_use_syslog) {
+	} else if (indigo_use_syslog) {
 		static bool initialize = true;
-		if (initialize)
+		if (initialize) {
 			openlog("INDIGO", LOG_NDELAY, LOG_USER | LOG_PERROR);
+			initialize = false;
+		}
 		while (line) {
 			char *eol = strchr(line, '\n');
 			if (eol)
 				*eol = 0;
-			if (eol > line)
-				syslog (LOG_NOTICE, "%s", indigo_last_message);
-			syslog (LOG_NOTICE, "%s", line);
+			if (*line)
+				syslog (LOG_NOTICE, "%s", line);
 			if (eol)
 				line = eol + 1;
 			else
@@ -193,25 +225,25 @@ void indigo_log_message(const char *format, va_list args) {
 #endif
 	} else {
 		char timestamp[16];
-		struct timeval tmnow;
-		gettimeofday(&tmnow, NULL);
 #if defined(INDIGO_WINDOWS)
 		struct tm *lt;
 		time_t rawtime;
-		lt = localtime((const time_t *) &(tmnow.tv_sec));
+		lt = localtime((const time_t *) &(now->tv_sec));
 		if (lt == NULL) {
 			time(&rawtime);
 			lt = localtime(&rawtime);
 		}
 		strftime (timestamp, 9, "%H:%M:%S", lt);
 #else
-		strftime (timestamp, 9, "%H:%M:%S", localtime((const time_t *) &tmnow.tv_sec));
+		struct tm lt;
+		time_t seconds = now->tv_sec;
+		strftime (timestamp, 9, "%H:%M:%S", localtime_r(&seconds, &lt));
 #endif
 
 #ifdef INDIGO_MACOS
-		snprintf(timestamp + 8, sizeof(timestamp) - 8, ".%06d", tmnow.tv_usec);
+		snprintf(timestamp + 8, sizeof(timestamp) - 8, ".%06d", now->tv_usec);
 #else
-		snprintf(timestamp + 8, sizeof(timestamp) - 8, ".%06ld", tmnow.tv_usec);
+		snprintf(timestamp + 8, sizeof(timestamp) - 8, ".%06ld", now->tv_usec);
 #endif
 		if (indigo_log_name[0] == '\0') {
 			if (indigo_main_argc == 0) {
@@ -242,13 +274,247 @@ void indigo_log_message(const char *format, va_list args) {
 				line = NULL;
 		}
 	}
+}
+
+#if defined(INDIGO_WINDOWS)
+
+static void free_log_buffers() {
+	indigo_safe_free(indigo_last_message);
+}
+
+static void log_message(const char *format, va_list args, bool synchronous) {
+	static pthread_mutex_t log_mutex = PTHREAD_MUTEX_INITIALIZER;
+	pthread_mutex_lock(&log_mutex);
+	if (indigo_last_message == NULL) {
+		indigo_last_message = indigo_safe_malloc(LOG_MESSAGE_SIZE);
+		atexit(free_log_buffers);
+	}
+	vsnprintf(indigo_last_message, LOG_MESSAGE_SIZE, format, args);
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	log_output(&now, indigo_last_message);
 	pthread_mutex_unlock(&log_mutex);
 }
 
+#else
+
+/* Every logging thread formats messages into its own ring buffer without any locking, single background thread
+ * merges the rings by timestamp and does the output. Messages not fitting into the ring are dropped and counted.
+ * Errors are written synchronously after the pending messages, so they are not lost if the process crashes.
+ */
+
+typedef struct {
+	struct timeval time;
+	uint32_t length;
+} log_record;
+
+#define LOG_RECORD_SIZE(length)	((sizeof(log_record) + (length) + 7) & ~7)
+
+typedef struct log_ring {
+	struct log_ring *next;
+	int owned;													// cleared when owner thread exits, ring is reused by next new thread
+	uint32_t head;											// written by owner thread only
+	uint32_t tail;											// written by flush thread only
+	unsigned long dropped;							// messages not fitting into the ring
+	char message[LOG_MESSAGE_SIZE];			// last message formatted by owner thread
+	char data[LOG_RING_SIZE];
+} log_ring;
+
+static log_ring *log_rings = NULL;
+static pthread_key_t log_ring_key;
+static pthread_once_t log_ring_key_once = PTHREAD_ONCE_INIT;
+static bool log_flush_thread_started = false;
+static bool log_synchronous = false;
+static bool log_flush_pending = false;
+static pthread_mutex_t log_flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t log_wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_wake_condition = PTHREAD_COND_INITIALIZER;
+static char log_flush_buffer[LOG_MESSAGE_SIZE];		// used under log_flush_mutex outside of flush thread
+
+static void release_log_ring(void *ring) {
+	__atomic_store_n(&((log_ring *)ring)->owned, 0, __ATOMIC_RELEASE);
+}
+
+static void log_fork_child(void) {
+	/* rings of other threads and pending messages belong to the parent process */
+	log_ring *own = pthread_getspecific(log_ring_key);
+	for (log_ring *ring = log_rings; ring != NULL; ring = ring->next) {
+		ring->tail = ring->head;
+		ring->dropped = 0;
+		ring->owned = ring == own;
+	}
+	pthread_mutex_init(&log_flush_mutex, NULL);
+	pthread_mutex_init(&log_wake_mutex, NULL);
+	pthread_cond_init(&log_wake_condition, NULL);
+	log_flush_thread_started = false;
+}
+
+static void flush_log_at_exit(void);
+
+static void create_log_ring_key(void) {
+	pthread_key_create(&log_ring_key, release_log_ring);
+	pthread_atfork(NULL, NULL, log_fork_child);
+	atexit(flush_log_at_exit);
+}
+
+static log_ring *get_log_ring(void) {
+	pthread_once(&log_ring_key_once, create_log_ring_key);
+	log_ring *ring = pthread_getspecific(log_ring_key);
+	if (ring == NULL) {
+		for (ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE); ring != NULL; ring = ring->next) {
+			int expected = 0;
+			if (__atomic_compare_exchange_n(&ring->owned, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+				break;
+		}
+		if (ring == NULL) {
+			ring = malloc(sizeof(log_ring));
+			assert(ring != NULL);
+			ring->owned = 1;
+			ring->head = ring->tail = 0;
+			ring->dropped = 0;
+			ring->next = __atomic_load_n(&log_rings, __ATOMIC_RELAXED);
+			while (!__atomic_compare_exchange_n(&log_rings, &ring->next, ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+				;
+		}
+		pthread_setspecific(log_ring_key, ring);
+	}
+	return ring;
+}
+
+static void ring_copy(log_ring *ring, uint32_t position, void *data, uint32_t length, bool write) {
+	uint32_t offset = position & (LOG_RING_SIZE - 1);
+	uint32_t chunk = LOG_RING_SIZE - offset < length ? LOG_RING_SIZE - offset : length;
+	if (write) {
+		memcpy(ring->data + offset, data, chunk);
+		memcpy(ring->data, (char *)data + chunk, length - chunk);
+	} else {
+		memcpy(data, ring->data + offset, chunk);
+		memcpy((char *)data + chunk, ring->data, length - chunk);
+	}
+}
+
+static bool flush_log(char *message) {
+	bool flushed = false;
+	while (true) {
+		log_ring *oldest = NULL;
+		log_record record, oldest_record;
+		for (log_ring *ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE); ring != NULL; ring = ring->next) {
+			if (ring->tail != __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+				ring_copy(ring, ring->tail, &record, sizeof(record), false);
+				if (oldest == NULL || timercmp(&record.time, &oldest_record.time, <)) {
+					oldest = ring;
+					oldest_record = record;
+				}
+			}
+		}
+		if (oldest == NULL)
+			break;
+		ring_copy(oldest, oldest->tail + sizeof(log_record), message, oldest_record.length + 1, false);
+		__atomic_store_n(&oldest->tail, oldest->tail + LOG_RECORD_SIZE(oldest_record.length + 1), __ATOMIC_RELEASE);
+		log_output(&oldest_record.time, message);
+		flushed = true;
+	}
+	for (log_ring *ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE); ring != NULL; ring = ring->next) {
+		unsigned long dropped = __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+		if (dropped) {
+			struct timeval now;
+			gettimeofday(&now, NULL);
+			snprintf(message, LOG_MESSAGE_SIZE, "Log buffer overflow, %lu messages dropped", dropped);
+			log_output(&now, message);
+		}
+	}
+	return flushed;
+}
+
+static void *log_flush_thread(void *arg) {
+	char *message = indigo_safe_malloc(LOG_MESSAGE_SIZE);
+	while (true) {
+		pthread_mutex_lock(&log_wake_mutex);
+		if (!log_flush_pending) {
+			struct timespec timeout;
+			clock_gettime(CLOCK_REALTIME, &timeout);
+			timeout.tv_nsec += LOG_FLUSH_INTERVAL * 1000;
+			if (timeout.tv_nsec >= 1000000000) {
+				timeout.tv_sec++;
+				timeout.tv_nsec -= 1000000000;
+			}
+			pthread_cond_timedwait(&log_wake_condition, &log_wake_mutex, &timeout);
+		}
+		log_flush_pending = false;
+		pthread_mutex_unlock(&log_wake_mutex);
+		pthread_mutex_lock(&log_flush_mutex);
+		flush_log(message);
+		pthread_mutex_unlock(&log_flush_mutex);
+	}
+	return NULL;
+}
+
+static void flush_log_at_exit(void) {
+	pthread_mutex_lock(&log_flush_mutex);
+	__atomic_store_n(&log_synchronous, true, __ATOMIC_RELEASE);
+	flush_log(log_flush_buffer);
+	pthread_mutex_unlock(&log_flush_mutex);
+}
+
+static void log_message(const char *format, va_list args, bool synchronous) {
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	log_ring *ring = get_log_ring();
+	int length = vsnprintf(ring->message, LOG_MESSAGE_SIZE, format, args);
+	if (length < 0)
+		length = 0;
+	else if (length >= LOG_MESSAGE_SIZE)
+		length = LOG_MESSAGE_SIZE - 1;
+	__atomic_store_n(&indigo_last_message, ring->message, __ATOMIC_RELAXED);
+	if (!__atomic_load_n(&log_flush_thread_started, __ATOMIC_ACQUIRE)) {
+		pthread_mutex_lock(&log_wake_mutex);
+		if (!log_flush_thread_started) {
+			pthread_t thread;
+			if (pthread_create(&thread, NULL, log_flush_thread, NULL) == 0) {
+				pthread_detach(thread);
+				__atomic_store_n(&log_flush_thread_started, true, __ATOMIC_RELEASE);
+			} else {
+				__atomic_store_n(&log_synchronous, true, __ATOMIC_RELEASE);
+			}
+		}
+		pthread_mutex_unlock(&log_wake_mutex);
+	}
+	if (synchronous || __atomic_load_n(&log_synchronous, __ATOMIC_ACQUIRE)) {
+		pthread_mutex_lock(&log_flush_mutex);
+		flush_log(log_flush_buffer);
+		log_output(&now, ring->message);
+		pthread_mutex_unlock(&log_flush_mutex);
+		return;
+	}
+	uint32_t size = LOG_RECORD_SIZE(length + 1);
+	uint32_t head = ring->head;
+	uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	if (LOG_RING_SIZE - (head - tail) < size) {
+		__atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+		return;
+	}
+	log_record record = { now, length };
+	ring_copy(ring, head, &record, sizeof(record), true);
+	ring_copy(ring, head + sizeof(record), ring->message, length + 1, true);
+	__atomic_store_n(&ring->head, head + size, __ATOMIC_RELEASE);
+	if (head == tail) {
+		pthread_mutex_lock(&log_wake_mutex);
+		log_flush_pending = true;
+		pthread_cond_signal(&log_wake_condition);
+		pthread_mutex_unlock(&log_wake_mutex);
+	}
+}
+
+#endif
+
+void indigo_log_message(const char *format, va_list args) {
+	log_message(format, args, false);
+}
+
 void indigo_error(const char *format, ...) {
 	va_list argList;
 	va_start(argList, format);
-	indigo_log_message(format, argList);
+	log_message(format, argList, true);
 	va_end(argList);
 }
 
@@ -361,6 +627,9 @@ indigo_result indigo_start() {
 	INDIGO_TRACE(indigo_trace("INDIGO Bus: start request"));
 	if (!is_started) {
 		memset(devices, 0, MAX_DEVICES * sizeof(indigo_device *));
+		memset(device_index_names, 0, sizeof(device_index_names));
+		memset(device_index_buckets, 0, sizeof(device_index_buckets));
+		device_forwarder_count = 0;
 		memset(clients, 0, MAX_CLIENTS * sizeof(indigo_client *));
 		memset(blobs, 0, MAX_BLOBS * sizeof(indigo_property *));
 		memset(&INDIGO_ALL_PROPERTIES, 0, sizeof(INDIGO_ALL_PROPERTIES));
@@ -376,6 +645,75 @@ indigo_result indigo_start() {
 	return INDIGO_OK;
 }
 
+static int device_bucket(const char *name) {
+	uint32_t hash = 2166136261u;
+	while (*name)
+		hash = (hash ^ (unsigned char)*name++) * 16777619u;
+	return hash % DEVICE_BUCKETS;
+}
+
+static void index_device(int slot) {
+	indigo_device *device = devices[slot];
+	indigo_copy_name(device_index_names[slot], device->name);
+	if (*device->name == '@') {
+		device_forwarders[device_forwarder_count++] = slot;
+	} else {
+		int *bucket = device_index_buckets + device_bucket(device->name);
+		device_index_next[slot] = *bucket;
+		*bucket = slot + 1;
+	}
+}
+
+static void unindex_device(int slot) {
+	if (*device_index_names[slot] == '@') {
+		for (int i = 0; i < device_forwarder_count; i++) {
+			if (device_forwarders[i] == slot) {
+				memmove(device_forwarders + i, device_forwarders + i + 1, (--device_forwarder_count - i) * sizeof(int));
+				break;
+			}
+		}
+	} else {
+		for (int *link = device_index_buckets + device_bucket(device_index_names[slot]); *link; link = device_index_next + *link - 1) {
+			if (*link == slot + 1) {
+				*link = device_index_next[slot];
+				break;
+			}
+		}
+	}
+	*device_index_names[slot] = 0;
+}
+
+static int compare_slots(const void *a, const void *b) {
+	return *(const int *)a - *(const int *)b;
+}
+
+/* Collect devices the request for given device name should be routed to, in slot order (device_mutex must be locked). */
+static int route_request(const char *name, indigo_device **targets) {
+	int slots[MAX_DEVICES];
+	int count = 0;
+	if (*name == 0) {
+		for (int i = 0; i < MAX_DEVICES; i++) {
+			if (devices[i] != NULL)
+				targets[count++] = devices[i];
+		}
+		return count;
+	}
+	for (int slot = device_index_buckets[device_bucket(name)]; slot; slot = device_index_next[slot - 1]) {
+		if (!strcmp(name, device_index_names[slot - 1]))
+			slots[count++] = slot - 1;
+	}
+	for (int i = 0; i < device_forwarder_count; i++) {
+		int slot = device_forwarders[i];
+		if (!indigo_use_host_suffix || strstr(name, device_index_names[slot]))
+			slots[count++] = slot;
+	}
+	if (count > 1)
+		qsort(slots, count, sizeof(int), compare_slots);
+	for (int i = 0; i < count; i++)
+		targets[i] = devices[slots[i]];
+	return count;
+}
+
 indigo_result indigo_attach_device(indigo_device *device) {
 	static int max_index = -1;
 	if ((!is_started) || (device == NULL))
@@ -389,6 +727,7 @@ indigo_result indigo_attach_device(indigo_device *device) {
 				indigo_debug("%d devices attached", max_index + 1);
 			}
 			devices[i] = device;
+			index_device(i);
 			pthread_mutex_unlock(&device_mutex);
 			device->access_token = 0;
 			if (device->attach != NULL)
@@ -400,6 +739,10 @@ indigo_result indigo_attach_device(indigo_device *device) {
 				indigo_release_property(property);
 			}
 			pthread_mutex_lock(&device_mutex);
+			if (devices[i] == device && strcmp(device_index_names[i], device->name)) {
+				unindex_device(i);
+				index_device(i);
+			}
 			device->access_token = indigo_get_device_token(device->name);
 			pthread_mutex_unlock(&device_mutex);
 			return INDIGO_OK;
@@ -442,6 +785,7 @@ indigo_result indigo_detach_device(indigo_device *device) {
 	for (int i = 0; i < MAX_DEVICES; i++) {
 		if (devices[i] == device) {
 			devices[i] = NULL;
+			unindex_device(i);
 			pthread_mutex_unlock(&device_mutex);
 			if (device->detach != NULL)
 				device->last_result = device->detach(device);
@@ -470,24 +814,35 @@ indigo_result indigo_detach_client(indigo_client *client) {
 	return INDIGO_OK;
 }
 
+bool indigo_is_client_attached(indigo_client *client) {
+	bool result = false;
+	pthread_mutex_lock(&client_mutex);
+	for (int i = 0; i < MAX_CLIENTS; i++) {
+		if (clients[i] == client) {
+			result = true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&client_mutex);
+	return result;
+}
+
 indigo_result indigo_enumerate_properties(indigo_client *client, indigo_property *property) {
 	if (!is_started)
 		return INDIGO_FAILED;
-	if (indigo_use_strict_locking)
-		pthread_mutex_lock(&device_mutex);
+	bool strict_locking = indigo_use_strict_locking;
 	INDIGO_TRACE(indigo_trace_property("INDIGO Bus: property enumeration request", property, false, false));
-	for (int i = 0; i < MAX_DEVICES; i++) {
-		indigo_device *device = devices[i];
-		if (device != NULL && device->enumerate_properties != NULL) {
-			bool route = *property->device == 0;
-			route = route || !strcmp(property->device, device->name);
-			route = route || (indigo_use_host_suffix && *device->name == '@' && strstr(property->device, device->name));
-			route = route || (!indigo_use_host_suffix && *device->name == '@');
-			if (route)
-				device->last_result = device->enumerate_properties(device, client, property);
-		}
+	indigo_device *targets[MAX_DEVICES];
+	pthread_mutex_lock(&device_mutex);
+	int count = route_request(property->device, targets);
+	if (!strict_locking)
+		pthread_mutex_unlock(&device_mutex);
+	for (int i = 0; i < count; i++) {
+		indigo_device *device = targets[i];
+		if (device->enumerate_properties != NULL)
+			device->last_result = device->enumerate_properties(device, client, property);
 	}
-	if (indigo_use_strict_locking)
+	if (strict_locking)
 		pthread_mutex_unlock(&device_mutex);
 	return INDIGO_OK;
 }
@@ -495,27 +850,25 @@ indigo_result indigo_enumerate_properties(indigo_client *client, indigo_property
 indigo_result indigo_change_property(indigo_client *client, indigo_property *property) {
 	if ((!is_started) || (property == NULL))
 		return INDIGO_FAILED;
-	if (indigo_use_strict_locking)
-		pthread_mutex_lock(&device_mutex);
+	bool strict_locking = indigo_use_strict_locking;
 	INDIGO_TRACE(indigo_trace_property("INDIGO Bus: property change request", property, false, true));
-	for (int i = 0; i < MAX_DEVICES; i++) {
-		indigo_device *device = devices[i];
-		if (device != NULL && device->change_property != NULL) {
-			bool route = *property->device == 0;
-			route = route || !strcmp(property->device, device->name);
-			route = route || (indigo_use_host_suffix && *device->name == '@' && strstr(property->device, device->name));
-			route = route || (!indigo_use_host_suffix && *device->name == '@');
-			if (route) {
-				INDIGO_TRACE(indigo_trace("INDIGO Bus: Change request - Device '%s' token 0x%x, Proprerty '%s' token 0x%x", device->name, device->access_token, property->name, property->access_token));
-				if (device->access_token != 0 && device->access_token != property->access_token && property->access_token != indigo_get_master_token()) {
-					indigo_send_message(device, "Device '%s' is protected or locked for exclusive access", device->name);
-					continue;
-				}
-				device->last_result = device->change_property(device, client, property);
+	indigo_device *targets[MAX_DEVICES];
+	pthread_mutex_lock(&device_mutex);
+	int count = route_request(property->device, targets);
+	if (!strict_locking)
+		pthread_mutex_unlock(&device_mutex);
+	for (int i = 0; i < count; i++) {
+		indigo_device *device = targets[i];
+		if (device->change_property != NULL) {
+			INDIGO_TRACE(indigo_trace("INDIGO Bus: Change request - Device '%s' token 0x%x, Proprerty '%s' token 0x%x", device->name, device->access_token, property->name, property->access_token));
+			if (device->access_token != 0 && device->access_token != property->access_token && property->access_token != indigo_get_master_token()) {
+				indigo_send_message(device, "Device '%s' is protected or locked for exclusive access", device->name);
+				continue;
 			}
+			device->last_result = device->change_property(device, client, property);
 		}
 	}
-	if (indigo_use_strict_locking)
+	if (strict_locking)
 		pthread_mutex_unlock(&device_mutex);
 	return INDIGO_OK;
 }
@@ -523,21 +876,19 @@ indigo_result indigo_change_property(indigo_client *client, indigo_property *pro
 indigo_result indigo_enable_blob(indigo_client *client, indigo_property *property, indigo_enable_blob_mode mode) {
 	if ((!is_started) || (property == NULL))
 		return INDIGO_FAILED;
-	if (indigo_use_strict_locking)
-		pthread_mutex_lock(&device_mutex);
+	bool strict_locking = indigo_use_strict_locking;
 	INDIGO_TRACE(indigo_trace_property("INDIGO Bus: enable BLOB mode change request", property, false, true));
-	for (int i = 0; i < MAX_DEVICES; i++) {
-		indigo_device *device = devices[i];
-		if (device != NULL && device->enable_blob != NULL) {
-			bool route = *property->device == 0;
-			route = route || !strcmp(property->device, device->name);
-			route = route || (indigo_use_host_suffix && *device->name == '@' && strstr(property->device, device->name));
-			route = route || (!indigo_use_host_suffix && *device->name == '@');
-			if (route)
-				device->last_result = device->enable_blob(device, client, property, mode);
-		}
+	indigo_device *targets[MAX_DEVICES];
+	pthread_mutex_lock(&device_mutex);
+	int count = route_request(property->device, targets);
+	if (!strict_locking)
+		pthread_mutex_unlock(&device_mutex);
+	for (int i = 0; i < count; i++) {
+		indigo_device *device = targets[i];
+		if (device->enable_blob != NULL)
+			device->last_result = device->enable_blob(device, client, property, mode);
 	}
-	if (indigo_use_strict_locking)
+	if (strict_locking)
 		pthread_mutex_unlock(&device_mutex);
 	return INDIGO_OK;
 }
@@ -609,11 +960,11 @@ indigo_result indigo_update_property(indigo_device *device, indigo_property *pro
 				if (entry) {
 					pthread_mutex_lock(&entry->mutext);
 					if (item->blob.size) {
-						entry->content = indigo_safe_realloc(entry->content, entry->size = item->blob.size);
+						entry->content = blob_content_resize(entry->content, entry->size = item->blob.size);
 						memcpy(entry->content, item->blob.value, entry->size);
 						strcpy(entry->format, item->blob.format);
 					} else if (entry->content) {
-						free(entry->content);
+						indigo_release_blob_content(entry->content);
 						entry->size = 0;
 						entry->content = NULL;
 					}
@@ -710,6 +1061,122 @@ indigo_result indigo_stop() {
 	return INDIGO_OK;
 }
 
+#define INTERNED_STRINGS_BUCKETS	1024
+
+typedef struct interned_string {
+	struct interned_string *next;
+	uint32_t hash;
+	int references;
+	char value[];
+} interned_string;
+
+#define INTERNED_STRING(string) ((interned_string *)((char *)(string) - offsetof(interned_string, value)))
+
+static interned_string *interned_strings[INTERNED_STRINGS_BUCKETS];
+static pthread_mutex_t interned_strings_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+const char *indigo_intern_string(const char *string) {
+	static const char *empty = "";
+	if (string == NULL || *string == 0)
+		return empty;
+	size_t length = strnlen(string, INDIGO_VALUE_SIZE - 1);
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++)
+		hash = (hash ^ (unsigned char)string[i]) * 16777619u;
+	pthread_mutex_lock(&interned_strings_mutex);
+	interned_string **bucket = interned_strings + (hash % INTERNED_STRINGS_BUCKETS);
+	for (interned_string *entry = *bucket; entry; entry = entry->next) {
+		if (entry->hash == hash && !strncmp(entry->value, string, length) && entry->value[length] == 0) {
+			entry->references++;
+			pthread_mutex_unlock(&interned_strings_mutex);
+			return entry->value;
+		}
+	}
+	interned_string *entry = indigo_safe_malloc(sizeof(interned_string) + length + 1);
+	entry->hash = hash;
+	entry->references = 1;
+	memcpy(entry->value, string, length);
+	entry->next = *bucket;
+	*bucket = entry;
+	pthread_mutex_unlock(&interned_strings_mutex);
+	return entry->value;
+}
+
+const char *indigo_find_interned_string(const char *string) {
+	if (string == NULL || *string == 0)
+		return NULL;
+	size_t length = strnlen(string, INDIGO_VALUE_SIZE - 1);
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++)
+		hash = (hash ^ (unsigned char)string[i]) * 16777619u;
+	const char *result = NULL;
+	pthread_mutex_lock(&interned_strings_mutex);
+	for (interned_string *entry = interned_strings[hash % INTERNED_STRINGS_BUCKETS]; entry; entry = entry->next) {
+		if (entry->hash == hash && !strncmp(entry->value, string, length) && entry->value[length] == 0) {
+			result = entry->value;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&interned_strings_mutex);
+	return result;
+}
+
+static void retain_string(const char *string) {
+	if (string == NULL || *string == 0)
+		return;
+	pthread_mutex_lock(&interned_strings_mutex);
+	INTERNED_STRING(string)->references++;
+	pthread_mutex_unlock(&interned_strings_mutex);
+}
+
+void indigo_release_string(const char *string) {
+	if (string == NULL || *string == 0)
+		return;
+	interned_string *entry = INTERNED_STRING(string);
+	pthread_mutex_lock(&interned_strings_mutex);
+	if (--entry->references == 0) {
+		interned_string **link = interned_strings + (entry->hash % INTERNED_STRINGS_BUCKETS);
+		while (*link != entry)
+			link = &(*link)->next;
+		*link = entry->next;
+		free(entry);
+	}
+	pthread_mutex_unlock(&interned_strings_mutex);
+}
+
+void indigo_retain_item_strings(indigo_item *items, int count) {
+	for (int i = 0; i < count; i++) {
+		retain_string(items[i].label);
+		retain_string(items[i].hints);
+	}
+}
+
+void indigo_release_item_strings(indigo_item *items, int count) {
+	for (int i = 0; i < count; i++) {
+		indigo_release_string(items[i].label);
+		indigo_release_string(items[i].hints);
+		items[i].label = items[i].hints = indigo_intern_string(NULL);
+	}
+}
+
+void indigo_set_item_label(indigo_item *item, const char *label) {
+	const char *previous = item->label;
+	item->label = indigo_intern_string(label);
+	indigo_release_string(previous);
+}
+
+void indigo_set_item_hints(indigo_item *item, const char *hints) {
+	const char *previous = item->hints;
+	item->hints = indigo_intern_string(hints);
+	indigo_release_string(previous);
+}
+
+static void init_items(indigo_item *items, int count) {
+	const char *empty = indigo_intern_string(NULL);
+	for (int i = 0; i < count; i++)
+		items[i].label = items[i].hints = empty;
+}
+
 indigo_property *indigo_init_text_property(indigo_property *property, const char *device, const char *name, const char *group, const char *label, indigo_property_state state, indigo_property_perm perm, int count) {
 	assert(device != NULL);
 	assert(name != NULL);
@@ -717,6 +1184,7 @@ indigo_property *indigo_init_text_property(indigo_property *property, const char
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		indigo_release_item_strings(property->items, property->count);
 		indigo_resize_property(property, count);
 	}
 	memset(property, 0, size);
@@ -724,6 +1192,7 @@ indigo_property *indigo_init_text_property(indigo_property *property, const char
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
 	indigo_copy_value(property->label, label ? label : "");
+	init_items(property->items, count);
 	property->type = INDIGO_TEXT_VECTOR;
 	property->state = state;
 	property->perm = perm;
@@ -739,6 +1208,7 @@ indigo_property *indigo_init_number_property(indigo_property *property, const ch
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		indigo_release_item_strings(property->items, property->count);
 		indigo_resize_property(property, count);
 	}
 	memset(property, 0, size);
@@ -746,6 +1216,7 @@ indigo_property *indigo_init_number_property(indigo_property *property, const ch
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
 	indigo_copy_value(property->label, label ? label : "");
+	init_items(property->items, count);
 	property->type = INDIGO_NUMBER_VECTOR;
 	property->state = state;
 	property->perm = perm;
@@ -761,6 +1232,7 @@ indigo_property *indigo_init_switch_property(indigo_property *property, const ch
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		indigo_release_item_strings(property->items, property->count);
 		indigo_resize_property(property, count);
 	}
 	memset(property, 0, size);
@@ -768,6 +1240,7 @@ indigo_property *indigo_init_switch_property(indigo_property *property, const ch
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
 	indigo_copy_value(property->label, label ? label : "");
+	init_items(property->items, count);
 	property->type = INDIGO_SWITCH_VECTOR;
 	property->state = state;
 	property->perm = perm;
@@ -784,6 +1257,7 @@ indigo_property *indigo_init_light_property(indigo_property *property, const cha
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		indigo_release_item_strings(property->items, property->count);
 		indigo_resize_property(property, count);
 	}
 	memset(property, 0, size);
@@ -791,6 +1265,7 @@ indigo_property *indigo_init_light_property(indigo_property *property, const cha
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
 	indigo_copy_value(property->label, label ? label : "");
+	init_items(property->items, count);
 	property->type = INDIGO_LIGHT_VECTOR;
 	property->perm = INDIGO_RO_PERM;
 	property->state = state;
@@ -806,6 +1281,7 @@ indigo_property *indigo_init_blob_property(indigo_property *property, const char
 	if (property == NULL) {
 		property = indigo_safe_malloc(size);
 	} else {
+		indigo_release_item_strings(property->items, property->count);
 		indigo_resize_property(property, count);
 	}
 	memset(property, 0, size);
@@ -813,6 +1289,7 @@ indigo_property *indigo_init_blob_property(indigo_property *property, const char
 	indigo_copy_name(property->name, name);
 	indigo_copy_name(property->group, group ? group : "");
 	indigo_copy_value(property->label, label ? label : "");
+	init_items(property->items, count);
 	property->type = INDIGO_BLOB_VECTOR;
 	property->perm = INDIGO_RO_PERM;
 	property->state = state;
@@ -825,10 +1302,14 @@ indigo_property *indigo_resize_property(indigo_property *property, int count) {
 	assert(property != NULL);
 	if (property->count == count)
 		return property;
+	if (count < property->count)
+		indigo_release_item_strings(property->items + count, property->count - count);
 	property = indigo_safe_realloc(property, sizeof(indigo_property) + count * sizeof(indigo_item));
 	assert(property != NULL);
-	if (count > property->count)
+	if (count > property->count) {
 		memset(property->items+property->count, 0, (count - property->count) * sizeof(indigo_item));
+		init_items(property->items + property->count, count - property->count);
+	}
 	property->count = count;
 	return property;
 }
@@ -845,7 +1326,7 @@ void indigo_release_property(indigo_property *property) {
 				if (entry && entry->item == item) {
 					pthread_mutex_lock(&entry->mutext);
 					blobs[j] = NULL;
-					indigo_safe_free(entry->content);
+					indigo_release_blob_content(entry->content);
 					pthread_mutex_unlock(&entry->mutext);
 					pthread_mutex_destroy(&entry->mutext);
 					indigo_safe_free(entry);
@@ -858,6 +1339,7 @@ void indigo_release_property(indigo_property *property) {
 		for (int i = 0; i < property->count; i++)
 			indigo_safe_free(property->items[i].text.long_value);
 	}
+	indigo_release_item_strings(property->items, property->count);
 	free(property);
 }
 
@@ -870,12 +1352,48 @@ indigo_blob_entry *indigo_validate_blob(indigo_item *item) {
 	return NULL;
 }
 
+void *indigo_alloc_blob_content(long size) {
+	return blob_content_resize(NULL, size);
+}
+
+void *indigo_retain_blob_content(indigo_item *item, long *size) {
+	void *content = NULL;
+	pthread_mutex_lock(&blob_mutex);
+	indigo_blob_entry *entry = indigo_validate_blob(item);
+	if (entry) {
+		pthread_mutex_lock(&entry->mutext);
+		if ((content = entry->content)) {
+			pthread_mutex_lock(&blob_content_mutex);
+			BLOB_CONTENT(content)->reference_count++;
+			pthread_mutex_unlock(&blob_content_mutex);
+			if (size)
+				*size = entry->size;
+		}
+		pthread_mutex_unlock(&entry->mutext);
+	}
+	pthread_mutex_unlock(&blob_mutex);
+	return content;
+}
+
+void indigo_release_blob_content(void *content) {
+	if (content == NULL)
+		return;
+	pthread_mutex_lock(&blob_content_mutex);
+	bool last = --BLOB_CONTENT(content)->reference_count == 0;
+	pthread_mutex_unlock(&blob_content_mutex);
+	if (last)
+		free(BLOB_CONTENT(content));
+}
+
 void indigo_init_text_item(indigo_item *item, const char *name, const char *label, const char *format, ...) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *interned_label = indigo_intern_string(label);
+	indigo_release_item_strings(item, 1);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = interned_label;
+	item->hints = indigo_intern_string(NULL);
 	va_list args;
 	va_start(args, format);
 	vsnprintf(item->text.value, INDIGO_VALUE_SIZE, format, args);
@@ -885,18 +1403,24 @@ void indigo_init_text_item(indigo_item *item, const char *name, const char *labe
 void indigo_init_text_item_raw(indigo_item *item, const char *name, const char *label, const char *value) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *interned_label = indigo_intern_string(label);
+	indigo_release_item_strings(item, 1);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = interned_label;
+	item->hints = indigo_intern_string(NULL);
 	indigo_set_text_item_value(item, value);
 }
 
 void indigo_init_number_item(indigo_item *item, const char *name, const char *label, double min, double max, double step, double value) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *interned_label = indigo_intern_string(label);
+	indigo_release_item_strings(item, 1);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = interned_label;
+	item->hints = indigo_intern_string(NULL);
 	indigo_copy_value(item->number.format, "%g");
 	item->number.min = min;
 	item->number.max = max;
@@ -907,27 +1431,36 @@ void indigo_init_number_item(indigo_item *item, const char *name, const char *la
 void indigo_init_switch_item(indigo_item *item, const char *name, const char *label, bool value) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *interned_label = indigo_intern_string(label);
+	indigo_release_item_strings(item, 1);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = interned_label;
+	item->hints = indigo_intern_string(NULL);
 	item->sw.value = value;
 }
 
 void indigo_init_light_item(indigo_item *item, const char *name, const char *label, indigo_property_state value) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *interned_label = indigo_intern_string(label);
+	indigo_release_item_strings(item, 1);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = interned_label;
+	item->hints = indigo_intern_string(NULL);
 	item->light.value = value;
 }
 
 void indigo_init_blob_item(indigo_item *item, const char *name, const char *label) {
 	assert(item != NULL);
 	assert(name != NULL);
+	const char *interned_label = indigo_intern_string(label);
+	indigo_release_item_strings(item, 1);
 	memset(item, 0, sizeof(indigo_item));
 	indigo_copy_name(item->name, name);
-	indigo_copy_value(item->label, label ? label : "");
+	item->label = interned_label;
+	item->hints = indigo_intern_string(NULL);
 }
 
 void *indigo_alloc_blob_buffer(long size) {
@@ -1237,6 +1770,118 @@ void indigo_set_text_item_value(indigo_item *item, const char *value) {
 	}
 }
 
+#define SENT_VALUES_BUCKETS	256
+
+typedef struct sent_values {
+	struct sent_values *next;
+	char device[INDIGO_NAME_SIZE];
+	char name[INDIGO_NAME_SIZE];
+	int count;
+	uint64_t fingerprints[];
+} sent_values;
+
+static uint64_t fingerprint(const void *data, size_t size, uint64_t hash) {
+	for (size_t i = 0; i < size; i++)
+		hash = (hash ^ ((unsigned char *)data)[i]) * 1099511628211u;
+	return hash;
+}
+
+static uint64_t item_fingerprint(indigo_property *property, indigo_item *item) {
+	uint64_t hash = 14695981039346656037u;
+	switch (property->type) {
+		case INDIGO_TEXT_VECTOR: {
+			char *value = indigo_get_text_item_value(item);
+			return fingerprint(value, strlen(value), hash);
+		}
+		case INDIGO_NUMBER_VECTOR:
+			hash = fingerprint(&item->number.value, sizeof(double), hash);
+			return fingerprint(&item->number.target, sizeof(double), hash);
+		case INDIGO_SWITCH_VECTOR:
+			return item->sw.value;
+		case INDIGO_LIGHT_VECTOR:
+			return item->light.value;
+		default:
+			return 0;
+	}
+}
+
+static sent_values **sent_values_bucket(indigo_adapter_context *context, indigo_property *property) {
+	if (context->sent_values == NULL)
+		context->sent_values = indigo_safe_malloc(SENT_VALUES_BUCKETS * sizeof(sent_values *));
+	uint64_t hash = fingerprint(property->device, strlen(property->device), 14695981039346656037u);
+	hash = fingerprint(property->name, strlen(property->name), hash);
+	return (sent_values **)context->sent_values + (hash % SENT_VALUES_BUCKETS);
+}
+
+static sent_values *find_sent_values(sent_values **bucket, indigo_property *property) {
+	for (sent_values *values = *bucket; values; values = values->next) {
+		if (!strcmp(values->name, property->name) && !strcmp(values->device, property->device))
+			return values;
+	}
+	return NULL;
+}
+
+void indigo_track_sent_values(indigo_adapter_context *context, indigo_property *property) {
+	if (!context->delta_updates || property->type == INDIGO_BLOB_VECTOR)
+		return;
+	sent_values **bucket = sent_values_bucket(context, property);
+	sent_values *values = find_sent_values(bucket, property);
+	if (values == NULL || values->count < property->count) {
+		indigo_forget_sent_values(context, property);
+		values = indigo_safe_malloc(sizeof(sent_values) + property->count * sizeof(uint64_t));
+		indigo_copy_name(values->device, property->device);
+		indigo_copy_name(values->name, property->name);
+		values->next = *bucket;
+		*bucket = values;
+	}
+	values->count = property->count;
+	for (int i = 0; i < property->count; i++)
+		values->fingerprints[i] = item_fingerprint(property, property->items + i);
+}
+
+int indigo_select_changed_items(indigo_adapter_context *context, indigo_property *property, bool *changed) {
+	sent_values *values = NULL;
+	if (context->delta_updates && property->type != INDIGO_BLOB_VECTOR)
+		values = find_sent_values(sent_values_bucket(context, property), property);
+	if (values == NULL || values->count != property->count) {
+		for (int i = 0; i < property->count; i++)
+			changed[i] = true;
+		indigo_track_sent_values(context, property);
+		return property->count;
+	}
+	/* receiver resets switches of OneOfMany and AtMostOne properties, so items turned on are always sent */
+	bool send_on = property->type == INDIGO_SWITCH_VECTOR && property->rule != INDIGO_ANY_OF_MANY_RULE;
+	int count = 0;
+	for (int i = 0; i < property->count; i++) {
+		uint64_t value = item_fingerprint(property, property->items + i);
+		if ((changed[i] = values->fingerprints[i] != value || (send_on && property->items[i].sw.value)))
+			count++;
+		values->fingerprints[i] = value;
+	}
+	return count;
+}
+
+void indigo_forget_sent_values(indigo_adapter_context *context, indigo_property *property) {
+	if (context->sent_values == NULL)
+		return;
+	for (int i = 0; i < SENT_VALUES_BUCKETS; i++) {
+		sent_values **next = (sent_values **)context->sent_values + i;
+		while (*next) {
+			sent_values *values = *next;
+			if (property == NULL || (!strcmp(values->device, property->device) && (*property->name == 0 || !strcmp(values->name, property->name)))) {
+				*next = values->next;
+				free(values);
+			} else {
+				next = &values->next;
+			}
+		}
+	}
+	if (property == NULL) {
+		free(context->sent_values);
+		context->sent_values = NULL;
+	}
+}
+
 
 indigo_result indigo_change_text_property_with_token(indigo_client *client, const char *device, indigo_token token, const char *name, int count, const char **items, const char **values) {
 	indigo_property *property = indigo_init_text_property(NULL, device, name, NULL, NULL, 0, 0, count);
@@ -1404,6 +2049,33 @@ bool indigo_async(void *fun(void *data), void *data) {
 	return false;
 }
 
+typedef struct {
+	indigo_item item;
+	void (*callback)(indigo_item *item, bool success, void *data);
+	void *data;
+} blob_download;
+
+static void *blob_download_handler(blob_download *download) {
+	bool success = indigo_populate_http_blob_item(&download->item);
+	download->callback(&download->item, success, download->data);
+	indigo_safe_free(download->item.blob.value);
+	free(download);
+	return NULL;
+}
+
+bool indigo_populate_http_blob_item_async(indigo_item *blob_item, void callback(indigo_item *item, bool success, void *data), void *data) {
+	blob_download *download = indigo_safe_malloc(sizeof(blob_download));
+	download->item = *blob_item;
+	download->item.blob.value = NULL;
+	download->item.blob.size = 0;
+	download->callback = callback;
+	download->data = data;
+	if (INDIGO_ASYNC(blob_download_handler, download))
+		return true;
+	free(download);
+	return false;
+}
+
 double indigo_stod(char *string) {
 	char copy[128];
 	strncpy(copy, string, 128);
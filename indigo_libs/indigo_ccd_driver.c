@@ -34,6 +34,9 @@
 #include <time.h>
 #include <math.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <dirent.h>
 #include <sys/stat.h>
 #include <jpeglib.h>
 
@@ -42,6 +45,7 @@
 #include <indigo/indigo_tiff.h>
 #include <indigo/indigo_avi.h>
 #include <indigo/indigo_ser.h>
+#include <indigo/indigo_raw_utils.h>
 
 struct indigo_jpeg_compress_struct {
 	struct jpeg_compress_struct pub;
@@ -86,6 +90,1133 @@ void indigo_use_shortest_exposure_if_bias(indigo_device *device) {
 	}
 }
 
+// -------------------------------------------------------------------------------- calibration
+
+#define CALIBRATION_TEMPERATURE_TOLERANCE		2.0
+#define CALIBRATION_MAX_THREADS							8
+#define CALIBRATION_PIXELS_PER_THREAD				(256 * 1024)
+
+typedef enum {
+	CALIBRATION_BIAS = 0,
+	CALIBRATION_DARK,
+	CALIBRATION_FLAT
+} calibration_type;
+
+typedef struct {
+	char file_name[PATH_MAX];
+	calibration_type type;
+	int bitpix;
+	double bzero, bscale;
+	long data_offset;
+	int width, height;
+	int horizontal_bin, vertical_bin;
+	double exposure, temperature, gain, offset;
+	bool has_temperature, has_gain, has_offset;
+	float *data;
+} calibration_master;
+
+typedef struct {
+	pthread_mutex_t mutex;
+	char dir[PATH_MAX];
+	time_t dir_time;
+	int count;
+	calibration_master *masters;
+	calibration_master *bias, *dark, *flat;
+	bool subtract_bias;
+	int left, top, width, height;
+	double exposure;
+	float *offset_map;
+	float *gain_map;
+	char message[INDIGO_VALUE_SIZE];
+} calibration_context;
+
+typedef struct {
+	void *data;
+	int byte_per_pixel;
+	const float *offset_map;
+	const float *gain_map;
+	long count;
+} calibration_job;
+
+static bool calibration_read_header(const char *file_name, calibration_master *master) {
+	int handle = open(file_name, O_RDONLY);
+	if (handle < 0)
+		return false;
+	char card[81];
+	bool type_found = false, end_found = false;
+	int naxis = 0;
+	memset(master, 0, sizeof(calibration_master));
+	strncpy(master->file_name, file_name, PATH_MAX - 1);
+	master->file_name[PATH_MAX - 1] = 0;
+	master->bscale = 1;
+	master->horizontal_bin = master->vertical_bin = 1;
+	card[80] = 0;
+	for (int i = 0; i < 360 && !end_found; i++) {
+		if (read(handle, card, 80) != 80)
+			break;
+		if (i == 0 && strncmp(card, "SIMPLE  =", 9))
+			break;
+		if (!strncmp(card, "END     ", 8)) {
+			end_found = true;
+			master->data_offset = ((i * 80) / FITS_HEADER_SIZE + 1) * FITS_HEADER_SIZE;
+			break;
+		}
+		if (card[8] != '=')
+			continue;
+		char *value = card + 10;
+		while (*value == ' ')
+			value++;
+		if (!strncmp(card, "BITPIX  ", 8))
+			master->bitpix = atoi(value);
+		else if (!strncmp(card, "NAXIS   ", 8))
+			naxis = atoi(value);
+		else if (!strncmp(card, "NAXIS1  ", 8))
+			master->width = atoi(value);
+		else if (!strncmp(card, "NAXIS2  ", 8))
+			master->height = atoi(value);
+		else if (!strncmp(card, "BZERO   ", 8))
+			master->bzero = indigo_atod(value);
+		else if (!strncmp(card, "BSCALE  ", 8))
+			master->bscale = indigo_atod(value);
+		else if (!strncmp(card, "XBINNING", 8))
+			master->horizontal_bin = atoi(value);
+		else if (!strncmp(card, "YBINNING", 8))
+			master->vertical_bin = atoi(value);
+		else if (!strncmp(card, "EXPTIME ", 8) || !strncmp(card, "EXPOSURE", 8))
+			master->exposure = indigo_atod(value);
+		else if (!strncmp(card, "CCD-TEMP", 8)) {
+			master->temperature = indigo_atod(value);
+			master->has_temperature = true;
+		} else if (!strncmp(card, "GAIN    ", 8)) {
+			master->gain = indigo_atod(value);
+			master->has_gain = true;
+		} else if (!strncmp(card, "OFFSET  ", 8)) {
+			master->offset = indigo_atod(value);
+			master->has_offset = true;
+		} else if (!strncmp(card, "IMAGETYP", 8) || !strncmp(card, "FRAME   ", 8)) {
+			for (char *tmp = value; *tmp; tmp++)
+				*tmp = tolower(*tmp);
+			if (strstr(value, "darkflat") || strstr(value, "dark flat")) {
+				type_found = false;
+			} else if (strstr(value, "bias") || strstr(value, "offset")) {
+				master->type = CALIBRATION_BIAS;
+				type_found = true;
+			} else if (strstr(value, "dark")) {
+				master->type = CALIBRATION_DARK;
+				type_found = true;
+			} else if (strstr(value, "flat")) {
+				master->type = CALIBRATION_FLAT;
+				type_found = true;
+			}
+		}
+	}
+	close(handle);
+	return end_found && type_found && naxis == 2 && master->width > 0 && master->height > 0 && (master->bitpix == 8 || master->bitpix == 16 || master->bitpix == 32 || master->bitpix == -32);
+}
+
+static bool calibration_read_data(calibration_master *master) {
+	if (master->data)
+		return true;
+	int handle = open(master->file_name, O_RDONLY);
+	if (handle < 0)
+		return false;
+	long count = (long)master->width * master->height;
+	int byte_per_pixel = abs(master->bitpix) / 8;
+	unsigned char *raw = indigo_safe_malloc(count * byte_per_pixel);
+	bool result = lseek(handle, master->data_offset, SEEK_SET) == master->data_offset && indigo_read(handle, (char *)raw, count * byte_per_pixel) == count * byte_per_pixel;
+	close(handle);
+	if (result) {
+		float *data = master->data = indigo_safe_malloc(count * sizeof(float));
+		float bzero = master->bzero, bscale = master->bscale;
+		unsigned char *pixel = raw;
+		switch (master->bitpix) {
+			case 8:
+				for (long i = 0; i < count; i++)
+					data[i] = pixel[i] * bscale + bzero;
+				break;
+			case 16:
+				for (long i = 0; i < count; i++, pixel += 2)
+					data[i] = (int16_t)(pixel[0] << 8 | pixel[1]) * bscale + bzero;
+				break;
+			case 32:
+				for (long i = 0; i < count; i++, pixel += 4)
+					data[i] = (int32_t)((uint32_t)pixel[0] << 24 | pixel[1] << 16 | pixel[2] << 8 | pixel[3]) * bscale + bzero;
+				break;
+			case -32:
+				for (long i = 0; i < count; i++, pixel += 4) {
+					union { uint32_t i; float f; } value = { (uint32_t)pixel[0] << 24 | pixel[1] << 16 | pixel[2] << 8 | pixel[3] };
+					data[i] = value.f * bscale + bzero;
+				}
+				break;
+		}
+		INDIGO_DEBUG(indigo_debug("Calibration master %s loaded", master->file_name));
+	} else {
+		INDIGO_ERROR(indigo_error("Failed to read calibration master %s", master->file_name));
+	}
+	free(raw);
+	return result;
+}
+
+static void calibration_clear_masters(calibration_context *calibration) {
+	for (int i = 0; i < calibration->count; i++)
+		indigo_safe_free(calibration->masters[i].data);
+	indigo_safe_free(calibration->masters);
+	calibration->masters = NULL;
+	calibration->count = 0;
+	calibration->bias = calibration->dark = calibration->flat = NULL;
+	calibration->width = calibration->height = 0;
+}
+
+static void calibration_scan(calibration_context *calibration, const char *dir) {
+	struct stat dir_stat;
+	if (stat(dir, &dir_stat) || !S_ISDIR(dir_stat.st_mode)) {
+		calibration_clear_masters(calibration);
+		calibration->dir_time = 0;
+		return;
+	}
+	if (!strcmp(calibration->dir, dir) && calibration->dir_time == dir_stat.st_mtime)
+		return;
+	calibration_clear_masters(calibration);
+	strncpy(calibration->dir, dir, PATH_MAX - 1);
+	calibration->dir_time = dir_stat.st_mtime;
+	DIR *folder = opendir(dir);
+	if (folder == NULL)
+		return;
+	int size = 0;
+	struct dirent *entry;
+	while ((entry = readdir(folder)) != NULL) {
+		char *suffix = strrchr(entry->d_name, '.');
+		if (suffix == NULL || (strcasecmp(suffix, ".fits") && strcasecmp(suffix, ".fit") && strcasecmp(suffix, ".fts")))
+			continue;
+		if (calibration->count == size)
+			calibration->masters = indigo_safe_realloc(calibration->masters, (size = size ? 2 * size : 16) * sizeof(calibration_master));
+		char file_name[PATH_MAX];
+		snprintf(file_name, sizeof(file_name), "%s%s", dir, entry->d_name);
+		if (calibration_read_header(file_name, calibration->masters + calibration->count))
+			calibration->count++;
+	}
+	closedir(folder);
+	INDIGO_DEBUG(indigo_debug("Calibration library %s scanned, %d masters found", dir, calibration->count));
+}
+
+static long calibration_origin(indigo_device *device, calibration_master *master, int width, int height) {
+	if (master->width == width && master->height == height)
+		return 0;
+	int left = CCD_FRAME_LEFT_ITEM->number.value / master->horizontal_bin;
+	int top = CCD_FRAME_TOP_ITEM->number.value / master->vertical_bin;
+	if (left + width > master->width || top + height > master->height)
+		return -1;
+	return (long)top * master->width + left;
+}
+
+static calibration_master *calibration_select(indigo_device *device, calibration_context *calibration, calibration_type type, int width, int height, double exposure, bool scalable) {
+	calibration_master *best = NULL;
+	double best_score = 0;
+	for (int i = 0; i < calibration->count; i++) {
+		calibration_master *master = calibration->masters + i;
+		if (master->type != type)
+			continue;
+		if (master->horizontal_bin != (int)CCD_BIN_HORIZONTAL_ITEM->number.value || master->vertical_bin != (int)CCD_BIN_VERTICAL_ITEM->number.value)
+			continue;
+		if (calibration_origin(device, master, width, height) < 0)
+			continue;
+		if (master->has_gain && !CCD_GAIN_PROPERTY->hidden && fabs(master->gain - CCD_GAIN_ITEM->number.value) > 0.5)
+			continue;
+		if (master->has_offset && !CCD_OFFSET_PROPERTY->hidden && fabs(master->offset - CCD_OFFSET_ITEM->number.value) > 0.5)
+			continue;
+		double score = 0;
+		if (type != CALIBRATION_FLAT && master->has_temperature && !CCD_TEMPERATURE_PROPERTY->hidden) {
+			double difference = fabs(master->temperature - CCD_TEMPERATURE_ITEM->number.value);
+			if (difference > CALIBRATION_TEMPERATURE_TOLERANCE)
+				continue;
+			score += difference;
+		}
+		if (type == CALIBRATION_DARK) {
+			double difference = fabs(master->exposure - exposure);
+			if (difference > 0.001 + 0.01 * exposure) {
+				if (!scalable || master->exposure <= 0)
+					continue;
+				score += 10 * difference / exposure;
+			}
+		}
+		if (best == NULL || score < best_score) {
+			best = master;
+			best_score = score;
+		}
+	}
+	return best;
+}
+
+static void calibration_build_maps(indigo_device *device, calibration_context *calibration, int width, int height, double exposure) {
+	long count = (long)width * height;
+	calibration->offset_map = indigo_safe_realloc(calibration->offset_map, count * sizeof(float));
+	if (calibration->flat)
+		calibration->gain_map = indigo_safe_realloc(calibration->gain_map, count * sizeof(float));
+	calibration_master *bias = calibration->bias, *dark = calibration->dark, *flat = calibration->flat;
+	long bias_origin = bias ? calibration_origin(device, bias, width, height) : 0;
+	long dark_origin = dark ? calibration_origin(device, dark, width, height) : 0;
+	long flat_origin = flat ? calibration_origin(device, flat, width, height) : 0;
+	float scale = 1;
+	if (dark && bias && dark->exposure > 0)
+		scale = exposure / dark->exposure;
+	double sum = 0;
+	for (int y = 0; y < height; y++) {
+		float *offset_row = calibration->offset_map + (long)y * width;
+		const float *bias_row = bias ? bias->data + bias_origin + (long)y * bias->width : NULL;
+		const float *dark_row = dark ? dark->data + dark_origin + (long)y * dark->width : NULL;
+		if (dark_row && bias_row) {
+			for (int x = 0; x < width; x++)
+				offset_row[x] = bias_row[x] + scale * (dark_row[x] - bias_row[x]);
+		} else if (dark_row) {
+			memcpy(offset_row, dark_row, width * sizeof(float));
+		} else if (bias_row && calibration->subtract_bias) {
+			memcpy(offset_row, bias_row, width * sizeof(float));
+		} else {
+			memset(offset_row, 0, width * sizeof(float));
+		}
+		if (flat) {
+			float *gain_row = calibration->gain_map + (long)y * width;
+			const float *flat_row = flat->data + flat_origin + (long)y * flat->width;
+			for (int x = 0; x < width; x++) {
+				float value = flat_row[x] - (bias_row ? bias_row[x] : 0);
+				gain_row[x] = value;
+				sum += value;
+			}
+		}
+	}
+	if (flat) {
+		float mean = sum / count;
+		float *gain = calibration->gain_map;
+		for (long i = 0; i < count; i++)
+			gain[i] = gain[i] > 0 ? mean / gain[i] : 1;
+	}
+	calibration->left = CCD_FRAME_LEFT_ITEM->number.value;
+	calibration->top = CCD_FRAME_TOP_ITEM->number.value;
+	calibration->width = width;
+	calibration->height = height;
+	calibration->exposure = exposure;
+}
+
+/* Float compares are not if-converted under trapping math, so clamp on the IEEE bit pattern (ordered as int32 for non-negative values) to keep loops vectorizable. */
+
+typedef union {
+	float f;
+	int32_t i;
+} pixel_bits;
+
+static inline float clamp_pixel(float value, int32_t max) {
+	pixel_bits bits = { value };
+	bits.i &= ~(bits.i >> 31);
+	int32_t high = -(bits.i > max);
+	bits.i = (bits.i & ~high) | (max & high);
+	return bits.f;
+}
+
+static void calibrate_8(uint8_t * restrict data, const float * restrict offset, const float * restrict gain, long count) {
+	int32_t max = ((pixel_bits){ 255.0f }).i;
+	if (gain) {
+		for (long i = 0; i < count; i++)
+			data[i] = (uint8_t)(clamp_pixel((data[i] - offset[i]) * gain[i], max) + 0.5f);
+	} else {
+		for (long i = 0; i < count; i++)
+			data[i] = (uint8_t)(clamp_pixel(data[i] - offset[i], max) + 0.5f);
+	}
+}
+
+static void calibrate_16(uint16_t * restrict data, const float * restrict offset, const float * restrict gain, long count) {
+	int32_t max = ((pixel_bits){ 65535.0f }).i;
+	if (gain) {
+		for (long i = 0; i < count; i++)
+			data[i] = (uint16_t)(clamp_pixel((data[i] - offset[i]) * gain[i], max) + 0.5f);
+	} else {
+		for (long i = 0; i < count; i++)
+			data[i] = (uint16_t)(clamp_pixel(data[i] - offset[i], max) + 0.5f);
+	}
+}
+
+static void *calibration_worker(calibration_job *job) {
+	if (job->byte_per_pixel == 1)
+		calibrate_8(job->data, job->offset_map, job->gain_map, job->count);
+	else
+		calibrate_16(job->data, job->offset_map, job->gain_map, job->count);
+	return NULL;
+}
+
+static void calibration_apply(calibration_context *calibration, void *data, int byte_per_pixel, long count) {
+	int thread_count = (int)(count / CALIBRATION_PIXELS_PER_THREAD);
+	long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (thread_count > cpu_count)
+		thread_count = (int)cpu_count;
+	if (thread_count > CALIBRATION_MAX_THREADS)
+		thread_count = CALIBRATION_MAX_THREADS;
+	if (thread_count < 1)
+		thread_count = 1;
+	calibration_job jobs[CALIBRATION_MAX_THREADS];
+	pthread_t threads[CALIBRATION_MAX_THREADS];
+	long chunk = (count / thread_count + 15) & ~15L;
+	for (int i = 0; i < thread_count; i++) {
+		long first = i * chunk;
+		long last = i == thread_count - 1 ? count : first + chunk;
+		jobs[i].data = (char *)data + first * byte_per_pixel;
+		jobs[i].byte_per_pixel = byte_per_pixel;
+		jobs[i].offset_map = calibration->offset_map + first;
+		jobs[i].gain_map = calibration->flat ? calibration->gain_map + first : NULL;
+		jobs[i].count = last > first ? last - first : 0;
+	}
+	int started = 0;
+	for (int i = 1; i < thread_count; i++) {
+		if (pthread_create(&threads[i], NULL, (void *(*)(void *))calibration_worker, jobs + i))
+			break;
+		started = i;
+	}
+	for (int i = started + 1; i < thread_count; i++)
+		calibration_worker(jobs + i);
+	calibration_worker(jobs);
+	for (int i = 1; i <= started; i++)
+		pthread_join(threads[i], NULL);
+}
+
+static bool calibrate_image(indigo_device *device, void *data, int width, int height, int byte_per_pixel, bool little_endian, char *status) {
+	calibration_context *calibration = CCD_CONTEXT->calibration;
+	if (calibration == NULL)
+		return false;
+	pthread_mutex_lock(&calibration->mutex);
+	calibration_scan(calibration, CCD_CALIBRATION_LIBRARY_DIR_ITEM->text.value);
+	double exposure = CCD_EXPOSURE_ITEM->number.target;
+	calibration_master *bias = NULL, *dark = NULL, *flat = NULL;
+	char message[INDIGO_VALUE_SIZE] = "";
+	if (CCD_CALIBRATION_BIAS_ITEM->sw.value || CCD_CALIBRATION_DARK_ITEM->sw.value || CCD_CALIBRATION_FLAT_ITEM->sw.value) {
+		bias = calibration_select(device, calibration, CALIBRATION_BIAS, width, height, exposure, false);
+		if (bias && !calibration_read_data(bias))
+			bias = NULL;
+	}
+	if (CCD_CALIBRATION_DARK_ITEM->sw.value) {
+		dark = calibration_select(device, calibration, CALIBRATION_DARK, width, height, exposure, bias != NULL);
+		if (dark && !calibration_read_data(dark))
+			dark = NULL;
+		if (dark == NULL)
+			strcat(message, "No matching master dark. ");
+	}
+	if (CCD_CALIBRATION_BIAS_ITEM->sw.value && bias == NULL)
+		strcat(message, "No matching master bias. ");
+	if (CCD_CALIBRATION_FLAT_ITEM->sw.value) {
+		flat = calibration_select(device, calibration, CALIBRATION_FLAT, width, height, exposure, false);
+		if (flat && !calibration_read_data(flat))
+			flat = NULL;
+		if (flat == NULL)
+			strcat(message, "No matching master flat. ");
+	}
+	bool subtract_bias = bias != NULL && CCD_CALIBRATION_BIAS_ITEM->sw.value;
+	bool result = false;
+	if (subtract_bias || dark || flat) {
+		if (bias != calibration->bias || dark != calibration->dark || flat != calibration->flat || subtract_bias != calibration->subtract_bias || width != calibration->width || height != calibration->height || exposure != calibration->exposure || calibration->left != (int)CCD_FRAME_LEFT_ITEM->number.value || calibration->top != (int)CCD_FRAME_TOP_ITEM->number.value) {
+			calibration->bias = bias;
+			calibration->dark = dark;
+			calibration->flat = flat;
+			calibration->subtract_bias = subtract_bias;
+			calibration_build_maps(device, calibration, width, height, exposure);
+		}
+		long count = (long)width * height;
+		if (byte_per_pixel == 2 && !little_endian) {
+			uint16_t *raw = data;
+			for (long i = 0; i < count; i++)
+				raw[i] = raw[i] << 8 | raw[i] >> 8;
+		}
+		calibration_apply(calibration, data, byte_per_pixel, count);
+		if (byte_per_pixel == 2 && !little_endian) {
+			uint16_t *raw = data;
+			for (long i = 0; i < count; i++)
+				raw[i] = raw[i] << 8 | raw[i] >> 8;
+		}
+		char *tmp = status;
+		if (subtract_bias || (bias && dark))
+			*tmp++ = 'B';
+		if (dark)
+			*tmp++ = 'D';
+		if (flat)
+			*tmp++ = 'F';
+		*tmp = 0;
+		result = true;
+	}
+	bool changed = strcmp(message, calibration->message) != 0;
+	if (changed)
+		strcpy(calibration->message, message);
+	pthread_mutex_unlock(&calibration->mutex);
+	if (changed) {
+		CCD_CALIBRATION_PROPERTY->state = *message ? INDIGO_ALERT_STATE : INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_CALIBRATION_PROPERTY, *message ? message : NULL);
+	}
+	return result;
+}
+
+static void calibration_reset(indigo_device *device, bool rescan) {
+	calibration_context *calibration = CCD_CONTEXT->calibration;
+	if (calibration == NULL)
+		return;
+	pthread_mutex_lock(&calibration->mutex);
+	if (rescan) {
+		calibration_clear_masters(calibration);
+		calibration->dir_time = 0;
+	}
+	calibration->bias = calibration->dark = calibration->flat = NULL;
+	calibration->width = calibration->height = 0;
+	*calibration->message = 0;
+	pthread_mutex_unlock(&calibration->mutex);
+}
+
+static void calibration_release(indigo_device *device) {
+	calibration_context *calibration = CCD_CONTEXT->calibration;
+	if (calibration == NULL)
+		return;
+	calibration_clear_masters(calibration);
+	indigo_safe_free(calibration->offset_map);
+	indigo_safe_free(calibration->gain_map);
+	pthread_mutex_destroy(&calibration->mutex);
+	free(calibration);
+	CCD_CONTEXT->calibration = NULL;
+}
+
+// -------------------------------------------------------------------------------- Software binning
+
+/* Rows are summed into 32-bit line accumulator first (contiguous, vectorizable), then columns are reduced.
+   Output is written in place, it never overtakes the input still to be read. For bayered frames pixels of
+   the same colour are binned together, so the CFA pattern is preserved. */
+static void software_bin(indigo_device *device, void *data, int *frame_width, int *frame_height, int byte_per_pixel, int channels, bool little_endian, bool bayer) {
+	int width = *frame_width;
+	int left = 0, top = 0, crop_width = width, crop_height = *frame_height;
+	if (CCD_CONTEXT->software_subframe) {
+		left = CCD_FRAME_LEFT_ITEM->number.value;
+		top = CCD_FRAME_TOP_ITEM->number.value;
+		if (bayer) {
+			left &= ~1;
+			top &= ~1;
+		}
+		if (left >= width || top >= *frame_height)
+			left = top = 0;
+		crop_width = CCD_FRAME_WIDTH_ITEM->number.value;
+		crop_height = CCD_FRAME_HEIGHT_ITEM->number.value;
+		if (crop_width <= 0 || left + crop_width > width)
+			crop_width = width - left;
+		if (crop_height <= 0 || top + crop_height > *frame_height)
+			crop_height = *frame_height - top;
+	}
+	int horizontal_bin = CCD_CONTEXT->software_binning ? CCD_BIN_HORIZONTAL_ITEM->number.value : 1;
+	int vertical_bin = CCD_CONTEXT->software_binning ? CCD_BIN_VERTICAL_ITEM->number.value : 1;
+	if (horizontal_bin < 1)
+		horizontal_bin = 1;
+	if (vertical_bin < 1)
+		vertical_bin = 1;
+	int step = bayer ? 2 : 1;
+	int out_width = (crop_width / (step * horizontal_bin)) * step;
+	int out_height = (crop_height / (step * vertical_bin)) * step;
+	if (out_width == 0 || out_height == 0)
+		return;
+	if (horizontal_bin == 1 && vertical_bin == 1 && left == 0 && top == 0 && out_width == width) {
+		*frame_height = out_height;
+		return;
+	}
+	bool swap = byte_per_pixel == 2 && !little_endian;
+	bool average = CCD_BIN_MODE_AVERAGE_ITEM->sw.value;
+	uint32_t max_value = byte_per_pixel == 1 ? 0xFF : 0xFFFF;
+	uint32_t divisor = horizontal_bin * vertical_bin;
+	long in_row_size = (long)width * channels;
+	int line_size = (left + crop_width) * channels;
+	uint32_t *line = indigo_safe_malloc(line_size * sizeof(uint32_t));
+	uint32_t *out = indigo_safe_malloc(out_width * channels * sizeof(uint32_t));
+	uint8_t *out8 = data;
+	uint16_t *out16 = data;
+	for (int y = 0; y < out_height; y++) {
+		int in_y = top + (y / step) * step * vertical_bin + (y % step);
+		memset(line, 0, line_size * sizeof(uint32_t));
+		for (int k = 0; k < vertical_bin; k++) {
+			long row = (in_y + k * step) * in_row_size;
+			if (byte_per_pixel == 1) {
+				const uint8_t * restrict in = (const uint8_t *)data + row;
+				for (int i = left * channels; i < line_size; i++)
+					line[i] += in[i];
+			} else {
+				const uint16_t * restrict in = (const uint16_t *)data + row;
+				if (swap) {
+					for (int i = left * channels; i < line_size; i++)
+						line[i] += (uint16_t)((in[i] >> 8) | (in[i] << 8));
+				} else {
+					for (int i = left * channels; i < line_size; i++)
+						line[i] += in[i];
+				}
+			}
+		}
+		for (int x = 0; x < out_width; x++) {
+			int in_x = left + (x / step) * step * horizontal_bin + (x % step);
+			for (int c = 0; c < channels; c++) {
+				uint32_t sum = 0;
+				for (int k = 0; k < horizontal_bin; k++)
+					sum += line[(in_x + k * step) * channels + c];
+				out[x * channels + c] = sum;
+			}
+		}
+		long out_row = (long)y * out_width * channels;
+		for (int i = 0; i < out_width * channels; i++) {
+			uint32_t value = average ? out[i] / divisor : (out[i] > max_value ? max_value : out[i]);
+			if (byte_per_pixel == 1)
+				out8[out_row + i] = value;
+			else
+				out16[out_row + i] = swap ? (uint16_t)((value >> 8) | (value << 8)) : value;
+		}
+	}
+	free(line);
+	free(out);
+	*frame_width = out_width;
+	*frame_height = out_height;
+}
+
+void indigo_ccd_enable_software_binning(indigo_device *device, int max_bin, bool subframe) {
+	assert(device != NULL);
+	assert(CCD_CONTEXT != NULL);
+	CCD_CONTEXT->software_binning = true;
+	CCD_BIN_PROPERTY->perm = INDIGO_RW_PERM;
+	CCD_BIN_PROPERTY->hidden = false;
+	CCD_BIN_HORIZONTAL_ITEM->number.min = CCD_BIN_VERTICAL_ITEM->number.min = 1;
+	CCD_BIN_HORIZONTAL_ITEM->number.max = CCD_BIN_VERTICAL_ITEM->number.max = max_bin;
+	CCD_INFO_MAX_HORIZONAL_BIN_ITEM->number.value = CCD_INFO_MAX_VERTICAL_BIN_ITEM->number.value = max_bin;
+	CCD_BIN_MODE_PROPERTY->hidden = false;
+	if (subframe) {
+		CCD_CONTEXT->software_subframe = true;
+		CCD_FRAME_PROPERTY->perm = INDIGO_RW_PERM;
+	}
+}
+
+static indigo_result ccd_connection_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CONNECTION
+	if (IS_CONNECTED) {
+		indigo_define_property(device, CCD_INFO_PROPERTY, NULL);
+		indigo_define_property(device, CCD_LENS_PROPERTY, NULL);
+		indigo_define_property(device, CCD_UPLOAD_MODE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_PREVIEW_PROPERTY, NULL);
+		indigo_define_property(device, CCD_LOCAL_MODE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_MODE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_READ_MODE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_EXPOSURE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_STREAMING_PROPERTY, NULL);
+		indigo_define_property(device, CCD_ABORT_EXPOSURE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_FRAME_PROPERTY, NULL);
+		indigo_define_property(device, CCD_BIN_PROPERTY, NULL);
+		indigo_define_property(device, CCD_OFFSET_PROPERTY, NULL);
+		indigo_define_property(device, CCD_GAIN_PROPERTY, NULL);
+		indigo_define_property(device, CCD_GAMMA_PROPERTY, NULL);
+		indigo_define_property(device, CCD_FRAME_TYPE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_IMAGE_FORMAT_PROPERTY, NULL);
+		indigo_define_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_IMAGE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
+		indigo_define_property(device, CCD_COOLER_PROPERTY, NULL);
+		indigo_define_property(device, CCD_COOLER_POWER_PROPERTY, NULL);
+		indigo_define_property(device, CCD_TEMPERATURE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_FITS_HEADERS_PROPERTY, NULL);
+		indigo_define_property(device, CCD_JPEG_SETTINGS_PROPERTY, NULL);
+		indigo_define_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
+		indigo_define_property(device, CCD_CALIBRATION_PROPERTY, NULL);
+		indigo_define_property(device, CCD_CALIBRATION_LIBRARY_PROPERTY, NULL);
+		indigo_define_property(device, CCD_BIN_MODE_PROPERTY, NULL);
+		indigo_define_property(device, CCD_JPEG_DEBAYER_PROPERTY, NULL);
+		indigo_define_property(device, CCD_PREVIEW_TIERS_PROPERTY, NULL);
+		indigo_define_property(device, CCD_PREVIEW_THUMBNAIL_PROPERTY, NULL);
+		for (int i = 0; i < CCD_PREVIEW_TIER_COUNT; i++)
+			indigo_define_property(device, CCD_PREVIEW_TIER_IMAGE_PROPERTY(i), NULL);
+	} else {
+		CCD_STREAMING_COUNT_ITEM->number.value = 0;
+		CCD_EXPOSURE_ITEM->number.value = 0;
+		CCD_STREAMING_PROPERTY->state = INDIGO_OK_STATE;
+		CCD_EXPOSURE_PROPERTY->state = INDIGO_OK_STATE;
+		CCD_IMAGE_PROPERTY->state = INDIGO_OK_STATE;
+		CCD_COOLER_POWER_PROPERTY->state = INDIGO_OK_STATE;
+		CCD_TEMPERATURE_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_delete_property(device, CCD_INFO_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_LENS_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_UPLOAD_MODE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_PREVIEW_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_LOCAL_MODE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_MODE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_READ_MODE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_EXPOSURE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_STREAMING_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_ABORT_EXPOSURE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_FRAME_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_BIN_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_OFFSET_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_GAIN_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_GAMMA_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_FRAME_TYPE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_IMAGE_FORMAT_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_IMAGE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_COOLER_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_COOLER_POWER_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_TEMPERATURE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_FITS_HEADERS_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_JPEG_SETTINGS_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_CALIBRATION_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_CALIBRATION_LIBRARY_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_BIN_MODE_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_JPEG_DEBAYER_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_PREVIEW_TIERS_PROPERTY, NULL);
+		indigo_delete_property(device, CCD_PREVIEW_THUMBNAIL_PROPERTY, NULL);
+		for (int i = 0; i < CCD_PREVIEW_TIER_COUNT; i++)
+			indigo_delete_property(device, CCD_PREVIEW_TIER_IMAGE_PROPERTY(i), NULL);
+	}
+	return indigo_device_change_property(device, client, property);
+}
+
+static indigo_result ccd_config_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CONFIG
+	if (indigo_switch_match(CONFIG_SAVE_ITEM, property)) {
+		indigo_save_property(device, NULL, CCD_LENS_PROPERTY);
+		indigo_save_property(device, NULL, CCD_MODE_PROPERTY);
+		indigo_save_property(device, NULL, CCD_READ_MODE_PROPERTY);
+		indigo_save_property(device, NULL, CCD_UPLOAD_MODE_PROPERTY);
+		indigo_save_property(device, NULL, CCD_LOCAL_MODE_PROPERTY);
+		indigo_save_property(device, NULL, CCD_FRAME_PROPERTY);
+		indigo_save_property(device, NULL, CCD_BIN_PROPERTY);
+		indigo_save_property(device, NULL, CCD_OFFSET_PROPERTY);
+		indigo_save_property(device, NULL, CCD_GAMMA_PROPERTY);
+		indigo_save_property(device, NULL, CCD_GAIN_PROPERTY);
+		indigo_save_property(device, NULL, CCD_FRAME_TYPE_PROPERTY);
+		indigo_save_property(device, NULL, CCD_FITS_HEADERS_PROPERTY);
+		indigo_save_property(device, NULL, CCD_JPEG_SETTINGS_PROPERTY);
+		indigo_save_property(device, NULL, CCD_JPEG_DEBAYER_PROPERTY);
+		indigo_save_property(device, NULL, CCD_PREVIEW_TIERS_PROPERTY);
+		indigo_save_property(device, NULL, CCD_PREVIEW_THUMBNAIL_PROPERTY);
+		indigo_save_property(device, NULL, CCD_RBI_FLUSH_ENABLE_PROPERTY);
+		indigo_save_property(device, NULL, CCD_RBI_FLUSH_PROPERTY);
+		indigo_save_property(device, NULL, CCD_CALIBRATION_PROPERTY);
+		indigo_save_property(device, NULL, CCD_CALIBRATION_LIBRARY_PROPERTY);
+		if (CCD_CONTEXT->software_binning)
+			indigo_save_property(device, NULL, CCD_BIN_MODE_PROPERTY);
+	}
+	return indigo_device_change_property(device, client, property);
+}
+
+static indigo_result ccd_lens_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	indigo_property_copy_values(CCD_LENS_PROPERTY, property, false);
+	CCD_LENS_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, CCD_LENS_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_exposure_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_EXPOSURE
+	if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
+		if (CCD_UPLOAD_MODE_LOCAL_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value) {
+			if (CCD_IMAGE_FILE_PROPERTY->state != INDIGO_BUSY_STATE) {
+				CCD_IMAGE_FILE_PROPERTY->state = INDIGO_BUSY_STATE;
+				indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
+			}
+		}
+		if (CCD_UPLOAD_MODE_CLIENT_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value) {
+			if (CCD_IMAGE_PROPERTY->state != INDIGO_BUSY_STATE) {
+				CCD_IMAGE_PROPERTY->state = INDIGO_BUSY_STATE;
+				indigo_update_property(device, CCD_IMAGE_PROPERTY, NULL);
+			}
+		}
+		if (CCD_EXPOSURE_ITEM->number.value >= 1) {
+			 indigo_set_timer(device, 1.0, countdown_timer_callback, &CCD_CONTEXT->countdown_timer);
+		}
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_abort_exposure_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_ABORT_EXPOSURE
+	if (CCD_IMAGE_PROPERTY->state == INDIGO_BUSY_STATE) {
+		CCD_IMAGE_PROPERTY->state = INDIGO_ALERT_STATE;
+		indigo_update_property(device, CCD_IMAGE_PROPERTY, NULL);
+	}
+	if (CCD_PREVIEW_IMAGE_PROPERTY->state == INDIGO_BUSY_STATE) {
+		CCD_PREVIEW_IMAGE_PROPERTY->state = INDIGO_ALERT_STATE;
+		indigo_update_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
+	}
+	if (CCD_PREVIEW_HISTOGRAM_PROPERTY->state == INDIGO_BUSY_STATE) {
+		CCD_PREVIEW_HISTOGRAM_PROPERTY->state = INDIGO_ALERT_STATE;
+		indigo_update_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
+	}
+	if (CCD_IMAGE_FILE_PROPERTY->state == INDIGO_BUSY_STATE) {
+		CCD_IMAGE_FILE_PROPERTY->state = INDIGO_ALERT_STATE;
+		indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
+	}
+	if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
+		CCD_EXPOSURE_PROPERTY->state = INDIGO_ALERT_STATE;
+		CCD_EXPOSURE_ITEM->number.value = 0;
+		indigo_update_property(device, CCD_EXPOSURE_PROPERTY, NULL);
+		CCD_ABORT_EXPOSURE_PROPERTY->state = INDIGO_OK_STATE;
+	} else if (CCD_STREAMING_PROPERTY->state == INDIGO_BUSY_STATE) {
+		CCD_STREAMING_PROPERTY->state = INDIGO_ALERT_STATE;
+		CCD_STREAMING_COUNT_ITEM->number.value = 0;
+		indigo_update_property(device, CCD_STREAMING_PROPERTY, NULL);
+		CCD_ABORT_EXPOSURE_PROPERTY->state = INDIGO_OK_STATE;
+	} else {
+		CCD_ABORT_EXPOSURE_PROPERTY->state = INDIGO_ALERT_STATE;
+	}
+	CCD_ABORT_EXPOSURE_ITEM->sw.value = false;
+	indigo_update_property(device, CCD_ABORT_EXPOSURE_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_frame_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_FRAME
+	indigo_property_copy_values(CCD_FRAME_PROPERTY, property, false);
+	CCD_FRAME_WIDTH_ITEM->number.value = ((int)CCD_FRAME_WIDTH_ITEM->number.value / (int)CCD_BIN_HORIZONTAL_ITEM->number.value) * (int)CCD_BIN_HORIZONTAL_ITEM->number.value;
+	CCD_FRAME_HEIGHT_ITEM->number.value = ((int)CCD_FRAME_HEIGHT_ITEM->number.value / (int)CCD_BIN_VERTICAL_ITEM->number.value) * (int)CCD_BIN_VERTICAL_ITEM->number.value;
+	CCD_FRAME_PROPERTY->state = INDIGO_OK_STATE;
+	if (CCD_FRAME_LEFT_ITEM->number.value + CCD_FRAME_WIDTH_ITEM->number.value > CCD_INFO_WIDTH_ITEM->number.value) {
+		CCD_FRAME_WIDTH_ITEM->number.value = CCD_INFO_WIDTH_ITEM->number.value - CCD_FRAME_LEFT_ITEM->number.value;
+		CCD_FRAME_PROPERTY->state = INDIGO_ALERT_STATE;
+	}
+	if (CCD_FRAME_TOP_ITEM->number.value + CCD_FRAME_HEIGHT_ITEM->number.value > CCD_INFO_HEIGHT_ITEM->number.value) {
+		CCD_FRAME_HEIGHT_ITEM->number.value = CCD_INFO_HEIGHT_ITEM->number.value - CCD_FRAME_TOP_ITEM->number.value;
+		CCD_FRAME_PROPERTY->state = INDIGO_ALERT_STATE;
+	}
+	if (IS_CONNECTED) {
+		indigo_update_property(device, CCD_FRAME_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_bin_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_BIN
+	indigo_property_copy_values(CCD_BIN_PROPERTY, property, false);
+	if (!CCD_CONTEXT->software_binning) {
+		char name[32];
+		snprintf(name, 32, "BIN_%dx%d", (int)CCD_BIN_HORIZONTAL_ITEM->number.value, (int)CCD_BIN_VERTICAL_ITEM->number.value);
+		for (int i = 0; i < CCD_MODE_PROPERTY->count; i++) {
+			indigo_item *item = &CCD_MODE_PROPERTY->items[i];
+			item->sw.value = !strcmp(item->name, name);
+		}
+	}
+	if (IS_CONNECTED) {
+		CCD_MODE_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_MODE_PROPERTY, NULL);
+		CCD_BIN_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_BIN_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_mode_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_MODE
+	indigo_property_copy_values(CCD_MODE_PROPERTY, property, false);
+	for (int i = 0; i < CCD_MODE_PROPERTY->count; i++) {
+		indigo_item *item = &CCD_MODE_PROPERTY->items[i];
+		if (item->sw.value) {
+			int h, v;
+			if (sscanf(item->name, "BIN_%dx%d", &h, &v) == 2) {
+				CCD_BIN_HORIZONTAL_ITEM->number.value = CCD_BIN_HORIZONTAL_ITEM->number.target = h;
+				CCD_BIN_VERTICAL_ITEM->number.value = CCD_BIN_VERTICAL_ITEM->number.target = v;
+				CCD_FRAME_TOP_ITEM->number.value = CCD_FRAME_LEFT_ITEM->number.value = 0;
+				CCD_FRAME_WIDTH_ITEM->number.value = ((int)CCD_INFO_WIDTH_ITEM->number.value / (int)CCD_BIN_HORIZONTAL_ITEM->number.value) * (int)CCD_BIN_HORIZONTAL_ITEM->number.value;
+				CCD_FRAME_HEIGHT_ITEM->number.value = ((int)CCD_INFO_HEIGHT_ITEM->number.value / (int)CCD_BIN_VERTICAL_ITEM->number.value) * (int)CCD_BIN_VERTICAL_ITEM->number.value;
+			}
+			break;
+		}
+	}
+	if (IS_CONNECTED) {
+		CCD_FRAME_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_FRAME_PROPERTY, NULL);
+		CCD_BIN_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_BIN_PROPERTY, NULL);
+		CCD_MODE_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_MODE_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_offset_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_OFFSET
+	indigo_property_copy_values(CCD_OFFSET_PROPERTY, property, false);
+	if (IS_CONNECTED) {
+		CCD_OFFSET_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_OFFSET_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_read_mode_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_READ_MODE
+	indigo_property_copy_values(CCD_READ_MODE_PROPERTY, property, false);
+	if (IS_CONNECTED) {
+		CCD_READ_MODE_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_READ_MODE_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_gain_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_GAIN
+	indigo_property_copy_values(CCD_GAIN_PROPERTY, property, false);
+	if (IS_CONNECTED) {
+		CCD_GAIN_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_GAIN_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_gamma_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_GAMMA
+	indigo_property_copy_values(CCD_GAMMA_PROPERTY, property, false);
+	if (IS_CONNECTED) {
+		CCD_GAMMA_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, CCD_GAMMA_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_frame_type_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_FRAME_TYPE
+	indigo_property_copy_values(CCD_FRAME_TYPE_PROPERTY, property, false);
+	CCD_FRAME_TYPE_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_FRAME_TYPE_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_image_format_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_IMAGE_FORMAT
+	indigo_property_copy_values(CCD_IMAGE_FORMAT_PROPERTY, property, false);
+	CCD_IMAGE_FORMAT_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_IMAGE_FORMAT_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_upload_mode_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_IMAGE_UPLOAD_MODE
+	indigo_property_copy_values(CCD_UPLOAD_MODE_PROPERTY, property, false);
+	CCD_UPLOAD_MODE_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_UPLOAD_MODE_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_preview_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_PREVIEW
+	indigo_property_copy_values(CCD_PREVIEW_PROPERTY, property, false);
+	if (CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value) {
+		if (CCD_PREVIEW_IMAGE_PROPERTY->hidden) {
+			CCD_PREVIEW_IMAGE_PROPERTY->hidden = false;
+			if (IS_CONNECTED)
+				indigo_define_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
+		}
+		if (CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden) {
+			CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden = false;
+			if (IS_CONNECTED)
+				indigo_define_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
+		}
+	} else if (CCD_PREVIEW_ENABLED_ITEM->sw.value) {
+		if (CCD_PREVIEW_IMAGE_PROPERTY->hidden) {
+			CCD_PREVIEW_IMAGE_PROPERTY->hidden = false;
+			if (IS_CONNECTED)
+				indigo_define_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
+		}
+		if (!CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden) {
+			if (IS_CONNECTED)
+				indigo_delete_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
+			CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden = true;
+		}
+	} else {
+		if (!CCD_PREVIEW_IMAGE_PROPERTY->hidden) {
+			if (IS_CONNECTED)
+				indigo_delete_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
+			CCD_PREVIEW_IMAGE_PROPERTY->hidden = true;
+		}
+		if (!CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden) {
+			if (IS_CONNECTED)
+				indigo_delete_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
+			CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden = true;
+		}
+	}
+	CCD_PREVIEW_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_PREVIEW_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_local_mode_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_LOCAL_MODE
+	indigo_property_copy_values(CCD_LOCAL_MODE_PROPERTY, property, false);
+	long len = strlen(CCD_LOCAL_MODE_DIR_ITEM->text.value);
+	if (len == 0)
+		snprintf(CCD_LOCAL_MODE_DIR_ITEM->text.value, INDIGO_VALUE_SIZE, "%s/", getenv("HOME"));
+	else if (CCD_LOCAL_MODE_DIR_ITEM->text.value[len - 1] != '/')
+		strcat(CCD_LOCAL_MODE_DIR_ITEM->text.value, "/");
+	CCD_LOCAL_MODE_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_LOCAL_MODE_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_fits_headers_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_FITS_HEADERS
+	indigo_property_copy_values(CCD_FITS_HEADERS_PROPERTY, property, false);
+	for (int i = 0; i < CCD_FITS_HEADERS_PROPERTY->count; i++) {
+		indigo_item *item = CCD_FITS_HEADERS_PROPERTY->items + i;
+		if (*item->text.value == 0)
+			continue;
+		char *eq = strchr(item->text.value, '=');
+		char line[81];
+		if (eq) {
+			char *tmp = item->text.value;
+			while (tmp - item->text.value < 8 && (isalpha(*tmp) || isdigit(*tmp) || *tmp == '-' || *tmp == '_')) {
+				int c = toupper(*tmp);
+				*tmp++ = c;
+			}
+			*tmp = 0;
+			eq++;
+			while (eq - item->text.value < 80 && *eq == ' ')
+				eq++;
+			snprintf(line, 80, "%-8s= %s", item->text.value, eq);
+			indigo_copy_value(item->text.value, line);
+		} else if (!strncasecmp(item->text.value, "COMMENT ", 7)) {
+			char *tmp = item->text.value + 7;
+			while (tmp - item->text.value < 80 && *tmp == ' ')
+				tmp++;
+			snprintf(line, 80, "COMMENT  %s", tmp);
+			indigo_copy_value(item->text.value, line);
+		} else if (!strncasecmp(item->text.value, "HISTORY ", 7)) {
+			char *tmp = item->text.value + 7;
+			while (tmp - item->text.value < 80 && *tmp == ' ')
+				tmp++;
+			snprintf(line, 80, "HISTORY  %s", tmp);
+			indigo_copy_value(item->text.value, line);
+		} else if (IS_CONNECTED) {
+			CCD_FITS_HEADERS_PROPERTY->state = INDIGO_ALERT_STATE;
+			indigo_update_property(device, CCD_FITS_HEADERS_PROPERTY, "Invalid header line format");
+			return INDIGO_OK;
+		} else {
+			*item->text.value = 0;
+		}
+	}
+	CCD_FITS_HEADERS_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_FITS_HEADERS_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_jpeg_settings_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_JPEG_SETTINGS
+	indigo_property_copy_values(CCD_JPEG_SETTINGS_PROPERTY, property, false);
+	CCD_JPEG_SETTINGS_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_JPEG_SETTINGS_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_rbi_flush_enable_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
+		CCD_RBI_FLUSH_ENABLE_PROPERTY->state = INDIGO_ALERT_STATE;
+		indigo_update_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, "Exposure in progress, RBI flush can not be changed.");
+		return INDIGO_OK;
+	}
+	indigo_property_copy_values(CCD_RBI_FLUSH_ENABLE_PROPERTY, property, false);
+	CCD_RBI_FLUSH_ENABLE_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED) {
+		indigo_update_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_rbi_flush_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
+		CCD_RBI_FLUSH_PROPERTY->state = INDIGO_ALERT_STATE;
+		indigo_update_property(device, CCD_RBI_FLUSH_PROPERTY, "Exposure in progress, RBI flush can not be changed.");
+		return INDIGO_OK;
+	}
+	indigo_property_copy_values(CCD_RBI_FLUSH_PROPERTY, property, false);
+	CCD_RBI_FLUSH_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED) {
+		indigo_update_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_calibration_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_CALIBRATION
+	indigo_property_copy_values(CCD_CALIBRATION_PROPERTY, property, false);
+	calibration_reset(device, false);
+	CCD_CALIBRATION_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_CALIBRATION_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_calibration_library_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_CALIBRATION_LIBRARY
+	indigo_property_copy_values(CCD_CALIBRATION_LIBRARY_PROPERTY, property, false);
+	long len = strlen(CCD_CALIBRATION_LIBRARY_DIR_ITEM->text.value);
+	if (len == 0)
+		snprintf(CCD_CALIBRATION_LIBRARY_DIR_ITEM->text.value, INDIGO_VALUE_SIZE, "%s/indigo_calibration/", getenv("HOME"));
+	else if (CCD_CALIBRATION_LIBRARY_DIR_ITEM->text.value[len - 1] != '/')
+		strcat(CCD_CALIBRATION_LIBRARY_DIR_ITEM->text.value, "/");
+	calibration_reset(device, true);
+	CCD_CALIBRATION_LIBRARY_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_CALIBRATION_LIBRARY_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_bin_mode_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_BIN_MODE
+	indigo_property_copy_values(CCD_BIN_MODE_PROPERTY, property, false);
+	CCD_BIN_MODE_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_BIN_MODE_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_jpeg_debayer_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_JPEG_DEBAYER
+	indigo_property_copy_values(CCD_JPEG_DEBAYER_PROPERTY, property, false);
+	CCD_JPEG_DEBAYER_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_JPEG_DEBAYER_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_preview_tiers_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_PREVIEW_TIERS
+	indigo_property_copy_values(CCD_PREVIEW_TIERS_PROPERTY, property, false);
+	for (int i = 0; i < CCD_PREVIEW_TIER_COUNT; i++) {
+		indigo_property *tier_property = CCD_PREVIEW_TIER_IMAGE_PROPERTY(i);
+		if (CCD_PREVIEW_TIERS_PROPERTY->items[i].sw.value) {
+			if (tier_property->hidden) {
+				tier_property->hidden = false;
+				if (IS_CONNECTED)
+					indigo_define_property(device, tier_property, NULL);
+			}
+		} else if (!tier_property->hidden) {
+			if (IS_CONNECTED)
+				indigo_delete_property(device, tier_property, NULL);
+			tier_property->hidden = true;
+		}
+	}
+	CCD_PREVIEW_TIERS_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_PREVIEW_TIERS_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result ccd_preview_thumbnail_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CCD_PREVIEW_THUMBNAIL
+	indigo_property_copy_values(CCD_PREVIEW_THUMBNAIL_PROPERTY, property, false);
+	CCD_PREVIEW_THUMBNAIL_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED)
+		indigo_update_property(device, CCD_PREVIEW_THUMBNAIL_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
 indigo_result indigo_ccd_attach(indigo_device *device, const char* driver_name, unsigned version) {
 	assert(device != NULL);
 	if (CCD_CONTEXT == NULL) {
@@ -293,7 +1424,85 @@ indigo_result indigo_ccd_attach(indigo_device *device, const char* driver_name,
 			CCD_RBI_FLUSH_PROPERTY->hidden = true;
 			indigo_init_number_item(CCD_RBI_FLUSH_EXPOSURE_ITEM, CCD_RBI_FLUSH_EXPOSURE_ITEM_NAME, "NIR flood time (s)", 0, 16, 0, 1);
 			indigo_init_number_item(CCD_RBI_FLUSH_COUNT_ITEM, CCD_RBI_FLUSH_COUNT_ITEM_NAME, "Number of flushes", 1, 10, 1, 3);
+			// -------------------------------------------------------------------------------- CCD_CALIBRATION
+			CCD_CALIBRATION_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_CALIBRATION_PROPERTY_NAME, CCD_IMAGE_GROUP, "Calibration", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, 3);
+			if (CCD_CALIBRATION_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_switch_item(CCD_CALIBRATION_BIAS_ITEM, CCD_CALIBRATION_BIAS_ITEM_NAME, "Subtract master bias", false);
+			indigo_init_switch_item(CCD_CALIBRATION_DARK_ITEM, CCD_CALIBRATION_DARK_ITEM_NAME, "Subtract master dark", false);
+			indigo_init_switch_item(CCD_CALIBRATION_FLAT_ITEM, CCD_CALIBRATION_FLAT_ITEM_NAME, "Divide by master flat", false);
+			// -------------------------------------------------------------------------------- CCD_CALIBRATION_LIBRARY
+			CCD_CALIBRATION_LIBRARY_PROPERTY = indigo_init_text_property(NULL, device->name, CCD_CALIBRATION_LIBRARY_PROPERTY_NAME, CCD_IMAGE_GROUP, "Calibration library", INDIGO_OK_STATE, INDIGO_RW_PERM, 1);
+			if (CCD_CALIBRATION_LIBRARY_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_text_item(CCD_CALIBRATION_LIBRARY_DIR_ITEM, CCD_CALIBRATION_LIBRARY_DIR_ITEM_NAME, "Master frames directory", "%s/indigo_calibration/", getenv("HOME"));
+			calibration_context *calibration = indigo_safe_malloc(sizeof(calibration_context));
+			pthread_mutex_init(&calibration->mutex, NULL);
+			CCD_CONTEXT->calibration = calibration;
+			// -------------------------------------------------------------------------------- CCD_BIN_MODE
+			CCD_BIN_MODE_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_BIN_MODE_PROPERTY_NAME, CCD_IMAGE_GROUP, "Software binning", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 2);
+			if (CCD_BIN_MODE_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			CCD_BIN_MODE_PROPERTY->hidden = true;
+			indigo_init_switch_item(CCD_BIN_MODE_SUM_ITEM, CCD_BIN_MODE_SUM_ITEM_NAME, "Sum (saturated)", false);
+			indigo_init_switch_item(CCD_BIN_MODE_AVERAGE_ITEM, CCD_BIN_MODE_AVERAGE_ITEM_NAME, "Average", true);
+			// -------------------------------------------------------------------------------- CCD_JPEG_DEBAYER
+			CCD_JPEG_DEBAYER_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_JPEG_DEBAYER_PROPERTY_NAME, CCD_IMAGE_GROUP, "JPEG debayering", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ONE_OF_MANY_RULE, 3);
+			if (CCD_JPEG_DEBAYER_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_switch_item(CCD_JPEG_DEBAYER_NONE_ITEM, CCD_JPEG_DEBAYER_NONE_ITEM_NAME, "None (show mosaic)", false);
+			indigo_init_switch_item(CCD_JPEG_DEBAYER_SUPERPIXEL_ITEM, CCD_JPEG_DEBAYER_SUPERPIXEL_ITEM_NAME, "Superpixel (half resolution)", false);
+			indigo_init_switch_item(CCD_JPEG_DEBAYER_BILINEAR_ITEM, CCD_JPEG_DEBAYER_BILINEAR_ITEM_NAME, "Bilinear", true);
+			// -------------------------------------------------------------------------------- CCD_PREVIEW_TIERS
+			CCD_PREVIEW_TIERS_PROPERTY = indigo_init_switch_property(NULL, device->name, CCD_PREVIEW_TIERS_PROPERTY_NAME, CCD_MAIN_GROUP, "Downsampled previews", INDIGO_OK_STATE, INDIGO_RW_PERM, INDIGO_ANY_OF_MANY_RULE, CCD_PREVIEW_TIER_COUNT);
+			if (CCD_PREVIEW_TIERS_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_switch_item(CCD_PREVIEW_TIERS_HALF_ITEM, CCD_PREVIEW_TIERS_HALF_ITEM_NAME, "1/2 resolution", false);
+			indigo_init_switch_item(CCD_PREVIEW_TIERS_QUARTER_ITEM, CCD_PREVIEW_TIERS_QUARTER_ITEM_NAME, "1/4 resolution", false);
+			indigo_init_switch_item(CCD_PREVIEW_TIERS_THUMBNAIL_ITEM, CCD_PREVIEW_TIERS_THUMBNAIL_ITEM_NAME, "Thumbnail", false);
+			// -------------------------------------------------------------------------------- CCD_PREVIEW_THUMBNAIL
+			CCD_PREVIEW_THUMBNAIL_PROPERTY = indigo_init_number_property(NULL, device->name, CCD_PREVIEW_THUMBNAIL_PROPERTY_NAME, CCD_MAIN_GROUP, "Thumbnail settings", INDIGO_OK_STATE, INDIGO_RW_PERM, 1);
+			if (CCD_PREVIEW_THUMBNAIL_PROPERTY == NULL)
+				return INDIGO_FAILED;
+			indigo_init_number_item(CCD_PREVIEW_THUMBNAIL_SIZE_ITEM, CCD_PREVIEW_THUMBNAIL_SIZE_ITEM_NAME, "Max edge (px)", 32, 4096, 16, 400);
+			// -------------------------------------------------------------------------------- CCD_PREVIEW_HALF_IMAGE, CCD_PREVIEW_QUARTER_IMAGE, CCD_PREVIEW_THUMBNAIL_IMAGE
+			static const char *tier_names[CCD_PREVIEW_TIER_COUNT] = { CCD_PREVIEW_HALF_IMAGE_PROPERTY_NAME, CCD_PREVIEW_QUARTER_IMAGE_PROPERTY_NAME, CCD_PREVIEW_THUMBNAIL_IMAGE_PROPERTY_NAME };
+			static const char *tier_labels[CCD_PREVIEW_TIER_COUNT] = { "Preview image data (1/2)", "Preview image data (1/4)", "Preview thumbnail data" };
+			for (int i = 0; i < CCD_PREVIEW_TIER_COUNT; i++) {
+				CCD_PREVIEW_TIER_IMAGE_PROPERTY(i) = indigo_init_blob_property(NULL, device->name, tier_names[i], CCD_IMAGE_GROUP, tier_labels[i], INDIGO_OK_STATE, 1);
+				if (CCD_PREVIEW_TIER_IMAGE_PROPERTY(i) == NULL)
+					return INDIGO_FAILED;
+				CCD_PREVIEW_TIER_IMAGE_PROPERTY(i)->hidden = true;
+				indigo_init_blob_item(CCD_PREVIEW_TIER_IMAGE_ITEM(i), CCD_PREVIEW_TIER_IMAGE_ITEM_NAME, "Image data");
+			}
 			// --------------------------------------------------------------------------------
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CONNECTION_PROPERTY, false, ccd_connection_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CONFIG_PROPERTY, false, ccd_config_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_LENS_PROPERTY, false, ccd_lens_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_EXPOSURE_PROPERTY, false, ccd_exposure_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_ABORT_EXPOSURE_PROPERTY, false, ccd_abort_exposure_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_FRAME_PROPERTY, true, ccd_frame_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_BIN_PROPERTY, true, ccd_bin_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_MODE_PROPERTY, true, ccd_mode_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_OFFSET_PROPERTY, true, ccd_offset_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_READ_MODE_PROPERTY, true, ccd_read_mode_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_GAIN_PROPERTY, true, ccd_gain_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_GAMMA_PROPERTY, true, ccd_gamma_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_FRAME_TYPE_PROPERTY, false, ccd_frame_type_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_IMAGE_FORMAT_PROPERTY, false, ccd_image_format_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_UPLOAD_MODE_PROPERTY, false, ccd_upload_mode_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_PREVIEW_PROPERTY, false, ccd_preview_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_LOCAL_MODE_PROPERTY, false, ccd_local_mode_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_FITS_HEADERS_PROPERTY, false, ccd_fits_headers_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_JPEG_SETTINGS_PROPERTY, false, ccd_jpeg_settings_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_RBI_FLUSH_ENABLE_PROPERTY, false, ccd_rbi_flush_enable_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_RBI_FLUSH_PROPERTY, false, ccd_rbi_flush_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_CALIBRATION_PROPERTY, false, ccd_calibration_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_CALIBRATION_LIBRARY_PROPERTY, false, ccd_calibration_library_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_BIN_MODE_PROPERTY, false, ccd_bin_mode_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_JPEG_DEBAYER_PROPERTY, false, ccd_jpeg_debayer_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_PREVIEW_TIERS_PROPERTY, false, ccd_preview_tiers_handler);
+			indigo_bind_change_handler(device, indigo_ccd_change_property, &CCD_PREVIEW_THUMBNAIL_PROPERTY, false, ccd_preview_thumbnail_handler);
 			return INDIGO_OK;
 		}
 	}
@@ -360,6 +1569,22 @@ indigo_result indigo_ccd_enumerate_properties(indigo_device *device, indigo_clie
 			indigo_define_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
 		if (indigo_property_match(CCD_RBI_FLUSH_PROPERTY, property))
 			indigo_define_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
+		if (indigo_property_match(CCD_CALIBRATION_PROPERTY, property))
+			indigo_define_property(device, CCD_CALIBRATION_PROPERTY, NULL);
+		if (indigo_property_match(CCD_CALIBRATION_LIBRARY_PROPERTY, property))
+			indigo_define_property(device, CCD_CALIBRATION_LIBRARY_PROPERTY, NULL);
+		if (indigo_property_match(CCD_BIN_MODE_PROPERTY, property))
+			indigo_define_property(device, CCD_BIN_MODE_PROPERTY, NULL);
+		if (indigo_property_match(CCD_JPEG_DEBAYER_PROPERTY, property))
+			indigo_define_property(device, CCD_JPEG_DEBAYER_PROPERTY, NULL);
+		if (indigo_property_match(CCD_PREVIEW_TIERS_PROPERTY, property))
+			indigo_define_property(device, CCD_PREVIEW_TIERS_PROPERTY, NULL);
+		if (indigo_property_match(CCD_PREVIEW_THUMBNAIL_PROPERTY, property))
+			indigo_define_property(device, CCD_PREVIEW_THUMBNAIL_PROPERTY, NULL);
+		for (int i = 0; i < CCD_PREVIEW_TIER_COUNT; i++) {
+			if (indigo_property_match(CCD_PREVIEW_TIER_IMAGE_PROPERTY(i), property))
+				indigo_define_property(device, CCD_PREVIEW_TIER_IMAGE_PROPERTY(i), NULL);
+		}
 	}
 	return indigo_device_enumerate_properties(device, client, property);
 }
@@ -368,398 +1593,9 @@ indigo_result indigo_ccd_change_property(indigo_device *device, indigo_client *c
 	assert(device != NULL);
 	assert(DEVICE_CONTEXT != NULL);
 	assert(property != NULL);
-	if (indigo_property_match(CONNECTION_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CONNECTION
-		if (IS_CONNECTED) {
-			indigo_define_property(device, CCD_INFO_PROPERTY, NULL);
-			indigo_define_property(device, CCD_LENS_PROPERTY, NULL);
-			indigo_define_property(device, CCD_UPLOAD_MODE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_PREVIEW_PROPERTY, NULL);
-			indigo_define_property(device, CCD_LOCAL_MODE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_MODE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_READ_MODE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_EXPOSURE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_STREAMING_PROPERTY, NULL);
-			indigo_define_property(device, CCD_ABORT_EXPOSURE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_FRAME_PROPERTY, NULL);
-			indigo_define_property(device, CCD_BIN_PROPERTY, NULL);
-			indigo_define_property(device, CCD_OFFSET_PROPERTY, NULL);
-			indigo_define_property(device, CCD_GAIN_PROPERTY, NULL);
-			indigo_define_property(device, CCD_GAMMA_PROPERTY, NULL);
-			indigo_define_property(device, CCD_FRAME_TYPE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_IMAGE_FORMAT_PROPERTY, NULL);
-			indigo_define_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_IMAGE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
-			indigo_define_property(device, CCD_COOLER_PROPERTY, NULL);
-			indigo_define_property(device, CCD_COOLER_POWER_PROPERTY, NULL);
-			indigo_define_property(device, CCD_TEMPERATURE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_FITS_HEADERS_PROPERTY, NULL);
-			indigo_define_property(device, CCD_JPEG_SETTINGS_PROPERTY, NULL);
-			indigo_define_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
-			indigo_define_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
-		} else {
-			CCD_STREAMING_COUNT_ITEM->number.value = 0;
-			CCD_EXPOSURE_ITEM->number.value = 0;
-			CCD_STREAMING_PROPERTY->state = INDIGO_OK_STATE;
-			CCD_EXPOSURE_PROPERTY->state = INDIGO_OK_STATE;
-			CCD_IMAGE_PROPERTY->state = INDIGO_OK_STATE;
-			CCD_COOLER_POWER_PROPERTY->state = INDIGO_OK_STATE;
-			CCD_TEMPERATURE_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_delete_property(device, CCD_INFO_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_LENS_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_UPLOAD_MODE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_PREVIEW_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_LOCAL_MODE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_MODE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_READ_MODE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_EXPOSURE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_STREAMING_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_ABORT_EXPOSURE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_FRAME_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_BIN_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_OFFSET_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_GAIN_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_GAMMA_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_FRAME_TYPE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_IMAGE_FORMAT_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_IMAGE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_COOLER_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_COOLER_POWER_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_TEMPERATURE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_FITS_HEADERS_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_JPEG_SETTINGS_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
-			indigo_delete_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
-		}
-	} else if (indigo_property_match(CONFIG_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CONFIG
-		if (indigo_switch_match(CONFIG_SAVE_ITEM, property)) {
-			indigo_save_property(device, NULL, CCD_LENS_PROPERTY);
-			indigo_save_property(device, NULL, CCD_MODE_PROPERTY);
-			indigo_save_property(device, NULL, CCD_READ_MODE_PROPERTY);
-			indigo_save_property(device, NULL, CCD_UPLOAD_MODE_PROPERTY);
-			indigo_save_property(device, NULL, CCD_LOCAL_MODE_PROPERTY);
-			indigo_save_property(device, NULL, CCD_FRAME_PROPERTY);
-			indigo_save_property(device, NULL, CCD_BIN_PROPERTY);
-			indigo_save_property(device, NULL, CCD_OFFSET_PROPERTY);
-			indigo_save_property(device, NULL, CCD_GAMMA_PROPERTY);
-			indigo_save_property(device, NULL, CCD_GAIN_PROPERTY);
-			indigo_save_property(device, NULL, CCD_FRAME_TYPE_PROPERTY);
-			indigo_save_property(device, NULL, CCD_FITS_HEADERS_PROPERTY);
-			indigo_save_property(device, NULL, CCD_JPEG_SETTINGS_PROPERTY);
-			indigo_save_property(device, NULL, CCD_RBI_FLUSH_ENABLE_PROPERTY);
-			indigo_save_property(device, NULL, CCD_RBI_FLUSH_PROPERTY);
-		}
-	} else if (indigo_property_match(CCD_LENS_PROPERTY, property)) {
-		indigo_property_copy_values(CCD_LENS_PROPERTY, property, false);
-		CCD_LENS_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, CCD_LENS_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(CCD_EXPOSURE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_EXPOSURE
-		if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
-			if (CCD_UPLOAD_MODE_LOCAL_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value) {
-				if (CCD_IMAGE_FILE_PROPERTY->state != INDIGO_BUSY_STATE) {
-					CCD_IMAGE_FILE_PROPERTY->state = INDIGO_BUSY_STATE;
-					indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
-				}
-			}
-			if (CCD_UPLOAD_MODE_CLIENT_ITEM->sw.value || CCD_UPLOAD_MODE_BOTH_ITEM->sw.value) {
-				if (CCD_IMAGE_PROPERTY->state != INDIGO_BUSY_STATE) {
-					CCD_IMAGE_PROPERTY->state = INDIGO_BUSY_STATE;
-					indigo_update_property(device, CCD_IMAGE_PROPERTY, NULL);
-				}
-			}
-			if (CCD_EXPOSURE_ITEM->number.value >= 1) {
-				 indigo_set_timer(device, 1.0, countdown_timer_callback, &CCD_CONTEXT->countdown_timer);
-			}
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match(CCD_ABORT_EXPOSURE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_ABORT_EXPOSURE
-		if (CCD_IMAGE_PROPERTY->state == INDIGO_BUSY_STATE) {
-			CCD_IMAGE_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, CCD_IMAGE_PROPERTY, NULL);
-		}
-		if (CCD_PREVIEW_IMAGE_PROPERTY->state == INDIGO_BUSY_STATE) {
-			CCD_PREVIEW_IMAGE_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
-		}
-		if (CCD_PREVIEW_HISTOGRAM_PROPERTY->state == INDIGO_BUSY_STATE) {
-			CCD_PREVIEW_HISTOGRAM_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
-		}
-		if (CCD_IMAGE_FILE_PROPERTY->state == INDIGO_BUSY_STATE) {
-			CCD_IMAGE_FILE_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, CCD_IMAGE_FILE_PROPERTY, NULL);
-		}
-		if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
-			CCD_EXPOSURE_PROPERTY->state = INDIGO_ALERT_STATE;
-			CCD_EXPOSURE_ITEM->number.value = 0;
-			indigo_update_property(device, CCD_EXPOSURE_PROPERTY, NULL);
-			CCD_ABORT_EXPOSURE_PROPERTY->state = INDIGO_OK_STATE;
-		} else if (CCD_STREAMING_PROPERTY->state == INDIGO_BUSY_STATE) {
-			CCD_STREAMING_PROPERTY->state = INDIGO_ALERT_STATE;
-			CCD_STREAMING_COUNT_ITEM->number.value = 0;
-			indigo_update_property(device, CCD_STREAMING_PROPERTY, NULL);
-			CCD_ABORT_EXPOSURE_PROPERTY->state = INDIGO_OK_STATE;
-		} else {
-			CCD_ABORT_EXPOSURE_PROPERTY->state = INDIGO_ALERT_STATE;
-		}
-		CCD_ABORT_EXPOSURE_ITEM->sw.value = false;
-		indigo_update_property(device, CCD_ABORT_EXPOSURE_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match_w(CCD_FRAME_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_FRAME
-		indigo_property_copy_values(CCD_FRAME_PROPERTY, property, false);
-		CCD_FRAME_WIDTH_ITEM->number.value = ((int)CCD_FRAME_WIDTH_ITEM->number.value / (int)CCD_BIN_HORIZONTAL_ITEM->number.value) * (int)CCD_BIN_HORIZONTAL_ITEM->number.value;
-		CCD_FRAME_HEIGHT_ITEM->number.value = ((int)CCD_FRAME_HEIGHT_ITEM->number.value / (int)CCD_BIN_VERTICAL_ITEM->number.value) * (int)CCD_BIN_VERTICAL_ITEM->number.value;
-		CCD_FRAME_PROPERTY->state = INDIGO_OK_STATE;
-		if (CCD_FRAME_LEFT_ITEM->number.value + CCD_FRAME_WIDTH_ITEM->number.value > CCD_INFO_WIDTH_ITEM->number.value) {
-			CCD_FRAME_WIDTH_ITEM->number.value = CCD_INFO_WIDTH_ITEM->number.value - CCD_FRAME_LEFT_ITEM->number.value;
-			CCD_FRAME_PROPERTY->state = INDIGO_ALERT_STATE;
-		}
-		if (CCD_FRAME_TOP_ITEM->number.value + CCD_FRAME_HEIGHT_ITEM->number.value > CCD_INFO_HEIGHT_ITEM->number.value) {
-			CCD_FRAME_HEIGHT_ITEM->number.value = CCD_INFO_HEIGHT_ITEM->number.value - CCD_FRAME_TOP_ITEM->number.value;
-			CCD_FRAME_PROPERTY->state = INDIGO_ALERT_STATE;
-		}
-		if (IS_CONNECTED) {
-			indigo_update_property(device, CCD_FRAME_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match_w(CCD_BIN_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_BIN
-		indigo_property_copy_values(CCD_BIN_PROPERTY, property, false);
-		char name[32];
-		snprintf(name, 32, "BIN_%dx%d", (int)CCD_BIN_HORIZONTAL_ITEM->number.value, (int)CCD_BIN_VERTICAL_ITEM->number.value);
-		for (int i = 0; i < CCD_MODE_PROPERTY->count; i++) {
-			indigo_item *item = &CCD_MODE_PROPERTY->items[i];
-			item->sw.value = !strcmp(item->name, name);
-		}
-		if (IS_CONNECTED) {
-			CCD_MODE_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, CCD_MODE_PROPERTY, NULL);
-			CCD_BIN_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, CCD_BIN_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match_w(CCD_MODE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_MODE
-		indigo_property_copy_values(CCD_MODE_PROPERTY, property, false);
-		for (int i = 0; i < CCD_MODE_PROPERTY->count; i++) {
-			indigo_item *item = &CCD_MODE_PROPERTY->items[i];
-			if (item->sw.value) {
-				int h, v;
-				if (sscanf(item->name, "BIN_%dx%d", &h, &v) == 2) {
-					CCD_BIN_HORIZONTAL_ITEM->number.value = CCD_BIN_HORIZONTAL_ITEM->number.target = h;
-					CCD_BIN_VERTICAL_ITEM->number.value = CCD_BIN_VERTICAL_ITEM->number.target = v;
-					CCD_FRAME_TOP_ITEM->number.value = CCD_FRAME_LEFT_ITEM->number.value = 0;
-					CCD_FRAME_WIDTH_ITEM->number.value = ((int)CCD_INFO_WIDTH_ITEM->number.value / (int)CCD_BIN_HORIZONTAL_ITEM->number.value) * (int)CCD_BIN_HORIZONTAL_ITEM->number.value;
-					CCD_FRAME_HEIGHT_ITEM->number.value = ((int)CCD_INFO_HEIGHT_ITEM->number.value / (int)CCD_BIN_VERTICAL_ITEM->number.value) * (int)CCD_BIN_VERTICAL_ITEM->number.value;
-				}
-				break;
-			}
-		}
-		if (IS_CONNECTED) {
-			CCD_FRAME_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, CCD_FRAME_PROPERTY, NULL);
-			CCD_BIN_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, CCD_BIN_PROPERTY, NULL);
-			CCD_MODE_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, CCD_MODE_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match_w(CCD_OFFSET_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_OFFSET
-		indigo_property_copy_values(CCD_OFFSET_PROPERTY, property, false);
-		if (IS_CONNECTED) {
-			CCD_OFFSET_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, CCD_OFFSET_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match_w(CCD_READ_MODE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_READ_MODE
-		indigo_property_copy_values(CCD_READ_MODE_PROPERTY, property, false);
-		if (IS_CONNECTED) {
-			CCD_READ_MODE_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, CCD_READ_MODE_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match_w(CCD_GAIN_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_GAIN
-		indigo_property_copy_values(CCD_GAIN_PROPERTY, property, false);
-		if (IS_CONNECTED) {
-			CCD_GAIN_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, CCD_GAIN_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match_w(CCD_GAMMA_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_GAMMA
-		indigo_property_copy_values(CCD_GAMMA_PROPERTY, property, false);
-		if (IS_CONNECTED) {
-			CCD_GAMMA_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, CCD_GAMMA_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match(CCD_FRAME_TYPE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_FRAME_TYPE
-		indigo_property_copy_values(CCD_FRAME_TYPE_PROPERTY, property, false);
-		CCD_FRAME_TYPE_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED)
-			indigo_update_property(device, CCD_FRAME_TYPE_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(CCD_IMAGE_FORMAT_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_IMAGE_FORMAT
-		indigo_property_copy_values(CCD_IMAGE_FORMAT_PROPERTY, property, false);
-		CCD_IMAGE_FORMAT_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED)
-			indigo_update_property(device, CCD_IMAGE_FORMAT_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(CCD_UPLOAD_MODE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_IMAGE_UPLOAD_MODE
-		indigo_property_copy_values(CCD_UPLOAD_MODE_PROPERTY, property, false);
-		CCD_UPLOAD_MODE_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED)
-			indigo_update_property(device, CCD_UPLOAD_MODE_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(CCD_PREVIEW_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_PREVIEW
-		indigo_property_copy_values(CCD_PREVIEW_PROPERTY, property, false);
-		if (CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value) {
-			if (CCD_PREVIEW_IMAGE_PROPERTY->hidden) {
-				CCD_PREVIEW_IMAGE_PROPERTY->hidden = false;
-				if (IS_CONNECTED)
-					indigo_define_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
-			}
-			if (CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden) {
-				CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden = false;
-				if (IS_CONNECTED)
-					indigo_define_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
-			}
-		} else if (CCD_PREVIEW_ENABLED_ITEM->sw.value) {
-			if (CCD_PREVIEW_IMAGE_PROPERTY->hidden) {
-				CCD_PREVIEW_IMAGE_PROPERTY->hidden = false;
-				if (IS_CONNECTED)
-					indigo_define_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
-			}
-			if (!CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden) {
-				if (IS_CONNECTED)
-					indigo_delete_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
-				CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden = true;
-			}
-		} else {
-			if (!CCD_PREVIEW_IMAGE_PROPERTY->hidden) {
-				if (IS_CONNECTED)
-					indigo_delete_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
-				CCD_PREVIEW_IMAGE_PROPERTY->hidden = true;
-			}
-			if (!CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden) {
-				if (IS_CONNECTED)
-					indigo_delete_property(device, CCD_PREVIEW_HISTOGRAM_PROPERTY, NULL);
-				CCD_PREVIEW_HISTOGRAM_PROPERTY->hidden = true;
-			}
-		}
-		CCD_PREVIEW_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED)
-			indigo_update_property(device, CCD_PREVIEW_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(CCD_LOCAL_MODE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_LOCAL_MODE
-		indigo_property_copy_values(CCD_LOCAL_MODE_PROPERTY, property, false);
-		long len = strlen(CCD_LOCAL_MODE_DIR_ITEM->text.value);
-		if (len == 0)
-			snprintf(CCD_LOCAL_MODE_DIR_ITEM->text.value, INDIGO_VALUE_SIZE, "%s/", getenv("HOME"));
-		else if (CCD_LOCAL_MODE_DIR_ITEM->text.value[len - 1] != '/')
-			strcat(CCD_LOCAL_MODE_DIR_ITEM->text.value, "/");
-		CCD_LOCAL_MODE_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED)
-			indigo_update_property(device, CCD_LOCAL_MODE_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(CCD_FITS_HEADERS_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_FITS_HEADERS
-		indigo_property_copy_values(CCD_FITS_HEADERS_PROPERTY, property, false);
-		for (int i = 0; i < CCD_FITS_HEADERS_PROPERTY->count; i++) {
-			indigo_item *item = CCD_FITS_HEADERS_PROPERTY->items + i;
-			if (*item->text.value == 0)
-				continue;
-			char *eq = strchr(item->text.value, '=');
-			char line[81];
-			if (eq) {
-				char *tmp = item->text.value;
-				while (tmp - item->text.value < 8 && (isalpha(*tmp) || isdigit(*tmp) || *tmp == '-' || *tmp == '_')) {
-					int c = toupper(*tmp);
-					*tmp++ = c;
-				}
-				*tmp = 0;
-				eq++;
-				while (eq - item->text.value < 80 && *eq == ' ')
-					eq++;
-				snprintf(line, 80, "%-8s= %s", item->text.value, eq);
-				indigo_copy_value(item->text.value, line);
-			} else if (!strncasecmp(item->text.value, "COMMENT ", 7)) {
-				char *tmp = item->text.value + 7;
-				while (tmp - item->text.value < 80 && *tmp == ' ')
-					tmp++;
-				snprintf(line, 80, "COMMENT  %s", tmp);
-				indigo_copy_value(item->text.value, line);
-			} else if (!strncasecmp(item->text.value, "HISTORY ", 7)) {
-				char *tmp = item->text.value + 7;
-				while (tmp - item->text.value < 80 && *tmp == ' ')
-					tmp++;
-				snprintf(line, 80, "HISTORY  %s", tmp);
-				indigo_copy_value(item->text.value, line);
-			} else if (IS_CONNECTED) {
-				CCD_FITS_HEADERS_PROPERTY->state = INDIGO_ALERT_STATE;
-				indigo_update_property(device, CCD_FITS_HEADERS_PROPERTY, "Invalid header line format");
-				return INDIGO_OK;
-			} else {
-				*item->text.value = 0;
-			}
-		}
-		CCD_FITS_HEADERS_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED)
-			indigo_update_property(device, CCD_FITS_HEADERS_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(CCD_JPEG_SETTINGS_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CCD_JPEG_SETTINGS
-		indigo_property_copy_values(CCD_JPEG_SETTINGS_PROPERTY, property, false);
-		CCD_JPEG_SETTINGS_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED)
-			indigo_update_property(device, CCD_JPEG_SETTINGS_PROPERTY, NULL);
-		return INDIGO_OK;
-		// -------------------------------------------------------------------------------- CCD_RBI_FLUSH_ENABLE
-	} else if (indigo_property_match(CCD_RBI_FLUSH_ENABLE_PROPERTY, property)) {
-		if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
-			CCD_RBI_FLUSH_ENABLE_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, "Exposure in progress, RBI flush can not be changed.");
-			return INDIGO_OK;
-		}
-		indigo_property_copy_values(CCD_RBI_FLUSH_ENABLE_PROPERTY, property, false);
-		CCD_RBI_FLUSH_ENABLE_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED) {
-			indigo_update_property(device, CCD_RBI_FLUSH_ENABLE_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-		// -------------------------------------------------------------------------------- FLI_RBI_FLUSH
-	} else if (indigo_property_match(CCD_RBI_FLUSH_PROPERTY, property)) {
-		if (CCD_EXPOSURE_PROPERTY->state == INDIGO_BUSY_STATE) {
-			CCD_RBI_FLUSH_PROPERTY->state = INDIGO_ALERT_STATE;
-			indigo_update_property(device, CCD_RBI_FLUSH_PROPERTY, "Exposure in progress, RBI flush can not be changed.");
-			return INDIGO_OK;
-		}
-		indigo_property_copy_values(CCD_RBI_FLUSH_PROPERTY, property, false);
-		CCD_RBI_FLUSH_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED) {
-			indigo_update_property(device, CCD_RBI_FLUSH_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-		// --------------------------------------------------------------------------------
-	}
+	indigo_result result;
+	if (indigo_dispatch_change_property(device, indigo_ccd_change_property, client, property, &result))
+		return result;
 	return indigo_device_change_property(device, client, property);
 }
 
@@ -793,6 +1629,17 @@ indigo_result indigo_ccd_detach(indigo_device *device) {
 	indigo_release_property(CCD_JPEG_SETTINGS_PROPERTY);
 	indigo_release_property(CCD_RBI_FLUSH_ENABLE_PROPERTY);
 	indigo_release_property(CCD_RBI_FLUSH_PROPERTY);
+	indigo_release_property(CCD_CALIBRATION_PROPERTY);
+	indigo_release_property(CCD_CALIBRATION_LIBRARY_PROPERTY);
+	indigo_release_property(CCD_BIN_MODE_PROPERTY);
+	indigo_release_property(CCD_JPEG_DEBAYER_PROPERTY);
+	indigo_release_property(CCD_PREVIEW_TIERS_PROPERTY);
+	indigo_release_property(CCD_PREVIEW_THUMBNAIL_PROPERTY);
+	for (int i = 0; i < CCD_PREVIEW_TIER_COUNT; i++) {
+		indigo_release_property(CCD_PREVIEW_TIER_IMAGE_PROPERTY(i));
+		indigo_safe_free(CCD_CONTEXT->preview_tier_image[i]);
+	}
+	calibration_release(device);
 	if (CCD_CONTEXT->preview_image)
 		free(CCD_CONTEXT->preview_image);
 	return indigo_device_detach(device);
@@ -1060,6 +1907,167 @@ static bool create_file_name(char *dir, char *prefix, char *suffix, char *file_n
 	return false;
 }
 
+// -------------------------------------------------------------------------------- Downsampled preview tiers
+
+/* Area averaging to all enabled tiers in a single pass over the input rows. Every input row is widened once and added
+   element by element to the full width 64-bit column sums of each tier (contiguous, vectorizable), columns are summed
+   horizontally only when output row is written after all its input rows are accumulated. 64-bit sums don't overflow
+   for any factor. Tiers are in host byte order with FITS_HEADER_SIZE offset, remainder rows and columns are cropped. */
+static void downsample_preview_tiers(void *data, int width, int height, int byte_per_pixel, int channels, bool little_endian, int factors[], void *tiers[], int tier_width[], int tier_height[]) {
+	bool swap = byte_per_pixel == 2 && !little_endian;
+	int row_size = width * channels;
+	uint32_t *row = indigo_safe_malloc(row_size * sizeof(uint32_t));
+	uint64_t *line[CCD_PREVIEW_TIER_COUNT] = { NULL };
+	int last_row = 0;
+	for (int t = 0; t < CCD_PREVIEW_TIER_COUNT; t++) {
+		if (factors[t] == 0)
+			continue;
+		tier_width[t] = width / factors[t];
+		tier_height[t] = height / factors[t];
+		if (tier_width[t] == 0 || tier_height[t] == 0) {
+			factors[t] = 0;
+			continue;
+		}
+		line[t] = indigo_safe_malloc(row_size * sizeof(uint64_t));
+		tiers[t] = indigo_safe_malloc(FITS_HEADER_SIZE + (long)tier_width[t] * tier_height[t] * channels * byte_per_pixel);
+		if (tier_height[t] * factors[t] > last_row)
+			last_row = tier_height[t] * factors[t];
+	}
+	for (int y = 0; y < last_row; y++) {
+		if (byte_per_pixel == 1) {
+			const uint8_t * restrict in = (const uint8_t *)data + (long)y * row_size;
+			for (int i = 0; i < row_size; i++)
+				row[i] = in[i];
+		} else {
+			const uint16_t * restrict in = (const uint16_t *)data + (long)y * row_size;
+			if (swap) {
+				for (int i = 0; i < row_size; i++)
+					row[i] = (uint16_t)((in[i] >> 8) | (in[i] << 8));
+			} else {
+				for (int i = 0; i < row_size; i++)
+					row[i] = in[i];
+			}
+		}
+		for (int t = 0; t < CCD_PREVIEW_TIER_COUNT; t++) {
+			int factor = factors[t];
+			if (factor == 0 || y >= tier_height[t] * factor)
+				continue;
+			uint64_t * restrict accumulator = line[t];
+			int used = tier_width[t] * factor * channels;
+			for (int i = 0; i < used; i++)
+				accumulator[i] += row[i];
+			if ((y + 1) % factor == 0) {
+				int count = tier_width[t] * channels;
+				uint64_t divisor = (uint64_t)factor * factor;
+				uint64_t half = divisor / 2;
+				long out_row = (long)(y / factor) * count;
+				uint8_t * restrict out8 = (uint8_t *)tiers[t] + FITS_HEADER_SIZE + out_row;
+				uint16_t * restrict out16 = (uint16_t *)((uint8_t *)tiers[t] + FITS_HEADER_SIZE) + out_row;
+				for (int i = 0; i < count; i++) {
+					const uint64_t * restrict in = accumulator + (long)(i / channels) * factor * channels + i % channels;
+					uint64_t sum = 0;
+					for (int k = 0; k < factor; k++)
+						sum += in[k * channels];
+					if (byte_per_pixel == 1)
+						out8[i] = (sum + half) / divisor;
+					else
+						out16[i] = (sum + half) / divisor;
+				}
+				memset(accumulator, 0, used * sizeof(uint64_t));
+			}
+		}
+	}
+	free(row);
+	for (int t = 0; t < CCD_PREVIEW_TIER_COUNT; t++)
+		indigo_safe_free(line[t]);
+}
+
+static void process_preview_tiers(indigo_device *device, void *data, int frame_width, int frame_height, int bpp, bool little_endian, bool byte_order_rgb) {
+	int channels = (bpp == 24 || bpp == 48) ? 3 : 1;
+	int byte_per_pixel = bpp / 8 / channels;
+	int factors[CCD_PREVIEW_TIER_COUNT] = { 0 };
+	if (CCD_PREVIEW_TIERS_HALF_ITEM->sw.value)
+		factors[0] = 2;
+	if (CCD_PREVIEW_TIERS_QUARTER_ITEM->sw.value)
+		factors[1] = 4;
+	if (CCD_PREVIEW_TIERS_THUMBNAIL_ITEM->sw.value) {
+		int max_edge = frame_width > frame_height ? frame_width : frame_height;
+		int size = CCD_PREVIEW_THUMBNAIL_SIZE_ITEM->number.value;
+		factors[2] = size > 0 ? (max_edge + size - 1) / size : 1;
+		if (factors[2] < 1)
+			factors[2] = 1;
+	}
+	void *tiers[CCD_PREVIEW_TIER_COUNT] = { NULL };
+	int tier_width[CCD_PREVIEW_TIER_COUNT] = { 0 }, tier_height[CCD_PREVIEW_TIER_COUNT] = { 0 };
+	INDIGO_DEBUG(clock_t start = clock());
+	downsample_preview_tiers(data + FITS_HEADER_SIZE, frame_width, frame_height, byte_per_pixel, channels, little_endian, factors, tiers, tier_width, tier_height);
+	INDIGO_DEBUG(indigo_debug("Preview tiers downsampling in %gs", (clock() - start) / (double)CLOCKS_PER_SEC));
+	for (int t = 0; t < CCD_PREVIEW_TIER_COUNT; t++) {
+		if (tiers[t] == NULL)
+			continue;
+		indigo_property *tier_property = CCD_PREVIEW_TIER_IMAGE_PROPERTY(t);
+		indigo_item *tier_item = CCD_PREVIEW_TIER_IMAGE_ITEM(t);
+		tier_property->state = INDIGO_BUSY_STATE;
+		indigo_update_property(device, tier_property, NULL);
+		void *jpeg_data = NULL;
+		unsigned long jpeg_size = 0;
+		indigo_raw_to_jpeg(device, tiers[t], tier_width[t], tier_height[t], bpp, true, byte_order_rgb, &jpeg_data, &jpeg_size, NULL, NULL);
+		free(tiers[t]);
+		if (jpeg_data) {
+			if (CCD_CONTEXT->preview_tier_image_size[t] < jpeg_size)
+				CCD_CONTEXT->preview_tier_image[t] = indigo_safe_realloc(CCD_CONTEXT->preview_tier_image[t], CCD_CONTEXT->preview_tier_image_size[t] = jpeg_size);
+			memcpy(CCD_CONTEXT->preview_tier_image[t], jpeg_data, jpeg_size);
+			free(jpeg_data);
+			tier_item->blob.value = CCD_CONTEXT->preview_tier_image[t];
+			tier_item->blob.size = jpeg_size;
+			strcpy(tier_item->blob.format, ".jpeg");
+			tier_property->state = INDIGO_OK_STATE;
+		} else {
+			tier_property->state = INDIGO_ALERT_STATE;
+		}
+		indigo_update_property(device, tier_property, NULL);
+	}
+}
+
+/* Debayered copy of the mosaic for JPEG conversion (with FITS_HEADER_SIZE offset, host byte order) or NULL if the frame is not bayered or debayering is disabled. */
+static void *debayer_for_jpeg(indigo_device *device, void *data, int *frame_width, int *frame_height, int *bpp, bool little_endian, indigo_fits_keyword *keywords) {
+	if (CCD_JPEG_DEBAYER_NONE_ITEM->sw.value || (*bpp != 8 && *bpp != 16))
+		return NULL;
+	indigo_cfa_pattern pattern = INDIGO_CFA_NONE;
+	for (indigo_fits_keyword *keyword = keywords; keyword && keyword->type; keyword++) {
+		if (keyword->type == INDIGO_FITS_STRING && !strcmp(keyword->name, "BAYERPAT")) {
+			pattern = indigo_cfa_pattern_from_string(keyword->string);
+			break;
+		}
+	}
+	if (pattern == INDIGO_CFA_NONE)
+		return NULL;
+	INDIGO_DEBUG(clock_t start = clock());
+	int size = *frame_width * *frame_height;
+	void *mosaic = data + FITS_HEADER_SIZE;
+	uint16_t *swapped = NULL;
+	if (*bpp == 16 && !little_endian) {
+		uint16_t *b16 = mosaic;
+		swapped = indigo_safe_malloc(size * 2);
+		for (int i = 0; i < size; i++)
+			swapped[i] = (b16[i] & 0xff) << 8 | (b16[i] & 0xff00) >> 8;
+		mosaic = swapped;
+	}
+	void *rgb = indigo_safe_malloc(FITS_HEADER_SIZE + 3 * size * (*bpp / 8));
+	int width, height;
+	indigo_result result = indigo_debayer(*bpp == 8 ? INDIGO_RAW_MONO8 : INDIGO_RAW_MONO16, mosaic, *frame_width, *frame_height, pattern, CCD_JPEG_DEBAYER_SUPERPIXEL_ITEM->sw.value ? INDIGO_DEBAYER_SUPERPIXEL : INDIGO_DEBAYER_BILINEAR, rgb + FITS_HEADER_SIZE, &width, &height);
+	indigo_safe_free(swapped);
+	if (result != INDIGO_OK) {
+		free(rgb);
+		return NULL;
+	}
+	INDIGO_DEBUG(indigo_debug("Debayering %dx%d to %dx%d in %gs", *frame_width, *frame_height, width, height, (clock() - start) / (double)CLOCKS_PER_SEC));
+	*frame_width = width;
+	*frame_height = height;
+	*bpp *= 3;
+	return rgb;
+}
+
 void indigo_process_image(indigo_device *device, void *data, int frame_width, int frame_height, int bpp, bool little_endian, bool byte_order_rgb, indigo_fits_keyword *keywords, bool streaming) {
 	assert(device != NULL);
 	assert(data != NULL);
@@ -1068,8 +2076,6 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 	int vertical_bin = CCD_BIN_VERTICAL_ITEM->number.value;
 	int byte_per_pixel = bpp / 8;
 	int naxis = 2;
-	unsigned long size = frame_width * frame_height;
-	unsigned long blobsize = byte_per_pixel * size;
 	if (byte_per_pixel == 3) {
 		byte_per_pixel = 1;
 		naxis = 3;
@@ -1077,13 +2083,52 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		byte_per_pixel = 2;
 		naxis = 3;
 	}
+	if (CCD_CONTEXT->software_binning || CCD_CONTEXT->software_subframe) {
+		bool bayer = false;
+		for (indigo_fits_keyword *keyword = keywords; keyword && keyword->type; keyword++) {
+			if (!strcmp(keyword->name, "BAYERPAT")) {
+				bayer = true;
+				break;
+			}
+		}
+		INDIGO_DEBUG(clock_t start = clock());
+		software_bin(device, data + FITS_HEADER_SIZE, &frame_width, &frame_height, byte_per_pixel, naxis == 3 ? 3 : 1, little_endian, bayer);
+		INDIGO_DEBUG(indigo_debug("Software binning %dx%d to %dx%d in %gs", horizontal_bin, vertical_bin, frame_width, frame_height, (clock() - start) / (double)CLOCKS_PER_SEC));
+	}
+	unsigned long size = frame_width * frame_height;
+	unsigned long blobsize = (bpp / 8) * size;
+
+	char calibration_status[4] = "";
+	if (naxis == 2 && CCD_FRAME_TYPE_LIGHT_ITEM->sw.value && (CCD_CALIBRATION_BIAS_ITEM->sw.value || CCD_CALIBRATION_DARK_ITEM->sw.value || CCD_CALIBRATION_FLAT_ITEM->sw.value)) {
+		INDIGO_DEBUG(clock_t start = clock());
+		if (calibrate_image(device, data + FITS_HEADER_SIZE, frame_width, frame_height, byte_per_pixel, little_endian, calibration_status))
+			INDIGO_DEBUG(indigo_debug("Calibration (%s) in %gs", calibration_status, (clock() - start) / (double)CLOCKS_PER_SEC));
+	}
 
 	void *jpeg_data = NULL;
 	unsigned long jpeg_size = 0;
 	void *histogram_data = NULL;
 	unsigned long histogram_size = 0;
-	if (CCD_IMAGE_FORMAT_JPEG_ITEM->sw.value || CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value || CCD_PREVIEW_ENABLED_ITEM->sw.value || CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value) {
-		indigo_raw_to_jpeg(device, data, frame_width, frame_height, bpp, little_endian, byte_order_rgb, &jpeg_data, &jpeg_size,  CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value ? &histogram_data : NULL, CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value ? &histogram_size : NULL);
+	bool full_jpeg = CCD_IMAGE_FORMAT_JPEG_ITEM->sw.value || CCD_IMAGE_FORMAT_JPEG_AVI_ITEM->sw.value || CCD_PREVIEW_ENABLED_ITEM->sw.value || CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value;
+	bool preview_tiers = false;
+	for (int i = 0; i < CCD_PREVIEW_TIER_COUNT; i++)
+		preview_tiers |= CCD_PREVIEW_TIERS_PROPERTY->items[i].sw.value;
+	if (full_jpeg || preview_tiers) {
+		int jpeg_width = frame_width, jpeg_height = frame_height, jpeg_bpp = bpp;
+		void *debayered = naxis == 2 ? debayer_for_jpeg(device, data, &jpeg_width, &jpeg_height, &jpeg_bpp, little_endian, keywords) : NULL;
+		if (full_jpeg) {
+			if (debayered)
+				indigo_raw_to_jpeg(device, debayered, jpeg_width, jpeg_height, jpeg_bpp, true, true, &jpeg_data, &jpeg_size,  CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value ? &histogram_data : NULL, CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value ? &histogram_size : NULL);
+			else
+				indigo_raw_to_jpeg(device, data, frame_width, frame_height, bpp, little_endian, byte_order_rgb, &jpeg_data, &jpeg_size,  CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value ? &histogram_data : NULL, CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value ? &histogram_size : NULL);
+		}
+		if (preview_tiers) {
+			if (debayered)
+				process_preview_tiers(device, debayered, jpeg_width, jpeg_height, jpeg_bpp, true, true);
+			else
+				process_preview_tiers(device, data, frame_width, frame_height, bpp, little_endian, byte_order_rgb);
+		}
+		indigo_safe_free(debayered);
 		if (CCD_PREVIEW_ENABLED_ITEM->sw.value || CCD_PREVIEW_ENABLED_WITH_HISTOGRAM_ITEM->sw.value) {
 			CCD_PREVIEW_IMAGE_PROPERTY->state = INDIGO_BUSY_STATE;
 			indigo_update_property(device, CCD_PREVIEW_IMAGE_PROPERTY, NULL);
@@ -1203,6 +2248,10 @@ void indigo_process_image(indigo_device *device, void *data, int frame_width, in
 		else if (CCD_FRAME_TYPE_DARKFLAT_ITEM->sw.value)
 			t = sprintf(header += 80, "IMAGETYP= 'DarkFlat'            / frame type");
 		header[t] = ' ';
+		if (*calibration_status) {
+			t = sprintf(header += 80, "CALSTAT = '%s'%*c / calibration applied", calibration_status, (int)(18 - strlen(calibration_status)), ' ');
+			header[t] = ' ';
+		}
 		if (!CCD_GAIN_PROPERTY->hidden) {
 			t = sprintf(header += 80, "GAIN    = %20.2f / Gain", CCD_GAIN_ITEM->number.value);
 			indigo_fix_locale(header - 80);
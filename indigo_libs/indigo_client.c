@@ -33,6 +33,7 @@
 #include <signal.h>
 #include <assert.h>
 #include <pthread.h>
+#include <time.h>
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
 #include <unistd.h>
 #include <libgen.h>
@@ -40,6 +41,7 @@
 #include <netdb.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #endif
 #if defined(INDIGO_WINDOWS)
@@ -52,8 +54,19 @@
 #include <indigo/indigo_client_xml.h>
 #include <indigo/indigo_client.h>
 
+#define RECONNECT_MIN_DELAY		1		/* first reconnect attempt delay [s] */
+#define RECONNECT_MAX_DELAY		60	/* reconnect delay is doubled up to this limit [s] */
+#define RECONNECT_MIN_UPTIME	10	/* connection shorter than this is treated as failed attempt [s] */
+#define RESYNC_GRACE_PERIOD		60	/* cached remote properties are deleted if server is not back within this period [s] */
+
+#define KEEPALIVE_IDLE				10	/* idle time before the first keepalive probe [s] */
+#define KEEPALIVE_INTERVAL		5		/* interval between keepalive probes [s] */
+#define KEEPALIVE_COUNT				3		/* number of unanswered probes before the connection is dropped */
+
 static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
+bool indigo_resync_remote_servers = false;
+
 #if defined(INDIGO_WINDOWS)
 static bool is_pre_vista() {
 	char buffer[MAX_PATH];
@@ -222,9 +235,10 @@ static void *subprocess_thread(indigo_subprocess_entry *subprocess) {
 	pthread_detach(pthread_self());
 	int sleep_interval = 5;
 	while (subprocess->pid >= 0) {
-		int input[2], output[2];
-		if (pipe(input) < 0 || pipe(output) < 0) {
-			INDIGO_ERROR(indigo_error("Can't create local pipe for subprocess %s (%s)", subprocess->executable, strerror(errno)));
+		/* Unix domain socket instead of pipes lets the driver attach BLOBs as shared memory file descriptors */
+		int channel[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, channel) < 0) {
+			INDIGO_ERROR(indigo_error("Can't create local socket for subprocess %s (%s)", subprocess->executable, strerror(errno)));
 			strncpy(subprocess->last_error, strerror(errno), sizeof(subprocess->last_error));
 			return NULL;
 		}
@@ -232,19 +246,24 @@ static void *subprocess_thread(indigo_subprocess_entry *subprocess) {
 		if (subprocess->pid == -1) {
 			INDIGO_ERROR(indigo_error("Can't create subprocess %s (%s)", subprocess->executable, strerror(errno)));
 			strncpy(subprocess->last_error, strerror(errno), sizeof(subprocess->last_error));
+			close(channel[0]);
+			close(channel[1]);
 		} else if (subprocess->pid == 0) {
+			close(channel[0]);
 			close(0);
-			dup2(output[0], 0);
+			dup2(channel[1], 0);
 			close(1);
-			dup2(input[1], 1);
+			dup2(channel[1], 1);
+			close(channel[1]);
 			execlp(subprocess->executable, subprocess->executable, NULL);
 			INDIGO_ERROR(indigo_error("Can't execute driver %s (%s)", subprocess->executable, strerror(errno)));
 			exit(0);
 		} else {
-			close(input[1]);
-			close(output[0]);
+			close(channel[1]);
 			char *slash = strrchr(subprocess->executable, '/');
-			subprocess->protocol_adapter = indigo_xml_client_adapter(slash ? slash + 1 : subprocess->executable, "", input[0], output[1]);
+			subprocess->protocol_adapter = indigo_xml_client_adapter(slash ? slash + 1 : subprocess->executable, "", channel[0], channel[0]);
+			subprocess->protocol_adapter->is_remote = false;
+			((indigo_adapter_context *)subprocess->protocol_adapter->device_context)->shared_blobs = true;
 			indigo_attach_device(subprocess->protocol_adapter);
 			indigo_xml_parse(subprocess->protocol_adapter, NULL);
 			indigo_detach_device(subprocess->protocol_adapter);
@@ -352,9 +371,41 @@ static void reset_socket(indigo_server_entry *server, int new_socket) {
 }
 
 
+static void set_keepalive(int socket) {
+	int value = 1;
+	setsockopt(socket, SOL_SOCKET, SO_KEEPALIVE, (const void *)&value, sizeof(value));
+#if defined(INDIGO_LINUX)
+	value = KEEPALIVE_IDLE;
+	setsockopt(socket, IPPROTO_TCP, TCP_KEEPIDLE, &value, sizeof(value));
+	value = KEEPALIVE_INTERVAL;
+	setsockopt(socket, IPPROTO_TCP, TCP_KEEPINTVL, &value, sizeof(value));
+	value = KEEPALIVE_COUNT;
+	setsockopt(socket, IPPROTO_TCP, TCP_KEEPCNT, &value, sizeof(value));
+#elif defined(INDIGO_MACOS)
+	value = KEEPALIVE_IDLE;
+	setsockopt(socket, IPPROTO_TCP, TCP_KEEPALIVE, &value, sizeof(value));
+	value = KEEPALIVE_INTERVAL;
+	setsockopt(socket, IPPROTO_TCP, TCP_KEEPINTVL, &value, sizeof(value));
+	value = KEEPALIVE_COUNT;
+	setsockopt(socket, IPPROTO_TCP, TCP_KEEPCNT, &value, sizeof(value));
+#endif
+}
+
+static void flush_property_cache(indigo_server_entry *server) {
+	if (server->property_cache) {
+		INDIGO_LOG(indigo_log("Server %s:%d cached properties removed", server->host, server->port));
+		indigo_flush_property_cache(server->property_cache);
+		indigo_safe_free(((indigo_property_cache *)server->property_cache)->properties);
+		free(server->property_cache);
+		server->property_cache = NULL;
+	}
+}
+
 static void *server_thread(indigo_server_entry *server) {
 	INDIGO_LOG(indigo_log("Server %s:%d thread started", server->host, server->port));
 	pthread_detach(pthread_self());
+	int reconnect_delay = RECONNECT_MIN_DELAY;
+	time_t disconnected_at = 0;
 	while (server->socket >= 0) {
 		pthread_mutex_lock(&mutex);
 		reset_socket(server, 0);
@@ -420,6 +471,7 @@ static void *server_thread(indigo_server_entry *server) {
 			pthread_mutex_lock(&mutex);
 			server->last_error[0] = '\0';
 			pthread_mutex_unlock(&mutex);
+			set_keepalive(server->socket);
 			if (*server->name == 0) {
 				indigo_service_name(server->host, server->port, server->name);
 			}
@@ -430,6 +482,10 @@ static void *server_thread(indigo_server_entry *server) {
 			indigo_send_message(server->protocol_adapter, "connected");
 #endif
 			server->protocol_adapter = indigo_xml_client_adapter(server->name, url, server->socket, server->socket);
+			if (indigo_resync_remote_servers && server->property_cache == NULL)
+				server->property_cache = indigo_safe_malloc(sizeof(indigo_property_cache));
+			((indigo_adapter_context *)server->protocol_adapter->device_context)->property_cache = server->property_cache;
+			time_t connected_at = time(NULL);
 			indigo_attach_device(server->protocol_adapter);
 			indigo_xml_parse(server->protocol_adapter, NULL);
 			indigo_detach_device(server->protocol_adapter);
@@ -447,10 +503,23 @@ static void *server_thread(indigo_server_entry *server) {
 #if defined(INDIGO_WINDOWS)
 			indigo_send_message(server->protocol_adapter, "disconnected");
 #endif
-		} else if (server->socket == 0) {
-			indigo_usleep(5 * ONE_SECOND_DELAY);
+			disconnected_at = time(NULL);
+			if (disconnected_at - connected_at >= RECONNECT_MIN_UPTIME) {
+				reconnect_delay = RECONNECT_MIN_DELAY;
+				continue;
+			}
+		}
+		if (server->socket == 0) {
+			if (server->property_cache && disconnected_at && time(NULL) - disconnected_at > RESYNC_GRACE_PERIOD)
+				flush_property_cache(server);
+			INDIGO_LOG(indigo_log("Server %s:%d reconnect in %ds", server->host, server->port, reconnect_delay));
+			for (int i = 0; i < reconnect_delay && server->socket == 0; i++)
+				indigo_usleep(ONE_SECOND_DELAY);
+			if (reconnect_delay < RECONNECT_MAX_DELAY)
+				reconnect_delay = reconnect_delay * 2 < RECONNECT_MAX_DELAY ? reconnect_delay * 2 : RECONNECT_MAX_DELAY;
 		}
 	}
+	flush_property_cache(server);
 	server->thread_started = false;
 	INDIGO_LOG(indigo_log("Server %s:%d thread stopped", server->host, server->port));
 	return NULL;
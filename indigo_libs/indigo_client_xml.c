@@ -77,16 +77,16 @@ static indigo_result xml_client_parser_enumerate_properties(indigo_device *devic
 	}
 	if (property != NULL) {
 		if (*property->device && *indigo_property_name(device->version, property)) {
-			INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d' device='%s' name='%s'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, indigo_xml_escape(device_name), indigo_property_name(device->version, property));
+			INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d' delta='true' device='%s' name='%s'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, indigo_xml_escape(device_name), indigo_property_name(device->version, property));
 		} else if (*property->device) {
-			INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d' device='%s'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, indigo_xml_escape(device_name));
+			INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d' delta='true' device='%s'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, indigo_xml_escape(device_name));
 		} else if (*indigo_property_name(device->version, property)) {
-			INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d' name='%s'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, indigo_property_name(device->version, property));
+			INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d' delta='true' name='%s'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, indigo_property_name(device->version, property));
 		} else {
-			INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF);
+			INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d' delta='true'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF);
 		}
 	} else {
-		INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF);
+		INDIGO_PRINTF(handle, "<getProperties version='1.7' switch='%d.%d' delta='true'/>\n", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF);
 	}
 	pthread_mutex_unlock(&xml_mutex);
 	return INDIGO_OK;
@@ -221,7 +221,8 @@ static indigo_result xml_client_parser_detach(indigo_device *device) {
 	if (device_context->output <= 0)
 		return INDIGO_OK;
 	close(device_context->input);
-	close(device_context->output);
+	if (device_context->output != device_context->input)
+		close(device_context->output);
 	return INDIGO_OK;
 }
 
@@ -25,6 +25,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <unistd.h>
 #include <string.h>
 #include <pthread.h>
@@ -33,6 +34,7 @@
 #include <assert.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <stdint.h>
 #include <time.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -47,6 +49,8 @@
 #include <libusb-1.0/libusb.h>
 #include <linux/serial.h>
 #include <sys/ioctl.h>
+#include <sys/inotify.h>
+#include <poll.h>
 #include <dirent.h>
 #else
 #include <libusb-1.0/libusb.h>
@@ -146,9 +150,28 @@ static int port_type(char *path) {
 #endif
 
 #define MAX_DEVICE_PORTS	20
+#define MAX_SERIAL_PORT_CLIENTS	256
 
-void indigo_enumerate_serial_ports(indigo_device *device, indigo_property *property) {
-	property->count = 1;
+/* Serial ports are scanned once per process and shared by all devices, on Linux the list is kept
+   up to date by watching /dev and devices with DEVICE_PORTS property are refreshed on change.
+*/
+
+static pthread_mutex_t serial_ports_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char serial_ports[MAX_DEVICE_PORTS - 1][INDIGO_NAME_SIZE];
+static int serial_ports_count = 0;
+static bool serial_ports_valid = false;
+static bool serial_ports_monitored = false;
+static indigo_device *serial_ports_clients[MAX_SERIAL_PORT_CLIENTS];
+
+static void add_serial_port(const char *name) {
+	if (serial_ports_count < MAX_DEVICE_PORTS - 1) {
+		indigo_copy_name(serial_ports[serial_ports_count], name);
+		serial_ports_count++;
+	}
+}
+
+static void scan_serial_ports() {
+	serial_ports_count = 0;
 	char name[PATH_MAX];
 #if defined(INDIGO_MACOS)
 	io_iterator_t iterator;
@@ -157,13 +180,12 @@ void indigo_enumerate_serial_ports(indigo_device *device, indigo_property *prope
 	CFDictionarySetValue(matching_dict, CFSTR(kIOSerialBSDTypeKey), CFSTR(kIOSerialBSDAllTypes));
 	kern_return_t kr = IOServiceGetMatchingServices(kIOMasterPortDefault, matching_dict, &iterator);
 	if (kr == 0) {
-		while ((serial_device = IOIteratorNext(iterator)) && property->count < MAX_DEVICE_PORTS) {
+		while ((serial_device = IOIteratorNext(iterator)) && serial_ports_count < MAX_DEVICE_PORTS - 1) {
 			CFTypeRef cfs = IORegistryEntryCreateCFProperty (serial_device, CFSTR(kIOCalloutDeviceKey), kCFAllocatorDefault,0);
 			if (cfs) {
 				CFStringGetCString(cfs, name, INDIGO_VALUE_SIZE, kCFStringEncodingASCII);
 				if (strcmp(name, "/dev/cu.Bluetooth-Incoming-Port") && strcmp(name, "/dev/cu.SSDC") && strcmp(name, "/dev/cu.debug-console") && strcmp(name, "/dev/cu.wlan-debug") && strstr(name, "-WirelessiAP") == NULL) {
-					int i = property->count++;
-					indigo_init_switch_item(property->items + i, name, name, false);
+					add_serial_port(name);
 				}
 				CFRelease(cfs);
 			}
@@ -182,7 +204,7 @@ void indigo_enumerate_serial_ports(indigo_device *device, indigo_property *prope
 	*/
 	dir = opendir("/dev/serial/by-id");
 	if (dir) {
-		while ((entry = readdir(dir)) != NULL && DEVICE_PORTS_PROPERTY->count < MAX_DEVICE_PORTS) {
+		while ((entry = readdir(dir)) != NULL && link_num < MAX_DEVICE_PORTS) {
 			if (entry->d_name[0] != '.') {
 				snprintf(name, PATH_MAX, "/dev/serial/by-id/%s", entry->d_name);
 				if (realpath(name, target)) {
@@ -195,7 +217,9 @@ void indigo_enumerate_serial_ports(indigo_device *device, indigo_property *prope
 	}
 
 	dir = opendir("/dev");
-	while ((entry = readdir(dir)) != NULL && DEVICE_PORTS_PROPERTY->count < MAX_DEVICE_PORTS) {
+	if (dir == NULL)
+		return;
+	while ((entry = readdir(dir)) != NULL && serial_ports_count < MAX_DEVICE_PORTS - 1) {
 		snprintf(name, INDIGO_VALUE_SIZE, "/dev/%s", entry->d_name);
 		if (!realpath(name, target)) continue;
 		if (!strstr(target, "/tty")) continue;
@@ -216,18 +240,138 @@ void indigo_enumerate_serial_ports(indigo_device *device, indigo_property *prope
 			INDIGO_DEBUG(indigo_debug("%s(): path = %s, IS SERIAL (type = %d)", __FUNCTION__, name, ser_type));
 		}
 		if (is_serial) {
-			int i = DEVICE_PORTS_PROPERTY->count++;
-			indigo_init_switch_item(DEVICE_PORTS_PROPERTY->items + i, name, name, false);
-			if (i == 0)
-				indigo_copy_value(DEVICE_PORT_ITEM->text.value, name);
+			add_serial_port(name);
 		}
 	}
 	closedir(dir);
 #else
 	/* freebsd */
+#endif
+	serial_ports_valid = true;
+}
+
+static void serial_ports_changed_handler(indigo_device *device) {
+	if (DEVICE_CONTEXT == NULL)
+		return;
+	indigo_delete_property(device, DEVICE_PORTS_PROPERTY, NULL);
+	indigo_enumerate_serial_ports(device, DEVICE_PORTS_PROPERTY);
+	indigo_define_property(device, DEVICE_PORTS_PROPERTY, NULL);
+	if (*DEVICE_PORT_ITEM->text.value == '/') {
+		indigo_property_state state = access(DEVICE_PORT_ITEM->text.value, R_OK) ? INDIGO_ALERT_STATE : INDIGO_OK_STATE;
+		if (DEVICE_PORT_PROPERTY->state != state) {
+			DEVICE_PORT_PROPERTY->state = state;
+			indigo_update_property(device, DEVICE_PORT_PROPERTY, NULL);
+		}
+	}
+}
+
+static void rescan_serial_ports(indigo_device *requester) {
+	pthread_mutex_lock(&serial_ports_mutex);
+	int previous_count = serial_ports_count;
+	char previous[MAX_DEVICE_PORTS - 1][INDIGO_NAME_SIZE];
+	memcpy(previous, serial_ports, sizeof(previous));
+	scan_serial_ports();
+	if (previous_count != serial_ports_count || memcmp(previous, serial_ports, serial_ports_count * INDIGO_NAME_SIZE)) {
+		INDIGO_DEBUG(indigo_debug("%s(): %d serial ports found", __FUNCTION__, serial_ports_count));
+		/* properties are refreshed from device timer threads, bus calls are never made with serial_ports_mutex locked */
+		for (int i = 0; i < MAX_SERIAL_PORT_CLIENTS; i++) {
+			if (serial_ports_clients[i] != NULL && serial_ports_clients[i] != requester)
+				indigo_set_timer(serial_ports_clients[i], 0, serial_ports_changed_handler, NULL);
+		}
+	}
+	pthread_mutex_unlock(&serial_ports_mutex);
+}
+
+#if defined(INDIGO_LINUX)
+static void *serial_ports_monitor(void *data) {
+	int fd = (int)(intptr_t)data;
+	char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+	while (true) {
+		ssize_t length = read(fd, buffer, sizeof(buffer));
+		if (length <= 0) {
+			if (length < 0 && errno == EINTR)
+				continue;
+			break;
+		}
+		bool changed = false;
+		for (char *ptr = buffer; ptr < buffer + length; ) {
+			struct inotify_event *event = (struct inotify_event *)ptr;
+			if (event->len > 0 && !(event->mask & IN_ISDIR))
+				changed = true;
+			ptr += sizeof(struct inotify_event) + event->len;
+		}
+		if (!changed)
+			continue;
+		/* udev creates device node first and links later, wait for the burst to settle and rescan once */
+		struct pollfd pfd = { fd, POLLIN, 0 };
+		while (poll(&pfd, 1, 500) > 0 && read(fd, buffer, sizeof(buffer)) > 0)
+			;
+		rescan_serial_ports(NULL);
+	}
+	INDIGO_ERROR(indigo_error("Serial port monitor failed (%s)", strerror(errno)));
+	pthread_mutex_lock(&serial_ports_mutex);
+	serial_ports_monitored = false;
+	pthread_mutex_unlock(&serial_ports_mutex);
+	close(fd);
+	return NULL;
+}
+#endif
+
+static void start_serial_ports_monitor() {
+#if defined(INDIGO_LINUX)
+	int fd = inotify_init1(IN_CLOEXEC);
+	if (fd < 0) {
+		INDIGO_ERROR(indigo_error("Can't initialize serial port monitor (%s)", strerror(errno)));
+		return;
+	}
+	if (inotify_add_watch(fd, "/dev", IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0 || !indigo_async(serial_ports_monitor, (void *)(intptr_t)fd)) {
+		INDIGO_ERROR(indigo_error("Can't start serial port monitor (%s)", strerror(errno)));
+		close(fd);
+		return;
+	}
+	serial_ports_monitored = true;
 #endif
 }
 
+static void unregister_serial_ports_client(indigo_device *device) {
+	pthread_mutex_lock(&serial_ports_mutex);
+	for (int i = 0; i < MAX_SERIAL_PORT_CLIENTS; i++) {
+		if (serial_ports_clients[i] == device)
+			serial_ports_clients[i] = NULL;
+	}
+	pthread_mutex_unlock(&serial_ports_mutex);
+}
+
+void indigo_enumerate_serial_ports(indigo_device *device, indigo_property *property) {
+	static bool monitor_started = false;
+	pthread_mutex_lock(&serial_ports_mutex);
+	if (!monitor_started) {
+		monitor_started = true;
+		start_serial_ports_monitor();
+	}
+	/* without monitor the cached list can't be trusted */
+	if (!serial_ports_valid || !serial_ports_monitored)
+		scan_serial_ports();
+	if (device != NULL && DEVICE_CONTEXT != NULL && property == DEVICE_PORTS_PROPERTY) {
+		int empty = -1;
+		for (int i = 0; i < MAX_SERIAL_PORT_CLIENTS; i++) {
+			if (serial_ports_clients[i] == device) {
+				empty = -1;
+				break;
+			}
+			if (serial_ports_clients[i] == NULL && empty < 0)
+				empty = i;
+		}
+		if (empty >= 0)
+			serial_ports_clients[empty] = device;
+	}
+	property->count = 1;
+	for (int i = 0; i < serial_ports_count; i++) {
+		indigo_init_switch_item(property->items + property->count++, serial_ports[i], serial_ports[i], false);
+	}
+	pthread_mutex_unlock(&serial_ports_mutex);
+}
+
 int indigo_compensate_backlash(int requested_position, int current_position, int backlash, bool *is_last_move_poitive) {
 	uint32_t target_position = requested_position;
 	int move = requested_position - current_position;
@@ -258,6 +402,220 @@ int indigo_compensate_backlash(int requested_position, int current_position, int
 	return target_position;
 }
 
+/* Change handlers are kept in per device hash table keyed by interned property name and layer. */
+
+#define CHANGE_HANDLER_BUCKETS	32
+
+typedef struct change_handler_entry {
+	struct change_handler_entry *next;
+	indigo_change_handler layer;
+	const char *name;
+	indigo_property **property;
+	bool writable_only;
+	indigo_change_handler handler;
+} change_handler_entry;
+
+static uint32_t property_name_hash(const char *name) {
+	uint32_t hash = 2166136261u;
+	while (*name)
+		hash = (hash ^ (unsigned char)*name++) * 16777619u;
+	return hash;
+}
+
+void indigo_bind_change_handler(indigo_device *device, indigo_change_handler layer, indigo_property **property, bool writable_only, indigo_change_handler handler) {
+	assert(device != NULL);
+	assert(DEVICE_CONTEXT != NULL);
+	assert(property != NULL && *property != NULL);
+	if (DEVICE_CONTEXT->change_handlers == NULL)
+		DEVICE_CONTEXT->change_handlers = indigo_safe_malloc(CHANGE_HANDLER_BUCKETS * sizeof(change_handler_entry *));
+	const char *name = indigo_intern_string((*property)->name);
+	uint32_t hash = property_name_hash(name);
+	change_handler_entry **bucket = (change_handler_entry **)DEVICE_CONTEXT->change_handlers + (hash % CHANGE_HANDLER_BUCKETS);
+	change_handler_entry *entry;
+	for (entry = *bucket; entry != NULL; entry = entry->next) {
+		if (entry->layer == layer && entry->name == name)
+			break;
+	}
+	if (entry == NULL) {
+		entry = indigo_safe_malloc(sizeof(change_handler_entry));
+		entry->layer = layer;
+		entry->name = name;
+		entry->next = *bucket;
+		*bucket = entry;
+	} else {
+		indigo_release_string(name);
+	}
+	entry->property = property;
+	entry->writable_only = writable_only;
+	entry->handler = handler;
+}
+
+bool indigo_dispatch_change_property(indigo_device *device, indigo_change_handler layer, indigo_client *client, indigo_property *property, indigo_result *result) {
+	change_handler_entry **buckets = (change_handler_entry **)DEVICE_CONTEXT->change_handlers;
+	if (buckets == NULL)
+		return false;
+	const char *name = indigo_find_interned_string(property->name);
+	if (name == NULL)
+		return false;
+	uint32_t hash = property_name_hash(name);
+	for (change_handler_entry *entry = buckets[hash % CHANGE_HANDLER_BUCKETS]; entry != NULL; entry = entry->next) {
+		if (entry->layer == layer && entry->name == name) {
+			if (entry->writable_only ? indigo_property_match_w(*entry->property, property) : indigo_property_match(*entry->property, property)) {
+				*result = entry->handler(device, client, property);
+				return true;
+			}
+			return false;
+		}
+	}
+	return false;
+}
+
+static void release_change_handlers(indigo_device *device) {
+	change_handler_entry **buckets = (change_handler_entry **)DEVICE_CONTEXT->change_handlers;
+	if (buckets == NULL)
+		return;
+	for (int i = 0; i < CHANGE_HANDLER_BUCKETS; i++) {
+		change_handler_entry *entry = buckets[i];
+		while (entry != NULL) {
+			change_handler_entry *next = entry->next;
+			indigo_release_string(entry->name);
+			free(entry);
+			entry = next;
+		}
+	}
+	free(buckets);
+	DEVICE_CONTEXT->change_handlers = NULL;
+}
+
+static indigo_result connection_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CONNECTION
+	if (CONNECTION_PROPERTY->state == INDIGO_ALERT_STATE)
+		indigo_set_switch(CONNECTION_PROPERTY, CONNECTION_DISCONNECTED_ITEM, true);
+	indigo_token token = indigo_get_device_token(device->name);
+	if (CONNECTION_CONNECTED_ITEM->sw.value) {
+		if (token > 0) {
+			device->access_token = token;
+		} else {
+			device->access_token = property->access_token;
+		}
+	} else {
+		device->access_token = token;
+	}
+	indigo_update_property(device, CONNECTION_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result simulation_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- SIMULATION
+	indigo_property_copy_values(SIMULATION_PROPERTY, property, false);
+	SIMULATION_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, SIMULATION_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result config_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CONFIG
+	if (indigo_switch_match(CONFIG_LOAD_ITEM, property)) {
+		if (indigo_load_properties(device, false) == INDIGO_OK)
+			CONFIG_PROPERTY->state = INDIGO_OK_STATE;
+		else
+			CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
+		CONFIG_LOAD_ITEM->sw.value = false;
+	} else if (indigo_switch_match(CONFIG_SAVE_ITEM, property)) {
+		indigo_save_property(device, NULL, SIMULATION_PROPERTY);
+		indigo_save_property(device, NULL, DEVICE_PORT_PROPERTY);
+		indigo_save_property(device, NULL, DEVICE_BAUDRATE_PROPERTY);
+		if (indigo_flush_properties(device) == INDIGO_OK) {
+			CONFIG_PROPERTY->state = INDIGO_OK_STATE;
+		} else {
+			CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
+		}
+		CONFIG_SAVE_ITEM->sw.value = false;
+	} else if (indigo_switch_match(CONFIG_REMOVE_ITEM, property)) {
+		if (indigo_remove_properties(device) == INDIGO_OK)
+			CONFIG_PROPERTY->state = INDIGO_OK_STATE;
+		else
+			CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
+		CONFIG_REMOVE_ITEM->sw.value = false;
+	}
+	indigo_update_property(device, CONFIG_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result profile_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- PROFILE
+	indigo_property_copy_values(PROFILE_PROPERTY, property, false);
+	PROFILE_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, PROFILE_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result device_port_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- DEVICE_PORT
+	indigo_property_copy_values(DEVICE_PORT_PROPERTY, property, false);
+	if (*DEVICE_PORT_ITEM->text.value == '/') {
+		if (!access(DEVICE_PORT_ITEM->text.value, R_OK)) {
+			DEVICE_PORT_PROPERTY->state = INDIGO_OK_STATE;
+			indigo_save_property(device, NULL, DEVICE_PORT_PROPERTY);
+			indigo_update_property(device, DEVICE_PORT_PROPERTY, NULL);
+		} else {
+			DEVICE_PORT_PROPERTY->state = INDIGO_ALERT_STATE;
+			indigo_update_property(device, DEVICE_PORT_PROPERTY, "Serial port %s does not exists", DEVICE_PORT_ITEM->text.value);
+		}
+	} else {
+		DEVICE_PORT_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_save_property(device, NULL, DEVICE_PORT_PROPERTY);
+		indigo_update_property(device, DEVICE_PORT_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result device_baudrate_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- DEVICE_BAUDRATE
+	indigo_property_copy_values(DEVICE_BAUDRATE_PROPERTY, property, false);
+	DEVICE_BAUDRATE_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_save_property(device, NULL, DEVICE_BAUDRATE_PROPERTY);
+	indigo_update_property(device, DEVICE_BAUDRATE_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result device_ports_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- DEVICE_PORTS
+	indigo_property_copy_values(DEVICE_PORTS_PROPERTY, property, false);
+	if (DEVICE_PORTS_PROPERTY->items->sw.value) {
+		rescan_serial_ports(device);
+		indigo_delete_property(device, DEVICE_PORTS_PROPERTY, NULL);
+		indigo_enumerate_serial_ports(device, DEVICE_PORTS_PROPERTY);
+		DEVICE_PORTS_PROPERTY->items->sw.value = false;
+		indigo_define_property(device, DEVICE_PORTS_PROPERTY, NULL);
+	} else {
+		for (int i = 0; i < DEVICE_PORTS_PROPERTY->count; i++) {
+			if (DEVICE_PORTS_PROPERTY->items[i].sw.value) {
+				indigo_copy_value(DEVICE_PORT_ITEM->text.value, DEVICE_PORTS_PROPERTY->items[i].name);
+				DEVICE_PORTS_PROPERTY->items[i].sw.value = false;
+			}
+		}
+	}
+	if (*DEVICE_PORT_ITEM->text.value == '/' && access(DEVICE_PORT_ITEM->text.value, R_OK)) {
+		DEVICE_PORT_PROPERTY->state = INDIGO_ALERT_STATE;
+	} else {
+		DEVICE_PORT_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_save_property(device, NULL, DEVICE_PORT_PROPERTY);
+	}
+	indigo_update_property(device, DEVICE_PORT_PROPERTY, NULL);
+	DEVICE_PORTS_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, DEVICE_PORTS_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result authentication_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- AUTHENTICATION
+	indigo_property_copy_values(AUTHENTICATION_PROPERTY, property, false);
+	PROFILE_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, AUTHENTICATION_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
 indigo_result indigo_device_attach(indigo_device *device, const char* driver_name, indigo_version version, int interface) {
 	assert(device != NULL);
 	assert(device != NULL);
@@ -338,15 +696,86 @@ indigo_result indigo_device_attach(indigo_device *device, const char* driver_nam
 		AUTHENTICATION_PROPERTY->hidden = true;
 		indigo_init_text_item(AUTHENTICATION_PASSWORD_ITEM, AUTHENTICATION_PASSWORD_ITEM_NAME, "Password", "");
 		indigo_init_text_item(AUTHENTICATION_USER_ITEM, AUTHENTICATION_USER_ITEM_NAME, "User name", "");
+		// --------------------------------------------------------------------------------
+		indigo_bind_change_handler(device, indigo_device_change_property, &CONNECTION_PROPERTY, false, connection_handler);
+		indigo_bind_change_handler(device, indigo_device_change_property, &SIMULATION_PROPERTY, true, simulation_handler);
+		indigo_bind_change_handler(device, indigo_device_change_property, &CONFIG_PROPERTY, false, config_handler);
+		indigo_bind_change_handler(device, indigo_device_change_property, &PROFILE_PROPERTY, false, profile_handler);
+		indigo_bind_change_handler(device, indigo_device_change_property, &DEVICE_PORT_PROPERTY, true, device_port_handler);
+		indigo_bind_change_handler(device, indigo_device_change_property, &DEVICE_BAUDRATE_PROPERTY, true, device_baudrate_handler);
+		indigo_bind_change_handler(device, indigo_device_change_property, &DEVICE_PORTS_PROPERTY, false, device_ports_handler);
+		indigo_bind_change_handler(device, indigo_device_change_property, &AUTHENTICATION_PROPERTY, false, authentication_handler);
 		pthread_mutex_init(&DEVICE_CONTEXT->config_mutex, NULL);
 		return INDIGO_OK;
 	}
 	return INDIGO_FAILED;
 }
 
+/* Remote clients enumerating all devices and agents enumerating selected device are subscribers,
+   detached clients are dropped when subscription is checked.
+*/
+
+static pthread_mutex_t subscribers_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const double poll_intervals[2][3] = {
+	{ 1, 5, 10 },			// not subscribed - busy, active, idle
+	{ 0.5, 1, 1 }			// subscribed - busy, active, idle
+};
+
+static void subscribe_client(indigo_device *device, indigo_client *client) {
+	pthread_mutex_lock(&subscribers_mutex);
+	int empty = -1;
+	for (int i = 0; i < INDIGO_MAX_SUBSCRIBERS; i++) {
+		if (DEVICE_CONTEXT->subscribers[i] == client) {
+			pthread_mutex_unlock(&subscribers_mutex);
+			return;
+		}
+		if (DEVICE_CONTEXT->subscribers[i] == NULL && empty < 0)
+			empty = i;
+	}
+	if (empty >= 0) {
+		DEVICE_CONTEXT->subscribers[empty] = client;
+		INDIGO_DEBUG(indigo_debug("'%s' subscribed to '%s'", client->name, device->name));
+	}
+	pthread_mutex_unlock(&subscribers_mutex);
+}
+
+bool indigo_device_is_subscribed(indigo_device *device) {
+	assert(device != NULL);
+	if (DEVICE_CONTEXT == NULL)
+		return false;
+	indigo_client *subscribers[INDIGO_MAX_SUBSCRIBERS];
+	pthread_mutex_lock(&subscribers_mutex);
+	memcpy(subscribers, DEVICE_CONTEXT->subscribers, sizeof(subscribers));
+	pthread_mutex_unlock(&subscribers_mutex);
+	bool result = false;
+	/* indigo_is_client_attached() locks the bus, subscribers_mutex must not be held */
+	for (int i = 0; i < INDIGO_MAX_SUBSCRIBERS; i++) {
+		if (subscribers[i] == NULL)
+			continue;
+		if (indigo_is_client_attached(subscribers[i])) {
+			result = true;
+		} else {
+			pthread_mutex_lock(&subscribers_mutex);
+			if (DEVICE_CONTEXT->subscribers[i] == subscribers[i])
+				DEVICE_CONTEXT->subscribers[i] = NULL;
+			pthread_mutex_unlock(&subscribers_mutex);
+		}
+	}
+	return result;
+}
+
+double indigo_poll_interval(indigo_device *device, indigo_poll_state state) {
+	if (state < INDIGO_POLL_BUSY || state > INDIGO_POLL_IDLE)
+		state = INDIGO_POLL_ACTIVE;
+	return poll_intervals[indigo_device_is_subscribed(device) ? 1 : 0][state];
+}
+
 indigo_result indigo_device_enumerate_properties(indigo_device *device, indigo_client *client, indigo_property *property) {
 	assert(device != NULL);
 	assert(DEVICE_CONTEXT != NULL);
+	if (client != NULL && property != NULL && (client->is_remote || *property->device))
+		subscribe_client(device, client);
 	if (indigo_property_match(INFO_PROPERTY, property) && !INFO_PROPERTY->hidden)
 		indigo_define_property(device, INFO_PROPERTY, NULL);
 	if (indigo_property_match(SIMULATION_PROPERTY, property) && !SIMULATION_PROPERTY->hidden)
@@ -372,119 +801,14 @@ indigo_result indigo_device_change_property(indigo_device *device, indigo_client
 	assert(device != NULL);
 	assert(DEVICE_CONTEXT != NULL);
 	assert(property != NULL);
-	if (indigo_property_match(CONNECTION_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CONNECTION
-		if (CONNECTION_PROPERTY->state == INDIGO_ALERT_STATE)
-			indigo_set_switch(CONNECTION_PROPERTY, CONNECTION_DISCONNECTED_ITEM, true);
-		indigo_token token = indigo_get_device_token(device->name);
-		if (CONNECTION_CONNECTED_ITEM->sw.value) {
-			if (token > 0) {
-				device->access_token = token;
-			} else {
-				device->access_token = property->access_token;
-			}
-		} else {
-			device->access_token = token;
-		}
-		indigo_update_property(device, CONNECTION_PROPERTY, NULL);
-	} else if (indigo_property_match_w(SIMULATION_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- SIMULATION
-		indigo_property_copy_values(SIMULATION_PROPERTY, property, false);
-		SIMULATION_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, SIMULATION_PROPERTY, NULL);
-	} else if (indigo_property_match(CONFIG_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CONFIG
-		if (indigo_switch_match(CONFIG_LOAD_ITEM, property)) {
-			if (indigo_load_properties(device, false) == INDIGO_OK)
-				CONFIG_PROPERTY->state = INDIGO_OK_STATE;
-			else
-				CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
-			CONFIG_LOAD_ITEM->sw.value = false;
-		} else if (indigo_switch_match(CONFIG_SAVE_ITEM, property)) {
-			indigo_save_property(device, NULL, SIMULATION_PROPERTY);
-			indigo_save_property(device, NULL, DEVICE_PORT_PROPERTY);
-			indigo_save_property(device, NULL, DEVICE_BAUDRATE_PROPERTY);
-			if (DEVICE_CONTEXT->property_save_file_handle) {
-				CONFIG_PROPERTY->state = INDIGO_OK_STATE;
-				close(DEVICE_CONTEXT->property_save_file_handle);
-				DEVICE_CONTEXT->property_save_file_handle = 0;
-			} else {
-				CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
-			}
-			CONFIG_SAVE_ITEM->sw.value = false;
-		} else if (indigo_switch_match(CONFIG_REMOVE_ITEM, property)) {
-			if (indigo_remove_properties(device) == INDIGO_OK)
-				CONFIG_PROPERTY->state = INDIGO_OK_STATE;
-			else
-				CONFIG_PROPERTY->state = INDIGO_ALERT_STATE;
-			CONFIG_REMOVE_ITEM->sw.value = false;
-		}
-		indigo_update_property(device, CONFIG_PROPERTY, NULL);
-	} else if (indigo_property_match(PROFILE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- PROFILE
-		indigo_property_copy_values(PROFILE_PROPERTY, property, false);
-		PROFILE_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, PROFILE_PROPERTY, NULL);
-	} else if (indigo_property_match_w(DEVICE_PORT_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- DEVICE_PORT
-		indigo_property_copy_values(DEVICE_PORT_PROPERTY, property, false);
-		if (*DEVICE_PORT_ITEM->text.value == '/') {
-			if (!access(DEVICE_PORT_ITEM->text.value, R_OK)) {
-				DEVICE_PORT_PROPERTY->state = INDIGO_OK_STATE;
-				indigo_save_property(device, NULL, DEVICE_PORT_PROPERTY);
-				indigo_update_property(device, DEVICE_PORT_PROPERTY, NULL);
-			} else {
-				DEVICE_PORT_PROPERTY->state = INDIGO_ALERT_STATE;
-				indigo_update_property(device, DEVICE_PORT_PROPERTY, "Serial port %s does not exists", DEVICE_PORT_ITEM->text.value);
-			}
-		} else {
-			DEVICE_PORT_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_save_property(device, NULL, DEVICE_PORT_PROPERTY);
-			indigo_update_property(device, DEVICE_PORT_PROPERTY, NULL);
-		}
-	} else if (indigo_property_match_w(DEVICE_BAUDRATE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- DEVICE_BAUDRATE
-		indigo_property_copy_values(DEVICE_BAUDRATE_PROPERTY, property, false);
-		DEVICE_BAUDRATE_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_save_property(device, NULL, DEVICE_BAUDRATE_PROPERTY);
-		indigo_update_property(device, DEVICE_BAUDRATE_PROPERTY, NULL);
-	} else if (indigo_property_match(DEVICE_PORTS_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- DEVICE_PORTS
-		indigo_property_copy_values(DEVICE_PORTS_PROPERTY, property, false);
-		if (DEVICE_PORTS_PROPERTY->items->sw.value) {
-			indigo_delete_property(device, DEVICE_PORTS_PROPERTY, NULL);
-			indigo_enumerate_serial_ports(device, DEVICE_PORTS_PROPERTY);
-			DEVICE_PORTS_PROPERTY->items->sw.value = false;
-			indigo_define_property(device, DEVICE_PORTS_PROPERTY, NULL);
-		} else {
-			for (int i = 0; i < DEVICE_PORTS_PROPERTY->count; i++) {
-				if (DEVICE_PORTS_PROPERTY->items[i].sw.value) {
-					indigo_copy_value(DEVICE_PORT_ITEM->text.value, DEVICE_PORTS_PROPERTY->items[i].name);
-					DEVICE_PORTS_PROPERTY->items[i].sw.value = false;
-				}
-			}
-		}
-		if (*DEVICE_PORT_ITEM->text.value == '/' && access(DEVICE_PORT_ITEM->text.value, R_OK)) {
-			DEVICE_PORT_PROPERTY->state = INDIGO_ALERT_STATE;
-		} else {
-			DEVICE_PORT_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_save_property(device, NULL, DEVICE_PORT_PROPERTY);
-		}
-		indigo_update_property(device, DEVICE_PORT_PROPERTY, NULL);
-		DEVICE_PORTS_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, DEVICE_PORTS_PROPERTY, NULL);
-	} else if (indigo_property_match(AUTHENTICATION_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- AUTHENTICATION
-		indigo_property_copy_values(AUTHENTICATION_PROPERTY, property, false);
-		PROFILE_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, AUTHENTICATION_PROPERTY, NULL);
-		// --------------------------------------------------------------------------------
-	}
-	return INDIGO_OK;
+	indigo_result result = INDIGO_OK;
+	indigo_dispatch_change_property(device, indigo_device_change_property, client, property, &result);
+	return result;
 }
 
 indigo_result indigo_device_detach(indigo_device *device) {
 	assert(device != NULL);
+	unregister_serial_ports_client(device);
 	indigo_cancel_all_timers(device);
 	indigo_release_property(CONNECTION_PROPERTY);
 	indigo_release_property(INFO_PROPERTY);
@@ -498,6 +822,8 @@ indigo_result indigo_device_detach(indigo_device *device) {
 	indigo_property *all_properties = indigo_init_text_property(NULL, device->name, "", "", "", INDIGO_OK_STATE, INDIGO_RO_PERM, 0);
 	indigo_delete_property(device, all_properties, NULL);
 	indigo_release_property(all_properties);
+	indigo_release_config_store(device);
+	release_change_handlers(device);
 	pthread_mutex_destroy(&DEVICE_CONTEXT->config_mutex);
 	free(DEVICE_CONTEXT);
 	device->device_context = NULL;
@@ -545,96 +871,389 @@ int indigo_open_config_file(char *device_name, int profile, int mode, const char
 	return -1;
 }
 
+#define CONFIG_FLUSH_DELAY	3	/* configuration store is written after this quiet period [s] */
+
+typedef struct {
+	char name[INDIGO_NAME_SIZE];
+	char *content;
+	long length;
+} config_entry;
+
+/* entries are merged by property name, stale entries are dropped only by indigo_remove_properties() */
+typedef struct config_store {
+	pthread_mutex_t mutex;
+	indigo_device *device;
+	bool loaded;
+	bool dirty;
+	int profile;
+	int count;
+	int size;
+	config_entry *entries;
+	bool queued;
+	time_t last_change;
+	struct config_store *next;
+} config_store;
+
+static pthread_mutex_t config_flush_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t config_flush_cond = PTHREAD_COND_INITIALIZER;
+static config_store *config_flush_queue = NULL;
+static config_store *config_flush_busy = NULL;
+static bool config_flush_thread_started = false;
+
+typedef struct {
+	char *buffer;
+	long length;
+	long size;
+} config_buffer;
+
+static void config_append(config_buffer *buffer, const char *format, ...) {
+	va_list args;
+	while (true) {
+		va_start(args, format);
+		long length = vsnprintf(buffer->buffer + buffer->length, buffer->size - buffer->length, format, args);
+		va_end(args);
+		if (buffer->length + length < buffer->size) {
+			buffer->length += length;
+			break;
+		}
+		buffer->size = 2 * (buffer->size + length);
+		buffer->buffer = indigo_safe_realloc(buffer->buffer, buffer->size);
+	}
+}
+
+static bool config_item_selected(indigo_item *item, const int count, const char **items) {
+	if (items == NULL)
+		return true;
+	for (int j = 0; j < count; j++) {
+		if (!strncmp(items[j], item->name, INDIGO_NAME_SIZE))
+			return true;
+	}
+	return false;
+}
+
+static void config_serialize(config_buffer *buffer, indigo_property *property, const int count, const char **items) {
+	char b1[32];
+	switch (property->type) {
+	case INDIGO_TEXT_VECTOR:
+		config_append(buffer, "<newTextVector device='%s' name='%s'>\n", indigo_xml_escape(property->device), property->name);
+		for (int i = 0; i < property->count; i++) {
+			indigo_item *item = &property->items[i];
+			if (config_item_selected(item, count, items))
+				config_append(buffer, "<oneText name='%s'>%s</oneText>\n", item->name, indigo_xml_escape(indigo_get_text_item_value(item)));
+		}
+		config_append(buffer, "</newTextVector>\n");
+		break;
+	case INDIGO_NUMBER_VECTOR:
+		config_append(buffer, "<newNumberVector device='%s' name='%s'>\n", indigo_xml_escape(property->device), property->name);
+		for (int i = 0; i < property->count; i++) {
+			indigo_item *item = &property->items[i];
+			if (config_item_selected(item, count, items))
+				config_append(buffer, "<oneNumber name='%s'>%s</oneNumber>\n", item->name, indigo_dtoa(item->number.value, b1));
+		}
+		config_append(buffer, "</newNumberVector>\n");
+		break;
+	case INDIGO_SWITCH_VECTOR:
+		config_append(buffer, "<newSwitchVector device='%s' name='%s'>\n", indigo_xml_escape(property->device), property->name);
+		for (int i = 0; i < property->count; i++) {
+			indigo_item *item = &property->items[i];
+			if (config_item_selected(item, count, items))
+				config_append(buffer, "<oneSwitch name='%s'>%s</oneSwitch>\n", item->name, item->sw.value ? "On" : "Off");
+		}
+		config_append(buffer, "</newSwitchVector>\n");
+		break;
+	default:
+		break;
+	}
+}
+
+static int config_profile(indigo_device *device) {
+	if (DEVICE_CONTEXT && PROFILE_PROPERTY) {
+		for (int i = 0; i < PROFILE_COUNT; i++)
+			if (PROFILE_PROPERTY->items[i].sw.value)
+				return i;
+	}
+	return 0;
+}
+
+static void config_store_clear(config_store *store) {
+	for (int i = 0; i < store->count; i++)
+		indigo_safe_free(store->entries[i].content);
+	store->count = 0;
+	store->dirty = false;
+}
+
+static void config_store_put(config_store *store, const char *name, char *content, long length) {
+	config_entry *entry = NULL;
+	for (int i = 0; i < store->count; i++) {
+		if (!strncmp(store->entries[i].name, name, INDIGO_NAME_SIZE)) {
+			entry = store->entries + i;
+			break;
+		}
+	}
+	if (entry == NULL) {
+		if (store->count == store->size) {
+			store->size = store->size ? 2 * store->size : 16;
+			store->entries = indigo_safe_realloc(store->entries, store->size * sizeof(config_entry));
+		}
+		entry = store->entries + store->count++;
+		indigo_copy_name(entry->name, name);
+		entry->content = NULL;
+		entry->length = 0;
+	} else if (entry->length == length && !memcmp(entry->content, content, length)) {
+		free(content);
+		return;
+	}
+	indigo_safe_free(entry->content);
+	entry->content = content;
+	entry->length = length;
+	store->dirty = true;
+}
+
+static void config_store_parse(config_store *store, char *buffer, long length) {
+	char *end = buffer + length;
+	char *begin = buffer;
+	while ((begin = strstr(begin, "<new")) != NULL) {
+		char *tag_end = strchr(begin, ' ');
+		char *name = strstr(begin, " name='");
+		char *close = strchr(begin, '>');
+		if (tag_end == NULL || name == NULL || close == NULL || name > close)
+			break;
+		char tag[INDIGO_NAME_SIZE] = "</";
+		int tag_length = (int)(tag_end - begin - 1);
+		if (tag_length <= 0 || tag_length > INDIGO_NAME_SIZE - 4)
+			break;
+		strncat(tag, begin + 1, tag_length);
+		strcat(tag, ">");
+		char *element_end = strstr(close, tag);
+		if (element_end == NULL)
+			break;
+		element_end += strlen(tag);
+		if (element_end < end && *element_end == '\n')
+			element_end++;
+		name += 7;
+		char *name_end = strchr(name, '\'');
+		if (name_end == NULL || name_end - name >= INDIGO_NAME_SIZE)
+			break;
+		char property_name[INDIGO_NAME_SIZE];
+		memcpy(property_name, name, name_end - name);
+		property_name[name_end - name] = 0;
+		config_store_put(store, property_name, indigo_safe_malloc_copy(element_end - begin, begin), element_end - begin);
+		begin = element_end;
+	}
+	store->dirty = false;
+}
+
+static char *config_read_file(char *device_name, int profile, const char *suffix, long *length) {
+	int handle = indigo_open_config_file(device_name, profile, O_RDONLY, suffix);
+	if (handle < 0)
+		return NULL;
+	struct stat file_stat;
+	char *buffer = NULL;
+	*length = 0;
+	if (fstat(handle, &file_stat) == 0) {
+		buffer = indigo_safe_malloc(file_stat.st_size + 1);
+		while (*length < file_stat.st_size) {
+			long count = read(handle, buffer + *length, file_stat.st_size - *length);
+			if (count <= 0)
+				break;
+			*length += count;
+		}
+		buffer[*length] = 0;
+	}
+	close(handle);
+	return buffer;
+}
+
+static config_store *config_store_get(indigo_device *device) {
+	if (DEVICE_CONTEXT->config_store == NULL) {
+		config_store *store = indigo_safe_malloc(sizeof(config_store));
+		pthread_mutex_init(&store->mutex, NULL);
+		store->device = device;
+		DEVICE_CONTEXT->config_store = store;
+	}
+	return DEVICE_CONTEXT->config_store;
+}
+
+static indigo_result config_store_write(indigo_device *device, config_store *store) {
+	if (!store->dirty)
+		return INDIGO_OK;
+	char path[512], tmp_path[520];
+	if (!make_config_file_name(device->name, store->profile, ".config", path, sizeof(path)))
+		return INDIGO_FAILED;
+	snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+	long length = 0;
+	for (int i = 0; i < store->count; i++)
+		length += store->entries[i].length;
+	char *buffer = indigo_safe_malloc(length + 1), *pointer = buffer;
+	for (int i = 0; i < store->count; i++) {
+		memcpy(pointer, store->entries[i].content, store->entries[i].length);
+		pointer += store->entries[i].length;
+	}
+	indigo_result result = INDIGO_FAILED;
+	int handle = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (handle < 0) {
+		INDIGO_DEBUG(indigo_debug("Can't create %s (%s)", tmp_path, strerror(errno)));
+	} else {
+		bool written = indigo_write(handle, buffer, length);
+		written = fsync(handle) == 0 && written;
+		close(handle);
+		if (written && rename(tmp_path, path) == 0) {
+			INDIGO_TRACE(indigo_trace("Config file %s written (%ld bytes, %d properties)", path, length, store->count));
+			store->dirty = false;
+			result = INDIGO_OK;
+		} else {
+			INDIGO_ERROR(indigo_error("Can't write %s (%s)", path, strerror(errno)));
+			unlink(tmp_path);
+		}
+	}
+	free(buffer);
+	return result;
+}
+
+static void *config_flush_thread(void *arg) {
+	pthread_mutex_lock(&config_flush_mutex);
+	while (true) {
+		config_store *store = config_flush_queue;
+		if (store == NULL) {
+			pthread_cond_wait(&config_flush_cond, &config_flush_mutex);
+			continue;
+		}
+		for (config_store *other = store->next; other; other = other->next) {
+			if (other->last_change < store->last_change)
+				store = other;
+		}
+		time_t now = time(NULL);
+		if (now - store->last_change < CONFIG_FLUSH_DELAY) {
+			struct timespec deadline = { store->last_change + CONFIG_FLUSH_DELAY, 0 };
+			pthread_cond_timedwait(&config_flush_cond, &config_flush_mutex, &deadline);
+			continue;
+		}
+		config_store **previous = &config_flush_queue;
+		while (*previous != store)
+			previous = &(*previous)->next;
+		*previous = store->next;
+		store->queued = false;
+		config_flush_busy = store;
+		pthread_mutex_unlock(&config_flush_mutex);
+		pthread_mutex_lock(&store->mutex);
+		config_store_write(store->device, store);
+		pthread_mutex_unlock(&store->mutex);
+		pthread_mutex_lock(&config_flush_mutex);
+		config_flush_busy = NULL;
+		pthread_cond_broadcast(&config_flush_cond);
+	}
+	return NULL;
+}
+
+static void config_store_enqueue(config_store *store) {
+	pthread_mutex_lock(&config_flush_mutex);
+	store->last_change = time(NULL);
+	if (!store->queued) {
+		store->next = config_flush_queue;
+		config_flush_queue = store;
+		store->queued = true;
+	}
+	if (!config_flush_thread_started)
+		config_flush_thread_started = indigo_async(config_flush_thread, NULL);
+	pthread_cond_broadcast(&config_flush_cond);
+	pthread_mutex_unlock(&config_flush_mutex);
+}
+
+static void config_store_dequeue(config_store *store) {
+	pthread_mutex_lock(&config_flush_mutex);
+	if (store->queued) {
+		config_store **previous = &config_flush_queue;
+		while (*previous != store)
+			previous = &(*previous)->next;
+		*previous = store->next;
+		store->queued = false;
+	}
+	while (config_flush_busy == store)
+		pthread_cond_wait(&config_flush_cond, &config_flush_mutex);
+	pthread_mutex_unlock(&config_flush_mutex);
+}
+
+static void config_store_load(indigo_device *device, config_store *store, int profile) {
+	if (store->loaded && store->profile == profile)
+		return;
+	if (store->loaded)
+		config_store_write(device, store);
+	config_store_clear(store);
+	store->profile = profile;
+	store->loaded = true;
+	long length = 0;
+	char *buffer = config_read_file(device->name, profile, ".config", &length);
+	if (buffer) {
+		config_store_parse(store, buffer, length);
+		free(buffer);
+	}
+}
+
+static indigo_result config_store_save(indigo_device *device, indigo_property *property, const int count, const char **items) {
+	config_buffer buffer = { indigo_safe_malloc(1024), 0, 1024 };
+	config_serialize(&buffer, property, count, items);
+	config_store *store = config_store_get(device);
+	pthread_mutex_lock(&store->mutex);
+	config_store_load(device, store, config_profile(device));
+	config_store_put(store, property->name, buffer.buffer, buffer.length);
+	bool dirty = store->dirty;
+	pthread_mutex_unlock(&store->mutex);
+	if (dirty)
+		config_store_enqueue(store);
+	return INDIGO_OK;
+}
+
 indigo_result indigo_load_properties(indigo_device *device, bool default_properties) {
 	assert(device != NULL);
 	int profile = 0;
 	if (DEVICE_CONTEXT) {
 		pthread_mutex_lock(&DEVICE_CONTEXT->config_mutex);
-		for (int i = 0; i < PROFILE_COUNT; i++)
-			if (PROFILE_PROPERTY->items[i].sw.value) {
-				profile = i;
-				break;
+		profile = config_profile(device);
+	}
+	long length = 0;
+	char *buffer = NULL;
+	if (DEVICE_CONTEXT && !default_properties) {
+		config_store *store = config_store_get(device);
+		pthread_mutex_lock(&store->mutex);
+		if (store->loaded)
+			config_store_write(device, store);
+		store->loaded = false;
+		config_store_load(device, store, profile);
+		if (store->count > 0) {
+			for (int i = 0; i < store->count; i++)
+				length += store->entries[i].length;
+			char *pointer = buffer = indigo_safe_malloc(length + 1);
+			for (int i = 0; i < store->count; i++) {
+				memcpy(pointer, store->entries[i].content, store->entries[i].length);
+				pointer += store->entries[i].length;
 			}
+		}
+		pthread_mutex_unlock(&store->mutex);
+	} else {
+		buffer = config_read_file(device->name, profile, default_properties ? ".default" : ".config", &length);
 	}
-	int handle = indigo_open_config_file(device->name, profile, O_RDONLY, default_properties ? ".default" : ".config");
-	if (handle > 0) {
-		INDIGO_TRACE(indigo_trace("Config file open for '%s' with descriptor %d", device->name, handle));
+	bool loaded = false;
+	if (buffer != NULL) {
+		INDIGO_TRACE(indigo_trace("Config for '%s' loaded (%ld bytes)", device->name, length));
 		indigo_client *client = indigo_safe_malloc(sizeof(indigo_client));
 		strcpy(client->name, CONFIG_READER);
 		indigo_adapter_context *context = indigo_safe_malloc(sizeof(indigo_adapter_context));
-		context->input = handle;
+		context->input = context->output = -1;
 		client->client_context = context;
 		client->version = INDIGO_VERSION_CURRENT;
-		indigo_xml_parse(NULL, client);
-		close(handle);
+		indigo_xml_parse_buffer(client, buffer, length);
 		free(context);
 		free(client);
+		free(buffer);
+		loaded = true;
 	}
 	if (DEVICE_CONTEXT)
 		pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
-	return handle > 0 ? INDIGO_OK : INDIGO_FAILED;
+	return loaded ? INDIGO_OK : INDIGO_FAILED;
 }
 
 indigo_result indigo_save_property(indigo_device *device, int *file_handle, indigo_property *property) {
-	if (property == NULL)
-		return INDIGO_FAILED;
-	if (DEVICE_CONTEXT && pthread_mutex_trylock(&DEVICE_CONTEXT->config_mutex)) {
-		INDIGO_DEBUG(indigo_debug("Config file is locked, property '%s.%s' not saved", device->name, property->name));
-		return INDIGO_FAILED;
-	}
-	if (!property->hidden && property->perm != INDIGO_RO_PERM) {
-		char b1[32];
-		if (file_handle == NULL)
-			file_handle = &DEVICE_CONTEXT->property_save_file_handle;
-		int handle = *file_handle;
-		if (handle == 0) {
-			int profile = 0;
-			if (DEVICE_CONTEXT) {
-				for (int i = 0; i < PROFILE_COUNT; i++)
-					if (PROFILE_PROPERTY->items[i].sw.value) {
-						profile = i;
-						break;
-					}
-			}
-			*file_handle = handle = indigo_open_config_file(property->device, profile, O_WRONLY | O_CREAT | O_TRUNC, ".config");
-			if (handle == 0) {
-				if (DEVICE_CONTEXT)
-					pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
-				return INDIGO_FAILED;
-			}
-		}
-		switch (property->type) {
-		case INDIGO_TEXT_VECTOR:
-			indigo_printf(handle, "<newTextVector device='%s' name='%s'>\n", indigo_xml_escape(property->device), property->name, indigo_property_state_text[property->state]);
-			for (int i = 0; i < property->count; i++) {
-				indigo_item *item = &property->items[i];
-				indigo_printf(handle, "<oneText name='%s'>%s</oneText>\n", item->name, indigo_xml_escape(indigo_get_text_item_value(item)));
-			}
-			indigo_printf(handle, "</newTextVector>\n");
-			break;
-		case INDIGO_NUMBER_VECTOR:
-			indigo_printf(handle, "<newNumberVector device='%s' name='%s'>\n", indigo_xml_escape(property->device), property->name, indigo_property_state_text[property->state]);
-			for (int i = 0; i < property->count; i++) {
-				indigo_item *item = &property->items[i];
-				indigo_printf(handle, "<oneNumber name='%s'>%s</oneNumber>\n", item->name, indigo_dtoa(item->number.value, b1));
-			}
-			indigo_printf(handle, "</newNumberVector>\n");
-			break;
-		case INDIGO_SWITCH_VECTOR:
-			indigo_printf(handle, "<newSwitchVector device='%s' name='%s'>\n", indigo_xml_escape(property->device), property->name, indigo_property_state_text[property->state]);
-			for (int i = 0; i < property->count; i++) {
-				indigo_item *item = &property->items[i];
-				indigo_printf(handle, "<oneSwitch name='%s'>%s</oneSwitch>\n", item->name, item->sw.value ? "On" : "Off");
-			}
-			indigo_printf(handle, "</newSwitchVector>\n");
-			break;
-		default:
-			break;
-		}
-	}
-	if (DEVICE_CONTEXT)
-		pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
-	return INDIGO_OK;
+	return indigo_save_property_items(device, file_handle, property, 0, NULL);
 }
 
 indigo_result indigo_save_property_items(indigo_device*device, int *file_handle, indigo_property *property, const int count, const char **items) {
@@ -644,74 +1263,57 @@ indigo_result indigo_save_property_items(indigo_device*device, int *file_handle,
 		INDIGO_DEBUG(indigo_debug("Config file is locked, property '%s.%s' not saved", device->name, property->name));
 		return INDIGO_FAILED;
 	}
+	indigo_result result = INDIGO_OK;
 	if (!property->hidden && property->perm != INDIGO_RO_PERM) {
-		char b1[32];
-		if (file_handle == NULL)
-			file_handle = &DEVICE_CONTEXT->property_save_file_handle;
-		int handle = *file_handle;
-		if (handle == 0) {
-			int profile = 0;
-			if (DEVICE_CONTEXT) {
-				for (int i = 0; i < PROFILE_COUNT; i++)
-					if (PROFILE_PROPERTY->items[i].sw.value) {
-						profile = i;
-						break;
-					}
-			}
-			*file_handle = handle = indigo_open_config_file(property->device, profile, O_WRONLY | O_CREAT | O_TRUNC, ".config");
+		if (file_handle == NULL) {
+			result = config_store_save(device, property, count, items);
+		} else {
+			int handle = *file_handle;
 			if (handle == 0) {
-				if (DEVICE_CONTEXT)
-					pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
-				return INDIGO_FAILED;
-			}
-		}
-		switch (property->type) {
-		case INDIGO_TEXT_VECTOR:
-			indigo_printf(handle, "<newTextVector device='%s' name='%s'>\n", indigo_xml_escape(property->device), property->name, indigo_property_state_text[property->state]);
-			for (int i = 0; i < property->count; i++) {
-				indigo_item *item = &property->items[i];
-				for (int j = 0; j < count; j++) {
-					if (!strncmp(items[j], item->name, INDIGO_NAME_SIZE)) {
-						indigo_printf(handle, "<oneText name='%s'>%s</oneText>\n", item->name, indigo_xml_escape(item->text.value));
-						break;
-					}
+				*file_handle = handle = indigo_open_config_file(property->device, config_profile(device), O_WRONLY | O_CREAT | O_TRUNC, ".config");
+				if (handle <= 0) {
+					if (DEVICE_CONTEXT)
+						pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
+					return INDIGO_FAILED;
 				}
 			}
-			indigo_printf(handle, "</newTextVector>\n");
-			break;
-		case INDIGO_NUMBER_VECTOR:
-			indigo_printf(handle, "<newNumberVector device='%s' name='%s'>\n", indigo_xml_escape(property->device), property->name, indigo_property_state_text[property->state]);
-			for (int i = 0; i < property->count; i++) {
-				indigo_item *item = &property->items[i];
-				for (int j = 0; j < count; j++) {
-					if (!strncmp(items[j], item->name, INDIGO_NAME_SIZE)) {
-						indigo_printf(handle, "<oneNumber name='%s'>%s</oneNumber>\n", item->name, indigo_dtoa(item->number.value, b1));
-						break;
-					}
-				}
-			}
-			indigo_printf(handle, "</newNumberVector>\n");
-			break;
-		case INDIGO_SWITCH_VECTOR:
-			indigo_printf(handle, "<newSwitchVector device='%s' name='%s'>\n", indigo_xml_escape(property->device), property->name, indigo_property_state_text[property->state]);
-			for (int i = 0; i < property->count; i++) {
-				indigo_item *item = &property->items[i];
-				for (int j = 0; j < count; j++) {
-					if (!strncmp(items[j], item->name, INDIGO_NAME_SIZE)) {
-						indigo_printf(handle, "<oneSwitch name='%s'>%s</oneSwitch>\n", item->name, item->sw.value ? "On" : "Off");
-						break;
-					}
-				}
-			}
-			indigo_printf(handle, "</newSwitchVector>\n");
-			break;
-		default:
-			break;
+			config_buffer buffer = { indigo_safe_malloc(1024), 0, 1024 };
+			config_serialize(&buffer, property, count, items);
+			if (!indigo_write(handle, buffer.buffer, buffer.length))
+				result = INDIGO_FAILED;
+			free(buffer.buffer);
 		}
 	}
 	if (DEVICE_CONTEXT)
 		pthread_mutex_unlock(&DEVICE_CONTEXT->config_mutex);
-	return INDIGO_OK;
+	return result;
+}
+
+indigo_result indigo_flush_properties(indigo_device *device) {
+	assert(device != NULL);
+	if (DEVICE_CONTEXT == NULL || DEVICE_CONTEXT->config_store == NULL)
+		return INDIGO_OK;
+	config_store *store = DEVICE_CONTEXT->config_store;
+	pthread_mutex_lock(&store->mutex);
+	indigo_result result = config_store_write(device, store);
+	pthread_mutex_unlock(&store->mutex);
+	return result;
+}
+
+void indigo_release_config_store(indigo_device *device) {
+	assert(device != NULL);
+	if (DEVICE_CONTEXT == NULL || DEVICE_CONTEXT->config_store == NULL)
+		return;
+	config_store *store = DEVICE_CONTEXT->config_store;
+	config_store_dequeue(store);
+	pthread_mutex_lock(&store->mutex);
+	config_store_write(device, store);
+	config_store_clear(store);
+	indigo_safe_free(store->entries);
+	pthread_mutex_unlock(&store->mutex);
+	pthread_mutex_destroy(&store->mutex);
+	free(store);
+	DEVICE_CONTEXT->config_store = NULL;
 }
 
 indigo_result indigo_remove_properties(indigo_device *device) {
@@ -720,11 +1322,15 @@ indigo_result indigo_remove_properties(indigo_device *device) {
 	if (DEVICE_CONTEXT) {
 		if (pthread_mutex_trylock(&DEVICE_CONTEXT->config_mutex))
 			return INDIGO_FAILED;
-		for (int i = 0; i < PROFILE_COUNT; i++)
-			if (PROFILE_PROPERTY->items[i].sw.value) {
-				profile = i;
-				break;
-			}
+		profile = config_profile(device);
+		if (DEVICE_CONTEXT->config_store) {
+			config_store *store = DEVICE_CONTEXT->config_store;
+			pthread_mutex_lock(&store->mutex);
+			config_store_clear(store);
+			store->profile = profile;
+			store->loaded = true;
+			pthread_mutex_unlock(&store->mutex);
+		}
 	}
 	static char path[512];
 	if (make_config_file_name(device->name, profile, ".config", path, sizeof(path))) {
@@ -746,13 +1352,15 @@ static void *hotplug_thread(void *arg) {
 	return NULL;
 }
 
+static void start_usb_event_handler(void) {
+	libusb_init(NULL);
+	indigo_async(hotplug_thread, NULL);
+}
+
 void indigo_start_usb_event_handler() {
-	static bool thread_started = false;
-	if (!thread_started) {
-		libusb_init(NULL);
-		indigo_async(hotplug_thread, NULL);
-		thread_started = true;
-	}
+	/* drivers may be initialized in parallel */
+	static pthread_once_t once = PTHREAD_ONCE_INIT;
+	pthread_once(&once, start_usb_event_handler);
 }
 
 /* TO BE REMOVED!
@@ -76,6 +76,7 @@ static indigo_result json_define_property(indigo_client *client, indigo_device *
 	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
 	assert(client_context != NULL);
 	int handle = client_context->output;
+	indigo_track_sent_values(client_context, property);
 	char *output_buffer = indigo_safe_malloc(JSON_BUFFER_SIZE);
 	char *pnt = output_buffer;
 	int size;
@@ -235,6 +236,9 @@ static indigo_result json_update_property(indigo_client *client, indigo_device *
 	char *pnt = output_buffer;
 	int size;
 	char b1[32], b2[32];
+	bool changed[property->count];
+	indigo_select_changed_items(client_context, property, changed);
+	int sent = 0;
 	switch (property->type) {
 		case INDIGO_TEXT_VECTOR:
 			size = sprintf(pnt, "{ \"setTextVector\": { \"device\": \"%s\", \"name\": \"%s\", \"state\": \"%s\"", property->device, property->name, indigo_property_state_text[property->state]);
@@ -247,8 +251,10 @@ static indigo_result json_update_property(indigo_client *client, indigo_device *
 				pnt += size;
 			}
 			for (int i = 0; i < property->count; i++) {
+				if (!changed[i])
+					continue;
 				indigo_item *item = &property->items[i];
-				size = sprintf(pnt, "%s { \"name\": \"%s\", \"value\": \"%s\" }",  i > 0 ? "," : "", item->name, indigo_json_escape(indigo_get_text_item_value(item)));
+				size = sprintf(pnt, "%s { \"name\": \"%s\", \"value\": \"%s\" }",  sent++ > 0 ? "," : "", item->name, indigo_json_escape(indigo_get_text_item_value(item)));
 				pnt += size;
 			}
 			size = sprintf(pnt, " ] } }");
@@ -265,11 +271,13 @@ static indigo_result json_update_property(indigo_client *client, indigo_device *
 				pnt += size;
 			}
 			for (int i = 0; i < property->count; i++) {
+				if (!changed[i])
+					continue;
 				indigo_item *item = &property->items[i];
 				if (property->perm != INDIGO_RO_PERM)
-					size = sprintf(pnt, "%s { \"name\": \"%s\", \"target\": %s, \"value\": %s }",  i > 0 ? "," : "", item->name, indigo_dtoa(item->number.target, b1), indigo_dtoa(item->number.value, b2));
+					size = sprintf(pnt, "%s { \"name\": \"%s\", \"target\": %s, \"value\": %s }",  sent++ > 0 ? "," : "", item->name, indigo_dtoa(item->number.target, b1), indigo_dtoa(item->number.value, b2));
 				else
-					size = sprintf(pnt, "%s { \"name\": \"%s\", \"value\": %s }",  i > 0 ? "," : "", item->name, indigo_dtoa(item->number.value, b1));
+					size = sprintf(pnt, "%s { \"name\": \"%s\", \"value\": %s }",  sent++ > 0 ? "," : "", item->name, indigo_dtoa(item->number.value, b1));
 				pnt += size;
 			}
 			size = sprintf(pnt, " ] } }");
@@ -286,8 +294,10 @@ static indigo_result json_update_property(indigo_client *client, indigo_device *
 				pnt += size;
 			}
 			for (int i = 0; i < property->count; i++) {
+				if (!changed[i])
+					continue;
 				indigo_item *item = &property->items[i];
-				size = sprintf(pnt, "%s { \"name\": \"%s\", \"value\": %s }",  i > 0 ? "," : "", item->name, item->sw.value ? "true" : "false");
+				size = sprintf(pnt, "%s { \"name\": \"%s\", \"value\": %s }",  sent++ > 0 ? "," : "", item->name, item->sw.value ? "true" : "false");
 				pnt += size;
 			}
 			size = sprintf(pnt, " ] } }");
@@ -304,8 +314,10 @@ static indigo_result json_update_property(indigo_client *client, indigo_device *
 				pnt += size;
 			}
 			for (int i = 0; i < property->count; i++) {
+				if (!changed[i])
+					continue;
 				indigo_item *item = &property->items[i];
-				size = sprintf(pnt, "%s { \"name\": \"%s\", \"value\": \"%s\" }",  i > 0 ? "," : "", item->name, indigo_property_state_text[item->light.value]);
+				size = sprintf(pnt, "%s { \"name\": \"%s\", \"value\": \"%s\" }",  sent++ > 0 ? "," : "", item->name, indigo_property_state_text[item->light.value]);
 				pnt += size;
 			}
 			size = sprintf(pnt, " ] } }");
@@ -364,6 +376,7 @@ static indigo_result json_delete_property(indigo_client *client, indigo_device *
 	indigo_adapter_context *client_context = (indigo_adapter_context *)client->client_context;
 	assert(client_context != NULL);
 	int handle = client_context->output;
+	indigo_forget_sent_values(client_context, property);
 	char *output_buffer = indigo_safe_malloc(JSON_BUFFER_SIZE);
 	char *pnt = output_buffer;
 	int size;
@@ -460,6 +473,7 @@ indigo_client *indigo_json_device_adapter(int input, int ouput, bool web_socket)
 void indigo_release_json_device_adapter(indigo_client *client) {
 	assert(client != NULL);
 	assert(client->client_context != NULL);
+	indigo_forget_sent_values(client->client_context, NULL);
 	free(client->client_context);
 	free(client);
 }
@@ -90,6 +90,7 @@ static indigo_result xml_device_adapter_define_property(indigo_client *client, i
 	assert(client_context != NULL);
 	int handle = client_context->output;
 	char b1[32], b2[32], b3[32], b4[32], b5[32];
+	indigo_track_sent_values(client_context, property);
 	switch (property->type) {
 	case INDIGO_TEXT_VECTOR:
 		INDIGO_PRINTF(handle, "<defTextVector device='%s' name='%s' group='%s' label='%s' perm='%s' state='%s'%s%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_xml_escape(property->group), indigo_xml_escape(property->label), indigo_property_perm_text[property->perm], indigo_property_state_text[property->state], hints_attribute(property->hints), message_attribute(message));
@@ -167,10 +168,14 @@ static indigo_result xml_device_adapter_update_property(indigo_client *client, i
 	assert(client_context != NULL);
 	int handle = client_context->output;
 	char b1[32], b2[32];
+	bool changed[property->count];
+	indigo_select_changed_items(client_context, property, changed);
 	switch (property->type) {
 		case INDIGO_TEXT_VECTOR:
 			INDIGO_PRINTF(handle, "<setTextVector device='%s' name='%s' state='%s'%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message));
 			for (int i = 0; i < property->count; i++) {
+				if (!changed[i])
+					continue;
 				indigo_item *item = &property->items[i];
 				INDIGO_PRINTF(handle, "<oneText name='%s'>%s</oneText>\n", indigo_item_name(client->version, property, item), indigo_xml_escape(indigo_get_text_item_value(item)));
 			}
@@ -179,6 +184,8 @@ static indigo_result xml_device_adapter_update_property(indigo_client *client, i
 		case INDIGO_NUMBER_VECTOR:
 			INDIGO_PRINTF(handle, "<setNumberVector device='%s' name='%s' state='%s'%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message));
 			for (int i = 0; i < property->count; i++) {
+				if (!changed[i])
+					continue;
 				indigo_item *item = &property->items[i];
 				if (client->version >= INDIGO_VERSION_2_0 && property->perm != INDIGO_RO_PERM) {
 					INDIGO_PRINTF(handle, "<oneNumber name='%s' target='%s'>%s</oneNumber>\n", indigo_item_name(client->version, property, item), indigo_dtoa(item->number.target, b1), indigo_dtoa(item->number.value, b2));
@@ -191,6 +198,8 @@ static indigo_result xml_device_adapter_update_property(indigo_client *client, i
 		case INDIGO_SWITCH_VECTOR:
 			INDIGO_PRINTF(handle, "<setSwitchVector device='%s' name='%s' state='%s'%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message));
 			for (int i = 0; i < property->count; i++) {
+				if (!changed[i])
+					continue;
 				indigo_item *item = &property->items[i];
 				INDIGO_PRINTF(handle, "<oneSwitch name='%s'>%s</oneSwitch>\n", indigo_item_name(client->version, property, item), item->sw.value ? "On" : "Off");
 			}
@@ -199,6 +208,8 @@ static indigo_result xml_device_adapter_update_property(indigo_client *client, i
 		case INDIGO_LIGHT_VECTOR:
 			INDIGO_PRINTF(handle, "<setLightVector device='%s' name='%s' state='%s'%s>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), indigo_property_state_text[property->state], message_attribute(message));
 			for (int i = 0; i < property->count; i++) {
+				if (!changed[i])
+					continue;
 				indigo_item *item = &property->items[i];
 				INDIGO_PRINTF(handle, "<oneLight name='%s'>%s</oneLight>\n", indigo_item_name(client->version, property, item), indigo_property_state_text[item->light.value]);
 			}
@@ -291,6 +302,7 @@ static indigo_result xml_device_adapter_delete_property(indigo_client *client, i
 	pthread_mutex_lock(&write_mutex);
 	assert(client_context != NULL);
 	int handle = client_context->output;
+	indigo_forget_sent_values(client_context, property);
 	if (*property->name) {
 		INDIGO_PRINTF(handle, "<delProperty device='%s' name='%s'%s/>\n", indigo_xml_escape(property->device), indigo_property_name(client->version, property), message_attribute(message));
 	} else {
@@ -367,6 +379,7 @@ void indigo_release_xml_device_adapter(indigo_client *client) {
 		free(blob_record);
 		blob_record = client->enable_blob_mode_records;
 	}
+	indigo_forget_sent_values(client->client_context, NULL);
 	free(client->client_context);
 	free(client);
 }
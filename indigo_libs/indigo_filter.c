@@ -396,6 +396,7 @@ indigo_result indigo_filter_change_property(indigo_device *device, indigo_client
 			int size = sizeof(indigo_property) + property->count * sizeof(indigo_item);
 			indigo_property *copy = (indigo_property *)malloc(size);
 			memcpy(copy, property, size);
+			indigo_retain_item_strings(copy->items, copy->count);
 			strcpy(copy->device, FILTER_DEVICE_CONTEXT->device_property_cache[i]->device);
 			strcpy(copy->name, FILTER_DEVICE_CONTEXT->device_property_cache[i]->name);
 			if (copy->type == INDIGO_TEXT_VECTOR) {
@@ -570,6 +571,7 @@ indigo_result indigo_filter_define_property(indigo_client *client, indigo_device
 						int size = sizeof(indigo_property) + property->count * sizeof(indigo_item);
 						indigo_property *copy = (indigo_property *)malloc(size);
 						memcpy(copy, property, size);
+						indigo_retain_item_strings(copy->items, copy->count);
 						strcpy(copy->device, device->name);
 						bool translate = strncmp(name_prefix, copy->name, name_prefix_length);
 						if (translate && !strcmp(name_prefix, "CCD_") && !strncmp(copy->name, "DSLR_", 5))
@@ -657,7 +659,9 @@ indigo_result indigo_filter_update_property(indigo_client *client, indigo_device
 								indigo_set_text_item_value(copy->items + k, indigo_get_text_item_value(property->items + k));
 							}
 						} else {
-							memcpy(agent_cache[i]->items, property->items, property->count * sizeof(indigo_item));
+							indigo_release_item_strings(copy->items, copy->count);
+							memcpy(copy->items, property->items, property->count * sizeof(indigo_item));
+							indigo_retain_item_strings(copy->items, copy->count);
 						}
 						agent_cache[i]->state = device_cache[i]->state;
 						indigo_update_property(device, agent_cache[i], message);
@@ -679,11 +683,14 @@ static void remove_from_list(indigo_device *device, indigo_property *device_list
 					*device_name = 0;
 				device_list->state = INDIGO_ALERT_STATE;
 			}
+			indigo_release_item_strings(device_list->items + i, 1);
 			int size = (device_list->count - i - 1) * sizeof(indigo_item);
 			if (size > 0) {
 				char buffer[size];
 				memcpy(buffer, device_list->items + i + 1, size);
 				memcpy(device_list->items + i, buffer, size);
+				/* last slot is a duplicate now, it doesn't own its label */
+				memset(device_list->items + device_list->count - 1, 0, sizeof(indigo_item));
 			}
 			indigo_delete_property(device, device_list, NULL);
 			device_list->count--;
@@ -809,6 +816,7 @@ bool indigo_filter_cached_property(indigo_device *device, int index, char *name,
 indigo_result indigo_filter_forward_change_property(indigo_client *client, indigo_property *property, char *device_name) {
 	int size = sizeof(indigo_property) + property->count * (sizeof(indigo_item));
 	indigo_property *copy = indigo_safe_malloc_copy(size, property);
+	indigo_retain_item_strings(copy->items, copy->count);
 	strcpy(copy->device, device_name);
 	if (copy->type == INDIGO_TEXT_VECTOR) {
 		for (int k = 0; k < copy->count; k++) {
@@ -35,6 +35,7 @@
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
 #include <unistd.h>
 #include <termios.h>
+#include <sys/select.h>
 #include <netdb.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -458,6 +459,118 @@ bool indigo_write(int handle, const char *buffer, long length) {
 	}
 }
 
+static long read_with_timeout(int handle, char *buffer, long length, long timeout) {
+	fd_set readout;
+	struct timeval tv;
+	FD_ZERO(&readout);
+	FD_SET(handle, &readout);
+	tv.tv_sec = timeout / 1000000;
+	tv.tv_usec = timeout % 1000000;
+	long result = select(handle + 1, &readout, NULL, NULL, &tv);
+	if (result <= 0)
+		return result;
+#if defined(INDIGO_WINDOWS)
+	result = recv(handle, buffer, length, 0);
+#else
+	result = read(handle, buffer, length);
+#endif
+	if (result == 0) {
+		errno = ECONNRESET;
+		return -1;
+	}
+	return result;
+}
+
+void indigo_flush_input(int handle, long timeout) {
+	char buffer[256];
+	while (read_with_timeout(handle, buffer, sizeof(buffer), timeout) > 0)
+		;
+}
+
+int indigo_transaction(int handle, indigo_transaction_item *items, int count, char terminator, long first_timeout, long gap_timeout) {
+	char *buffer = indigo_alloc_large_buffer();
+	long length = 0;
+	for (int i = 0; i < count; i++) {
+		items[i].result = -1;
+		if (items[i].response)
+			*items[i].response = 0;
+		if (items[i].command) {
+			long command_length = strlen(items[i].command);
+			if (length + command_length > INDIGO_BUFFER_SIZE) {
+				if (!indigo_write(handle, buffer, length)) {
+					indigo_free_large_buffer(buffer);
+					return -1;
+				}
+				length = 0;
+			}
+			memcpy(buffer + length, items[i].command, command_length);
+			length += command_length;
+		}
+	}
+	if (length > 0) {
+		INDIGO_TRACE_PROTOCOL(indigo_trace("%d ← %.*s", handle, (int)length, buffer));
+		if (!indigo_write(handle, buffer, length)) {
+			indigo_free_large_buffer(buffer);
+			return -1;
+		}
+	}
+	/* responses to pipelined commands may arrive in one chunk, bytes left in buffer belong to the next item */
+	long available = 0, offset = 0;
+	int completed = 0;
+	for (int i = 0; i < count; i++) {
+		indigo_transaction_item *item = items + i;
+		if (item->response == NULL) {
+			item->result = 0;
+			completed++;
+			continue;
+		}
+		int index = 0;
+		long timeout = first_timeout;
+		bool done = false;
+		while (!done && index < item->length) {
+			if (offset == available) {
+				long result = read_with_timeout(handle, buffer, INDIGO_BUFFER_SIZE, timeout);
+				if (result < 0) {
+					INDIGO_ERROR(indigo_error("%s(): %s", __FUNCTION__, strerror(errno)));
+					item->response[index] = 0;
+					indigo_free_large_buffer(buffer);
+					return -1;
+				}
+				if (result == 0)
+					break;
+				available = result;
+				offset = 0;
+			}
+			char c = buffer[offset++];
+			timeout = gap_timeout;
+			if (c == terminator)
+				done = true;
+			else
+				item->response[index++] = c;
+		}
+		item->response[index] = 0;
+		if (!done && index == 0)
+			break;
+		if (!done && index == item->length) {
+			/* response framed by length may still be followed by terminator, don't pass it to the next item or transaction */
+			if (offset == available) {
+				long result = read_with_timeout(handle, buffer, INDIGO_BUFFER_SIZE, gap_timeout);
+				if (result > 0) {
+					available = result;
+					offset = 0;
+				}
+			}
+			if (offset < available && buffer[offset] == terminator)
+				offset++;
+		}
+		item->result = index;
+		completed++;
+		INDIGO_TRACE_PROTOCOL(indigo_trace("%d → %s", handle, item->response));
+	}
+	indigo_free_large_buffer(buffer);
+	return completed;
+}
+
 bool indigo_printf(int handle, const char *format, ...) {
 	if (strchr(format, '%')) {
 		char *buffer = indigo_alloc_large_buffer();
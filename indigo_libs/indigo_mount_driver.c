@@ -45,6 +45,475 @@ static double indigo_range24(double ha) {
 	return fmod(ha + (24000), 24);
 }
 
+static indigo_result mount_connection_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CONNECTION
+	if (IS_CONNECTED) {
+		indigo_mount_load_alignment_points(device);
+		indigo_eq2hor(NULL, MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.value, MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value, MOUNT_GEOGRAPHIC_COORDINATES_ELEVATION_ITEM->number.value, MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value, MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value, &MOUNT_HORIZONTAL_COORDINATES_ALT_ITEM->number.value, &MOUNT_HORIZONTAL_COORDINATES_AZ_ITEM->number.value);
+		indigo_define_property(device, MOUNT_INFO_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_LST_TIME_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_UTC_TIME_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_SET_HOST_TIME_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_PARK_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_PARK_SET_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_HOME_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_HOME_SET_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_SLEW_RATE_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_MOTION_DEC_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_MOTION_RA_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_TRACK_RATE_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_CUSTOM_TRACKING_RATE_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_TRACKING_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_GUIDE_RATE_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_ON_COORDINATES_SET_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_EQUATORIAL_COORDINATES_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_HORIZONTAL_COORDINATES_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_ABORT_MOTION_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_ALIGNMENT_MODE_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_RAW_COORDINATES_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_EPOCH_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_SIDE_OF_PIER_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_SNOOP_DEVICES_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_PEC_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_PEC_TRAINING_PROPERTY, NULL);
+		indigo_add_snoop_rule(MOUNT_PARK_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_PARK_PROPERTY_NAME);
+		indigo_add_snoop_rule(MOUNT_SLEW_RATE_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_SLEW_RATE_PROPERTY_NAME);
+		indigo_add_snoop_rule(MOUNT_TRACKING_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_TRACKING_PROPERTY_NAME);
+		indigo_add_snoop_rule(MOUNT_MOTION_DEC_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_DEC_PROPERTY_NAME);
+		indigo_add_snoop_rule(MOUNT_MOTION_RA_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_RA_PROPERTY_NAME);
+		indigo_add_snoop_rule(MOUNT_ABORT_MOTION_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_ABORT_MOTION_PROPERTY_NAME);
+		indigo_add_snoop_rule(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, GEOGRAPHIC_COORDINATES_PROPERTY_NAME);
+		indigo_add_snoop_rule(MOUNT_UTC_TIME_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, UTC_TIME_PROPERTY_NAME);
+	} else {
+		MOUNT_PARK_PROPERTY->state = INDIGO_OK_STATE;
+		MOUNT_HOME_PROPERTY->state = INDIGO_OK_STATE;
+		MOUNT_MOTION_DEC_PROPERTY->state = INDIGO_OK_STATE;
+		MOUNT_MOTION_RA_PROPERTY->state = INDIGO_OK_STATE;
+		MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
+		MOUNT_HORIZONTAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
+		MOUNT_RAW_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_remove_snoop_rule(MOUNT_PARK_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_PARK_PROPERTY_NAME);
+		indigo_remove_snoop_rule(MOUNT_SLEW_RATE_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_SLEW_RATE_PROPERTY_NAME);
+		indigo_remove_snoop_rule(MOUNT_TRACKING_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_TRACKING_PROPERTY_NAME);
+		indigo_remove_snoop_rule(MOUNT_MOTION_DEC_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_DEC_PROPERTY_NAME);
+		indigo_remove_snoop_rule(MOUNT_MOTION_RA_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_RA_PROPERTY_NAME);
+		indigo_remove_snoop_rule(MOUNT_ABORT_MOTION_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_ABORT_MOTION_PROPERTY_NAME);
+		indigo_remove_snoop_rule(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, GEOGRAPHIC_COORDINATES_PROPERTY_NAME);
+		indigo_remove_snoop_rule(MOUNT_UTC_TIME_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, UTC_TIME_PROPERTY_NAME);
+		indigo_delete_property(device, MOUNT_INFO_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_LST_TIME_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_UTC_TIME_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_SET_HOST_TIME_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_PARK_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_PARK_SET_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_HOME_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_HOME_SET_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_SLEW_RATE_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_MOTION_DEC_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_MOTION_RA_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_TRACK_RATE_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_CUSTOM_TRACKING_RATE_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_TRACKING_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_GUIDE_RATE_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_ON_COORDINATES_SET_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_EQUATORIAL_COORDINATES_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_HORIZONTAL_COORDINATES_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_ABORT_MOTION_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_ALIGNMENT_MODE_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_RAW_COORDINATES_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_EPOCH_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_SIDE_OF_PIER_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_SNOOP_DEVICES_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_PEC_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_PEC_TRAINING_PROPERTY, NULL);
+	}
+	return indigo_device_change_property(device, client, property);
+}
+
+static indigo_result mount_geographic_coordinates_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_GEOGRAPHIC_COORDINATES
+	indigo_property_copy_values(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, property, false);
+	if (MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value < 0)
+		MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value += 360;
+	if (MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.value < 0) {
+		if (MOUNT_PARK_POSITION_DEC_ITEM->number.value == 90) {
+			MOUNT_PARK_POSITION_DEC_ITEM->number.value = MOUNT_PARK_POSITION_DEC_ITEM->number.target = -90;
+			indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
+		}
+		if (MOUNT_HOME_POSITION_DEC_ITEM->number.value == 90) {
+			MOUNT_HOME_POSITION_DEC_ITEM->number.value = MOUNT_HOME_POSITION_DEC_ITEM->number.target = -90;
+			indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
+		}
+	} else {
+		if (MOUNT_PARK_POSITION_DEC_ITEM->number.value == -90) {
+			MOUNT_PARK_POSITION_DEC_ITEM->number.value = MOUNT_PARK_POSITION_DEC_ITEM->number.target = 90;
+			indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
+		}
+		if (MOUNT_HOME_POSITION_DEC_ITEM->number.value == -90) {
+			MOUNT_HOME_POSITION_DEC_ITEM->number.value = MOUNT_HOME_POSITION_DEC_ITEM->number.target = 90;
+			indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
+		}
+	}
+	indigo_update_coordinates(device, NULL);
+	MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED) {
+		indigo_update_property(device, MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result mount_on_coordinates_set_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_ON_COORDINATES_SET
+	indigo_property_copy_values(MOUNT_ON_COORDINATES_SET_PROPERTY, property, false);
+	MOUNT_ON_COORDINATES_SET_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, MOUNT_ON_COORDINATES_SET_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result mount_track_rate_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_TRACK_RATE
+	indigo_property_copy_values(MOUNT_TRACK_RATE_PROPERTY, property, false);
+	MOUNT_TRACK_RATE_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED) {
+		indigo_update_property(device, MOUNT_TRACK_RATE_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result mount_tracking_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_TRACKING
+	indigo_property_copy_values(MOUNT_TRACKING_PROPERTY, property, false);
+	MOUNT_TRACKING_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, MOUNT_TRACKING_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result mount_slew_rate_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_SLEW_RATE
+	indigo_property_copy_values(MOUNT_SLEW_RATE_PROPERTY, property, false);
+	MOUNT_SLEW_RATE_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED) {
+		indigo_update_property(device, MOUNT_SLEW_RATE_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result mount_guide_rate_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_GUIDE_RATE
+	indigo_property_copy_values(MOUNT_GUIDE_RATE_PROPERTY, property, false);
+	MOUNT_GUIDE_RATE_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED) {
+		indigo_update_property(device, MOUNT_GUIDE_RATE_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result mount_park_set_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_PARK_SET
+	indigo_property_copy_values(MOUNT_PARK_SET_PROPERTY, property, false);
+	if (MOUNT_PARK_SET_DEFAULT_ITEM->sw.value) {
+		double lat = MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.value;
+		MOUNT_PARK_POSITION_HA_ITEM->number.value = 6;
+		MOUNT_PARK_POSITION_DEC_ITEM->number.value = lat > 0 ? 90 : -90;
+		MOUNT_PARK_POSITION_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
+		MOUNT_PARK_SET_DEFAULT_ITEM->sw.value = false;
+	} else if (MOUNT_PARK_SET_CURRENT_ITEM->sw.value) {
+		double lng = MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value;
+		time_t utc = indigo_get_mount_utc(device);
+		MOUNT_PARK_POSITION_HA_ITEM->number.value = indigo_lst(&utc, lng) - MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value;
+		MOUNT_PARK_POSITION_DEC_ITEM->number.value = MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value;
+		MOUNT_PARK_POSITION_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
+		MOUNT_PARK_SET_CURRENT_ITEM->sw.value = false;
+	}
+	MOUNT_PARK_SET_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, MOUNT_PARK_SET_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result mount_park_position_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+		// -------------------------------------------------------------------------------- MOUNT_PARK_POSITION
+	indigo_property_copy_values(MOUNT_PARK_POSITION_PROPERTY, property, false);
+	MOUNT_PARK_POSITION_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED) {
+		indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result mount_home_set_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_HOME_SET
+	indigo_property_copy_values(MOUNT_HOME_SET_PROPERTY, property, false);
+	if (MOUNT_HOME_SET_DEFAULT_ITEM->sw.value) {
+		double lat = MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.value;
+		MOUNT_HOME_POSITION_HA_ITEM->number.value = 6;
+		MOUNT_HOME_POSITION_DEC_ITEM->number.value = lat > 0 ? 90 : -90;
+		MOUNT_HOME_POSITION_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
+		MOUNT_HOME_SET_DEFAULT_ITEM->sw.value = false;
+	} else if (MOUNT_HOME_SET_CURRENT_ITEM->sw.value) {
+		double lng = MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value;
+		time_t utc = indigo_get_mount_utc(device);
+		MOUNT_HOME_POSITION_HA_ITEM->number.value = indigo_lst(&utc, lng) - MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value;
+		MOUNT_HOME_POSITION_DEC_ITEM->number.value = MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value;
+		MOUNT_HOME_POSITION_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
+		MOUNT_HOME_SET_CURRENT_ITEM->sw.value = false;
+	}
+	MOUNT_HOME_SET_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, MOUNT_HOME_SET_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result mount_home_position_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_HOME_POSITION
+	indigo_property_copy_values(MOUNT_HOME_POSITION_PROPERTY, property, false);
+	MOUNT_HOME_POSITION_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result mount_config_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- CONFIG
+	if (indigo_switch_match(CONFIG_SAVE_ITEM, property)) {
+		indigo_save_property(device, NULL, MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY);
+		indigo_save_property(device, NULL, MOUNT_SLEW_RATE_PROPERTY);
+		indigo_save_property(device, NULL, MOUNT_TRACK_RATE_PROPERTY);
+		indigo_save_property(device, NULL, MOUNT_CUSTOM_TRACKING_RATE_PROPERTY);
+		indigo_save_property(device, NULL, MOUNT_GUIDE_RATE_PROPERTY);
+		indigo_save_property(device, NULL, MOUNT_ALIGNMENT_MODE_PROPERTY);
+		indigo_save_property(device, NULL, MOUNT_PARK_POSITION_PROPERTY);
+		indigo_save_property(device, NULL, MOUNT_EPOCH_PROPERTY);
+		indigo_save_property(device, NULL, MOUNT_PEC_PROPERTY);
+		indigo_mount_save_alignment_points(device);
+	} else if (indigo_switch_match(CONFIG_LOAD_ITEM, property)) {
+		indigo_mount_load_alignment_points(device);
+	}
+	return indigo_device_change_property(device, client, property);
+}
+
+static indigo_result mount_equatorial_coordinates_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_EQUATORIAL_COORDINATES
+	if (MOUNT_ON_COORDINATES_SET_SYNC_ITEM->sw.value) {
+		if (MOUNT_ALIGNMENT_MODE_CONTROLLER_ITEM->sw.value) {
+			MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_ALERT_STATE;
+			indigo_update_coordinates(device, "SYNC in CONTROLLER mode passed to indigo_mount_change_property");
+		} else if (MOUNT_CONTEXT->alignment_point_count >= MOUNT_MAX_ALIGNMENT_POINTS) {
+			MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_ALERT_STATE;
+			indigo_update_coordinates(device, "Too many alignment points");
+		} else {
+			indigo_property_copy_values(MOUNT_EQUATORIAL_COORDINATES_PROPERTY, property, false);
+			int index = MOUNT_CONTEXT->alignment_point_count++;
+			indigo_alignment_point *point = MOUNT_CONTEXT->alignment_points + index;
+			time_t utc = indigo_get_mount_utc(device);
+			point->lst = indigo_lst(&utc, MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value);
+			point->ra = MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value;
+			point->dec = MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value;
+			point->raw_ra = MOUNT_RAW_COORDINATES_RA_ITEM->number.value;
+			point->raw_dec = MOUNT_RAW_COORDINATES_DEC_ITEM->number.value;
+
+			if (MOUNT_SIDE_OF_PIER_PROPERTY->hidden) {
+				double ha = indigo_range24(point->lst - point->ra);
+				if (ha > 12.0)
+					ha -= 24.0;
+				point->side_of_pier = (ha >= 0) ? MOUNT_SIDE_WEST : MOUNT_SIDE_EAST;
+			}
+			else {
+				point->side_of_pier = MOUNT_SIDE_OF_PIER_EAST_ITEM->sw.value ? MOUNT_SIDE_EAST : MOUNT_SIDE_WEST;
+			}
+
+			char name[INDIGO_NAME_SIZE], label[INDIGO_VALUE_SIZE];
+			snprintf(name, INDIGO_NAME_SIZE, "%d", index);
+			snprintf(label, INDIGO_VALUE_SIZE, "%s %s %c", indigo_dtos(point->ra, "%2d:%02d:%02d"), indigo_dtos(point->dec, "%2d:%02d:%02d"), point->side_of_pier == MOUNT_SIDE_EAST ? 'E' : 'W');
+			indigo_init_switch_item(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items + index, name, label, true);
+			point->used = true;
+
+			//  Deselect other points if using single point mode
+			if (MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value) {
+				for (int i = 0; i < MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count; i++) {
+					MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].sw.value = false;
+					MOUNT_CONTEXT->alignment_points[i].used = false;
+				}
+			}
+
+			indigo_mount_save_alignment_points(device);
+			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count = MOUNT_CONTEXT->alignment_point_count;
+			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->state = INDIGO_OK_STATE;
+			indigo_delete_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
+			indigo_define_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
+			indigo_init_switch_item(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items + index, name, label, false);
+			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->count = MOUNT_CONTEXT->alignment_point_count;
+			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->state = INDIGO_OK_STATE;
+			indigo_delete_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
+			indigo_define_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
+			MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
+			indigo_update_coordinates(device, NULL);
+		}
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result mount_alignment_mode_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_MODE
+	indigo_property_copy_values(MOUNT_ALIGNMENT_MODE_PROPERTY, property, false);
+	if (IS_CONNECTED) {
+		indigo_delete_property(device, MOUNT_RAW_COORDINATES_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
+		indigo_delete_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
+	}
+	if (MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value) {
+		MOUNT_RAW_COORDINATES_PROPERTY->hidden = false;
+		MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->hidden = false;
+		MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->rule = INDIGO_ONE_OF_MANY_RULE;
+		MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->hidden = false;
+		if (strcmp(client->name, CONFIG_READER)) {
+			indigo_set_switch(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items + MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count - 1, true);
+		}
+	} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value) {
+		MOUNT_RAW_COORDINATES_PROPERTY->hidden = false;
+		MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->hidden = false;
+		MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->rule = INDIGO_ANY_OF_MANY_RULE;
+		MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->hidden = false;
+		if (strcmp(client->name, CONFIG_READER)) {
+			for (int i = 0; i < MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count; i++) {
+				MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].sw.value = true;
+			}
+		}
+	} else if (MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
+		MOUNT_RAW_COORDINATES_PROPERTY->hidden = false;
+		MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->hidden = false;
+		MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->rule = INDIGO_ANY_OF_MANY_RULE;
+		MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->hidden = false;
+		if (strcmp(client->name, CONFIG_READER)) {
+			for (int i = 0; i < MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count; i++) {
+				MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].sw.value = true;
+			}
+		}
+	} else {
+		MOUNT_RAW_COORDINATES_PROPERTY->hidden = true;
+		MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->hidden = true;
+		MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->hidden = true;
+	}
+	MOUNT_ALIGNMENT_MODE_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED) {
+		indigo_define_property(device, MOUNT_RAW_COORDINATES_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
+		indigo_define_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
+		indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.value, MOUNT_RAW_COORDINATES_DEC_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value);
+		indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.target, MOUNT_RAW_COORDINATES_DEC_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.target);
+		MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
+		indigo_update_coordinates(device, NULL);
+		indigo_update_property(device, MOUNT_ALIGNMENT_MODE_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result mount_alignment_select_points_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_SELECT_POINTS
+	indigo_property_copy_values(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, property, false);
+	for (int i = 0; i < MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count; i++) {
+		int index = atoi(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].name);
+		if (index < MOUNT_CONTEXT->alignment_point_count) {
+			bool used = MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].sw.value;
+			MOUNT_CONTEXT->alignment_points[index].used = used;
+		}
+	}
+	indigo_mount_save_alignment_points(device);
+	indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.value, MOUNT_RAW_COORDINATES_DEC_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value);
+	indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.target, MOUNT_RAW_COORDINATES_DEC_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.target);
+	MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_coordinates(device, NULL);
+	MOUNT_ALIGNMENT_MODE_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result mount_alignment_delete_points_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_DELETE_POINTS
+	for (int i = 0; i < property->count; i++) {
+		int index = atoi(property->items[i].name);
+		if (index < MOUNT_CONTEXT->alignment_point_count) {
+			if (property->items[i].sw.value) {
+				indigo_release_item_strings(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items + index, 1);
+				indigo_release_item_strings(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items + index, 1);
+				for (int j = index + 1; j < MOUNT_CONTEXT->alignment_point_count; j++) {
+					char name[INDIGO_NAME_SIZE];
+					snprintf(name, INDIGO_NAME_SIZE, "%d", j - 1);
+					MOUNT_CONTEXT->alignment_points[j - 1] = MOUNT_CONTEXT->alignment_points[j];
+					MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[j - 1] = MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[j];
+					indigo_copy_name(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[j - 1].name, name);
+					MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[j - 1] = MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[j];
+					indigo_copy_name(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[j - 1].name, name);
+				}
+				if (index < MOUNT_CONTEXT->alignment_point_count - 1) {
+					/* last slots are duplicates now, they don't own their labels */
+					memset(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items + MOUNT_CONTEXT->alignment_point_count - 1, 0, sizeof(indigo_item));
+					memset(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items + MOUNT_CONTEXT->alignment_point_count - 1, 0, sizeof(indigo_item));
+				}
+				MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count = MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->count = --MOUNT_CONTEXT->alignment_point_count;
+				break;
+			}
+		}
+	}
+	indigo_mount_update_alignment_points(device);
+	return INDIGO_OK;
+}
+
+static indigo_result mount_epoch_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_EPOCH
+	indigo_property_copy_values(MOUNT_EPOCH_PROPERTY, property, false);
+	MOUNT_EPOCH_PROPERTY->state = INDIGO_OK_STATE;
+	if (IS_CONNECTED) {
+		indigo_update_property(device, MOUNT_EPOCH_PROPERTY, NULL);
+	}
+	return INDIGO_OK;
+}
+
+static indigo_result mount_side_of_pier_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- MOUNT_SIDE_OF_PIER_PROPERTY
+	indigo_property_copy_values(MOUNT_SIDE_OF_PIER_PROPERTY, property, false);
+	MOUNT_SIDE_OF_PIER_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, MOUNT_SIDE_OF_PIER_PROPERTY, NULL);
+	return INDIGO_OK;
+}
+
+static indigo_result mount_snoop_devices_handler(indigo_device *device, indigo_client *client, indigo_property *property) {
+	// -------------------------------------------------------------------------------- SNOOP_DEVICES
+	indigo_remove_snoop_rule(MOUNT_PARK_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_PARK_PROPERTY_NAME);
+	indigo_remove_snoop_rule(MOUNT_SLEW_RATE_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_SLEW_RATE_PROPERTY_NAME);
+	indigo_remove_snoop_rule(MOUNT_TRACKING_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_TRACKING_PROPERTY_NAME);
+	indigo_remove_snoop_rule(MOUNT_MOTION_DEC_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_DEC_PROPERTY_NAME);
+	indigo_remove_snoop_rule(MOUNT_MOTION_RA_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_RA_PROPERTY_NAME);
+	indigo_remove_snoop_rule(MOUNT_ABORT_MOTION_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_ABORT_MOTION_PROPERTY_NAME);
+	indigo_remove_snoop_rule(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, GEOGRAPHIC_COORDINATES_PROPERTY_NAME);
+	indigo_remove_snoop_rule(MOUNT_UTC_TIME_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, UTC_TIME_PROPERTY_NAME);
+	indigo_property_copy_values(MOUNT_SNOOP_DEVICES_PROPERTY, property, false);
+	indigo_trim_local_service(MOUNT_SNOOP_JOYSTICK_ITEM->text.value);
+	indigo_trim_local_service(MOUNT_SNOOP_GPS_ITEM->text.value);
+	indigo_add_snoop_rule(MOUNT_PARK_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_PARK_PROPERTY_NAME);
+	indigo_add_snoop_rule(MOUNT_SLEW_RATE_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_SLEW_RATE_PROPERTY_NAME);
+	indigo_add_snoop_rule(MOUNT_TRACKING_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_TRACKING_PROPERTY_NAME);
+	indigo_add_snoop_rule(MOUNT_MOTION_DEC_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_DEC_PROPERTY_NAME);
+	indigo_add_snoop_rule(MOUNT_MOTION_RA_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_RA_PROPERTY_NAME);
+	indigo_add_snoop_rule(MOUNT_ABORT_MOTION_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_ABORT_MOTION_PROPERTY_NAME);
+	indigo_add_snoop_rule(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, GEOGRAPHIC_COORDINATES_PROPERTY_NAME);
+	indigo_add_snoop_rule(MOUNT_UTC_TIME_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, UTC_TIME_PROPERTY_NAME);
+	MOUNT_SNOOP_DEVICES_PROPERTY->state = INDIGO_OK_STATE;
+	indigo_update_property(device, MOUNT_SNOOP_DEVICES_PROPERTY, NULL);
+	return indigo_device_change_property(device, client, property);
+}
+
 indigo_result indigo_mount_attach(indigo_device *device, const char* driver_name, unsigned version) {
 	assert(device != NULL);
 	assert(device != NULL);
@@ -259,6 +728,25 @@ indigo_result indigo_mount_attach(indigo_device *device, const char* driver_name
 			indigo_init_switch_item(MOUNT_PEC_TRAINIG_STARTED_ITEM, MOUNT_PEC_TRAINIG_STARTED_ITEM_NAME, "Started", false);
 			indigo_init_switch_item(MOUNT_PEC_TRAINIG_STOPPED_ITEM, MOUNT_PEC_TRAINIG_STOPPED_ITEM_NAME, "Stopped", true);
 			// --------------------------------------------------------------------------------
+			indigo_bind_change_handler(device, indigo_mount_change_property, &CONNECTION_PROPERTY, false, mount_connection_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, true, mount_geographic_coordinates_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_ON_COORDINATES_SET_PROPERTY, false, mount_on_coordinates_set_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_TRACK_RATE_PROPERTY, false, mount_track_rate_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_TRACKING_PROPERTY, false, mount_tracking_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_SLEW_RATE_PROPERTY, false, mount_slew_rate_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_GUIDE_RATE_PROPERTY, false, mount_guide_rate_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_PARK_SET_PROPERTY, false, mount_park_set_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_PARK_POSITION_PROPERTY, false, mount_park_position_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_HOME_SET_PROPERTY, false, mount_home_set_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_HOME_POSITION_PROPERTY, false, mount_home_position_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &CONFIG_PROPERTY, false, mount_config_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_EQUATORIAL_COORDINATES_PROPERTY, false, mount_equatorial_coordinates_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_ALIGNMENT_MODE_PROPERTY, false, mount_alignment_mode_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, false, mount_alignment_select_points_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, false, mount_alignment_delete_points_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_EPOCH_PROPERTY, false, mount_epoch_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_SIDE_OF_PIER_PROPERTY, true, mount_side_of_pier_handler);
+			indigo_bind_change_handler(device, indigo_mount_change_property, &MOUNT_SNOOP_DEVICES_PROPERTY, false, mount_snoop_devices_handler);
 			return INDIGO_OK;
 		}
 	}
@@ -315,8 +803,8 @@ void indigo_mount_update_alignment_points(indigo_device *device) {
 	for (int i = 0; i < MOUNT_CONTEXT->alignment_point_count; i++) {
 		indigo_alignment_point *point =  MOUNT_CONTEXT->alignment_points + i;
 		snprintf(label, INDIGO_VALUE_SIZE, "%s %s %c", indigo_dtos(point->ra, "%2d:%02d:%02d"), indigo_dtos(point->dec, "%2d:%02d:%02d"), point->side_of_pier == MOUNT_SIDE_EAST ? 'E' : 'W');
-		strcpy(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].label, label);
-		strcpy(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[i].label, label);
+		indigo_set_item_label(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items + i, label);
+		indigo_set_item_label(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items + i, label);
 	}
 	indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.value, MOUNT_RAW_COORDINATES_DEC_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value);
 	indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.target, MOUNT_RAW_COORDINATES_DEC_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.target);
@@ -404,429 +892,9 @@ indigo_result indigo_mount_change_property(indigo_device *device, indigo_client
 	assert(device != NULL);
 	assert(DEVICE_CONTEXT != NULL);
 	assert(property != NULL);
-	if (indigo_property_match(CONNECTION_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CONNECTION
-		if (IS_CONNECTED) {
-			indigo_mount_load_alignment_points(device);
-			indigo_eq2hor(NULL, MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.value, MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value, MOUNT_GEOGRAPHIC_COORDINATES_ELEVATION_ITEM->number.value, MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value, MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value, &MOUNT_HORIZONTAL_COORDINATES_ALT_ITEM->number.value, &MOUNT_HORIZONTAL_COORDINATES_AZ_ITEM->number.value);
-			indigo_define_property(device, MOUNT_INFO_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_LST_TIME_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_UTC_TIME_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_SET_HOST_TIME_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_PARK_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_PARK_SET_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_HOME_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_HOME_SET_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_SLEW_RATE_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_MOTION_DEC_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_MOTION_RA_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_TRACK_RATE_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_CUSTOM_TRACKING_RATE_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_TRACKING_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_GUIDE_RATE_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_ON_COORDINATES_SET_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_EQUATORIAL_COORDINATES_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_HORIZONTAL_COORDINATES_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_ABORT_MOTION_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_ALIGNMENT_MODE_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_RAW_COORDINATES_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_EPOCH_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_SIDE_OF_PIER_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_SNOOP_DEVICES_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_PEC_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_PEC_TRAINING_PROPERTY, NULL);
-			indigo_add_snoop_rule(MOUNT_PARK_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_PARK_PROPERTY_NAME);
-			indigo_add_snoop_rule(MOUNT_SLEW_RATE_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_SLEW_RATE_PROPERTY_NAME);
-			indigo_add_snoop_rule(MOUNT_TRACKING_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_TRACKING_PROPERTY_NAME);
-			indigo_add_snoop_rule(MOUNT_MOTION_DEC_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_DEC_PROPERTY_NAME);
-			indigo_add_snoop_rule(MOUNT_MOTION_RA_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_RA_PROPERTY_NAME);
-			indigo_add_snoop_rule(MOUNT_ABORT_MOTION_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_ABORT_MOTION_PROPERTY_NAME);
-			indigo_add_snoop_rule(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, GEOGRAPHIC_COORDINATES_PROPERTY_NAME);
-			indigo_add_snoop_rule(MOUNT_UTC_TIME_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, UTC_TIME_PROPERTY_NAME);
-		} else {
-			MOUNT_PARK_PROPERTY->state = INDIGO_OK_STATE;
-			MOUNT_HOME_PROPERTY->state = INDIGO_OK_STATE;
-			MOUNT_MOTION_DEC_PROPERTY->state = INDIGO_OK_STATE;
-			MOUNT_MOTION_RA_PROPERTY->state = INDIGO_OK_STATE;
-			MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
-			MOUNT_HORIZONTAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
-			MOUNT_RAW_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_remove_snoop_rule(MOUNT_PARK_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_PARK_PROPERTY_NAME);
-			indigo_remove_snoop_rule(MOUNT_SLEW_RATE_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_SLEW_RATE_PROPERTY_NAME);
-			indigo_remove_snoop_rule(MOUNT_TRACKING_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_TRACKING_PROPERTY_NAME);
-			indigo_remove_snoop_rule(MOUNT_MOTION_DEC_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_DEC_PROPERTY_NAME);
-			indigo_remove_snoop_rule(MOUNT_MOTION_RA_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_RA_PROPERTY_NAME);
-			indigo_remove_snoop_rule(MOUNT_ABORT_MOTION_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_ABORT_MOTION_PROPERTY_NAME);
-			indigo_remove_snoop_rule(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, GEOGRAPHIC_COORDINATES_PROPERTY_NAME);
-			indigo_remove_snoop_rule(MOUNT_UTC_TIME_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, UTC_TIME_PROPERTY_NAME);
-			indigo_delete_property(device, MOUNT_INFO_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_LST_TIME_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_UTC_TIME_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_SET_HOST_TIME_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_PARK_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_PARK_SET_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_HOME_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_HOME_SET_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_SLEW_RATE_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_MOTION_DEC_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_MOTION_RA_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_TRACK_RATE_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_CUSTOM_TRACKING_RATE_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_TRACKING_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_GUIDE_RATE_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_ON_COORDINATES_SET_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_EQUATORIAL_COORDINATES_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_HORIZONTAL_COORDINATES_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_ABORT_MOTION_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_ALIGNMENT_MODE_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_RAW_COORDINATES_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_EPOCH_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_SIDE_OF_PIER_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_SNOOP_DEVICES_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_PEC_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_PEC_TRAINING_PROPERTY, NULL);
-		}
-	} else if (indigo_property_match_w(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_GEOGRAPHIC_COORDINATES
-		indigo_property_copy_values(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, property, false);
-		if (MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value < 0)
-			MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value += 360;
-		if (MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.value < 0) {
-			if (MOUNT_PARK_POSITION_DEC_ITEM->number.value == 90) {
-				MOUNT_PARK_POSITION_DEC_ITEM->number.value = MOUNT_PARK_POSITION_DEC_ITEM->number.target = -90;
-				indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
-			}
-			if (MOUNT_HOME_POSITION_DEC_ITEM->number.value == 90) {
-				MOUNT_HOME_POSITION_DEC_ITEM->number.value = MOUNT_HOME_POSITION_DEC_ITEM->number.target = -90;
-				indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
-			}
-		} else {
-			if (MOUNT_PARK_POSITION_DEC_ITEM->number.value == -90) {
-				MOUNT_PARK_POSITION_DEC_ITEM->number.value = MOUNT_PARK_POSITION_DEC_ITEM->number.target = 90;
-				indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
-			}
-			if (MOUNT_HOME_POSITION_DEC_ITEM->number.value == -90) {
-				MOUNT_HOME_POSITION_DEC_ITEM->number.value = MOUNT_HOME_POSITION_DEC_ITEM->number.target = 90;
-				indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
-			}
-		}
-		indigo_update_coordinates(device, NULL);
-		MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED) {
-			indigo_update_property(device, MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_ON_COORDINATES_SET_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_ON_COORDINATES_SET
-		indigo_property_copy_values(MOUNT_ON_COORDINATES_SET_PROPERTY, property, false);
-		MOUNT_ON_COORDINATES_SET_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, MOUNT_ON_COORDINATES_SET_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_TRACK_RATE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_TRACK_RATE
-		indigo_property_copy_values(MOUNT_TRACK_RATE_PROPERTY, property, false);
-		MOUNT_TRACK_RATE_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED) {
-			indigo_update_property(device, MOUNT_TRACK_RATE_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_TRACKING_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_TRACKING
-		indigo_property_copy_values(MOUNT_TRACKING_PROPERTY, property, false);
-		MOUNT_TRACKING_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, MOUNT_TRACKING_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_SLEW_RATE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_SLEW_RATE
-		indigo_property_copy_values(MOUNT_SLEW_RATE_PROPERTY, property, false);
-		MOUNT_SLEW_RATE_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED) {
-			indigo_update_property(device, MOUNT_SLEW_RATE_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_GUIDE_RATE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_GUIDE_RATE
-		indigo_property_copy_values(MOUNT_GUIDE_RATE_PROPERTY, property, false);
-		MOUNT_GUIDE_RATE_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED) {
-			indigo_update_property(device, MOUNT_GUIDE_RATE_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_PARK_SET_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_PARK_SET
-		indigo_property_copy_values(MOUNT_PARK_SET_PROPERTY, property, false);
-		if (MOUNT_PARK_SET_DEFAULT_ITEM->sw.value) {
-			double lat = MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.value;
-			MOUNT_PARK_POSITION_HA_ITEM->number.value = 6;
-			MOUNT_PARK_POSITION_DEC_ITEM->number.value = lat > 0 ? 90 : -90;
-			MOUNT_PARK_POSITION_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
-			MOUNT_PARK_SET_DEFAULT_ITEM->sw.value = false;
-		} else if (MOUNT_PARK_SET_CURRENT_ITEM->sw.value) {
-			double lng = MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value;
-			time_t utc = indigo_get_mount_utc(device);
-			MOUNT_PARK_POSITION_HA_ITEM->number.value = indigo_lst(&utc, lng) - MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value;
-			MOUNT_PARK_POSITION_DEC_ITEM->number.value = MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value;
-			MOUNT_PARK_POSITION_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
-			MOUNT_PARK_SET_CURRENT_ITEM->sw.value = false;
-		}
-		MOUNT_PARK_SET_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, MOUNT_PARK_SET_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_PARK_POSITION_PROPERTY, property)) {
-			// -------------------------------------------------------------------------------- MOUNT_PARK_POSITION
-		indigo_property_copy_values(MOUNT_PARK_POSITION_PROPERTY, property, false);
-		MOUNT_PARK_POSITION_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED) {
-			indigo_update_property(device, MOUNT_PARK_POSITION_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_HOME_SET_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_HOME_SET
-		indigo_property_copy_values(MOUNT_HOME_SET_PROPERTY, property, false);
-		if (MOUNT_HOME_SET_DEFAULT_ITEM->sw.value) {
-			double lat = MOUNT_GEOGRAPHIC_COORDINATES_LATITUDE_ITEM->number.value;
-			MOUNT_HOME_POSITION_HA_ITEM->number.value = 6;
-			MOUNT_HOME_POSITION_DEC_ITEM->number.value = lat > 0 ? 90 : -90;
-			MOUNT_HOME_POSITION_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
-			MOUNT_HOME_SET_DEFAULT_ITEM->sw.value = false;
-		} else if (MOUNT_HOME_SET_CURRENT_ITEM->sw.value) {
-			double lng = MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value;
-			time_t utc = indigo_get_mount_utc(device);
-			MOUNT_HOME_POSITION_HA_ITEM->number.value = indigo_lst(&utc, lng) - MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value;
-			MOUNT_HOME_POSITION_DEC_ITEM->number.value = MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value;
-			MOUNT_HOME_POSITION_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
-			MOUNT_HOME_SET_CURRENT_ITEM->sw.value = false;
-		}
-		MOUNT_HOME_SET_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, MOUNT_HOME_SET_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_HOME_POSITION_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_HOME_POSITION
-		indigo_property_copy_values(MOUNT_HOME_POSITION_PROPERTY, property, false);
-		MOUNT_HOME_POSITION_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, MOUNT_HOME_POSITION_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(CONFIG_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- CONFIG
-		if (indigo_switch_match(CONFIG_SAVE_ITEM, property)) {
-			indigo_save_property(device, NULL, MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY);
-			indigo_save_property(device, NULL, MOUNT_SLEW_RATE_PROPERTY);
-			indigo_save_property(device, NULL, MOUNT_TRACK_RATE_PROPERTY);
-			indigo_save_property(device, NULL, MOUNT_CUSTOM_TRACKING_RATE_PROPERTY);
-			indigo_save_property(device, NULL, MOUNT_GUIDE_RATE_PROPERTY);
-			indigo_save_property(device, NULL, MOUNT_ALIGNMENT_MODE_PROPERTY);
-			indigo_save_property(device, NULL, MOUNT_PARK_POSITION_PROPERTY);
-			indigo_save_property(device, NULL, MOUNT_EPOCH_PROPERTY);
-			indigo_save_property(device, NULL, MOUNT_PEC_PROPERTY);
-			indigo_mount_save_alignment_points(device);
-		} else if (indigo_switch_match(CONFIG_LOAD_ITEM, property)) {
-			indigo_mount_load_alignment_points(device);
-		}
-	} else if (indigo_property_match(MOUNT_EQUATORIAL_COORDINATES_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_EQUATORIAL_COORDINATES
-		if (MOUNT_ON_COORDINATES_SET_SYNC_ITEM->sw.value) {
-			if (MOUNT_ALIGNMENT_MODE_CONTROLLER_ITEM->sw.value) {
-				MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_ALERT_STATE;
-				indigo_update_coordinates(device, "SYNC in CONTROLLER mode passed to indigo_mount_change_property");
-			} else if (MOUNT_CONTEXT->alignment_point_count >= MOUNT_MAX_ALIGNMENT_POINTS) {
-				MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_ALERT_STATE;
-				indigo_update_coordinates(device, "Too many alignment points");
-			} else {
-				indigo_property_copy_values(MOUNT_EQUATORIAL_COORDINATES_PROPERTY, property, false);
-				int index = MOUNT_CONTEXT->alignment_point_count++;
-				indigo_alignment_point *point = MOUNT_CONTEXT->alignment_points + index;
-				time_t utc = indigo_get_mount_utc(device);
-				point->lst = indigo_lst(&utc, MOUNT_GEOGRAPHIC_COORDINATES_LONGITUDE_ITEM->number.value);
-				point->ra = MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value;
-				point->dec = MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value;
-				point->raw_ra = MOUNT_RAW_COORDINATES_RA_ITEM->number.value;
-				point->raw_dec = MOUNT_RAW_COORDINATES_DEC_ITEM->number.value;
-
-				if (MOUNT_SIDE_OF_PIER_PROPERTY->hidden) {
-					double ha = indigo_range24(point->lst - point->ra);
-					if (ha > 12.0)
-						ha -= 24.0;
-					point->side_of_pier = (ha >= 0) ? MOUNT_SIDE_WEST : MOUNT_SIDE_EAST;
-				}
-				else {
-					point->side_of_pier = MOUNT_SIDE_OF_PIER_EAST_ITEM->sw.value ? MOUNT_SIDE_EAST : MOUNT_SIDE_WEST;
-				}
-
-				char name[INDIGO_NAME_SIZE], label[INDIGO_VALUE_SIZE];
-				snprintf(name, INDIGO_NAME_SIZE, "%d", index);
-				snprintf(label, INDIGO_VALUE_SIZE, "%s %s %c", indigo_dtos(point->ra, "%2d:%02d:%02d"), indigo_dtos(point->dec, "%2d:%02d:%02d"), point->side_of_pier == MOUNT_SIDE_EAST ? 'E' : 'W');
-				indigo_init_switch_item(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items + index, name, label, true);
-				point->used = true;
-
-				//  Deselect other points if using single point mode
-				if (MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value) {
-					for (int i = 0; i < MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count; i++) {
-						MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].sw.value = false;
-						MOUNT_CONTEXT->alignment_points[i].used = false;
-					}
-				}
-
-				indigo_mount_save_alignment_points(device);
-				MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count = MOUNT_CONTEXT->alignment_point_count;
-				MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->state = INDIGO_OK_STATE;
-				indigo_delete_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
-				indigo_define_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
-				indigo_init_switch_item(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items + index, name, label, false);
-				MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->count = MOUNT_CONTEXT->alignment_point_count;
-				MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->state = INDIGO_OK_STATE;
-				indigo_delete_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
-				indigo_define_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
-				MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
-				indigo_update_coordinates(device, NULL);
-			}
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_ALIGNMENT_MODE_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_MODE
-		indigo_property_copy_values(MOUNT_ALIGNMENT_MODE_PROPERTY, property, false);
-		if (IS_CONNECTED) {
-			indigo_delete_property(device, MOUNT_RAW_COORDINATES_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
-			indigo_delete_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
-		}
-		if (MOUNT_ALIGNMENT_MODE_SINGLE_POINT_ITEM->sw.value) {
-			MOUNT_RAW_COORDINATES_PROPERTY->hidden = false;
-			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->hidden = false;
-			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->rule = INDIGO_ONE_OF_MANY_RULE;
-			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->hidden = false;
-			if (strcmp(client->name, CONFIG_READER)) {
-				indigo_set_switch(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items + MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count - 1, true);
-			}
-		} else if (MOUNT_ALIGNMENT_MODE_NEAREST_POINT_ITEM->sw.value) {
-			MOUNT_RAW_COORDINATES_PROPERTY->hidden = false;
-			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->hidden = false;
-			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->rule = INDIGO_ANY_OF_MANY_RULE;
-			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->hidden = false;
-			if (strcmp(client->name, CONFIG_READER)) {
-				for (int i = 0; i < MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count; i++) {
-					MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].sw.value = true;
-				}
-			}
-		} else if (MOUNT_ALIGNMENT_MODE_MULTI_POINT_ITEM->sw.value) {
-			MOUNT_RAW_COORDINATES_PROPERTY->hidden = false;
-			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->hidden = false;
-			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->rule = INDIGO_ANY_OF_MANY_RULE;
-			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->hidden = false;
-			if (strcmp(client->name, CONFIG_READER)) {
-				for (int i = 0; i < MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count; i++) {
-					MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].sw.value = true;
-				}
-			}
-		} else {
-			MOUNT_RAW_COORDINATES_PROPERTY->hidden = true;
-			MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->hidden = true;
-			MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->hidden = true;
-		}
-		MOUNT_ALIGNMENT_MODE_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED) {
-			indigo_define_property(device, MOUNT_RAW_COORDINATES_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
-			indigo_define_property(device, MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, NULL);
-			indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.value, MOUNT_RAW_COORDINATES_DEC_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value);
-			indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.target, MOUNT_RAW_COORDINATES_DEC_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.target);
-			MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
-			indigo_update_coordinates(device, NULL);
-			indigo_update_property(device, MOUNT_ALIGNMENT_MODE_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_SELECT_POINTS
-		indigo_property_copy_values(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, property, false);
-		for (int i = 0; i < MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count; i++) {
-			int index = atoi(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].name);
-			if (index < MOUNT_CONTEXT->alignment_point_count) {
-				bool used = MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[i].sw.value;
-				MOUNT_CONTEXT->alignment_points[index].used = used;
-			}
-		}
-		indigo_mount_save_alignment_points(device);
-		indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.value, MOUNT_RAW_COORDINATES_DEC_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.value, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.value);
-		indigo_raw_to_translated(device, MOUNT_RAW_COORDINATES_RA_ITEM->number.target, MOUNT_RAW_COORDINATES_DEC_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_RA_ITEM->number.target, &MOUNT_EQUATORIAL_COORDINATES_DEC_ITEM->number.target);
-		MOUNT_EQUATORIAL_COORDINATES_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_coordinates(device, NULL);
-		MOUNT_ALIGNMENT_MODE_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY, NULL);
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_ALIGNMENT_DELETE_POINTS
-		for (int i = 0; i < property->count; i++) {
-			int index = atoi(property->items[i].name);
-			if (index < MOUNT_CONTEXT->alignment_point_count) {
-				if (property->items[i].sw.value) {
-					for (int j = index + 1; j < MOUNT_CONTEXT->alignment_point_count; j++) {
-						char name[INDIGO_NAME_SIZE];
-						snprintf(name, INDIGO_NAME_SIZE, "%d", j - 1);
-						MOUNT_CONTEXT->alignment_points[j - 1] = MOUNT_CONTEXT->alignment_points[j];
-						MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[j - 1] = MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[j];
-						indigo_copy_name(MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->items[j - 1].name, name);
-						MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[j - 1] = MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[j];
-						indigo_copy_name(MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->items[j - 1].name, name);
-					}
-					MOUNT_ALIGNMENT_SELECT_POINTS_PROPERTY->count = MOUNT_ALIGNMENT_DELETE_POINTS_PROPERTY->count = --MOUNT_CONTEXT->alignment_point_count;
-					break;
-				}
-			}
-		}
-		indigo_mount_update_alignment_points(device);
-		return INDIGO_OK;
-	} else if (indigo_property_match(MOUNT_EPOCH_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_EPOCH
-		indigo_property_copy_values(MOUNT_EPOCH_PROPERTY, property, false);
-		MOUNT_EPOCH_PROPERTY->state = INDIGO_OK_STATE;
-		if (IS_CONNECTED) {
-			indigo_update_property(device, MOUNT_EPOCH_PROPERTY, NULL);
-		}
-		return INDIGO_OK;
-	} else if (indigo_property_match_w(MOUNT_SIDE_OF_PIER_PROPERTY, property)) {
-		// -------------------------------------------------------------------------------- MOUNT_SIDE_OF_PIER_PROPERTY
-		indigo_property_copy_values(MOUNT_SIDE_OF_PIER_PROPERTY, property, false);
-		MOUNT_SIDE_OF_PIER_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, MOUNT_SIDE_OF_PIER_PROPERTY, NULL);
-		return INDIGO_OK;
-		// -------------------------------------------------------------------------------- SNOOP_DEVICES
-	} else if (indigo_property_match(MOUNT_SNOOP_DEVICES_PROPERTY, property)) {
-		indigo_remove_snoop_rule(MOUNT_PARK_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_PARK_PROPERTY_NAME);
-		indigo_remove_snoop_rule(MOUNT_SLEW_RATE_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_SLEW_RATE_PROPERTY_NAME);
-		indigo_remove_snoop_rule(MOUNT_TRACKING_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_TRACKING_PROPERTY_NAME);
-		indigo_remove_snoop_rule(MOUNT_MOTION_DEC_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_DEC_PROPERTY_NAME);
-		indigo_remove_snoop_rule(MOUNT_MOTION_RA_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_RA_PROPERTY_NAME);
-		indigo_remove_snoop_rule(MOUNT_ABORT_MOTION_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_ABORT_MOTION_PROPERTY_NAME);
-		indigo_remove_snoop_rule(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, GEOGRAPHIC_COORDINATES_PROPERTY_NAME);
-		indigo_remove_snoop_rule(MOUNT_UTC_TIME_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, UTC_TIME_PROPERTY_NAME);
-		indigo_property_copy_values(MOUNT_SNOOP_DEVICES_PROPERTY, property, false);
-		indigo_trim_local_service(MOUNT_SNOOP_JOYSTICK_ITEM->text.value);
-		indigo_trim_local_service(MOUNT_SNOOP_GPS_ITEM->text.value);
-		indigo_add_snoop_rule(MOUNT_PARK_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_PARK_PROPERTY_NAME);
-		indigo_add_snoop_rule(MOUNT_SLEW_RATE_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_SLEW_RATE_PROPERTY_NAME);
-		indigo_add_snoop_rule(MOUNT_TRACKING_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_TRACKING_PROPERTY_NAME);
-		indigo_add_snoop_rule(MOUNT_MOTION_DEC_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_DEC_PROPERTY_NAME);
-		indigo_add_snoop_rule(MOUNT_MOTION_RA_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_MOTION_RA_PROPERTY_NAME);
-		indigo_add_snoop_rule(MOUNT_ABORT_MOTION_PROPERTY, MOUNT_SNOOP_JOYSTICK_ITEM->text.value, MOUNT_ABORT_MOTION_PROPERTY_NAME);
-		indigo_add_snoop_rule(MOUNT_GEOGRAPHIC_COORDINATES_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, GEOGRAPHIC_COORDINATES_PROPERTY_NAME);
-		indigo_add_snoop_rule(MOUNT_UTC_TIME_PROPERTY, MOUNT_SNOOP_GPS_ITEM->text.value, UTC_TIME_PROPERTY_NAME);
-		MOUNT_SNOOP_DEVICES_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, MOUNT_SNOOP_DEVICES_PROPERTY, NULL);
-		// --------------------------------------------------------------------------------
-	}
+	indigo_result result;
+	if (indigo_dispatch_change_property(device, indigo_mount_change_property, client, property, &result))
+		return result;
 	return indigo_device_change_property(device, client, property);
 }
 
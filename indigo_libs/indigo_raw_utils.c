@@ -12,7 +12,10 @@
 #include <stdlib.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 #include <errno.h>
+#include <pthread.h>
 #include <sys/param.h>
 
 #include <indigo/indigo_bus.h>
@@ -117,6 +120,18 @@ static int clear_hot_pixel_8(uint8_t* image, int x, int y, int width, int height
 	return value;
 }
 
+/*
+Reads pixel [x, y], filtered by clear_hot_pixel_*() unless the frame was
+already repaired with a defect map (see indigo_apply_defect_map()).
+*/
+static inline int read_pixel_16(uint16_t* image, int x, int y, int width, int height, bool hot_pixel_filter) {
+	return hot_pixel_filter ? clear_hot_pixel_16(image, x, y, width, height) : image[y * width + x];
+}
+
+static inline int read_pixel_8(uint8_t* image, int x, int y, int width, int height, bool hot_pixel_filter) {
+	return hot_pixel_filter ? clear_hot_pixel_8(image, x, y, width, height) : image[y * width + x];
+}
+
 static void hann_window(double (*data)[2], int len) {
 	for (int n = 0; n < len; n++) {
 		double sin_value = sin(3.14159265358979 * n / len);
@@ -442,15 +457,23 @@ indigo_result indigo_selection_psf(indigo_raw_type raw_type, const void *data, d
 }
 
 indigo_result indigo_selection_frame_digest_iterative(indigo_raw_type raw_type, const void *data, double *x, double *y, const int radius, const int width, const int height, indigo_frame_digest *digest, int converge_iterations) {
+	return indigo_selection_frame_digest_iterative_with_filter(raw_type, data, x, y, radius, width, height, digest, converge_iterations, true);
+}
+
+indigo_result indigo_selection_frame_digest_iterative_with_filter(indigo_raw_type raw_type, const void *data, double *x, double *y, const int radius, const int width, const int height, indigo_frame_digest *digest, int converge_iterations, const bool hot_pixel_filter) {
 	int result = INDIGO_FAILED;
 	while (converge_iterations--) {
 		// indigo_debug("%s: X = %.3f, Y= %3f", __FUNCTION__, *x, *y);
-		result = indigo_selection_frame_digest(raw_type, data, x, y, radius, width, height, digest);
+		result = indigo_selection_frame_digest_with_filter(raw_type, data, x, y, radius, width, height, digest, hot_pixel_filter);
 	}
 	return result;
 }
 
 indigo_result indigo_selection_frame_digest(indigo_raw_type raw_type, const void *data, double *x, double *y, const int radius, const int width, const int height, indigo_frame_digest *digest) {
+	return indigo_selection_frame_digest_with_filter(raw_type, data, x, y, radius, width, height, digest, true);
+}
+
+indigo_result indigo_selection_frame_digest_with_filter(indigo_raw_type raw_type, const void *data, double *x, double *y, const int radius, const int width, const int height, indigo_frame_digest *digest, const bool hot_pixel_filter) {
 	const int xx = (int)round(*x);
 	const int yy = (int)round(*y);
 
@@ -474,7 +497,7 @@ indigo_result indigo_selection_frame_digest(indigo_raw_type raw_type, const void
 		case INDIGO_RAW_MONO8: {
 			for (int j = ls; j <= le; j++) {
 				for (int i = cs; i <= ce; i++) {
-					value = clear_hot_pixel_8(data8, i, j, width, height);
+					value = read_pixel_8(data8, i, j, width, height, hot_pixel_filter);
 					sum += value;
 					if (value > max) max = value;
 				}
@@ -484,7 +507,7 @@ indigo_result indigo_selection_frame_digest(indigo_raw_type raw_type, const void
 		case INDIGO_RAW_MONO16: {
 			for (int j = ls; j <= le; j++) {
 				for (int i = cs; i <= ce; i++) {
-					value = clear_hot_pixel_16(data16, i, j, width, height);
+					value = read_pixel_16(data16, i, j, width, height, hot_pixel_filter);
 					sum += value;
 					if (value > max) max = value;
 				}
@@ -553,7 +576,7 @@ indigo_result indigo_selection_frame_digest(indigo_raw_type raw_type, const void
 		case INDIGO_RAW_MONO8: {
 			for (int j = ls; j <= le; j++) {
 				for (int i = cs; i <= ce; i++) {
-					value = clear_hot_pixel_8(data8, i, j, width, height) - threshold;
+					value = read_pixel_8(data8, i, j, width, height, hot_pixel_filter) - threshold;
 					/* Set all values below the threshold to 0 */
 					if (value < 0) value = 0;
 					m10 += (i + 1 - cs) * value;
@@ -566,7 +589,7 @@ indigo_result indigo_selection_frame_digest(indigo_raw_type raw_type, const void
 		case INDIGO_RAW_MONO16: {
 			for (int j = ls; j <= le; j++) {
 				for (int i = cs; i <= ce; i++) {
-					value = clear_hot_pixel_16(data16, i, j, width, height) - threshold;
+					value = read_pixel_16(data16, i, j, width, height, hot_pixel_filter) - threshold;
 					/* Set all values below the threshold to 0 */
 					if (value < 0) value = 0;
 					m10 += (i + 1 - cs) * value;
@@ -883,6 +906,10 @@ static double calibrate_re(double (*vector)[2], int size) {
 }
 
 indigo_result indigo_donuts_frame_digest(indigo_raw_type raw_type, const void *data, const int width, const int height, const int edge_clipping, indigo_frame_digest *digest) {
+	return indigo_donuts_frame_digest_with_filter(raw_type, data, width, height, edge_clipping, digest, true);
+}
+
+indigo_result indigo_donuts_frame_digest_with_filter(indigo_raw_type raw_type, const void *data, const int width, const int height, const int edge_clipping, indigo_frame_digest *digest, const bool hot_pixel_filter) {
 	const int xx = edge_clipping;
 	const int yy = edge_clipping;
 
@@ -904,7 +931,7 @@ indigo_result indigo_donuts_frame_digest(indigo_raw_type raw_type, const void *d
 		case INDIGO_RAW_MONO8: {
 			for (int j = ls; j < le; j++) {
 				for (int i = cs; i < ce; i++) {
-					value = clear_hot_pixel_8(data8, i, j, width, height);
+					value = read_pixel_8(data8, i, j, width, height, hot_pixel_filter);
 					sum += value;
 					if (value > max) max = value;
 				}
@@ -914,7 +941,7 @@ indigo_result indigo_donuts_frame_digest(indigo_raw_type raw_type, const void *d
 		case INDIGO_RAW_MONO16: {
 			for (int j = ls; j < le; j++) {
 				for (int i = cs; i < ce; i++) {
-					value = clear_hot_pixel_16(data16, i, j, width, height);
+					value = read_pixel_16(data16, i, j, width, height, hot_pixel_filter);
 					sum += value;
 					if (value > max) max = value;
 				}
@@ -995,7 +1022,7 @@ indigo_result indigo_donuts_frame_digest(indigo_raw_type raw_type, const void *d
 			for (int j = ls; j < le; j++) {
 				int y = j - ls;
 				for (int i = cs; i < ce; i++) {
-					value = clear_hot_pixel_8(data8, i, j, width, height) - threshold;
+					value = read_pixel_8(data8, i, j, width, height, hot_pixel_filter) - threshold;
 					/* Set all values below the threshold to 0 */
 					if (value < 0) value = 0;
 
@@ -1009,7 +1036,7 @@ indigo_result indigo_donuts_frame_digest(indigo_raw_type raw_type, const void *d
 			for (int j = ls; j < le; j++) {
 				int y = j - ls;
 				for (int i = cs; i < ce; i++) {
-					value = clear_hot_pixel_16(data16, i, j, width, height) - threshold;
+					value = read_pixel_16(data16, i, j, width, height, hot_pixel_filter) - threshold;
 					/* Set all values below the threshold to 0 */
 					if (value < 0) value = 0;
 
@@ -1258,6 +1285,347 @@ indigo_result indigo_delete_frame_digest(indigo_frame_digest *fdigest) {
 	return INDIGO_FAILED;
 }
 
+#define DEFECT_SIGMA				6.0		/* defect threshold above dark median in robust sigmas */
+#define DEFECT_MAX_FRACTION	0.01	/* at most this fraction of pixels is considered defective */
+
+static int raw_channels(indigo_raw_type raw_type, int *max_value) {
+	switch (raw_type) {
+		case INDIGO_RAW_MONO8:
+			*max_value = 0xFF;
+			return 1;
+		case INDIGO_RAW_MONO16:
+			*max_value = 0xFFFF;
+			return 1;
+		case INDIGO_RAW_RGB24:
+			*max_value = 0xFF;
+			return 3;
+		case INDIGO_RAW_RGB48:
+			*max_value = 0xFFFF;
+			return 3;
+		default:
+			*max_value = 0;
+			return 0;
+	}
+}
+
+static inline int raw_pixel_value(const void *data, int max_value, int channels, int index) {
+	int value = 0;
+	if (max_value == 0xFF) {
+		const uint8_t *data8 = (const uint8_t *)data + index * channels;
+		for (int c = 0; c < channels; c++)
+			value += data8[c];
+	} else {
+		const uint16_t *data16 = (const uint16_t *)data + index * channels;
+		for (int c = 0; c < channels; c++)
+			value += data16[c];
+	}
+	return value;
+}
+
+/*
+Builds a list of hot pixels from a dark frame. Pixels brighter than median + DEFECT_SIGMA * 1.4826 * MAD
+are considered defective. For every defect up to INDIGO_DEFECT_NEIGHBOURS good pixels from 3x3 window
+(or 5x5 window for clustered defects) are remembered, so the repair is a simple gather and replace.
+*/
+indigo_result indigo_make_defect_map(indigo_raw_type raw_type, const void *data, const int width, const int height, indigo_defect_map *map) {
+	if (data == NULL || map == NULL || width <= 0 || height <= 0)
+		return INDIGO_FAILED;
+	int max_value;
+	int channels = raw_channels(raw_type, &max_value);
+	if (channels == 0)
+		return INDIGO_FAILED;
+	int size = width * height;
+	int histogram_size = max_value * channels + 1;
+	int *histogram = indigo_safe_malloc(histogram_size * sizeof(int));
+	for (int i = 0; i < size; i++)
+		histogram[raw_pixel_value(data, max_value, channels, i)]++;
+	int median = 0;
+	for (int sum = 0; median < histogram_size; median++) {
+		sum += histogram[median];
+		if (sum > size / 2)
+			break;
+	}
+	int mad = 0;
+	for (int sum = histogram[median]; sum <= size / 2 && mad < histogram_size; ) {
+		mad++;
+		if (median - mad >= 0)
+			sum += histogram[median - mad];
+		if (median + mad < histogram_size)
+			sum += histogram[median + mad];
+	}
+	int threshold = median + (int)ceil(DEFECT_SIGMA * 1.4826 * (mad > 0 ? mad : 1));
+	int limit = (int)(size * DEFECT_MAX_FRACTION);
+	int count = 0;
+	for (int value = histogram_size - 1; value > threshold; value--) {
+		if (count + histogram[value] > limit) {
+			threshold = value;
+			break;
+		}
+		count += histogram[value];
+	}
+	free(histogram);
+	indigo_delete_defect_map(map);
+	map->width = width;
+	map->height = height;
+	if (count == 0)
+		return INDIGO_OK;
+	uint8_t *defective = indigo_safe_malloc(size);
+	map->defects = indigo_safe_malloc(count * sizeof(indigo_defect));
+	for (int i = 0; i < size && map->count < count; i++) {
+		if (raw_pixel_value(data, max_value, channels, i) > threshold) {
+			defective[i] = 1;
+			map->defects[map->count].x = i % width;
+			map->defects[map->count].y = i / width;
+			map->count++;
+		}
+	}
+	for (int i = 0; i < map->count; i++) {
+		indigo_defect *defect = map->defects + i;
+		defect->count = 0;
+		for (int ring = 1; ring <= 2 && defect->count < 2; ring++) {
+			for (int dy = -ring; dy <= ring && defect->count < INDIGO_DEFECT_NEIGHBOURS; dy++) {
+				for (int dx = -ring; dx <= ring && defect->count < INDIGO_DEFECT_NEIGHBOURS; dx++) {
+					if (abs(dx) != ring && abs(dy) != ring)
+						continue;
+					int x = defect->x + dx;
+					int y = defect->y + dy;
+					if (x < 0 || x >= width || y < 0 || y >= height || defective[y * width + x])
+						continue;
+					defect->dx[defect->count] = dx;
+					defect->dy[defect->count] = dy;
+					defect->count++;
+				}
+			}
+		}
+	}
+	free(defective);
+	indigo_debug("Defect map %dx%d: median = %d, MAD = %d, threshold = %d, %d defects", width, height, median, mad, threshold, map->count);
+	return INDIGO_OK;
+}
+
+/*
+Replaces defective pixels with the mean of their good neighbours. Frame [left, top, width, height] is
+a subframe of the frame the map was built for, neighbours outside of the subframe are ignored.
+*/
+indigo_result indigo_apply_defect_map(indigo_raw_type raw_type, void *data, const int left, const int top, const int width, const int height, const indigo_defect_map *map) {
+	if (data == NULL || map == NULL || left < 0 || top < 0 || left + width > map->width || top + height > map->height)
+		return INDIGO_FAILED;
+	int max_value;
+	int channels = raw_channels(raw_type, &max_value);
+	if (channels == 0)
+		return INDIGO_FAILED;
+	uint8_t *data8 = (uint8_t *)data;
+	uint16_t *data16 = (uint16_t *)data;
+	for (int i = 0; i < map->count; i++) {
+		const indigo_defect *defect = map->defects + i;
+		int x = defect->x - left;
+		int y = defect->y - top;
+		if (y >= height)
+			break;
+		if (x < 0 || x >= width || y < 0)
+			continue;
+		int sum[3] = { 0, 0, 0 };
+		int used = 0;
+		for (int j = 0; j < defect->count; j++) {
+			int nx = x + defect->dx[j];
+			int ny = y + defect->dy[j];
+			if (nx < 0 || nx >= width || ny < 0 || ny >= height)
+				continue;
+			int index = (ny * width + nx) * channels;
+			for (int c = 0; c < channels; c++)
+				sum[c] += max_value == 0xFF ? data8[index + c] : data16[index + c];
+			used++;
+		}
+		if (used == 0)
+			continue;
+		int index = (y * width + x) * channels;
+		for (int c = 0; c < channels; c++) {
+			if (max_value == 0xFF)
+				data8[index + c] = sum[c] / used;
+			else
+				data16[index + c] = sum[c] / used;
+		}
+	}
+	return INDIGO_OK;
+}
+
+indigo_result indigo_delete_defect_map(indigo_defect_map *map) {
+	if (map) {
+		if (map->defects)
+			free(map->defects);
+		map->defects = NULL;
+		map->count = 0;
+		map->width = 0;
+		map->height = 0;
+		return INDIGO_OK;
+	}
+	return INDIGO_FAILED;
+}
+
+#define DEBAYER_MAX_THREADS		8
+#define DEBAYER_MIN_ROWS			64		/* minimal number of output rows per thread */
+
+indigo_cfa_pattern indigo_cfa_pattern_from_string(const char *pattern) {
+	if (pattern == NULL)
+		return INDIGO_CFA_NONE;
+	while (*pattern == '\'' || *pattern == ' ')
+		pattern++;
+	if (!strncmp(pattern, "RGGB", 4))
+		return INDIGO_CFA_RGGB;
+	if (!strncmp(pattern, "GRBG", 4))
+		return INDIGO_CFA_GRBG;
+	if (!strncmp(pattern, "GBRG", 4))
+		return INDIGO_CFA_GBRG;
+	if (!strncmp(pattern, "BGGR", 4))
+		return INDIGO_CFA_BGGR;
+	return INDIGO_CFA_NONE;
+}
+
+typedef struct {
+	indigo_raw_type raw_type;
+	const void *data;
+	int width, height;
+	int red_x, red_y;
+	indigo_debayer_mode mode;
+	void *out;
+	int first_row, last_row;
+} debayer_job;
+
+/* input row y (mirrored at the edges, so the CFA parity is kept) widened to int with one pixel mirrored padding on both sides */
+static void debayer_load_row(const debayer_job *job, int y, int *restrict row) {
+	int width = job->width;
+	if (y < 0)
+		y = 1;
+	else if (y >= job->height)
+		y = job->height - 2;
+	if (job->raw_type == INDIGO_RAW_MONO8) {
+		const uint8_t *restrict src = (const uint8_t *)job->data + (long)y * width;
+		for (int x = 0; x < width; x++)
+			row[x + 1] = src[x];
+	} else {
+		const uint16_t *restrict src = (const uint16_t *)job->data + (long)y * width;
+		for (int x = 0; x < width; x++)
+			row[x + 1] = src[x];
+	}
+	row[0] = row[2];
+	row[width + 1] = row[width - 1];
+}
+
+static void debayer_store_row(const debayer_job *job, long offset, const int *restrict row, int count) {
+	if (job->raw_type == INDIGO_RAW_MONO8) {
+		uint8_t *restrict dst = (uint8_t *)job->out + offset;
+		for (int i = 0; i < count; i++)
+			dst[i] = row[i];
+	} else {
+		uint16_t *restrict dst = (uint16_t *)job->out + offset;
+		for (int i = 0; i < count; i++)
+			dst[i] = row[i];
+	}
+}
+
+/*
+Kernels work on int rows without data dependent branches, so they are vectorised by the compiler.
+Bilinear interpolation computes the horizontal, vertical, cross and diagonal neighbour averages for
+every pixel and picks them by the CFA site with stride 2 loops.
+*/
+static void *debayer_worker(void *arg) {
+	debayer_job *job = arg;
+	int width = job->width;
+	int *buffer = indigo_safe_malloc((3 * (width + 2) + 3 * width) * sizeof(int));
+	int *restrict p = buffer + 1;
+	int *restrict c = p + width + 2;
+	int *restrict n = c + width + 2;
+	int *restrict rgb = buffer + 3 * (width + 2);
+	for (int y = job->first_row; y < job->last_row; y++) {
+		if (job->mode == INDIGO_DEBAYER_SUPERPIXEL) {
+			int out_width = width / 2;
+			debayer_load_row(job, 2 * y + job->red_y, c - 1);
+			debayer_load_row(job, 2 * y + 1 - job->red_y, n - 1);
+			int rx = job->red_x, bx = 1 - job->red_x;
+			for (int x = 0; x < out_width; x++) {
+				rgb[3 * x] = c[2 * x + rx];
+				rgb[3 * x + 1] = (c[2 * x + bx] + n[2 * x + rx] + 1) >> 1;
+				rgb[3 * x + 2] = n[2 * x + bx];
+			}
+			debayer_store_row(job, (long)y * out_width * 3, rgb, out_width * 3);
+			continue;
+		}
+		debayer_load_row(job, y - 1, p - 1);
+		debayer_load_row(job, y, c - 1);
+		debayer_load_row(job, y + 1, n - 1);
+		if (job->mode == INDIGO_DEBAYER_LUMINANCE) {
+			for (int x = 0; x < width; x++)
+				rgb[x] = (p[x - 1] + 2 * p[x] + p[x + 1] + 2 * (c[x - 1] + 2 * c[x] + c[x + 1]) + n[x - 1] + 2 * n[x] + n[x + 1] + 8) >> 4;
+			debayer_store_row(job, (long)y * width, rgb, width);
+			continue;
+		}
+		/* channel of the row colour sites (0 = red, 2 = blue) and the other one */
+		int row_channel = ((y & 1) == job->red_y) ? 0 : 2;
+		int other_channel = 2 - row_channel;
+		int colour_x = row_channel == 0 ? job->red_x : 1 - job->red_x;
+		for (int x = colour_x; x < width; x += 2) {
+			rgb[3 * x + row_channel] = c[x];
+			rgb[3 * x + 1] = (c[x - 1] + c[x + 1] + p[x] + n[x] + 2) >> 2;
+			rgb[3 * x + other_channel] = (p[x - 1] + p[x + 1] + n[x - 1] + n[x + 1] + 2) >> 2;
+		}
+		for (int x = 1 - colour_x; x < width; x += 2) {
+			rgb[3 * x + row_channel] = (c[x - 1] + c[x + 1] + 1) >> 1;
+			rgb[3 * x + 1] = c[x];
+			rgb[3 * x + other_channel] = (p[x] + n[x] + 1) >> 1;
+		}
+		debayer_store_row(job, (long)y * width * 3, rgb, width * 3);
+	}
+	free(buffer);
+	return NULL;
+}
+
+/*
+Converts CFA mosaic (MONO8 or MONO16 in host byte order) to RGB24 / RGB48 (superpixel or bilinear) or to
+mono luminance of the same depth. Rows are split between threads. Output buffer must be large enough
+for the result, its dimensions are returned in out_width and out_height.
+*/
+indigo_result indigo_debayer(indigo_raw_type raw_type, const void *data, const int width, const int height, const indigo_cfa_pattern pattern, const indigo_debayer_mode mode, void *out, int *out_width, int *out_height) {
+	if (data == NULL || out == NULL || width < 2 || height < 2 || (raw_type != INDIGO_RAW_MONO8 && raw_type != INDIGO_RAW_MONO16))
+		return INDIGO_FAILED;
+	if (pattern == INDIGO_CFA_NONE && mode != INDIGO_DEBAYER_LUMINANCE)
+		return INDIGO_FAILED;
+	debayer_job job = { raw_type, data, width, height, 0, 0, mode, out, 0, 0 };
+	job.red_x = (pattern == INDIGO_CFA_GRBG || pattern == INDIGO_CFA_BGGR) ? 1 : 0;
+	job.red_y = (pattern == INDIGO_CFA_GBRG || pattern == INDIGO_CFA_BGGR) ? 1 : 0;
+	int rows = height;
+	if (mode == INDIGO_DEBAYER_SUPERPIXEL)
+		rows = height / 2;
+	if (out_width)
+		*out_width = mode == INDIGO_DEBAYER_SUPERPIXEL ? width / 2 : width;
+	if (out_height)
+		*out_height = rows;
+	int thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (thread_count > DEBAYER_MAX_THREADS)
+		thread_count = DEBAYER_MAX_THREADS;
+	if (thread_count > rows / DEBAYER_MIN_ROWS)
+		thread_count = rows / DEBAYER_MIN_ROWS;
+	if (thread_count < 1)
+		thread_count = 1;
+	debayer_job jobs[DEBAYER_MAX_THREADS];
+	pthread_t threads[DEBAYER_MAX_THREADS];
+	bool started[DEBAYER_MAX_THREADS];
+	for (int i = 0; i < thread_count; i++) {
+		jobs[i] = job;
+		jobs[i].first_row = rows * i / thread_count;
+		jobs[i].last_row = rows * (i + 1) / thread_count;
+		started[i] = i > 0 && pthread_create(&threads[i], NULL, debayer_worker, &jobs[i]) == 0;
+	}
+	for (int i = 0; i < thread_count; i++) {
+		if (!started[i])
+			debayer_worker(&jobs[i]);
+	}
+	for (int i = 1; i < thread_count; i++) {
+		if (started[i])
+			pthread_join(threads[i], NULL);
+	}
+	return INDIGO_OK;
+}
+
 static const double FIND_STAR_EDGE_CLIPPING = 20;
 
 static int luminance_comparator(const void *item_1, const void *item_2) {
@@ -181,7 +181,9 @@ static void start_worker_thread(int *client_socket) {
 								item_copy.blob.value = NULL;
 								if (indigo_populate_http_blob_item(&item_copy)) {
 									working_size = entry->size = item_copy.blob.size;
-									entry->content = item_copy.blob.value;
+									entry->content = indigo_alloc_blob_content(working_size);
+									memcpy(entry->content, item_copy.blob.value, working_size);
+									free(item_copy.blob.value);
 								} else {
 									INDIGO_ERROR(indigo_error("Failed to populate BLOB"));
 								}
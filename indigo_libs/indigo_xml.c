@@ -37,6 +37,9 @@
 
 #if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
 #include <unistd.h>
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif
 #if defined(INDIGO_WINDOWS)
 #include <io.h>
@@ -51,9 +54,14 @@
 #include <indigo/indigo_io.h>
 #include <indigo/indigo_version.h>
 #include <indigo/indigo_names.h>
+#include <indigo/indigo_timer.h>
 
 #define BUFFER_SIZE 524288  /* BUFFER_SIZE % 4 == 0, inportant for base64 */
 
+#define MAX_ATTACHED_BLOBS	16  /* file descriptors received but not yet claimed by oneBLOB with attached='true' */
+
+#define RESYNC_TIMEOUT	5   /* cached properties not redefined by remote server within this period are deleted */
+
 #define PROPERTY_SIZE sizeof(indigo_property)+INDIGO_MAX_ITEMS*(sizeof(indigo_item))
 
 typedef enum PARSE_STATES {
@@ -131,7 +139,20 @@ typedef struct {
 	indigo_client *client;
 	int count;
 	indigo_property **properties;
+	bool *pending;
+	indigo_timer *resync_timer;
 	pthread_mutex_t mutex;
+	bool shared_blobs;
+	bool attached;
+	const char *source;					// parsed memory buffer instead of handle
+	long source_length;
+	int fd_count;
+	int fds[MAX_ATTACHED_BLOBS];
+	int mapped_count;
+	struct {
+		void *data;
+		size_t size;
+	} mapped[MAX_ATTACHED_BLOBS];
 } parser_context;
 
 bool indigo_use_blob_urls = true;
@@ -153,6 +174,89 @@ static void *set_switch_vector_handler(parser_state state, parser_context *conte
 static void *set_light_vector_handler(parser_state state, parser_context *context, char *name, char *value, char *message);
 static void *set_blob_vector_handler(parser_state state, parser_context *context, char *name, char *value, char *message);
 
+static ssize_t parser_read(parser_context *context, int handle, void *buffer, size_t size) {
+	if (context->source != NULL) {
+		size_t count = (size_t)context->source_length < size ? (size_t)context->source_length : size;
+		memcpy(buffer, context->source, count);
+		context->source += count;
+		context->source_length -= count;
+		return count;
+	}
+#if defined(INDIGO_WINDOWS)
+	return indigo_recv(handle, buffer, (ssize_t)size);
+#else
+	if (!context->shared_blobs)
+		return read(handle, buffer, size);
+	/* BLOBs attached by the driver arrive as file descriptors with the bytes of their <oneBLOB> element */
+	char control[CMSG_SPACE(MAX_ATTACHED_BLOBS * sizeof(int))];
+	struct iovec iov = { .iov_base = buffer, .iov_len = size };
+	struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1, .msg_control = control, .msg_controllen = sizeof(control) };
+#if defined(MSG_CMSG_CLOEXEC)
+	ssize_t count = recvmsg(handle, &msg, MSG_CMSG_CLOEXEC);
+#else
+	ssize_t count = recvmsg(handle, &msg, 0);
+#endif
+	if (count < 0)
+		return count;
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+			int *fds = (int *)CMSG_DATA(cmsg);
+			int fd_count = (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+			for (int i = 0; i < fd_count; i++) {
+				if (context->fd_count < MAX_ATTACHED_BLOBS) {
+					context->fds[context->fd_count++] = fds[i];
+				} else {
+					indigo_error("XML Parser: too many attached BLOBs pending");
+					close(fds[i]);
+				}
+			}
+		}
+	}
+	if (msg.msg_flags & MSG_CTRUNC)
+		indigo_error("XML Parser: attached BLOB descriptors truncated");
+	return count;
+#endif
+}
+
+static void map_attached_blob(parser_context *context, indigo_item *item) {
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	if (context->fd_count == 0) {
+		indigo_error("XML Parser: no descriptor for attached BLOB %s", item->name);
+		item->blob.size = 0;
+		return;
+	}
+	int fd = context->fds[0];
+	memmove(context->fds, context->fds + 1, --context->fd_count * sizeof(int));
+	struct stat st;
+	if (fstat(fd, &st) < 0 || st.st_size < item->blob.size) {
+		// mapping beyond the end of the object would raise SIGBUS on access
+		indigo_error("XML Parser: attached BLOB %s is shorter than announced size %ld", item->name, item->blob.size);
+		close(fd);
+		item->blob.size = 0;
+		return;
+	}
+	void *data = item->blob.size > 0 && context->mapped_count < MAX_ATTACHED_BLOBS ? mmap(NULL, item->blob.size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+	close(fd);
+	if (data == MAP_FAILED) {
+		indigo_error("XML Parser: can't map attached BLOB %s (%s)", item->name, strerror(errno));
+		item->blob.size = 0;
+		return;
+	}
+	context->mapped[context->mapped_count].data = data;
+	context->mapped[context->mapped_count].size = item->blob.size;
+	context->mapped_count++;
+	item->blob.value = data;
+#endif
+}
+
+static void unmap_attached_blobs(parser_context *context) {
+#if defined(INDIGO_LINUX) || defined(INDIGO_MACOS)
+	for (int i = 0; i < context->mapped_count; i++)
+		munmap(context->mapped[i].data, context->mapped[i].size);
+	context->mapped_count = 0;
+#endif
+}
+
 static void *enable_blob_handler(parser_state state, parser_context *context, char *name, char *value, char *message) {
 	indigo_property *property = (indigo_property *)context->property_buffer;
 	indigo_client *client = context->client;
@@ -229,12 +333,17 @@ static void *get_properties_handler(parser_state state, parser_context *context,
 				indigo_printf(handle, "<switchProtocol version='%d.%d'/>\n", (version >> 8) & 0xFF, version & 0xFF);
 				client->version = version;
 			}
+		} else if (!strcmp(name, "delta")) {
+			assert(client->client_context != NULL);
+			((indigo_adapter_context *)(client->client_context))->delta_updates = !strcmp(value, "true");
 		} else if (!strncmp(name, "device",INDIGO_NAME_SIZE)) {
 			indigo_copy_name(property->device, value);
 		} else if (!strncmp(name, "name",INDIGO_NAME_SIZE)) {
 			indigo_copy_property_name(client->version, property, value);;
 		}
 	} else if (state == END_TAG) {
+		if (client->version < INDIGO_VERSION_2_0)
+			((indigo_adapter_context *)(client->client_context))->delta_updates = false;
 		indigo_enumerate_properties(client, property);
 		memset(property, 0, PROPERTY_SIZE);
 		return top_level_handler;
@@ -703,10 +812,16 @@ static void *set_one_blob_vector_handler(parser_state state, parser_context *con
 			snprintf(property->items[property->count-1].blob.url, INDIGO_VALUE_SIZE, "%s%s", ((indigo_adapter_context *)context->device->device_context)->url_prefix, value);
 		} else if (!strcmp(name, "url")) {
 			indigo_copy_value(property->items[property->count-1].blob.url, value);
+		} else if (!strcmp(name, "attached")) {
+			context->attached = context->shared_blobs && !strcmp(value, "true");
 		}
 	} else if (state == BLOB) {
 		property->items[property->count-1].blob.value = value;
 	} else if (state == END_TAG) {
+		if (context->attached) {
+			map_attached_blob(context, property->items + property->count - 1);
+			context->attached = false;
+		}
 		return set_blob_vector_handler;
 	}
 	return set_one_blob_vector_handler;
@@ -737,12 +852,106 @@ static void *set_blob_vector_handler(parser_state state, parser_context *context
 		}
 	} else if (state == END_TAG) {
 		set_property(context, property, message);
+		unmap_attached_blobs(context);
 		memset(property, 0, PROPERTY_SIZE);
 		return top_level_handler;
 	}
 	return set_blob_vector_handler;
 }
 
+static bool same_definition(indigo_property *property, indigo_property *other) {
+	if (property->type != other->type || property->perm != other->perm || property->rule != other->rule || property->count != other->count)
+		return false;
+	if (strncmp(property->group, other->group, INDIGO_NAME_SIZE) || strncmp(property->label, other->label, INDIGO_VALUE_SIZE))
+		return false;
+	for (int i = 0; i < property->count; i++) {
+		indigo_item *property_item = property->items + i;
+		indigo_item *other_item = other->items + i;
+		if (strncmp(property_item->name, other_item->name, INDIGO_NAME_SIZE) || property_item->label != other_item->label || property_item->hints != other_item->hints)
+			return false;
+		if (property->type == INDIGO_NUMBER_VECTOR) {
+			if (property_item->number.min != other_item->number.min || property_item->number.max != other_item->number.max || property_item->number.step != other_item->number.step || strncmp(property_item->number.format, other_item->number.format, INDIGO_VALUE_SIZE))
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool resync_values(indigo_property *property, indigo_property *other) {
+	bool changed = property->state != other->state;
+	property->state = other->state;
+	for (int i = 0; i < property->count; i++) {
+		indigo_item *property_item = property->items + i;
+		indigo_item *other_item = other->items + i;
+		switch (property->type) {
+			case INDIGO_TEXT_VECTOR:
+				if (strcmp(indigo_get_text_item_value(property_item), indigo_get_text_item_value(other_item))) {
+					if (property_item->text.long_value) {
+						free(property_item->text.long_value);
+						property_item->text.long_value = NULL;
+					}
+					indigo_copy_value(property_item->text.value, other_item->text.value);
+					if (other_item->text.long_value) {
+						property_item->text.long_value = indigo_safe_malloc_copy(property_item->text.length = other_item->text.length, other_item->text.long_value);
+					}
+					changed = true;
+				}
+				break;
+			case INDIGO_NUMBER_VECTOR:
+				if (property_item->number.value != other_item->number.value || property_item->number.target != other_item->number.target) {
+					property_item->number.value = other_item->number.value;
+					property_item->number.target = other_item->number.target;
+					changed = true;
+				}
+				break;
+			case INDIGO_SWITCH_VECTOR:
+				if (property_item->sw.value != other_item->sw.value) {
+					property_item->sw.value = other_item->sw.value;
+					changed = true;
+				}
+				break;
+			case INDIGO_LIGHT_VECTOR:
+				if (property_item->light.value != other_item->light.value) {
+					property_item->light.value = other_item->light.value;
+					changed = true;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	return changed;
+}
+
+static void release_property(indigo_property *property) {
+	if (property->type == INDIGO_BLOB_VECTOR) {
+		for (int i = 0; i < property->count; i++) {
+			void *blob = property->items[i].blob.value;
+			if (blob)
+				free(blob);
+		}
+	}
+	indigo_release_property(property);
+}
+
+static void resync_timer_callback(indigo_device *unused, parser_context *context) {
+	pthread_mutex_lock(&context->mutex);
+	if (context->pending) {
+		for (int index = 0; index < context->count; index++) {
+			indigo_property *property = context->properties[index];
+			if (property != NULL && context->pending[index]) {
+				INDIGO_TRACE_PARSER(indigo_trace("XML Parser: resync removed '%s' '%s' %d", property->device, property->name, index));
+				indigo_delete_property(context->device, property, NULL);
+				release_property(property);
+				context->properties[index] = NULL;
+			}
+		}
+		free(context->pending);
+		context->pending = NULL;
+	}
+	pthread_mutex_unlock(&context->mutex);
+}
+
 static void def_property(parser_context *context, indigo_property *other, char *message) {
 	indigo_property *property = NULL;
 	int index;
@@ -750,21 +959,50 @@ static void def_property(parser_context *context, indigo_property *other, char *
 	for (index = 0; index < context->count; index++) {
 		property = context->properties[index];
 		if (property == NULL)
-			break;
+			continue;
 		if (!strncmp(property->device, other->device, INDIGO_NAME_SIZE) && !strncmp(property->name, other->name, INDIGO_NAME_SIZE))
 			break;
+		property = NULL;
+	}
+	if (property == NULL) {
+		for (index = 0; index < context->count; index++) {
+			if (context->properties[index] == NULL)
+				break;
+		}
 	}
 	if (index == context->count) {
 		context->properties = indigo_safe_realloc(context->properties, context->count * 2 * sizeof(indigo_property *));
 		memset(context->properties + context->count, 0, context->count * sizeof(indigo_property *));
+		if (context->pending) {
+			context->pending = indigo_safe_realloc(context->pending, context->count * 2 * sizeof(bool));
+			memset(context->pending + context->count, 0, context->count * sizeof(bool));
+		}
 		context->count *= 2;
 		property = NULL;
 	}
+	if (property != NULL && context->pending && context->pending[index]) {
+		context->pending[index] = false;
+		if (same_definition(property, other)) {
+			if (resync_values(property, other)) {
+				INDIGO_TRACE_PARSER(indigo_trace("XML Parser: resync updated '%s' '%s' %d", property->device, property->name, index));
+				indigo_update_property(context->device, property, *message ? message : NULL);
+			} else {
+				INDIGO_TRACE_PARSER(indigo_trace("XML Parser: resync unchanged '%s' '%s' %d", property->device, property->name, index));
+			}
+			pthread_mutex_unlock(&context->mutex);
+			return;
+		}
+		INDIGO_TRACE_PARSER(indigo_trace("XML Parser: resync redefined '%s' '%s' %d", property->device, property->name, index));
+		indigo_delete_property(context->device, property, NULL);
+		release_property(property);
+		context->properties[index] = property = NULL;
+	}
 	if (property == NULL) {
 		switch (other->type) {
 			case INDIGO_TEXT_VECTOR:
 				property = indigo_init_text_property(property, other->device, other->name, other->group, other->label, other->state, other->perm, other->count);
 				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
+				indigo_retain_item_strings(property->items, property->count);
 				for (int i = 0; i < property->count; i++) {
 					indigo_item *property_item = property->items + i;
 					indigo_item *other_item = other->items + i;
@@ -776,18 +1014,22 @@ static void def_property(parser_context *context, indigo_property *other, char *
 			case INDIGO_NUMBER_VECTOR:
 				property = indigo_init_number_property(property, other->device, other->name, other->group, other->label, other->state, other->perm, other->count);
 				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
+				indigo_retain_item_strings(property->items, property->count);
 				break;
 			case INDIGO_SWITCH_VECTOR:
 				property = indigo_init_switch_property(property, other->device, other->name, other->group, other->label, other->state, other->perm, other->rule, other->count);
 				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
+				indigo_retain_item_strings(property->items, property->count);
 				break;
 			case INDIGO_LIGHT_VECTOR:
 				property = indigo_init_light_property(property, other->device, other->name, other->group, other->label, other->state, other->count);
 				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
+				indigo_retain_item_strings(property->items, property->count);
 				break;
 			case INDIGO_BLOB_VECTOR:
 				property = indigo_init_blob_property(property, other->device, other->name, other->group, other->label, other->state, other->count);
 				memcpy(property->items, other->items, other->count * sizeof(indigo_item));
+				indigo_retain_item_strings(property->items, property->count);
 				for (int i = 0; i < property->count; i++) {
 					indigo_item *item = property->items + i;
 					item->blob.value = NULL;
@@ -797,6 +1039,8 @@ static void def_property(parser_context *context, indigo_property *other, char *
 				break;
 		}
 		context->properties[index] = property;
+		if (context->pending)
+			context->pending[index] = false;
 	}
 	INDIGO_TRACE_PARSER(indigo_trace("XML Parser: def_property '%s' '%s' %d", property->device, property->name, index));
 	indigo_define_property(context->device, property, *message ? message : NULL);
@@ -811,9 +1055,9 @@ static void *def_text_handler(parser_state state, parser_context *context, char
 		if (!strcmp(name, "name")) {
 			indigo_copy_item_name(device->version, property, property->items+property->count-1, value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count-1].label, value);
+			indigo_set_item_label(property->items + property->count-1, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count-1].hints, value);
+			indigo_set_item_hints(property->items + property->count-1, value);
 		}
 	} else if (state == TEXT) {
 		indigo_set_text_item_value(property->items + property->count - 1, value);
@@ -829,8 +1073,10 @@ static void *def_text_vector_handler(parser_state state, parser_context *context
 	INDIGO_TRACE_PARSER(indigo_trace("XML Parser: def_text_vector_handler %s '%s' '%s'", parser_state_name[state], name != NULL ? name : "", value != NULL ? value : ""));
 	if (state == BEGIN_TAG) {
 		if (!strcmp(name, "defText")) {
-			if (property->count < INDIGO_MAX_ITEMS)
-				property->count++;
+			if (property->count < INDIGO_MAX_ITEMS) {
+				indigo_item *item = property->items + property->count++;
+				item->label = item->hints = indigo_intern_string(NULL);
+			}
 			return def_text_handler;
 		}
 	} else if (state == ATTRIBUTE_VALUE) {
@@ -856,6 +1102,7 @@ static void *def_text_vector_handler(parser_state state, parser_context *context
 		}
 	} else if (state == END_TAG) {
 		def_property(context, property, message);
+		indigo_release_item_strings(property->items, property->count);
 		memset(property, 0, PROPERTY_SIZE);
 		return top_level_handler;
 	}
@@ -872,9 +1119,9 @@ static void *def_number_handler(parser_state state, parser_context *context, cha
 		} else if (!strcmp(name, "target")) {
 			property->items[property->count-1].number.target = indigo_atod(value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count-1].label, value);
+			indigo_set_item_label(property->items + property->count-1, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count-1].hints, value);
+			indigo_set_item_hints(property->items + property->count-1, value);
 		} else if (!strcmp(name, "min")) {
 			property->items[property->count-1].number.min = indigo_atod(value);
 		} else if (!strcmp(name, "max")) {
@@ -898,8 +1145,10 @@ static void *def_number_vector_handler(parser_state state, parser_context *conte
 	INDIGO_TRACE_PARSER(indigo_trace("XML Parser: def_number_vector_handler %s '%s' '%s'", parser_state_name[state], name != NULL ? name : "", value != NULL ? value : ""));
 	if (state == BEGIN_TAG) {
 		if (!strcmp(name, "defNumber")) {
-			if (property->count < INDIGO_MAX_ITEMS)
-				property->count++;
+			if (property->count < INDIGO_MAX_ITEMS) {
+				indigo_item *item = property->items + property->count++;
+				item->label = item->hints = indigo_intern_string(NULL);
+			}
 			return def_number_handler;
 		}
 	} else if (state == ATTRIBUTE_VALUE) {
@@ -925,6 +1174,7 @@ static void *def_number_vector_handler(parser_state state, parser_context *conte
 		}
 	} else if (state == END_TAG) {
 		def_property(context, property, message);
+		indigo_release_item_strings(property->items, property->count);
 		memset(property, 0, PROPERTY_SIZE);
 		return top_level_handler;
 	}
@@ -939,9 +1189,9 @@ static void *def_switch_handler(parser_state state, parser_context *context, cha
 		if (!strcmp(name, "name")) {
 			indigo_copy_item_name(device->version, property, property->items+property->count-1, value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count-1].label, value);
+			indigo_set_item_label(property->items + property->count-1, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count-1].hints, value);
+			indigo_set_item_hints(property->items + property->count-1, value);
 		}
 	} else if (state == TEXT) {
 		property->items[property->count-1].sw.value = !strcmp(value, "On");
@@ -957,8 +1207,10 @@ static void *def_switch_vector_handler(parser_state state, parser_context *conte
 	INDIGO_TRACE_PARSER(indigo_trace("XML Parser: def_switch_vector_handler %s '%s' '%s'", parser_state_name[state], name != NULL ? name : "", value != NULL ? value : ""));
 	if (state == BEGIN_TAG) {
 		if (!strcmp(name, "defSwitch")) {
-			if (property->count < INDIGO_MAX_ITEMS)
-				property->count++;
+			if (property->count < INDIGO_MAX_ITEMS) {
+				indigo_item *item = property->items + property->count++;
+				item->label = item->hints = indigo_intern_string(NULL);
+			}
 			return def_switch_handler;
 		}
 	} else if (state == ATTRIBUTE_VALUE) {
@@ -986,6 +1238,7 @@ static void *def_switch_vector_handler(parser_state state, parser_context *conte
 		}
 	} else if (state == END_TAG) {
 		def_property(context, property, message);
+		indigo_release_item_strings(property->items, property->count);
 		memset(property, 0, PROPERTY_SIZE);
 		return top_level_handler;
 	}
@@ -1000,9 +1253,9 @@ static void *def_light_handler(parser_state state, parser_context *context, char
 		if (!strcmp(name, "name")) {
 			indigo_copy_item_name(device->version, property, property->items+property->count-1, value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count-1].label, value);
+			indigo_set_item_label(property->items + property->count-1, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count-1].hints, value);
+			indigo_set_item_hints(property->items + property->count-1, value);
 		}
 	} else if (state == TEXT) {
 		property->items[property->count-1].light.value = parse_state(INDIGO_VERSION_CURRENT, value);
@@ -1018,8 +1271,10 @@ static void *def_light_vector_handler(parser_state state, parser_context *contex
 	INDIGO_TRACE_PARSER(indigo_trace("XML Parser: def_light_vector_handler %s '%s' '%s'", parser_state_name[state], name != NULL ? name : "", value != NULL ? value : ""));
 	if (state == BEGIN_TAG) {
 		if (!strcmp(name, "defLight")) {
-			if (property->count < INDIGO_MAX_ITEMS)
-				property->count++;
+			if (property->count < INDIGO_MAX_ITEMS) {
+				indigo_item *item = property->items + property->count++;
+				item->label = item->hints = indigo_intern_string(NULL);
+			}
 			return def_light_handler;
 		}
 	} else if (state == ATTRIBUTE_VALUE) {
@@ -1043,6 +1298,7 @@ static void *def_light_vector_handler(parser_state state, parser_context *contex
 		}
 	} else if (state == END_TAG) {
 		def_property(context, property, message);
+		indigo_release_item_strings(property->items, property->count);
 		memset(property, 0, PROPERTY_SIZE);
 		return top_level_handler;
 	}
@@ -1057,9 +1313,9 @@ static void *def_blob_handler(parser_state state, parser_context *context, char
 		if (!strcmp(name, "name")) {
 			indigo_copy_item_name(device->version, property, property->items+property->count-1, value);
 		} else if (!strcmp(name, "label")) {
-			indigo_copy_value(property->items[property->count-1].label, value);
+			indigo_set_item_label(property->items + property->count-1, value);
 		} else if (!strcmp(name, "hints")) {
-			indigo_copy_value(property->items[property->count-1].hints, value);
+			indigo_set_item_hints(property->items + property->count-1, value);
 		} else if (!strcmp(name, "path")) {
 			snprintf(property->items[property->count-1].blob.url, INDIGO_VALUE_SIZE, "%s%s", ((indigo_adapter_context *)context->device->device_context)->url_prefix, value);
 		} else if (!strcmp(name, "url")) {
@@ -1077,8 +1333,10 @@ static void *def_blob_vector_handler(parser_state state, parser_context *context
 	INDIGO_TRACE_PARSER(indigo_trace("XML Parser: def_blob_vector_handler %s '%s' '%s'", parser_state_name[state], name != NULL ? name : "", value != NULL ? value : ""));
 	if (state == BEGIN_TAG) {
 		if (!strcmp(name, "defBLOB")) {
-			if (property->count < INDIGO_MAX_ITEMS)
-				property->count++;
+			if (property->count < INDIGO_MAX_ITEMS) {
+				indigo_item *item = property->items + property->count++;
+				item->label = item->hints = indigo_intern_string(NULL);
+			}
 			return def_blob_handler;
 		}
 	} else if (state == ATTRIBUTE_VALUE) {
@@ -1104,6 +1362,7 @@ static void *def_blob_vector_handler(parser_state state, parser_context *context
 		}
 	} else if (state == END_TAG) {
 		def_property(context, property, message);
+		indigo_release_item_strings(property->items, property->count);
 		memset(property, 0, PROPERTY_SIZE);
 		return top_level_handler;
 	}
@@ -1141,6 +1400,8 @@ static void *del_property_handler(parser_state state, parser_context *context, c
 					}
 					indigo_release_property(tmp);
 					context->properties[i] = NULL;
+					if (context->pending)
+						context->pending[i] = false;
 					break;
 				}
 			}
@@ -1151,6 +1412,8 @@ static void *del_property_handler(parser_state state, parser_context *context, c
 					indigo_delete_property(device, tmp, *message ? message : NULL);
 					indigo_release_property(tmp);
 					context->properties[i] = NULL;
+					if (context->pending)
+						context->pending[i] = false;
 				}
 			}
 		}
@@ -1255,7 +1518,7 @@ static void *top_level_handler(parser_state state, parser_context *context, char
 	return top_level_handler;
 }
 
-void indigo_xml_parse(indigo_device *device, indigo_client *client) {
+static void xml_parse(indigo_device *device, indigo_client *client, const char *source, long source_length) {
 	char *buffer = indigo_safe_malloc(BUFFER_SIZE + 3); /* BUFFER_SIZE % 4 == 0 and keep always +3 for base64 alignmet */
 	char *value_buffer = indigo_safe_malloc(BUFFER_SIZE + 1); /* +1 to accomodate \0" */
 	char *name_buffer = indigo_safe_malloc(INDIGO_NAME_SIZE);
@@ -1283,9 +1546,22 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 	context->client = client;
 	context->device = device;
 	pthread_mutex_init(&context->mutex, NULL);
+	indigo_property_cache *cache = NULL;
 	if (device != NULL) {
-		context->count = 32;
-		context->properties = indigo_safe_malloc(context->count * sizeof(indigo_property *));
+		cache = (indigo_property_cache *)((indigo_adapter_context *)device->device_context)->property_cache;
+		if (cache != NULL && cache->properties != NULL) {
+			context->count = cache->count;
+			context->properties = cache->properties;
+			context->pending = indigo_safe_malloc(context->count * sizeof(bool));
+			for (int index = 0; index < context->count; index++)
+				context->pending[index] = context->properties[index] != NULL;
+			cache->properties = NULL;
+			cache->count = 0;
+			indigo_set_timer_with_data(NULL, RESYNC_TIMEOUT, (indigo_timer_with_data_callback)resync_timer_callback, &context->resync_timer, context);
+		} else {
+			context->count = 32;
+			context->properties = indigo_safe_malloc(context->count * sizeof(indigo_property *));
+		}
 	} else {
 		context->count = 0;
 		context->properties = NULL;
@@ -1294,9 +1570,13 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 	indigo_property *property = (indigo_property *)&context->property_buffer;
 	memset(context->property_buffer, 0, PROPERTY_SIZE);
 
-	int handle = 0;
-	if (device != NULL) {
+	int handle = -1;
+	if (source != NULL) {
+		context->source = source;
+		context->source_length = source_length;
+	} else if (device != NULL) {
 		handle = ((indigo_adapter_context *)device->device_context)->input;
+		context->shared_blobs = ((indigo_adapter_context *)device->device_context)->shared_blobs;
 		device->enumerate_properties(device, client, NULL);
 	} else {
 		handle = ((indigo_adapter_context *)client->client_context)->input;
@@ -1311,11 +1591,7 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 			goto exit_loop;
 		}
 		while ((c = *pointer++) == 0) {
-#if defined(INDIGO_WINDOWS)
-			ssize_t count = indigo_recv(handle, (void *)buffer, (ssize_t)BUFFER_SIZE);
-#else
-			ssize_t count = (int)read(handle, (void *)buffer, (ssize_t)BUFFER_SIZE);
-#endif
+			ssize_t count = parser_read(context, handle, buffer, BUFFER_SIZE);
 			if (count <= 0) {
 				goto exit_loop;
 			}
@@ -1501,11 +1777,7 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 					if (bytes_needed)
 						bytes_needed = 4 - bytes_needed;
 					while (bytes_needed) {
-#if defined(INDIGO_WINDOWS)
-						count = indigo_recv(handle, (void *)buffer_end, bytes_needed);
-#else
-						count = (int)read(handle, (void *)buffer_end, bytes_needed);
-#endif
+						count = parser_read(context, handle, buffer_end, bytes_needed);
 						if (count <= 0)
 							goto exit_loop;
 						len += count;
@@ -1520,11 +1792,7 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 						ssize_t to_read = len;
 						char *ptr = buffer;
 						while(to_read) {
-#if defined(INDIGO_WINDOWS)
-							count = indigo_recv(handle, (void *)ptr, to_read);
-#else
-							count = (int)read(handle, (void *)ptr, to_read);
-#endif
+							count = parser_read(context, handle, ptr, to_read);
 							if (count <= 0)
 								goto exit_loop;
 							ptr += count;
@@ -1577,7 +1845,7 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 					state = END_TAG1;
 				} else if (c == '>') {
 					value_pointer = value_buffer;
-					if (handler == set_one_blob_vector_handler) {
+					if (handler == set_one_blob_vector_handler && !context->attached) {
 						blob_size = property->items[property->count-1].blob.size;
 						if (blob_size > 0) {
 							state = BLOB;
@@ -1640,12 +1908,50 @@ void indigo_xml_parse(indigo_device *device, indigo_client *client) {
 		}
 	}
 exit_loop:
+	if (context->resync_timer)
+		indigo_cancel_timer_sync(NULL, &context->resync_timer);
 	pthread_mutex_lock(&context->mutex);
+	if (cache != NULL) {
+		cache->count = context->count;
+		cache->properties = context->properties;
+		context->properties = NULL;
+	} else {
+		indigo_property_cache all = { context->count, context->properties };
+		indigo_flush_property_cache(&all);
+	}
+	unmap_attached_blobs(context);
+	while (context->fd_count > 0)
+		close(context->fds[--context->fd_count]);
+	indigo_safe_free(context->pending);
+	indigo_safe_free(blob_buffer);
+	indigo_safe_free(name_buffer);
+	indigo_safe_free(message);
+	indigo_safe_free(context->properties);
+	pthread_mutex_unlock(&context->mutex);
+	pthread_mutex_destroy(&context->mutex);
+	free(context);
+	free(buffer);
+	free(value_buffer);
+	if (handle >= 0)
+		close(handle);
+	INDIGO_TRACE_PARSER(indigo_trace("XML Parser: parser finished"));
+}
+
+void indigo_xml_parse(indigo_device *device, indigo_client *client) {
+	xml_parse(device, client, NULL, 0);
+}
+
+void indigo_xml_parse_buffer(indigo_client *client, const char *buffer, long length) {
+	xml_parse(NULL, client, buffer, length);
+}
+
+
+void indigo_flush_property_cache(indigo_property_cache *cache) {
 	while (true) {
 		indigo_property *property = NULL;
 		int index;
-		for (index = 0; index < context->count; index++) {
-			property = context->properties[index];
+		for (index = 0; index < cache->count; index++) {
+			property = cache->properties[index];
 			if (property != NULL)
 				break;
 		}
@@ -1657,35 +1963,16 @@ exit_loop:
 		indigo_property *all_properties = indigo_init_text_property(NULL, remote_device.name, "", "", "", INDIGO_OK_STATE, INDIGO_RO_PERM, 0);
 		indigo_delete_property(&remote_device, all_properties, NULL);
 		indigo_release_property(all_properties);
-		for (; index < context->count; index++) {
-			indigo_property *property = context->properties[index];
+		for (; index < cache->count; index++) {
+			indigo_property *property = cache->properties[index];
 			if (property != NULL && !strncmp(remote_device.name, property->device, INDIGO_NAME_SIZE)) {
-				if (property->type == INDIGO_BLOB_VECTOR) {
-					for (int i = 0; i < property->count; i++) {
-						void *blob = property->items[i].blob.value;
-						if (blob)
-							free(blob);
-					}
-				}
-				indigo_release_property(property);
-				context->properties[index] = NULL;
+				release_property(property);
+				cache->properties[index] = NULL;
 			}
 		}
 	}
-	indigo_safe_free(blob_buffer);
-	indigo_safe_free(name_buffer);
-	indigo_safe_free(message);
-	indigo_safe_free(context->properties);
-	pthread_mutex_unlock(&context->mutex);
-	pthread_mutex_destroy(&context->mutex);
-	free(context);
-	free(buffer);
-	free(value_buffer);
-	close(handle);
-	INDIGO_TRACE_PARSER(indigo_trace("XML Parser: parser finished"));
 }
 
-
 #define BUFFER_COUNT	10
 static char *escape_buffer[BUFFER_COUNT] = { NULL };
 static long escape_buffer_size[BUFFER_COUNT] =  { 0 };
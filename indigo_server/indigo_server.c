@@ -31,6 +31,7 @@
 #include <pthread.h>
 #include <dirent.h>
 #include <errno.h>
+#include <time.h>
 
 #include <arpa/inet.h>
 #include <sys/types.h>
@@ -307,6 +308,41 @@ static int static_drivers_count = 0;
 static int dynamic_drivers_count = 0;
 static bool command_line_drivers = false;
 
+#define DEFAULT_DRIVER_THREADS	1	/* drivers are not required to support parallel INIT, -P enables it */
+
+typedef struct {
+	char name[INDIGO_NAME_SIZE];
+	int item;
+	bool load;
+	indigo_driver_entry *driver;
+	indigo_result result;
+	double duration;
+} driver_init_job;
+
+typedef struct {
+	char name[INDIGO_NAME_SIZE];
+	int item;
+	indigo_driver_entry *driver;
+	indigo_result result;
+} driver_unload_job;
+
+typedef struct {
+	driver_init_job *jobs;
+	int count;
+	int next;
+	pthread_mutex_t mutex;
+} driver_init_queue;
+
+static int driver_threads = DEFAULT_DRIVER_THREADS;
+static char deferred_drivers[INDIGO_MAX_DRIVERS][INDIGO_NAME_SIZE];
+static int deferred_drivers_count = 0;
+static bool deferred_drivers_released = false;
+static bool drivers_reconcile_running = false;
+static bool drivers_reconcile_pending = false;
+static pthread_mutex_t drivers_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* Guards SERVER_DRIVERS_PROPERTY items and state. Bus handlers take it with the bus locked, the reconcile thread must not call bus while holding it. */
+static pthread_mutex_t drivers_property_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static indigo_property *info_property;
 static indigo_property *drivers_property;
 static indigo_property *servers_property;
@@ -800,6 +836,188 @@ static void check_versions(indigo_device *device) {
 
 #endif
 
+static double monotonic_time() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static bool is_deferred_driver(const char *name) {
+	if (deferred_drivers_released)
+		return false;
+	for (int i = 0; i < deferred_drivers_count; i++) {
+		if (!strcmp(deferred_drivers[i], name))
+			return true;
+	}
+	return false;
+}
+
+static void init_driver(driver_init_job *job) {
+	double start = monotonic_time();
+	if (job->driver == NULL) {
+		job->result = indigo_load_driver(job->name, true, &job->driver);
+	} else {
+		job->result = job->driver->driver(INDIGO_DRIVER_INIT, NULL);
+		job->driver->initialized = job->result == INDIGO_OK;
+	}
+	job->duration = monotonic_time() - start;
+}
+
+static void *init_drivers_worker(driver_init_queue *queue) {
+	while (true) {
+		pthread_mutex_lock(&queue->mutex);
+		int index = queue->next++;
+		pthread_mutex_unlock(&queue->mutex);
+		if (index >= queue->count)
+			break;
+		init_driver(queue->jobs + index);
+	}
+	return NULL;
+}
+
+/* Driver INIT is mostly waiting for USB enumeration or port probing, independent drivers are initialized on a bounded pool.
+   Must not be called with bus mutex locked as drivers attach their devices from INIT.
+ */
+
+static void init_drivers(driver_init_job *jobs, int count) {
+	if (count == 0)
+		return;
+	double start = monotonic_time();
+	driver_init_queue queue = { jobs, count, 0, PTHREAD_MUTEX_INITIALIZER };
+	int thread_count = driver_threads < count ? driver_threads : count;
+	pthread_t threads[thread_count];
+	bool started[thread_count];
+	for (int i = 1; i < thread_count; i++)
+		started[i] = pthread_create(&threads[i], NULL, (void *(*)(void *))init_drivers_worker, &queue) == 0;
+	init_drivers_worker(&queue);
+	for (int i = 1; i < thread_count; i++) {
+		if (started[i])
+			pthread_join(threads[i], NULL);
+	}
+	for (int i = 0; i < count; i++) {
+		if (jobs[i].driver && jobs[i].driver->initialized)
+			indigo_log("Driver %s initialized in %.3fs", jobs[i].name, jobs[i].duration);
+		else
+			indigo_log("Driver %s failed to initialize in %.3fs (%d)", jobs[i].name, jobs[i].duration, jobs[i].result);
+	}
+	indigo_log("%d driver(s) initialized in %.3fs using %d thread(s)", count, monotonic_time() - start, thread_count);
+}
+
+static void *reconcile_drivers(void *data) {
+	indigo_device *device = &server_device;
+	driver_init_job *jobs = indigo_safe_malloc(INDIGO_MAX_DRIVERS * sizeof(driver_init_job));
+	driver_unload_job *unloads = indigo_safe_malloc(INDIGO_MAX_DRIVERS * sizeof(driver_unload_job));
+	bool again = true;
+	while (again) {
+		int count = 0, unload_count = 0;
+		/* collect work with property locked, load and unload drivers with property unlocked as drivers attach and detach their devices */
+		pthread_mutex_lock(&drivers_property_mutex);
+		for (int i = 0; i < SERVER_DRIVERS_PROPERTY->count; i++) {
+			char *name = SERVER_DRIVERS_PROPERTY->items[i].name;
+			indigo_driver_entry *driver = NULL;
+			for (int j = 0; j < INDIGO_MAX_DRIVERS; j++) {
+				if (!strcmp(indigo_available_drivers[j].name, name)) {
+					driver = &indigo_available_drivers[j];
+					break;
+				}
+			}
+			if (SERVER_DRIVERS_PROPERTY->items[i].sw.value) {
+				if (driver && driver->initialized)
+					continue;
+				if (is_deferred_driver(name)) {
+					indigo_log("Driver %s deferred until first client request", name);
+					continue;
+				}
+				driver_init_job *job = jobs + count++;
+				memset(job, 0, sizeof(driver_init_job));
+				indigo_copy_name(job->name, name);
+				job->item = i;
+				job->driver = driver;
+				job->load = driver == NULL;
+			} else if (driver && (driver->dl_handle || driver->initialized)) {
+				driver_unload_job *unload = unloads + unload_count++;
+				indigo_copy_name(unload->name, name);
+				unload->item = i;
+				unload->driver = driver;
+			}
+		}
+		pthread_mutex_unlock(&drivers_property_mutex);
+		for (int i = 0; i < unload_count; i++) {
+			driver_unload_job *unload = unloads + i;
+			indigo_driver_entry *driver = unload->driver;
+			if (driver->dl_handle) {
+				unload->result = indigo_remove_driver(driver);
+			} else {
+				unload->result = driver->driver(INDIGO_DRIVER_SHUTDOWN, NULL);
+				if (unload->result == INDIGO_OK)
+					driver->initialized = false;
+			}
+			if (unload->result == INDIGO_BUSY) {
+				indigo_send_message(device, "Driver %s is in use, can't be unloaded", unload->name);
+			} else if (unload->result != INDIGO_OK) {
+				indigo_send_message(device, "Driver %s failed to unload", unload->name);
+			}
+		}
+		init_drivers(jobs, count);
+		for (int i = 0; i < count; i++) {
+			driver_init_job *job = jobs + i;
+			indigo_driver_entry *driver = job->driver;
+			if (job->result == INDIGO_UNSUPPORTED_ARCH)
+				indigo_send_message(device, "Driver '%s' is not supported on this architecture", driver ? driver->description : job->name);
+			if (driver && !driver->initialized) {
+				if (job->load)
+					indigo_send_message(device, "Driver %s failed to load", job->name);
+				if (driver->dl_handle)
+					indigo_remove_driver(driver);
+			}
+		}
+		pthread_mutex_lock(&drivers_property_mutex);
+		for (int i = 0; i < unload_count; i++) {
+			if (unloads[i].result != INDIGO_OK)
+				SERVER_DRIVERS_PROPERTY->items[unloads[i].item].sw.value = true;
+		}
+		for (int i = 0; i < count; i++)
+			SERVER_DRIVERS_PROPERTY->items[jobs[i].item].sw.value = jobs[i].driver && jobs[i].driver->initialized;
+		pthread_mutex_lock(&drivers_mutex);
+		again = drivers_reconcile_pending;
+		drivers_reconcile_pending = false;
+		drivers_reconcile_running = again;
+		pthread_mutex_unlock(&drivers_mutex);
+		if (!again)
+			SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
+		pthread_mutex_unlock(&drivers_property_mutex);
+	}
+	indigo_safe_free(jobs);
+	indigo_safe_free(unloads);
+	indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
+	int handle = 0;
+	if (!command_line_drivers) {
+		indigo_save_property(device, &handle, SERVER_DRIVERS_PROPERTY);
+		close(handle);
+	}
+	return NULL;
+}
+
+static void request_drivers_reconcile(indigo_device *device) {
+	pthread_mutex_lock(&drivers_mutex);
+	if (drivers_reconcile_running) {
+		drivers_reconcile_pending = true;
+		pthread_mutex_unlock(&drivers_mutex);
+		return;
+	}
+	drivers_reconcile_running = true;
+	pthread_mutex_unlock(&drivers_mutex);
+	SERVER_DRIVERS_PROPERTY->state = INDIGO_BUSY_STATE;
+	indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
+	if (!indigo_async(reconcile_drivers, NULL)) {
+		pthread_mutex_lock(&drivers_mutex);
+		drivers_reconcile_running = drivers_reconcile_pending = false;
+		pthread_mutex_unlock(&drivers_mutex);
+		SERVER_DRIVERS_PROPERTY->state = INDIGO_ALERT_STATE;
+		indigo_update_property(device, SERVER_DRIVERS_PROPERTY, "Can't start driver loading thread");
+	}
+}
+
 static indigo_result attach(indigo_device *device) {
 	assert(device != NULL);
 	SERVER_INFO_PROPERTY = indigo_init_text_property(NULL, server_device.name, SERVER_INFO_PROPERTY_NAME, MAIN_GROUP, "Server info", INDIGO_OK_STATE, INDIGO_RO_PERM, 2);
@@ -930,8 +1148,21 @@ static indigo_result attach(indigo_device *device) {
 
 static indigo_result enumerate_properties(indigo_device *device, indigo_client *client, indigo_property *property) {
 	assert(device != NULL);
+	pthread_mutex_lock(&drivers_property_mutex);
+	if (client != NULL && client->is_remote && deferred_drivers_count > 0 && !deferred_drivers_released) {
+		deferred_drivers_released = true;
+		for (int i = 0; i < SERVER_DRIVERS_PROPERTY->count; i++) {
+			for (int j = 0; j < deferred_drivers_count; j++) {
+				if (!strcmp(SERVER_DRIVERS_PROPERTY->items[i].name, deferred_drivers[j]))
+					SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
+			}
+		}
+		indigo_log("Loading deferred drivers requested by %s", client->name);
+		request_drivers_reconcile(device);
+	}
 	indigo_define_property(device, SERVER_INFO_PROPERTY, NULL);
 	indigo_define_property(device, SERVER_DRIVERS_PROPERTY, NULL);
+	pthread_mutex_unlock(&drivers_property_mutex);
 	if (SERVER_SERVERS_PROPERTY->count > 0)
 		indigo_define_property(device, SERVER_SERVERS_PROPERTY, NULL);
 	indigo_define_property(device, SERVER_LOAD_PROPERTY, NULL);
@@ -978,73 +1209,23 @@ static indigo_result change_property(indigo_device *device, indigo_client *clien
 	// -------------------------------------------------------------------------------- DRIVERS
 		if (command_line_drivers && !strcmp(client->name, CONFIG_READER))
 			return INDIGO_OK;
-		indigo_property_copy_values(SERVER_DRIVERS_PROPERTY, property, false);
-		for (int i = 0; i < SERVER_DRIVERS_PROPERTY->count; i++) {
-			char *name = SERVER_DRIVERS_PROPERTY->items[i].name;
-			indigo_driver_entry *driver = NULL;
-			for (int j = 0; j < INDIGO_MAX_DRIVERS; j++) {
-				if (!strcmp(indigo_available_drivers[j].name, name)) {
-					driver = &indigo_available_drivers[j];
-					break;
-				}
-			}
-			if (SERVER_DRIVERS_PROPERTY->items[i].sw.value) {
-				if (driver) {
-					if (driver->dl_handle == NULL && !driver->initialized) {
-						indigo_result result = driver->driver(INDIGO_DRIVER_INIT, NULL);
-						SERVER_DRIVERS_PROPERTY->items[i].sw.value = driver->initialized = result == INDIGO_OK;
-						if (result == INDIGO_UNSUPPORTED_ARCH)
-							indigo_send_message(&server_device, "Driver '%s' is not supported on this architecture", driver->description);
-					} else if (driver->dl_handle != NULL && !driver->initialized) {
-						indigo_result result = driver->driver(INDIGO_DRIVER_INIT, NULL);
-						SERVER_DRIVERS_PROPERTY->items[i].sw.value = driver->initialized = result == INDIGO_OK;
-						if (result == INDIGO_UNSUPPORTED_ARCH)
-							indigo_send_message(&server_device, "Driver '%s' is not supported on this architecture", driver->description);
-						if (driver && !driver->initialized)
-							indigo_remove_driver(driver);
-					}
-				} else {
-					SERVER_DRIVERS_PROPERTY->items[i].sw.value = indigo_load_driver(name, true, &driver) == INDIGO_OK;
-					if (driver && !driver->initialized) {
-						indigo_send_message(device, "Driver %s failed to load", name);
-						indigo_remove_driver(driver);
-					}
-				}
-			} else if (driver) {
-				indigo_result result = INDIGO_OK;
-				if (driver->dl_handle) {
-					result = indigo_remove_driver(driver);
-					if (result != INDIGO_OK) {
-						SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
-					}
-				} else if (driver->initialized) {
-					result = driver->driver(INDIGO_DRIVER_SHUTDOWN, NULL);
-					if (result != INDIGO_OK) {
-						SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
-					} else {
-						driver->initialized = false;
-					}
-				}
-				if (result != INDIGO_OK) {
-					if (result == INDIGO_BUSY) {
-						indigo_send_message(device, "Driver %s is in use, can't be unloaded", name);
-					} else {
-						indigo_send_message(device, "Driver %s failed to unload", name);
-					}
-				}
-			}
-		}
-		SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
-		indigo_update_property(device, SERVER_DRIVERS_PROPERTY, NULL);
-		int handle = 0;
-		if (!command_line_drivers) {
-			indigo_save_property(device, &handle, SERVER_DRIVERS_PROPERTY);
-			close(handle);
+		pthread_mutex_lock(&drivers_property_mutex);
+		if (SERVER_DRIVERS_PROPERTY->state == INDIGO_BUSY_STATE) {
+			indigo_update_property(device, SERVER_DRIVERS_PROPERTY, "Drivers are being loaded, try again later");
+		} else {
+			indigo_property_copy_values(SERVER_DRIVERS_PROPERTY, property, false);
+			request_drivers_reconcile(device);
 		}
+		pthread_mutex_unlock(&drivers_property_mutex);
 		return INDIGO_OK;
 	} else if (indigo_property_match(SERVER_LOAD_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- LOAD
 		indigo_property_copy_values(SERVER_LOAD_PROPERTY, property, false);
+		if (*SERVER_LOAD_ITEM->text.value && SERVER_DRIVERS_PROPERTY->state == INDIGO_BUSY_STATE) {
+			SERVER_LOAD_PROPERTY->state = INDIGO_ALERT_STATE;
+			indigo_update_property(device, SERVER_LOAD_PROPERTY, "Drivers are being loaded, try again later");
+			return INDIGO_OK;
+		}
 		if (*SERVER_LOAD_ITEM->text.value) {
 			char *name = basename(SERVER_LOAD_ITEM->text.value);
 			for (int i = 0; i < INDIGO_MAX_DRIVERS; i++)
@@ -1056,6 +1237,7 @@ static indigo_result change_property(indigo_device *device, indigo_client *clien
 			indigo_driver_entry *driver;
 			if (indigo_load_driver(SERVER_LOAD_ITEM->text.value, true, &driver) == INDIGO_OK) {
 				bool found = false;
+				pthread_mutex_lock(&drivers_property_mutex);
 				for (int i = 0; i < SERVER_DRIVERS_PROPERTY->count; i++) {
 					if (!strcmp(SERVER_DRIVERS_PROPERTY->items[i].name, name)) {
 						SERVER_DRIVERS_PROPERTY->items[i].sw.value = true;
@@ -1071,6 +1253,7 @@ static indigo_result change_property(indigo_device *device, indigo_client *clien
 					SERVER_DRIVERS_PROPERTY->state = INDIGO_OK_STATE;
 					indigo_define_property(device, SERVER_DRIVERS_PROPERTY, NULL);
 				}
+				pthread_mutex_unlock(&drivers_property_mutex);
 				SERVER_LOAD_PROPERTY->state = INDIGO_OK_STATE;
 				indigo_update_property(device, SERVER_LOAD_PROPERTY, "Driver %s (%s) loaded", name, driver->description);
 			} else {
@@ -1082,6 +1265,11 @@ static indigo_result change_property(indigo_device *device, indigo_client *clien
 	} else if (indigo_property_match(SERVER_UNLOAD_PROPERTY, property)) {
 		// -------------------------------------------------------------------------------- UNLOAD
 		indigo_property_copy_values(SERVER_UNLOAD_PROPERTY, property, false);
+		if (*SERVER_UNLOAD_ITEM->text.value && SERVER_DRIVERS_PROPERTY->state == INDIGO_BUSY_STATE) {
+			SERVER_UNLOAD_PROPERTY->state = INDIGO_ALERT_STATE;
+			indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Drivers are being loaded, try again later");
+			return INDIGO_OK;
+		}
 		if (*SERVER_UNLOAD_ITEM->text.value) {
 			char *name = basename(SERVER_UNLOAD_ITEM->text.value);
 			for (int i = 0; i < INDIGO_MAX_DRIVERS; i++)
@@ -1093,6 +1281,7 @@ static indigo_result change_property(indigo_device *device, indigo_client *clien
 						result = indigo_available_drivers[i].driver(INDIGO_DRIVER_SHUTDOWN, NULL);
 					}
 					if (result == INDIGO_OK) {
+						pthread_mutex_lock(&drivers_property_mutex);
 						for (int j = 0; j < SERVER_DRIVERS_PROPERTY->count; j++) {
 							if (!strcmp(SERVER_DRIVERS_PROPERTY->items[j].name, name)) {
 								SERVER_DRIVERS_PROPERTY->items[j].sw.value = false;
@@ -1101,6 +1290,7 @@ static indigo_result change_property(indigo_device *device, indigo_client *clien
 								break;
 							}
 						}
+						pthread_mutex_unlock(&drivers_property_mutex);
 						SERVER_UNLOAD_PROPERTY->state = INDIGO_OK_STATE;
 						indigo_update_property(device, SERVER_UNLOAD_PROPERTY, "Driver %s unloaded", name);
 					} else if (result == INDIGO_BUSY) {
@@ -1329,7 +1519,7 @@ static void server_main() {
 	indigo_start();
 	indigo_log("INDIGO server %d.%d-%s built on %s %s", (INDIGO_VERSION_CURRENT >> 8) & 0xFF, INDIGO_VERSION_CURRENT & 0xFF, INDIGO_BUILD, __DATE__, __TIME__);
 
-	/* Make sure master token and ACL are loaded before drivers */
+	/* Make sure master token and ACL are loaded before drivers and remote servers are connected */
 	for (int i = 1; i < server_argc; i++) {
 		if ((!strcmp(server_argv[i], "-T") || !strcmp(server_argv[i], "--master-token")) && i < server_argc - 1) {
 			indigo_set_master_token(indigo_string_to_token(server_argv[i + 1]));
@@ -1337,8 +1527,28 @@ static void server_main() {
 		} else if ((!strcmp(server_argv[i], "-a") || !strcmp(server_argv[i], "--acl-file")) && i < server_argc - 1) {
 			indigo_load_device_tokens_from_file(server_argv[i + 1]);
 			i++;
+		} else if (!strcmp(server_argv[i], "-R") || !strcmp(server_argv[i], "--enable-remote-resync")) {
+			indigo_resync_remote_servers = true;
+		} else if ((!strcmp(server_argv[i], "-P") || !strcmp(server_argv[i], "--driver-threads")) && i < server_argc - 1) {
+			driver_threads = atoi(server_argv[i + 1]);
+			if (driver_threads < 1)
+				driver_threads = 1;
+			i++;
+		} else if ((!strcmp(server_argv[i], "-D") || !strcmp(server_argv[i], "--defer-driver")) && i < server_argc - 1) {
+			if (deferred_drivers_count < INDIGO_MAX_DRIVERS) {
+				char name[INDIGO_NAME_SIZE];
+				indigo_copy_name(name, server_argv[i + 1]);
+				char *dot = strchr(basename(name), '.');
+				if (dot)
+					*dot = 0;
+				indigo_copy_name(deferred_drivers[deferred_drivers_count], basename(name));
+				deferred_drivers_count++;
+			}
+			i++;
 		}
 	}
+	driver_init_job *command_line_jobs = indigo_safe_malloc(server_argc * sizeof(driver_init_job));
+	int command_line_jobs_count = 0;
 	for (int i = 1; i < server_argc; i++) {
 		if ((!strcmp(server_argv[i], "-p") || !strcmp(server_argv[i], "--port")) && i < server_argc - 1) {
 			indigo_server_tcp_port = atoi(server_argv[i + 1]);
@@ -1367,6 +1577,12 @@ static void server_main() {
 		} else if ((!strcmp(server_argv[i], "-a") || !strcmp(server_argv[i], "--acl-file")) && i < server_argc - 1) {
 			/* just skip it - handled above */
 			i++;
+		} else if ((!strcmp(server_argv[i], "-P") || !strcmp(server_argv[i], "--driver-threads")) && i < server_argc - 1) {
+			/* just skip it - handled above */
+			i++;
+		} else if ((!strcmp(server_argv[i], "-D") || !strcmp(server_argv[i], "--defer-driver")) && i < server_argc - 1) {
+			/* just skip it - handled above */
+			i++;
 		} else if (!strcmp(server_argv[i], "-b-") || !strcmp(server_argv[i], "--disable-bonjour")) {
 			use_bonjour = false;
 		} else if (!strcmp(server_argv[i], "-b") || !strcmp(server_argv[i], "--bonjour")) {
@@ -1401,10 +1617,22 @@ static void server_main() {
 			}
 #endif /* RPI_MANAGEMENT */
 		} else if(server_argv[i][0] != '-') {
-			indigo_load_driver(server_argv[i], true, NULL);
+			char name[INDIGO_NAME_SIZE];
+			indigo_copy_name(name, server_argv[i]);
+			char *dot = strchr(basename(name), '.');
+			if (dot)
+				*dot = 0;
+			if (is_deferred_driver(basename(name))) {
+				indigo_load_driver(server_argv[i], false, NULL);
+			} else {
+				indigo_copy_name(command_line_jobs[command_line_jobs_count].name, server_argv[i]);
+				command_line_jobs_count++;
+			}
 			command_line_drivers = true;
 		}
 	}
+	init_drivers(command_line_jobs, command_line_jobs_count);
+	indigo_safe_free(command_line_jobs);
 
 	use_ctrl_panel |= use_web_apps;
 
@@ -1668,8 +1896,11 @@ int main(int argc, const char * argv[]) {
 			       "       -vv | --enable-debug\n"
 			       "       -vvv| --enable-trace\n"
 			       "       -r  | --remote-server host[:port]     (default port: 7624)\n"
+			       "       -R  | --enable-remote-resync          (keep remote properties over reconnect)\n"
 			       "       -x  | --enable-blob-proxy\n"
 			       "       -i  | --indi-driver driver_executable\n"
+			       "       -P  | --driver-threads count          (default: 1)\n"
+			       "       -D  | --defer-driver driver_name      (initialize on first client request)\n"
 			);
 			return 0;
 		} else {
@@ -0,0 +1,118 @@
+// Copyright (c) 2016 CloudMakers, s. r. o.
+// All rights reserved.
+//
+// You can use this software under the terms of 'INDIGO Astronomy
+// open-source license' (see LICENSE.md).
+//
+// THIS SOFTWARE IS PROVIDED BY THE AUTHORS 'AS IS' AND ANY EXPRESS
+// OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+// GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// version history
+// 2.0 by Peter Polakovic <peter.polakovic@cloudmakers.eu>
+
+/** INDIGO XML parser resync test
+ \file indigo_xml_resync_test.c
+
+ Property deleted by remote server and another one defined into the same cache slot
+ after reconnect must survive the resync timer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#include <indigo/indigo_bus.h>
+#include <indigo/indigo_client_xml.h>
+#include <indigo/indigo_xml.h>
+
+#define RESYNC_WAIT	7	/* longer than RESYNC_TIMEOUT in indigo_xml.c */
+
+static int defined_a = 0, deleted_a = 0, defined_b = 0, deleted_b = 0;
+
+static indigo_result client_define_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	if (!strcmp(property->name, "A"))
+		defined_a++;
+	else if (!strcmp(property->name, "B"))
+		defined_b++;
+	return INDIGO_OK;
+}
+
+static indigo_result client_delete_property(indigo_client *client, indigo_device *device, indigo_property *property, const char *message) {
+	if (!strcmp(property->name, "A"))
+		deleted_a++;
+	else if (!strcmp(property->name, "B"))
+		deleted_b++;
+	return INDIGO_OK;
+}
+
+static indigo_client client = {
+	"indigo_xml_resync_test", false, NULL, INDIGO_OK, INDIGO_VERSION_CURRENT, NULL,
+	NULL,
+	client_define_property,
+	NULL,
+	client_delete_property,
+	NULL,
+	NULL
+};
+
+static void send_xml(int handle, const char *xml) {
+	if (write(handle, xml, strlen(xml)) < 0)
+		perror("write");
+}
+
+static pthread_t start_parser(indigo_device *adapter, int sockets[2]) {
+	pthread_t thread;
+	socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+	indigo_adapter_context *context = adapter->device_context;
+	context->input = context->output = sockets[0];
+	pthread_create(&thread, NULL, (void *(*)(void *))indigo_xml_parse, adapter);
+	return thread;
+}
+
+static void stop_parser(pthread_t thread, int sockets[2]) {
+	shutdown(sockets[1], SHUT_RDWR);
+	pthread_join(thread, NULL);
+	close(sockets[1]);
+}
+
+int main(int argc, const char * argv[]) {
+	indigo_main_argc = argc;
+	indigo_main_argv = argv;
+	indigo_start();
+	indigo_attach_client(&client);
+	int sockets[2] = { -1, -1 };
+	indigo_device *adapter = indigo_xml_client_adapter("resync", "", -1, -1);
+	indigo_property_cache *cache = indigo_safe_malloc(sizeof(indigo_property_cache));
+	((indigo_adapter_context *)adapter->device_context)->property_cache = cache;
+	indigo_attach_device(adapter);
+	// first connection, A is cached in slot 0
+	pthread_t thread = start_parser(adapter, sockets);
+	send_xml(sockets[1], "<defNumberVector device='D' name='A' state='Ok' perm='rw' group='G' label='A'><defNumber name='X' label='X' min='0' max='1' step='1' format='%g'>0</defNumber></defNumberVector>\n");
+	sleep(1);
+	stop_parser(thread, sockets);
+	// reconnect, A is pending resync, remote deletes it and defines B into the freed slot
+	thread = start_parser(adapter, sockets);
+	send_xml(sockets[1], "<delProperty device='D' name='A'/>\n");
+	send_xml(sockets[1], "<defNumberVector device='D' name='B' state='Ok' perm='rw' group='G' label='B'><defNumber name='X' label='X' min='0' max='1' step='1' format='%g'>0</defNumber></defNumberVector>\n");
+	sleep(RESYNC_WAIT);
+	bool passed = defined_a == 1 && deleted_a == 1 && defined_b == 1 && deleted_b == 0;
+	printf("%s: A defined %d deleted %d, B defined %d deleted %d\n", passed ? "PASSED" : "FAILED", defined_a, deleted_a, defined_b, deleted_b);
+	stop_parser(thread, sockets);
+	indigo_detach_device(adapter);
+	indigo_flush_property_cache(cache);
+	indigo_safe_free(cache->properties);
+	free(cache);
+	return passed ? 0 : 1;
+}